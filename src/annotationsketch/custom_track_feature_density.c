@@ -0,0 +1,152 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "annotationsketch/custom_track_feature_density.h"
+#include "annotationsketch/custom_track_rep.h"
+#include "core/class_alloc_lock.h"
+#include "core/ma.h"
+#include "core/mathsupport.h"
+#include "core/unused_api.h"
+#include "extended/feature_index.h"
+
+struct GtCustomTrackFeatureDensity {
+  const GtCustomTrack parent_instance;
+  GtFeatureIndex *feature_index;
+  GtStr *seqid,
+        *title;
+  GtUword height;
+};
+
+#define gt_custom_track_feature_density_cast(ct)\
+        gt_custom_track_cast(gt_custom_track_feature_density_class(), ct)
+
+int gt_custom_track_feature_density_sketch(GtCustomTrack *ct,
+                                           GtGraphics *graphics,
+                                           unsigned int start_ypos,
+                                           GtRange viewrange,
+                                           GtStyle *style, GtError *err)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  GtUword *counts, nof_columns, maxcount = 0, i;
+  double margins, column_width;
+  GtColor color;
+  int had_err = 0;
+  gt_assert(ct && graphics && viewrange.start <= viewrange.end);
+
+  ctfd = gt_custom_track_feature_density_cast(ct);
+  margins = gt_graphics_get_xmargins(graphics);
+  gt_assert(gt_double_smaller_double(0, gt_graphics_get_image_width(graphics)
+                                        - 2*margins));
+
+  color.red = color.green = 0.3;
+  color.blue = 0.7;
+  color.alpha = 1.0;
+  if (gt_style_get_color(style, "feature_density", "fill", &color, NULL,
+                         err) == GT_STYLE_QUERY_ERROR) {
+    return -1;
+  }
+
+  /* one bin per pixel column, this makes drawing O(width) */
+  nof_columns = (GtUword) (gt_graphics_get_image_width(graphics) - 2*margins);
+  if (nof_columns > gt_range_length(&viewrange))
+    nof_columns = gt_range_length(&viewrange);
+  column_width = (gt_graphics_get_image_width(graphics) - 2*margins)
+                   / nof_columns;
+  counts = gt_malloc(nof_columns * sizeof (*counts));
+  had_err = gt_feature_index_get_feature_counts_for_range(ctfd->feature_index,
+                                                          counts,
+                                                          nof_columns,
+                                                          gt_str_get(ctfd
+                                                                     ->seqid),
+                                                          &viewrange, err);
+  for (i = 0; !had_err && i < nof_columns; i++) {
+    if (counts[i] > maxcount)
+      maxcount = counts[i];
+  }
+  for (i = 0; !had_err && maxcount > 0 && i < nof_columns; i++) {
+    double barheight;
+    if (counts[i] == 0)
+      continue;
+    barheight = ((double) counts[i] / maxcount) * ctfd->height;
+    gt_graphics_draw_vertical_line(graphics,
+                                   margins + (i + 0.5) * column_width,
+                                   start_ypos + ctfd->height - barheight,
+                                   color,
+                                   barheight,
+                                   column_width);
+  }
+  gt_free(counts);
+  return had_err;
+}
+
+GtUword gt_custom_track_feature_density_get_height(GtCustomTrack *ct)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  ctfd = gt_custom_track_feature_density_cast(ct);
+  return ctfd->height;
+}
+
+const char* gt_custom_track_feature_density_get_title(GtCustomTrack *ct)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  ctfd = gt_custom_track_feature_density_cast(ct);
+  return gt_str_get(ctfd->title);
+}
+
+void gt_custom_track_feature_density_delete(GtCustomTrack *ct)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  if (!ct) return;
+  ctfd = gt_custom_track_feature_density_cast(ct);
+  gt_feature_index_delete(ctfd->feature_index);
+  gt_str_delete(ctfd->seqid);
+  gt_str_delete(ctfd->title);
+}
+
+const GtCustomTrackClass* gt_custom_track_feature_density_class(void)
+{
+  static const GtCustomTrackClass *ctc = NULL;
+  gt_class_alloc_lock_enter();
+  if (!ctc)
+  {
+    ctc = gt_custom_track_class_new(sizeof (GtCustomTrackFeatureDensity),
+                                    gt_custom_track_feature_density_sketch,
+                                    gt_custom_track_feature_density_get_height,
+                                    gt_custom_track_feature_density_get_title,
+                                    gt_custom_track_feature_density_delete);
+  }
+  gt_class_alloc_lock_leave();
+  return ctc;
+}
+
+GtCustomTrack* gt_custom_track_feature_density_new(GtFeatureIndex
+                                                                *feature_index,
+                                                   const char *seqid,
+                                                   GtUword height)
+{
+  GtCustomTrackFeatureDensity *ctfd;
+  GtCustomTrack *ct;
+  gt_assert(feature_index && seqid);
+  ct = gt_custom_track_create(gt_custom_track_feature_density_class());
+  ctfd = gt_custom_track_feature_density_cast(ct);
+  ctfd->feature_index = gt_feature_index_ref(feature_index);
+  ctfd->seqid = gt_str_new_cstr(seqid);
+  ctfd->height = height;
+  ctfd->title = gt_str_new_cstr("Feature density (");
+  gt_str_append_cstr(ctfd->title, seqid);
+  gt_str_append_cstr(ctfd->title, ")");
+  return ct;
+}
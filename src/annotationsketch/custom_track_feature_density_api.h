@@ -0,0 +1,35 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef CUSTOM_TRACK_FEATURE_DENSITY_API_H
+#define CUSTOM_TRACK_FEATURE_DENSITY_API_H
+
+#include "annotationsketch/custom_track_api.h"
+#include "extended/feature_index_api.h"
+
+/* Implements the <GtCustomTrack> interface. This custom track draws a
+   histogram of the number of features overlapping each pixel column of the
+   displayed range, as retrieved from a <GtFeatureIndex>. Its drawing time
+   only depends on the image width, not on the number of features. */
+typedef struct GtCustomTrackFeatureDensity GtCustomTrackFeatureDensity;
+
+/* Creates a new <GtCustomTrackFeatureDensity> of height <height> for the
+   features on sequence region <seqid> in <feature_index>. */
+GtCustomTrack* gt_custom_track_feature_density_new(GtFeatureIndex
+                                                                *feature_index,
+                                                   const char *seqid,
+                                                   GtUword height);
+#endif
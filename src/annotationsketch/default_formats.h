@@ -28,6 +28,8 @@
 #define ARROW_WIDTH_DEFAULT        6
 #define STROKE_WIDTH_DEFAULT     0.5
 #define FONT_SIZE_DEFAULT          8
+#define MAX_FEATURES_PER_PIXEL_DEFAULT 50
+#define DENSITY_TRACK_HEIGHT_DEFAULT   50
 
 #define HEADER_SPACE              40
 #define HEAD_TRACK_SPACE_DEFAULT  15
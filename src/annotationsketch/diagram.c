@@ -20,6 +20,7 @@
 #include "annotationsketch/canvas.h"
 #include "annotationsketch/canvas_cairo_file.h"
 #include "annotationsketch/diagram.h"
+#include "extended/feature_index.h"
 #include "extended/feature_index_memory_api.h"
 #include "annotationsketch/line_breaker_captions.h"
 #include "annotationsketch/style.h"
@@ -48,6 +49,8 @@
 struct GtDiagram {
   /* GtBlock lists indexed by track keys */
   GtHashmap *blocks;
+  /* GtBlock lists indexed by root feature, kept across range changes */
+  GtHashmap *rootblocks;
   /* Reverse lookup structure (per node) */
   GtHashmap *nodeinfo;
   /* Cache tables for configuration data */
@@ -55,6 +58,9 @@ struct GtDiagram {
   GtStyle *style;
   GtArray *features,
           *custom_tracks;
+  /* only set if the diagram was created from a feature index */
+  GtFeatureIndex *feature_index;
+  GtStr *seqid;
   GtRange range;
   void *ptr;
   GtTrackSelectorFunc select_func;
@@ -675,20 +681,17 @@ static void default_track_selector(GtBlock *block, GtStr *result,
   gt_str_append_cstr(result, gt_block_get_type(block));
 }
 
-/* Create lists of all GtBlocks in the diagram. */
+/* Create list of all GtBlocks belonging to a root feature. */
 static int collect_blocks(GT_UNUSED void *key, void *value, void *data,
                           GT_UNUSED GtError *err)
 {
   NodeInfoElement *ni = (NodeInfoElement*) value;
-  GtDiagram *diagram = (GtDiagram*) data;
+  GtArray *blocklist = (GtArray*) data;
   GtBlock *block = NULL;
-  GtStr *trackid_str;
   GtUword i = 0;
-  trackid_str = gt_str_new();
   for (i = 0; i < gt_str_array_size(ni->types); i++) {
     const char *type;
     GtUword j;
-    GtArray *list;
     PerTypeInfo *type_struc = NULL;
     GtBlock* mainblock = NULL;
     type = gt_str_array_get(ni->types, i);
@@ -715,19 +718,7 @@ static int collect_blocks(GT_UNUSED void *key, void *value, void *data,
         } else block = bt->block;
       }
       gt_assert(block);
-      gt_str_reset(trackid_str);
-      /* execute hook for track selector function */
-      diagram->select_func(block, trackid_str, diagram->ptr);
-
-      if (!(list = (GtArray*) gt_hashmap_get(diagram->blocks,
-                                             gt_str_get(trackid_str))))
-      {
-        list = gt_array_new(sizeof (GtBlock*));
-        gt_hashmap_add(diagram->blocks, gt_cstr_dup(gt_str_get(trackid_str)),
-                       list);
-      };
-      gt_assert(list);
-      gt_array_add(list, block);
+      gt_array_add(blocklist, block);
       gt_free(bt);
     }
     gt_array_delete(type_struc->blocktuples);
@@ -737,7 +728,6 @@ static int collect_blocks(GT_UNUSED void *key, void *value, void *data,
   gt_hashmap_delete(ni->type_index);
   gt_str_array_delete(ni->types);
   gt_free(ni);
-  gt_str_delete(trackid_str);
   return 0;
 }
 
@@ -773,15 +763,36 @@ static void blocklist_delete(void *value)
   gt_array_delete(a);
 }
 
-static int gt_diagram_build(GtDiagram *diagram, GtError *err)
+static GtArray* build_root_blocks(GtDiagram *diagram, GtFeatureNode *root,
+                                  GtError *err)
 {
-  GtUword i = 0;
-  int had_err = 0;
+  GtArray *blocklist;
   NodeTraverseInfo nti;
-  gt_assert(diagram);
+  GT_UNUSED int rval;
+  gt_assert(diagram && root);
 
   nti.diagram = diagram;
   nti.err = err;
+  gt_hashmap_reset(diagram->nodeinfo);
+  if (traverse_genome_nodes(root, &nti))
+    return NULL;
+  blocklist = gt_array_new(sizeof (GtBlock*));
+  /* collect blocks from nodeinfo structures */
+  rval = gt_hashmap_foreach_ordered(diagram->nodeinfo,
+                                    collect_blocks,
+                                    blocklist,
+                                    (GtCompare) gt_genome_node_cmp,
+                                    NULL);
+  gt_assert(!rval); /* collect_blocks() is sane */
+  return blocklist;
+}
+
+static int gt_diagram_build(GtDiagram *diagram, GtError *err)
+{
+  GtUword i = 0, j;
+  GtStr *trackid_str;
+  gt_assert(diagram);
+
   /* clear caches */
   gt_hashmap_reset(diagram->collapsingtypes);
   gt_hashmap_reset(diagram->groupedtypes);
@@ -789,28 +800,46 @@ static int gt_diagram_build(GtDiagram *diagram, GtError *err)
 
   if (!diagram->blocks)
   {
-    gt_hashmap_reset(diagram->nodeinfo);
-    /* do node traversal for each root feature */
+    diagram->blocks = gt_hashmap_new(GT_HASH_STRING, gt_free_func,
+                                     (GtFree) blocklist_delete);
+    trackid_str = gt_str_new();
+    /* do node traversal for each root feature not already processed */
     for (i = 0; i < gt_array_size(diagram->features); i++)
     {
       GtFeatureNode *current_root;
+      GtArray *blocklist;
       current_root = *(GtFeatureNode**) gt_array_get(diagram->features,i);
-      had_err = traverse_genome_nodes(current_root, &nti);
-      if (had_err)
-        return -1;
+      if (!(blocklist = gt_hashmap_get(diagram->rootblocks, current_root))) {
+        if (!(blocklist = build_root_blocks(diagram, current_root, err))) {
+          gt_hashmap_delete(diagram->blocks);
+          diagram->blocks = NULL;
+          gt_str_delete(trackid_str);
+          return -1;
+        }
+        gt_hashmap_add(diagram->rootblocks, current_root, blocklist);
+      }
+      for (j = 0; j < gt_array_size(blocklist); j++) {
+        GtArray *list;
+        GtBlock *block = *(GtBlock**) gt_array_get(blocklist, j);
+        gt_str_reset(trackid_str);
+        /* execute hook for track selector function */
+        diagram->select_func(block, trackid_str, diagram->ptr);
+        if (!(list = (GtArray*) gt_hashmap_get(diagram->blocks,
+                                               gt_str_get(trackid_str))))
+        {
+          list = gt_array_new(sizeof (GtBlock*));
+          gt_hashmap_add(diagram->blocks,
+                         gt_cstr_dup(gt_str_get(trackid_str)), list);
+        }
+        gt_assert(list);
+        block = gt_block_ref(block);
+        gt_array_add(list, block);
+      }
     }
-    diagram->blocks = gt_hashmap_new(GT_HASH_STRING, gt_free_func,
-                                     (GtFree) blocklist_delete);
-    /* collect blocks from nodeinfo structures */
-    had_err = gt_hashmap_foreach_ordered(diagram->nodeinfo,
-                                         collect_blocks,
-                                         diagram,
-                                         (GtCompare) gt_genome_node_cmp,
-                                         NULL);
-    gt_assert(!had_err); /* collect_blocks() is sane */
+    gt_str_delete(trackid_str);
   }
 
-  return had_err;
+  return 0;
 }
 
 static GtDiagram* gt_diagram_new_generic(GtArray *features,
@@ -821,6 +850,8 @@ static GtDiagram* gt_diagram_new_generic(GtArray *features,
   GtDiagram *diagram;
   diagram = gt_calloc(1, sizeof (GtDiagram));
   diagram->nodeinfo = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  diagram->rootblocks = gt_hashmap_new(GT_HASH_DIRECT, NULL,
+                                       (GtFree) blocklist_delete);
   diagram->style = style;
   diagram->lock = gt_rwlock_new();
   diagram->range = *range;
@@ -860,6 +891,8 @@ GtDiagram* gt_diagram_new(GtFeatureIndex *feature_index, const char *seqid,
     return NULL;
   }
   diagram = gt_diagram_new_generic(features, range, style, false);
+  diagram->feature_index = gt_feature_index_ref(feature_index);
+  diagram->seqid = gt_str_new_cstr(seqid);
   return diagram;
 }
 
@@ -870,6 +903,114 @@ GtDiagram* gt_diagram_new_from_array(GtArray *features, const GtRange *range,
   return gt_diagram_new_generic(features, range, style, true);
 }
 
+static int diagram_add_features_for_range(GtDiagram *diagram,
+                                          GtArray *features,
+                                          GtHashmap *present,
+                                          GtUword start, GtUword end,
+                                          GtError *err)
+{
+  GtArray *newfeatures;
+  GtRange qry_range;
+  GtUword i;
+  int had_err;
+  gt_assert(diagram && features && present && start <= end);
+  qry_range.start = start;
+  qry_range.end = end;
+  newfeatures = gt_array_new(sizeof (GtGenomeNode*));
+  had_err = gt_feature_index_get_features_for_range(diagram->feature_index,
+                                                    newfeatures,
+                                                    gt_str_get(diagram->seqid),
+                                                    &qry_range, err);
+  for (i = 0; !had_err && i < gt_array_size(newfeatures); i++) {
+    GtFeatureNode *fn = *(GtFeatureNode**) gt_array_get(newfeatures, i);
+    /* features spanning into the old range are already present */
+    if (!gt_hashmap_get(present, fn)) {
+      gt_hashmap_add(present, fn, fn);
+      gt_array_add(features, fn);
+    }
+  }
+  gt_array_delete(newfeatures);
+  return had_err;
+}
+
+int gt_diagram_set_range(GtDiagram *diagram, const GtRange *range,
+                         GtError *err)
+{
+  GtArray *features;
+  GtHashmap *present;
+  GtRange oldrange;
+  GtUword i;
+  bool same_width;
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(diagram && range);
+  if (range->start == range->end)
+  {
+    gt_error_set(err, "range start must not be equal to range end");
+    return -1;
+  }
+  gt_rwlock_wrlock(diagram->lock);
+  if (!diagram->feature_index) {
+    gt_error_set(err, "diagram was not created from a feature index");
+    gt_rwlock_unlock(diagram->lock);
+    return -1;
+  }
+  oldrange = diagram->range;
+  /* visibility and captions depend on the range width, blocks can only be
+     reused if it does not change */
+  same_width = (gt_range_length(&oldrange) == gt_range_length(range));
+  if (!same_width)
+    gt_hashmap_reset(diagram->rootblocks);
+  features = gt_array_new(sizeof (GtGenomeNode*));
+  present = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+
+  /* keep features still in view, their blocks are only kept if they were not
+     clipped by the old range and will not be clipped by the new one */
+  for (i = 0; i < gt_array_size(diagram->features); i++) {
+    GtFeatureNode *fn = *(GtFeatureNode**) gt_array_get(diagram->features, i);
+    GtRange rng = gt_genome_node_get_range((GtGenomeNode*) fn);
+    if (gt_range_overlap(range, &rng)) {
+      gt_array_add(features, fn);
+      gt_hashmap_add(present, fn, fn);
+      if (same_width && (!gt_range_contains(&oldrange, &rng)
+                           || !gt_range_contains(range, &rng))) {
+        gt_hashmap_remove(diagram->rootblocks, fn);
+      }
+    } else if (same_width)
+      gt_hashmap_remove(diagram->rootblocks, fn);
+  }
+
+  /* only query the parts of the new range not covered by the old one */
+  if (!gt_range_overlap(&oldrange, range)) {
+    had_err = diagram_add_features_for_range(diagram, features, present,
+                                             range->start, range->end, err);
+  } else {
+    if (range->start < oldrange.start) {
+      had_err = diagram_add_features_for_range(diagram, features, present,
+                                               range->start,
+                                               oldrange.start - 1, err);
+    }
+    if (!had_err && range->end > oldrange.end) {
+      had_err = diagram_add_features_for_range(diagram, features, present,
+                                               oldrange.end + 1, range->end,
+                                               err);
+    }
+  }
+  gt_hashmap_delete(present);
+
+  if (!had_err) {
+    gt_array_sort(features, (GtCompare) gt_genome_node_compare);
+    gt_array_delete(diagram->features);
+    diagram->features = features;
+    diagram->range = *range;
+    gt_hashmap_delete(diagram->blocks);
+    diagram->blocks = NULL;
+  } else
+    gt_array_delete(features);
+  gt_rwlock_unlock(diagram->lock);
+  return had_err;
+}
+
 GtRange gt_diagram_get_range(const GtDiagram *diagram)
 {
   GtRange rng;
@@ -880,6 +1021,28 @@ GtRange gt_diagram_get_range(const GtDiagram *diagram)
   return rng;
 }
 
+GtUword gt_diagram_get_number_of_features(const GtDiagram *diagram)
+{
+  GtUword nof_features;
+  gt_assert(diagram);
+  gt_rwlock_rdlock(diagram->lock);
+  nof_features = gt_array_size(diagram->features);
+  gt_rwlock_unlock(diagram->lock);
+  return nof_features;
+}
+
+GtFeatureIndex* gt_diagram_get_feature_index(const GtDiagram *diagram)
+{
+  gt_assert(diagram);
+  return diagram->feature_index;
+}
+
+const char* gt_diagram_get_seqid(const GtDiagram *diagram)
+{
+  gt_assert(diagram);
+  return diagram->seqid ? gt_str_get(diagram->seqid) : NULL;
+}
+
 void gt_diagram_set_track_selector_func(GtDiagram *diagram,
                                         GtTrackSelectorFunc bsfunc,
                                         void *ptr)
@@ -892,6 +1055,7 @@ void gt_diagram_set_track_selector_func(GtDiagram *diagram,
   /* this could change track assignment -> discard current blocks and requeue */
   gt_hashmap_delete(diagram->blocks);
   diagram->blocks = NULL;
+  gt_hashmap_reset(diagram->rootblocks);
   gt_rwlock_unlock(diagram->lock);
 }
 
@@ -902,6 +1066,7 @@ void gt_diagram_reset_track_selector_func(GtDiagram *diagram)
   diagram->select_func = default_track_selector;
   gt_hashmap_delete(diagram->blocks);
   diagram->blocks = NULL;
+  gt_hashmap_reset(diagram->rootblocks);
   gt_rwlock_unlock(diagram->lock);
 }
 
@@ -975,6 +1140,23 @@ void* gt_diagram_unit_test_sketch_func(void *data)
   return NULL;
 }
 
+static int count_blocks(GT_UNUSED void *key, void *value, void *data,
+                        GT_UNUSED GtError *err)
+{
+  *(GtUword*) data += gt_array_size((GtArray*) value);
+  return 0;
+}
+
+static GtUword diagram_number_of_blocks(GtDiagram *d, GtError *err)
+{
+  GtHashmap *blocks;
+  GtUword nof_blocks = 0;
+  if (!(blocks = gt_diagram_get_blocks(d, err)))
+    return GT_UNDEF_UWORD;
+  (void) gt_hashmap_foreach(blocks, count_blocks, &nof_blocks, NULL);
+  return nof_blocks;
+}
+
 int gt_diagram_unit_test(GtError *err)
 {
   int had_err = 0;
@@ -996,6 +1178,33 @@ int gt_diagram_unit_test(GtError *err)
   gt_diagram_unit_test_sketch_func(&sh);
   gt_ensure(sh.errstatus == 0);
 
+  /* scroll: the gene stays completely in view */
+  if (!had_err) {
+    GtRange rng = {200, 10100}, newrng;
+    GtUword nof_blocks = diagram_number_of_blocks(sh.d, err);
+    gt_ensure(nof_blocks != GT_UNDEF_UWORD && nof_blocks > 0);
+    gt_ensure(gt_diagram_set_range(sh.d, &rng, err) == 0);
+    newrng = gt_diagram_get_range(sh.d);
+    gt_ensure(gt_range_compare(&rng, &newrng) == 0);
+    gt_ensure(diagram_number_of_blocks(sh.d, err) == nof_blocks);
+  }
+
+  /* scroll: the gene is partially in view */
+  if (!had_err) {
+    GtRange rng = {5000, 14900};
+    gt_ensure(gt_diagram_set_range(sh.d, &rng, err) == 0);
+    gt_ensure(diagram_number_of_blocks(sh.d, err) > 0);
+    gt_diagram_unit_test_sketch_func(&sh);
+    gt_ensure(sh.errstatus == 0);
+  }
+
+  /* scroll: the gene has left the view */
+  if (!had_err) {
+    GtRange rng = {20000, 29900};
+    gt_ensure(gt_diagram_set_range(sh.d, &rng, err) == 0);
+    gt_ensure(diagram_number_of_blocks(sh.d, err) == 0);
+  }
+
   gt_style_delete(sh.sty);
   gt_diagram_delete(sh.d);
   gt_feature_index_delete(sh.fi);
@@ -1010,7 +1219,10 @@ void gt_diagram_delete(GtDiagram *diagram)
   gt_array_delete(diagram->features);
   if (diagram->blocks)
     gt_hashmap_delete(diagram->blocks);
+  gt_hashmap_delete(diagram->rootblocks);
   gt_hashmap_delete(diagram->nodeinfo);
+  gt_feature_index_delete(diagram->feature_index);
+  gt_str_delete(diagram->seqid);
   gt_hashmap_delete(diagram->collapsingtypes);
   gt_hashmap_delete(diagram->groupedtypes);
   gt_hashmap_delete(diagram->caption_display_status);
@@ -26,6 +26,14 @@
 
 GtHashmap* gt_diagram_get_blocks(GtDiagram *diagram, GtError *err);
 GtArray*   gt_diagram_get_custom_tracks(const GtDiagram *diagram);
+/* Returns the number of top-level features currently in <diagram>. */
+GtUword    gt_diagram_get_number_of_features(const GtDiagram *diagram);
+/* Returns the feature index <diagram> was created from, or NULL if it was
+   created from an array. */
+GtFeatureIndex* gt_diagram_get_feature_index(const GtDiagram *diagram);
+/* Returns the sequence ID <diagram> was created for, or NULL if it was
+   created from an array. */
+const char* gt_diagram_get_seqid(const GtDiagram *diagram);
 void       gt_diagram_reset(GtDiagram *diagram);
 int        gt_diagram_unit_test(GtError*);
 
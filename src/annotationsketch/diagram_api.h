@@ -53,6 +53,14 @@ GtDiagram* gt_diagram_new_from_array(GtArray *features, const GtRange *range,
                                      GtStyle *style);
 /* Returns the sequence position range represented by the <diagram>. */
 GtRange    gt_diagram_get_range(const GtDiagram *diagram);
+/* Moves the <diagram>, which must have been created by <gt_diagram_new()>, to
+   show the region <range> of the same sequence. Only features entering the
+   view are retrieved from the feature index, and the blocks of features lying
+   completely inside both the old and the new range are reused as long as the
+   width of the range does not change (e.g. when scrolling).
+   Returns 0 on success, and -1 if an error occurred (<err> is set). */
+int        gt_diagram_set_range(GtDiagram *diagram, const GtRange *range,
+                                GtError *err);
 /* Assigns a GtTrackSelectorFunc to use to assign blocks to tracks.
    If none is set, or set to NULL, then track types are used as track keys
    (default behavior). */
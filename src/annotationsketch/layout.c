@@ -18,6 +18,7 @@
 #include "annotationsketch/block.h"
 #include "annotationsketch/canvas.h"
 #include "annotationsketch/cliptype.h"
+#include "annotationsketch/custom_track_feature_density.h"
 #include "annotationsketch/default_formats.h"
 #include "annotationsketch/diagram.h"
 #include "annotationsketch/layout.h"
@@ -62,6 +63,7 @@ struct GtLayout {
   bool own_twc,
        layout_done;
   GtArray *custom_tracks;
+  GtCustomTrack *density_track;
   GtHashmap *tracks,
             *blocks;
   GtRange viewrange;
@@ -234,6 +236,33 @@ static int check_width(unsigned int width, GtStyle *style, GtError *err)
   return had_err;
 }
 
+/* Returns true if <diagram> holds too many features to be drawn individually
+   at width <width>, in which case a density summary is shown instead. */
+static int layout_should_summarize(GtDiagram *diagram, unsigned int width,
+                                   GtStyle *style, bool *summarize,
+                                   GtError *err)
+{
+  double margins = MARGINS_DEFAULT,
+         max_features_per_pixel = MAX_FEATURES_PER_PIXEL_DEFAULT;
+  *summarize = false;
+  if (!gt_diagram_get_feature_index(diagram))
+    return 0;
+  if (gt_style_get_num(style, "format", "margins", &margins, NULL,
+                       err) == GT_STYLE_QUERY_ERROR
+        || gt_style_get_num(style, "format", "max_features_per_pixel",
+                            &max_features_per_pixel, NULL,
+                            err) == GT_STYLE_QUERY_ERROR) {
+    return -1;
+  }
+  /* a non-positive threshold disables summarization */
+  if (gt_double_smaller_double(0, max_features_per_pixel)) {
+    *summarize = gt_double_smaller_double(max_features_per_pixel
+                                            * (width - 2*margins),
+                                   gt_diagram_get_number_of_features(diagram));
+  }
+  return 0;
+}
+
 GtLayout* gt_layout_new(GtDiagram *diagram,
                         unsigned int width,
                         GtStyle *style,
@@ -263,12 +292,15 @@ GtLayout* gt_layout_new_with_twc(GtDiagram *diagram,
 {
   GtLayout *layout;
   GtHashmap *blocks;
+  bool summarize;
   gt_assert(diagram);
   gt_assert(style);
   gt_assert(twc);
   gt_assert(err);
   if (check_width(width, style, err) < 0)
     return NULL;
+  if (layout_should_summarize(diagram, width, style, &summarize, err) < 0)
+    return NULL;
   layout = gt_calloc(1, sizeof (GtLayout));
   layout->twc = twc;
   layout->style = style;
@@ -283,13 +315,40 @@ GtLayout* gt_layout_new_with_twc(GtDiagram *diagram,
   layout->lock = gt_rwlock_new();
   layout->own_twc = false;
   layout->layout_done = false;
-  layout->custom_tracks = gt_array_ref(gt_diagram_get_custom_tracks(diagram));
   /* XXX: use other container type here! */
   layout->tracks = gt_hashmap_new(GT_HASH_STRING, gt_free_func,
                                   (GtFree) gt_track_delete);
+  if (summarize) {
+    /* too many features to draw individually, replace all feature tracks by
+       a single density track whose drawing cost only depends on the width */
+    GtArray *diagram_tracks = gt_diagram_get_custom_tracks(diagram);
+    double height = DENSITY_TRACK_HEIGHT_DEFAULT;
+    GtUword i;
+    if (gt_style_get_num(style, "feature_density", "height", &height, NULL,
+                         err) == GT_STYLE_QUERY_ERROR) {
+      gt_hashmap_delete(layout->tracks);
+      gt_rwlock_delete(layout->lock);
+      gt_free(layout);
+      return NULL;
+    }
+    layout->custom_tracks = gt_array_new(sizeof (GtCustomTrack*));
+    for (i = 0; i < gt_array_size(diagram_tracks); i++)
+      gt_array_add(layout->custom_tracks,
+                   *(GtCustomTrack**) gt_array_get(diagram_tracks, i));
+    layout->density_track =
+              gt_custom_track_feature_density_new(
+                                         gt_diagram_get_feature_index(diagram),
+                                         gt_diagram_get_seqid(diagram),
+                                         (GtUword) height);
+    gt_array_add(layout->custom_tracks, layout->density_track);
+    layout->blocks = gt_hashmap_new(GT_HASH_STRING, NULL, NULL);
+    return layout;
+  }
+  layout->custom_tracks = gt_array_ref(gt_diagram_get_custom_tracks(diagram));
   blocks = gt_diagram_get_blocks(diagram, err);
   if (!blocks) {
     gt_array_delete(layout->custom_tracks);
+    gt_rwlock_delete(layout->lock);
     gt_hashmap_delete(layout->tracks);
     gt_free(layout);
     return NULL;
@@ -306,6 +365,7 @@ void gt_layout_delete(GtLayout *layout)
     gt_text_width_calculator_delete(layout->twc);
   gt_hashmap_delete(layout->tracks);
   gt_array_delete(layout->custom_tracks);
+  gt_custom_track_delete(layout->density_track);
   if (layout->blocks)
     gt_hashmap_delete(layout->blocks);
   gt_rwlock_unlock(layout->lock);
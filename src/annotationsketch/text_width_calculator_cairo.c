@@ -18,10 +18,13 @@
 #include <cairo.h>
 #include <pango/pangocairo.h>
 #include "core/class_alloc_lock.h"
+#include "core/cstr_api.h"
 #include "core/ensure.h"
+#include "core/hashmap.h"
 #include "core/ma.h"
 #include "core/mathsupport.h"
 #include "core/str_api.h"
+#include "core/thread_api.h"
 #include "core/unused_api.h"
 #include "annotationsketch/default_formats.h"
 #include "annotationsketch/style.h"
@@ -40,6 +43,8 @@ struct GtTextWidthCalculatorCairo {
   cairo_surface_t *mysurf;
   PangoLayout *layout;
   PangoFontDescription *desc;
+  GtHashmap *widthcache;
+  GtMutex *cachelock;
   bool own_context;
 };
 
@@ -53,9 +58,19 @@ double gt_text_width_calculator_cairo_get_text_width(GtTextWidthCalculator *twc,
 {
   GtTextWidthCalculatorCairo *twcc;
   PangoRectangle rect;
+  double *width;
   gt_assert(twc && text);
   twcc = gt_text_width_calculator_cairo_cast(twc);
 
+  /* the font settings are fixed for the lifetime of a calculator, so the
+     measured width only depends on the text itself: captions and type labels
+     recur very often, measure each of them only once */
+  gt_mutex_lock(twcc->cachelock);
+  if ((width = gt_hashmap_get(twcc->widthcache, text))) {
+    gt_mutex_unlock(twcc->cachelock);
+    return *width;
+  }
+
   /* redo layout */
   pango_layout_set_text(twcc->layout, text, -1);
 
@@ -65,7 +80,11 @@ double gt_text_width_calculator_cairo_get_text_width(GtTextWidthCalculator *twc,
   if (twcc->style)
     cairo_restore(twcc->context);
   gt_assert(gt_double_smaller_double(0, rect.width));
-  return rect.width;
+  width = gt_malloc(sizeof *width);
+  *width = rect.width;
+  gt_hashmap_add(twcc->widthcache, gt_cstr_dup(text), width);
+  gt_mutex_unlock(twcc->cachelock);
+  return *width;
 }
 
 void gt_text_width_calculator_cairo_delete(GtTextWidthCalculator *twc)
@@ -74,6 +93,8 @@ void gt_text_width_calculator_cairo_delete(GtTextWidthCalculator *twc)
   if (!twc) return;
   twcc = gt_text_width_calculator_cairo_cast(twc);
   g_object_unref(twcc->layout);
+  gt_hashmap_delete(twcc->widthcache);
+  gt_mutex_delete(twcc->cachelock);
   if (twcc->style)
     gt_style_delete(twcc->style);
   if (twcc->own_context)
@@ -110,6 +131,9 @@ GtTextWidthCalculator* gt_text_width_calculator_cairo_new(cairo_t *context,
   twc = gt_text_width_calculator_create(gt_text_width_calculator_cairo_class());
   twcc = gt_text_width_calculator_cairo_cast(twc);
   fontfam = gt_str_new_cstr("Sans");
+  twcc->widthcache = gt_hashmap_new(GT_HASH_STRING, gt_free_func,
+                                    gt_free_func);
+  twcc->cachelock = gt_mutex_new();
   if (style)
     twcc->style = gt_style_ref(style);
   if (!context)
@@ -0,0 +1,60 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "core/assert_api.h"
+#include "core/chunk_dispenser.h"
+#include "core/ma_api.h"
+#include "core/minmax.h"
+#include "core/thread_api.h"
+
+#define GT_CHUNK_DISPENSER_FACTOR 4UL
+
+struct GtChunkDispenser {
+  GtUword nofitems,
+          next;
+  GtMutex *mutex;
+};
+
+GtChunkDispenser* gt_chunk_dispenser_new(GtUword nofitems)
+{
+  GtChunkDispenser *cd = gt_malloc(sizeof *cd);
+  cd->nofitems = nofitems;
+  cd->next = 0;
+  cd->mutex = gt_mutex_new();
+  return cd;
+}
+
+GtUword gt_chunk_dispenser_next(GtChunkDispenser *cd, GtUword *first)
+{
+  GtUword chunk = 0;
+  gt_assert(cd && first);
+  gt_mutex_lock(cd->mutex);
+  if (cd->next < cd->nofitems) {
+    chunk = MAX(1UL, (cd->nofitems - cd->next) /
+                     (GT_CHUNK_DISPENSER_FACTOR * MAX(gt_jobs, 1U)));
+    *first = cd->next;
+    cd->next += chunk;
+  }
+  gt_mutex_unlock(cd->mutex);
+  return chunk;
+}
+
+void gt_chunk_dispenser_delete(GtChunkDispenser *cd)
+{
+  if (!cd) return;
+  gt_mutex_delete(cd->mutex);
+  gt_free(cd);
+}
@@ -0,0 +1,36 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef CHUNK_DISPENSER_H
+#define CHUNK_DISPENSER_H
+
+#include "core/types_api.h"
+
+/* A <GtChunkDispenser> hands out the indices 0 to <nofitems>-1 to the threads
+   started by <gt_multithread()> in consecutive chunks of decreasing size: each
+   chunk holds at most the number of remaining items divided by four times
+   <gt_jobs>. This keeps the lock contention low, while threads which received
+   expensive items are still compensated by the small chunks at the end. */
+typedef struct GtChunkDispenser GtChunkDispenser;
+
+GtChunkDispenser* gt_chunk_dispenser_new(GtUword nofitems);
+/* Claim the next chunk of items for the calling thread. Returns the number of
+   items claimed (0 if all items have been handed out) and stores the index of
+   the first one in <first>. Thread-safe. */
+GtUword           gt_chunk_dispenser_next(GtChunkDispenser*, GtUword *first);
+void              gt_chunk_dispenser_delete(GtChunkDispenser*);
+
+#endif
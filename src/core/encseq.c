@@ -20,6 +20,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 #include <errno.h>
 #ifndef S_SPLINT_S
@@ -57,6 +58,7 @@
 #include "core/minmax.h"
 #include "core/progressbar.h"
 #include "core/sequence_buffer_fasta.h"
+#include "core/sequence_buffer_memory.h"
 #include "core/sequence_buffer_plain.h"
 #include "core/str.h"
 #include "core/timer_api.h"
@@ -683,23 +685,251 @@ static void showGtRange(const GtRange *range)
 }
 #endif
 
+/* Decodes the two bit encoding of the positions <frompos> to <topos> into
+   <buffer>, a whole unit at a time. The characters at special positions
+   are not correct after this, see encseq_extract_patch_specials(). */
+static void encseq_extract_twobitencoding(const GtEncseq *encseq,
+                                          GtUchar *buffer,
+                                          GtUword frompos,
+                                          GtUword topos)
+{
+  const GtTwobitencoding *tbeptr;
+  GtUword pos = frompos;
+  GtUchar *bufptr = buffer;
+
+  while (pos <= topos && GT_MODBYUNITSIN2BITENC(pos) > 0) {
+    *bufptr++ = (GtUchar) EXTRACTENCODEDCHAR(encseq->twobitencoding, pos);
+    pos++;
+  }
+  tbeptr = encseq->twobitencoding + GT_DIVBYUNITSIN2BITENC(pos);
+  while (pos + GT_UNITSIN2BITENC <= topos + 1) {
+    const GtTwobitencoding tbe = *tbeptr++;
+    unsigned int idx;
+
+    /* constant trip count without dependencies: compilers unroll and
+       vectorize this loop */
+    for (idx = 0; idx < (unsigned int) GT_UNITSIN2BITENC; idx++) {
+      bufptr[idx] = (GtUchar) EXTRACTENCODEDCHARSCALARFROMLEFT(tbe, idx);
+    }
+    bufptr += GT_UNITSIN2BITENC;
+    pos += GT_UNITSIN2BITENC;
+  }
+  for (/* Nothing */; pos <= topos; pos++) {
+    *bufptr++ = (GtUchar) EXTRACTENCODEDCHAR(encseq->twobitencoding, pos);
+  }
+}
+
+static void encseq_extract_patch_rangesViatables(GtEncseqReader *esr,
+                                                 KindofSWtable kindsw,
+                                                 GtUchar cc,
+                                                 GtUchar *buffer,
+                                                 GtUword frompos,
+                                                 GtUword topos)
+{
+  GtEncseqReaderViatablesinfo *swstate
+    = (kindsw == SWtable_wildcardrange) ? esr->wildcardrangestate
+                                        : esr->ssptabstate;
+
+  gt_assert(swstate != NULL);
+  while (swstate->hasprevious && swstate->previousrange.start <= topos) {
+    if (swstate->previousrange.end > frompos) {
+      GtUword start = MAX(swstate->previousrange.start, frompos),
+              end = MIN(swstate->previousrange.end, topos + 1);
+
+      memset(buffer + start - frompos, (int) cc, (size_t) (end - start));
+    }
+    if (!swstate->hasmore)
+      break;
+    advancerangeGtEncseqReader(esr, kindsw);
+  }
+}
+
+/* Overwrites the positions of <buffer> which correspond to special
+   characters in the range <frompos> to <topos>. */
+static void encseq_extract_patch_specials(const GtEncseq *encseq,
+                                          GtUchar *buffer,
+                                          GtUword frompos,
+                                          GtUword topos)
+{
+  GtUword pos;
+
+  if (!encseq->has_specialranges)
+    return;
+  if (encseq->accesstype_via_utables) {
+    GtEncseqReader *esr
+      = gt_encseq_create_reader_with_readmode(encseq, GT_READMODE_FORWARD,
+                                              frompos);
+    if (encseq->has_wildcardranges)
+      encseq_extract_patch_rangesViatables(esr, SWtable_wildcardrange,
+                                           (GtUchar) WILDCARD, buffer,
+                                           frompos, topos);
+    if (encseq->numofdbsequences > 1UL)
+      encseq_extract_patch_rangesViatables(esr, SWtable_ssptab,
+                                           (GtUchar) SEPARATOR, buffer,
+                                           frompos, topos);
+    gt_encseq_reader_delete(esr);
+    return;
+  }
+  switch (encseq->sat) {
+    case GT_ACCESS_TYPE_BITACCESS:
+      pos = frompos;
+      while (pos <= topos) {
+        GtBitsequence word = GT_BITNUM2WORD(encseq->specialbits, pos);
+
+        if (word == 0) {
+          pos += GT_INTWORDSIZE - GT_MODWORDSIZE(pos);
+          continue;
+        }
+        if (GT_ISBITSET(word, pos)) {
+          buffer[pos - frompos]
+            = (buffer[pos - frompos] == (GtUchar) GT_TWOBITS_FOR_SEPARATOR)
+                ? (GtUchar) SEPARATOR
+                : (GtUchar) WILDCARD;
+        }
+        pos++;
+      }
+      break;
+    case GT_ACCESS_TYPE_EQUALLENGTH:
+      if (encseq->numofdbsequences > 1UL) {
+        const GtUword seqlen = encseq->equallength.valueunsignedlong;
+
+        /* separators are at positions seqlen + k * (seqlen + 1) */
+        pos = seqlen + (seqlen + 1) * (frompos / (seqlen + 1));
+        for (/* Nothing */; pos <= topos; pos += seqlen + 1) {
+          buffer[pos - frompos] = (GtUchar) SEPARATOR;
+        }
+      }
+      break;
+    default:
+      gt_assert(false);
+  }
+}
+
+static void encseq_extract_apply_readmode(GtUchar *buffer,
+                                          GtUword len,
+                                          GtReadmode readmode)
+{
+  if (GT_ISDIRCOMPLEMENT(readmode)) {
+    GtUword idx;
+
+    for (idx = 0; idx < len; idx++) {
+      if (ISNOTSPECIAL(buffer[idx]))
+        buffer[idx] = GT_COMPLEMENTBASE(buffer[idx]);
+    }
+  }
+  if (GT_ISDIRREVERSE(readmode) && len > 1UL) {
+    GtUchar *lptr, *rptr, tmp;
+
+    for (lptr = buffer, rptr = buffer + len - 1; lptr < rptr; lptr++, rptr--) {
+      tmp = *lptr;
+      *lptr = *rptr;
+      *rptr = tmp;
+    }
+  }
+}
+
+void gt_encseq_extract_encoded_with_readmode(const GtEncseq *encseq,
+                                             GtUchar *buffer,
+                                             GtUword frompos,
+                                             GtUword topos,
+                                             GtReadmode readmode)
+{
+  gt_assert(frompos <= topos && encseq != NULL &&
+            topos < encseq->logicaltotallength);
+  gt_assert(buffer != NULL);
+  gt_assert(!GT_ISDIRCOMPLEMENT(readmode) ||
+            gt_alphabet_is_dna(encseq->alpha));
+  if (topos < encseq->totallength && encseq->twobitencoding != NULL) {
+    encseq_extract_twobitencoding(encseq, buffer, frompos, topos);
+    encseq_extract_patch_specials(encseq, buffer, frompos, topos);
+  } else if (topos < encseq->totallength &&
+             encseq->sat == GT_ACCESS_TYPE_DIRECTACCESS) {
+    memcpy(buffer, encseq->plainseq + frompos,
+           sizeof (*buffer) * (topos - frompos + 1));
+  } else {
+    GtEncseqReader *esr;
+    GtUword pos, idx;
+
+    esr = gt_encseq_create_reader_with_readmode(encseq,
+                                                GT_READMODE_FORWARD,
+                                                frompos);
+    for (pos = frompos, idx = 0; pos <= topos; pos++, idx++) {
+      buffer[idx] = gt_encseq_reader_next_encoded_char(esr);
+    }
+    gt_encseq_reader_delete(esr);
+  }
+  encseq_extract_apply_readmode(buffer, topos - frompos + 1, readmode);
+}
+
 void gt_encseq_extract_encoded(const GtEncseq *encseq,
                                GtUchar *buffer,
                                GtUword frompos,
                                GtUword topos)
 {
-  GtEncseqReader *esr;
-  GtUword idx, pos;
+  gt_encseq_extract_encoded_with_readmode(encseq, buffer, frompos, topos,
+                                          GT_READMODE_FORWARD);
+}
+
+void gt_encseq_extract_decoded_with_readmode(const GtEncseq *encseq,
+                                             char *buffer,
+                                             GtUword frompos,
+                                             GtUword topos,
+                                             GtReadmode readmode)
+{
+  GtUword idx, len;
 
   gt_assert(frompos <= topos && encseq != NULL &&
             topos < encseq->logicaltotallength);
-  esr = gt_encseq_create_reader_with_readmode(encseq,
-                                              GT_READMODE_FORWARD,
-                                              frompos);
-  for (pos=frompos, idx = 0; pos <= topos; pos++, idx++) {
-    buffer[idx] = gt_encseq_reader_next_encoded_char(esr);
+  gt_assert(buffer != NULL);
+  len = topos - frompos + 1;
+  if (!encseq->has_exceptiontable) {
+    /* no lossless support: decode the encoded characters in place */
+    GtUchar *encoded = (GtUchar*) buffer;
+    const GtUchar *characters = gt_alphabet_characters(encseq->alpha);
+    const GtUchar numofchars
+      = (GtUchar) gt_alphabet_num_of_chars(encseq->alpha);
+    const char wildcardshow = (char) gt_alphabet_wildcard_show(encseq->alpha);
+
+    gt_encseq_extract_encoded_with_readmode(encseq, encoded, frompos, topos,
+                                            readmode);
+    for (idx = 0; idx < len; idx++) {
+      const GtUchar cc = encoded[idx];
+
+      if (cc < numofchars)
+        buffer[idx] = (char) characters[cc];
+      else
+        buffer[idx] = (cc == (GtUchar) SEPARATOR) ? (char) SEPARATOR
+                                                   : wildcardshow;
+    }
+  } else {
+    GtEncseqReader *esr;
+
+    gt_assert(!GT_ISDIRCOMPLEMENT(readmode) ||
+              gt_alphabet_is_dna(encseq->alpha));
+    esr = gt_encseq_create_reader_with_readmode(encseq,
+                                                GT_READMODE_FORWARD,
+                                                frompos);
+    for (idx = 0; idx < len; idx++) {
+      buffer[idx] = gt_encseq_reader_next_decoded_char(esr);
+    }
+    gt_encseq_reader_delete(esr);
+    if (GT_ISDIRCOMPLEMENT(readmode)) {
+      for (idx = 0; idx < len; idx++) {
+        if (buffer[idx] != (char) SEPARATOR)
+          (void) gt_complement(buffer + idx, buffer[idx], NULL);
+      }
+    }
+    if (GT_ISDIRREVERSE(readmode)) {
+      char *lptr, *rptr, tmp;
+
+      for (lptr = buffer, rptr = buffer + len - 1; lptr < rptr;
+           lptr++, rptr--) {
+        tmp = *lptr;
+        *lptr = *rptr;
+        *rptr = tmp;
+      }
+    }
   }
-  gt_encseq_reader_delete(esr);
 }
 
 void gt_encseq_extract_decoded(const GtEncseq *encseq,
@@ -707,19 +937,8 @@ void gt_encseq_extract_decoded(const GtEncseq *encseq,
                                GtUword frompos,
                                GtUword topos)
 {
-  GtEncseqReader *esr;
-  GtUword idx, pos;
-
-  gt_assert(frompos <= topos && encseq != NULL &&
-            topos < encseq->logicaltotallength);
-  gt_assert(buffer != NULL);
-  esr = gt_encseq_create_reader_with_readmode(encseq,
-                                              GT_READMODE_FORWARD,
-                                              frompos);
-  for (pos=frompos, idx = 0; pos <= topos; pos++, idx++) {
-    buffer[idx] = gt_encseq_reader_next_decoded_char(esr);
-  }
-  gt_encseq_reader_delete(esr);
+  gt_encseq_extract_decoded_with_readmode(encseq, buffer, frompos, topos,
+                                          GT_READMODE_FORWARD);
 }
 
 const char* gt_encseq_accessname(const GtEncseq *encseq)
@@ -4423,6 +4642,21 @@ int gt_encseq_seppos2ssptab(const char *indexname,
 
 #define SIZEOFFUNCTAB sizeof (encodedseqfunctab)/sizeof (encodedseqfunctab[0])
 
+/* Returns a sequence buffer for the input files, delivering the already
+   parsed contents from <inputdata> if not NULL. */
+static GtSequenceBuffer *encseq_input_sequence_buffer_new(
+                                   const GtStrArray *filenametab,
+                                   bool plainformat,
+                                   const GtSequenceBufferMemoryData *inputdata,
+                                   GtError *err)
+{
+  if (inputdata != NULL)
+    return gt_sequence_buffer_memory_new(inputdata);
+  if (plainformat)
+    return gt_sequence_buffer_plain_new(filenametab);
+  return gt_sequence_buffer_new_guess_type(filenametab, err);
+}
+
 static GtEncseq *files2encodedsequence(const GtStrArray *filenametab,
                                        const GtFilelengthvalues *filelengthtab,
                                        bool plainformat,
@@ -4446,6 +4680,8 @@ static GtEncseq *files2encodedsequence(const GtStrArray *filenametab,
                                        GtUword wildcardranges,
                                        GtUword minseqlength,
                                        GtUword maxseqlength,
+                                       const GtSequenceBufferMemoryData
+                                                                    *inputdata,
                                        GtLogger *logger,
                                        GtError *err)
 {
@@ -4492,12 +4728,8 @@ static GtEncseq *files2encodedsequence(const GtStrArray *filenametab,
     encseq->subsymbolmap = subsymbolmap;
     encseq->maxsubalphasize = maxsubalphasize;
     gt_assert(filenametab != NULL);
-    if (plainformat) {
-      fb = gt_sequence_buffer_plain_new(filenametab);
-    }
-    else {
-      fb = gt_sequence_buffer_new_guess_type(filenametab, err);
-    }
+    fb = encseq_input_sequence_buffer_new(filenametab, plainformat, inputdata,
+                                          err);
     if (!fb)
       haserr = true;
   }
@@ -5260,15 +5492,15 @@ static int countnumberofexceptionranges(const GtAlphabet *alpha,
                                         const GtStrArray *filenametab,
                                         GtSpecialcharinfo *specialcharinfo,
                                         char *maxchars,
+                                        const GtSequenceBufferMemoryData
+                                                                    *inputdata,
                                         GtError *err)
 {
   int had_err = 0;
   GtSequenceBuffer *fb;
   GtUword currentpos;
-  if (plainformat)
-    fb = gt_sequence_buffer_plain_new(filenametab);
-  else
-    fb = gt_sequence_buffer_new_guess_type(filenametab, err);
+  fb = encseq_input_sequence_buffer_new(filenametab, plainformat, inputdata,
+                                        err);
   if (!fb) {
     gt_assert(gt_error_is_set(err));
     had_err = -1;
@@ -5342,6 +5574,8 @@ static int gt_inputfiles2sequencekeyvalues(const char *indexname,
                                            GtUword *minseqlen,
                                            GtUword *maxseqlen,
                                            bool clip_desc,
+                                           const GtSequenceBufferMemoryData
+                                                                    *inputdata,
                                            GtLogger *logger,
                                            GtError *err)
 {
@@ -5376,13 +5610,10 @@ static int gt_inputfiles2sequencekeyvalues(const char *indexname,
   specialcharinfo->lengthofwildcardprefix = 0;
   specialcharinfo->lengthofwildcardsuffix = 0;
 
-  if (plainformat) {
-    fb = gt_sequence_buffer_plain_new(filenametab);
+  if (plainformat)
     equallength->defined = false;
-  }
-  else {
-    fb = gt_sequence_buffer_new_guess_type(filenametab, err);
-  }
+  fb = encseq_input_sequence_buffer_new(filenametab, plainformat, inputdata,
+                                        err);
   if (!fb)
     haserr = true;
   if (!haserr && outdestab) {
@@ -5501,7 +5732,8 @@ static int gt_inputfiles2sequencekeyvalues(const char *indexname,
                                classstartpositions, originaldistribution);
     if (outoistab) {
       retval = countnumberofexceptionranges(alpha, plainformat, filenametab,
-                                            specialcharinfo, maxchars, err);
+                                            specialcharinfo, maxchars,
+                                            inputdata, err);
       if (retval != 0)
         haserr = true;
     }
@@ -7409,6 +7641,7 @@ static GtEncseq* gt_encseq_new_from_files(GtTimer *sfxprogress,
                                           bool outmd5tab,
                                           bool esq_no_header,
                                           bool clip_desc,
+                                          bool parallel_input,
                                           GtLogger *logger,
                                           GtError *err)
 {
@@ -7437,6 +7670,7 @@ static GtEncseq* gt_encseq_new_from_files(GtTimer *sfxprogress,
   GtEncseqAccessType sat = GT_ACCESS_TYPE_UNDEFINED;
   char *allchars = NULL,
        *maxchars = NULL;
+  GtSequenceBufferMemoryData *inputdata = NULL;
 
   gt_error_check(err);
   filenametab = gt_str_array_ref(filenametab);
@@ -7466,6 +7700,15 @@ static GtEncseq* gt_encseq_new_from_files(GtTimer *sfxprogress,
       haserr = true;
     }
   }
+  if (!haserr && parallel_input && !isplain) {
+    /* parse all input files once, in parallel, and traverse the parsed
+       contents for all subsequent passes */
+    inputdata = gt_sequence_buffer_memory_data_new(filenametab,
+                                               gt_alphabet_symbolmap(alphabet),
+                                                   clip_desc, err);
+    if (inputdata == NULL)
+      haserr = true;
+  }
   if (!haserr) {
     characterdistribution = initcharacterdistribution(alphabet);
     maxchars = gt_calloc((size_t) UCHAR_MAX, sizeof (*maxchars));
@@ -7499,6 +7742,7 @@ static GtEncseq* gt_encseq_new_from_files(GtTimer *sfxprogress,
                                         &minseqlen,
                                         &maxseqlen,
                                         clip_desc,
+                                        inputdata,
                                         logger,
                                         err) != 0) {
       char buf[BUFSIZ];
@@ -7563,11 +7807,13 @@ static GtEncseq* gt_encseq_new_from_files(GtTimer *sfxprogress,
                                    wildcardranges,
                                    minseqlen,
                                    maxseqlen,
+                                   inputdata,
                                    logger,
                                    err);
     if (encseq == NULL)
       haserr = true;
   }
+  gt_sequence_buffer_memory_data_delete(inputdata);
   if (!haserr) {
     alphabetisbound = true;
     if (gt_encseq_flush2file(indexname, encseq, esq_no_header, err) != 0)
@@ -7714,6 +7960,58 @@ static void testscanatpos(const GtEncseq *encseq,
   gt_encseq_reader_delete(esr);
 }
 
+static void runextractrangetrial(const GtEncseq *encseq,
+                                 GtReadmode readmode,
+                                 GtUchar *buffer,
+                                 GtUword frompos,
+                                 GtUword topos)
+{
+  GtUword pos, len = topos - frompos + 1;
+  GtUchar ccra;
+
+  gt_encseq_extract_encoded_with_readmode(encseq, buffer, frompos, topos,
+                                          readmode);
+  for (pos = frompos; pos <= topos; pos++) {
+    GtUword idx = GT_ISDIRREVERSE(readmode) ? topos - pos : pos - frompos;
+
+    ccra = gt_encseq_get_encoded_char(encseq, pos, GT_READMODE_FORWARD);
+    if (GT_ISDIRCOMPLEMENT(readmode) && ISNOTSPECIAL(ccra))
+      ccra = GT_COMPLEMENTBASE(ccra);
+    if (ccra != buffer[idx]) {
+      fprintf(stderr, "range ("GT_WU","GT_WU") of length "GT_WU""
+                     " access=%s, mode=%s: position="GT_WU""
+                     ": random access (correct) = %u != %u = "
+                     " range extraction (wrong)\n",
+                     frompos, topos, len,
+                     gt_encseq_accessname(encseq),
+                     gt_readmode_show(readmode),
+                     pos,
+                     (unsigned int) ccra,
+                     (unsigned int) buffer[idx]);
+      exit(GT_EXIT_PROGRAMMING_ERROR);
+    }
+  }
+}
+
+static void testextractrange(const GtEncseq *encseq,
+                             GtReadmode readmode,
+                             GtUword trials)
+{
+  GtUword frompos, len, totallength, trial;
+  const GtUword maxlen = 1000UL;
+  GtUchar *buffer;
+
+  totallength = encseq->logicaltotallength;
+  buffer = gt_malloc(sizeof (*buffer) * MAX(maxlen, totallength));
+  runextractrangetrial(encseq, readmode, buffer, 0, totallength - 1);
+  for (trial = 0; trial < trials; trial++) {
+    frompos = (GtUword) (random() % totallength);
+    len = 1UL + (GtUword) (random() % MIN(maxlen, totallength - frompos));
+    runextractrangetrial(encseq, readmode, buffer, frompos, frompos + len - 1);
+  }
+  gt_free(buffer);
+}
+
 static void testmulticharactercompare(const GtEncseq *encseq,
                                       GtReadmode readmode,
                                       GtUword multicharcmptrials)
@@ -7875,6 +8173,11 @@ int gt_encseq_check_consistency(const GtEncseq *encseq,
     gt_logger_log(logger, "run testscanatpos for "GT_WU" trials", scantrials);
     testscanatpos(encseq, readmode, scantrials);
   }
+  if (scantrials > 0) {
+    gt_logger_log(logger, "run testextractrange for "GT_WU" trials",
+                  scantrials);
+    testextractrange(encseq, readmode, scantrials);
+  }
   if (withseqnumcheck && readmode == GT_READMODE_FORWARD) {
     gt_logger_log(logger, "run testseqnumextraction");
     testseqnumextraction(encseq);
@@ -8042,7 +8345,8 @@ struct GtEncseqEncoder {
        isprotein,
        isplain,
        esq_no_header,
-       clip_desc;
+       clip_desc,
+       parallel_input;
   GtStr *sat,
         *smapfile;
   GtLogger *logger;
@@ -8096,6 +8400,8 @@ GtEncseqEncoder* gt_encseq_encoder_new_from_options(GtEncseqOptions *opts,
     gt_encseq_encoder_enable_md5_support(ee);
   if (gt_encseq_options_clip_desc_value(opts))
     gt_encseq_encoder_clip_desc(ee);
+  if (gt_encseq_options_parallel_input_value(opts))
+    gt_encseq_encoder_enable_parallel_input(ee);
   if (gt_str_length(gt_encseq_options_smap_value(opts)) > 0)
     had_err = gt_encseq_encoder_use_symbolmap_file(ee,
                                  gt_str_get(gt_encseq_options_smap_value(opts)),
@@ -8321,6 +8627,24 @@ bool gt_encseq_encoder_are_descs_clipped(GtEncseqEncoder *ee)
   return ee->clip_desc;
 }
 
+void gt_encseq_encoder_enable_parallel_input(GtEncseqEncoder *ee)
+{
+  gt_assert(ee);
+  ee->parallel_input = true;
+}
+
+void gt_encseq_encoder_disable_parallel_input(GtEncseqEncoder *ee)
+{
+  gt_assert(ee);
+  ee->parallel_input = false;
+}
+
+bool gt_encseq_encoder_parallel_input_enabled(const GtEncseqEncoder *ee)
+{
+  gt_assert(ee);
+  return ee->parallel_input;
+}
+
 bool gt_encseq_encoder_is_input_preencoded(GtEncseqEncoder *ee)
 {
   gt_assert(ee);
@@ -8390,6 +8714,7 @@ int gt_encseq_encoder_encode(GtEncseqEncoder *ee, GtStrArray *seqfiles,
                                     ee->md5tab,
                                     ee->esq_no_header,
                                     ee->clip_desc,
+                                    ee->parallel_input,
                                     ee->logger,
                                     err);
   if (!encseq)
@@ -124,6 +124,26 @@ void              gt_encseq_extract_decoded(const GtEncseq *encseq,
                                             char *buffer,
                                             GtUword frompos,
                                             GtUword topos);
+/* Like <gt_encseq_extract_encoded()>, but delivers the substring from
+   position <frompos> to position <topos> (both given in forward direction)
+   of <encseq> in the given <readmode>, i.e. reversed and/or complemented.
+   Complementing readmodes may only be used on DNA alphabets. */
+void              gt_encseq_extract_encoded_with_readmode(
+                                                   const GtEncseq *encseq,
+                                                   GtUchar *buffer,
+                                                   GtUword frompos,
+                                                   GtUword topos,
+                                                   GtReadmode readmode);
+/* Like <gt_encseq_extract_decoded()>, but delivers the substring from
+   position <frompos> to position <topos> (both given in forward direction)
+   of <encseq> in the given <readmode>, i.e. reversed and/or complemented.
+   Complementing readmodes may only be used on DNA alphabets. */
+void              gt_encseq_extract_decoded_with_readmode(
+                                                   const GtEncseq *encseq,
+                                                   char *buffer,
+                                                   GtUword frompos,
+                                                   GtUword topos,
+                                                   GtReadmode readmode);
 /* Returns the length of the <seqnum>-th sequence in the <encseq>.
    Requires multiple sequence support enabled in <encseq>. */
 GtUword           gt_encseq_seqlength(const GtEncseq *encseq,
@@ -332,6 +352,16 @@ bool              gt_encseq_encoder_is_input_protein(GtEncseqEncoder *ee);
 void              gt_encseq_encoder_clip_desc(GtEncseqEncoder *ee);
 /* Returns <true> if <ee> clips all descriptions after the first whitespace. */
 bool              gt_encseq_encoder_are_descs_clipped(GtEncseqEncoder *ee);
+/* Makes <ee> parse all input files exactly once, using <gt_jobs> threads in
+   parallel, and keep the parsed sequences in memory for the encoding passes.
+   Only FASTA input is supported. Disabled by default. */
+void              gt_encseq_encoder_enable_parallel_input(GtEncseqEncoder *ee);
+/* Makes <ee> read the input files sequentially, once for each encoding
+   pass. */
+void              gt_encseq_encoder_disable_parallel_input(GtEncseqEncoder *ee);
+/* Returns <true> if <ee> parses its input files in parallel. */
+bool              gt_encseq_encoder_parallel_input_enabled(
+                                                     const GtEncseqEncoder *ee);
 /* Encodes the sequence files given in <seqfiles> using the settings in <ee>
    and <indexname> as the prefix for the index tables. Returns 0 on success, or
    a negative value on error (<err> is set accordingly). */
@@ -50,7 +50,8 @@ struct GtEncseqOptions {
            *optionprotein,
            *optionsmap,
            *optionmirrored,
-           *optionclip_desc;
+           *optionclip_desc,
+           *optionparallel_input;
   GtStrArray *db;
   bool des,
        ssp,
@@ -64,7 +65,8 @@ struct GtEncseqOptions {
        mirrored,
        withdb,
        withindexname,
-       clip_desc;
+       clip_desc,
+       parallel_input;
 };
 
 static GtEncseqOptions* gt_encseq_options_new(void)
@@ -84,6 +86,7 @@ static GtEncseqOptions* gt_encseq_options_new(void)
   oi->protein = false;
   oi->plain = false;
   oi->mirrored = false;
+  oi->parallel_input = false;
   oi->optiondb = NULL;
   oi->optionindexname = NULL;
   oi->optionsat = NULL;
@@ -98,6 +101,7 @@ static GtEncseqOptions* gt_encseq_options_new(void)
   oi->optionprotein = NULL;
   oi->optionsmap = NULL;
   oi->optionmirrored = NULL;
+  oi->optionparallel_input = NULL;
   oi->withdb = false;
   oi->withindexname = false;
   return oi;
@@ -221,6 +225,16 @@ gt_encseq_options_register_generic(GtOptionParser *op,
                                              false);
     gt_option_parser_add_option(op, oi->optionclip_desc);
 
+    oi->optionparallel_input = gt_option_new_bool("parallelinput",
+                                                  "parse FASTA input files in "
+                                                  "parallel (see -j) and only "
+                                                  "once, keeping the sequences "
+                                                  "in memory (about two bits "
+                                                  "per DNA character)",
+                                                  &oi->parallel_input,
+                                                  false);
+    gt_option_parser_add_option(op, oi->optionparallel_input);
+
     oi->optionsat = gt_option_new_string("sat",
                                          "specify kind of sequence "
                                          "representation\n"
@@ -271,6 +285,7 @@ gt_encseq_options_register_generic(GtOptionParser *op,
     gt_option_exclude(oi->optionsmap, oi->optiondna);
     gt_option_exclude(oi->optionsmap, oi->optionprotein);
     gt_option_exclude(oi->optiondna, oi->optionprotein);
+    gt_option_exclude(oi->optionparallel_input, oi->optionplain);
   }
 
   /* decoding options */
@@ -367,6 +382,7 @@ GT_ENCSEQ_OPTS_GETTER_DEF(smap, GtStr*);
 GT_ENCSEQ_OPTS_GETTER_DEF(ssp, bool);
 GT_ENCSEQ_OPTS_GETTER_DEF(tis, bool);
 GT_ENCSEQ_OPTS_GETTER_DEF(clip_desc, bool);
+GT_ENCSEQ_OPTS_GETTER_DEF(parallel_input, bool);
 GT_ENCSEQ_OPTS_GETTER_DEF_OPT(dir);
 
 void gt_encseq_options_delete(GtEncseqOptions *oi)
@@ -79,6 +79,7 @@ GT_ENCSEQ_OPTS_GETTER_DECL(smap, GtStr*);
 GT_ENCSEQ_OPTS_GETTER_DECL(ssp, bool);
 GT_ENCSEQ_OPTS_GETTER_DECL(tis, bool);
 GT_ENCSEQ_OPTS_GETTER_DECL(clip_desc, bool);
+GT_ENCSEQ_OPTS_GETTER_DECL(parallel_input, bool);
 GT_ENCSEQ_OPTS_GETTER_DECL_OPT(dir);
 
 #endif
@@ -16,11 +16,11 @@
 */
 
 #include <limits.h>
-#include <setjmp.h>
-#if TJ_DEBUG > 1
 #include <stdio.h>
-#endif
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "core/array.h"
 #include "core/cstr_api.h"
 #include "core/hashtable.h"
@@ -29,47 +29,48 @@
 #include "core/thread_api.h"
 #include "core/types_api.h"
 
-union link_data
-{
-  htsize_t *table;
-};
-
-#define free_mark (~(htsize_t)0)
-#define end_mark (free_mark - 1)
-#define mark_bit ((free_mark >> 1) + 1)
+/* The table uses open addressing in the style of the SwissTable design:
+   every slot has a control byte which is either <ctrl_empty>,
+   <ctrl_deleted> or the 7-bit tag of the hash of the element stored in the
+   slot. Lookups probe the control bytes in aligned groups of <GROUP_WIDTH>
+   slots, all of which are compared against the tag at once (with SSE2 where
+   available). Elements are stored inline in <table>, next to their full
+   hash value in <hashes>, so that most tag collisions are rejected without
+   calling the compare function and resizing never has to call the hash
+   function again.
+   The output of several tools depends on the iteration order of the chained
+   table formerly used here, which visits the elements ordered by their hash
+   value modulo the table size and, within the same chain, in the order of
+   insertion. To retain this order, every element carries an insertion number
+   in <seqs> and <order_size_log> follows the size the chained table would
+   have. */
+
+typedef int8_t htctrl_t;
+typedef uint32_t htgroupmask_t;
+
+#define ctrl_empty ((htctrl_t) -128)
+#define ctrl_deleted ((htctrl_t) -2)
+#define no_idx (~(htsize_t)0)
 enum {
-  MIN_SIZE_LOG     =   4,
+  GROUP_WIDTH_LOG  =   4,
+  GROUP_WIDTH      = 1 << GROUP_WIDTH_LOG,
+  MIN_SIZE_LOG     = GROUP_WIDTH_LOG,
   FILL_DIVISOR     = 256,
   DEFAULT_LOW_MUL  =  32,       /**< will be used as quotient
                                    DEFAULT_LOW_MUL/FILL_DIVISOR */
-  DEFAULT_HIGH_MUL = 192,
+  DEFAULT_HIGH_MUL = 224,
+  ORDER_HIGH_MUL   = 192,       /**< growth threshold of the chained table */
 };
 
-typedef htsize_t (*GetLinkFunc)(GtHashtable *ht, htsize_t idx);
-typedef void (*SetLinkFunc)(GtHashtable *ht, htsize_t idx, htsize_t link);
-
-static htsize_t
-gt_ht_get_table_link(GtHashtable *ht, htsize_t idx);
-static void
-gt_ht_set_table_link(GtHashtable *ht, htsize_t idx, htsize_t link);
-
-#if POLYMORPHLINK
-#define HT_GET_LINK(ht, idx) ht->get_link(ht, idx)
-#define HT_SET_LINK(ht, idx, link) ht->set_link(ht, idx, link)
-#else
-#define HT_GET_LINK(ht, idx) gt_ht_get_table_link(ht, idx)
-#define HT_SET_LINK(ht, idx, link) gt_ht_set_table_link(ht, idx, link)
-#endif
-
 struct GtHashtable
 {
   HashElemInfo table_info;
   void *table;
-  GetLinkFunc get_link;
-  SetLinkFunc set_link;
-  htsize_t table_mask, high_fill, low_fill, current_fill;
-  union link_data links;
-  unsigned short table_size_log, high_fill_mul, low_fill_mul;
+  htctrl_t *ctrl;
+  htsize_t *hashes, *seqs;
+  htsize_t table_mask, high_fill, low_fill, current_fill, deleted_fill,
+           next_seq;
+  unsigned short table_size_log, high_fill_mul, low_fill_mul, order_size_log;
   GtRWLock *lock;
   GtUword reference_count;
   bool no_ma;
@@ -81,14 +82,113 @@ gt_ht_elem_ptr(const GtHashtable *ht, htsize_t idx)
   return (char *)ht->table + ht->table_info.elem_size * idx;
 }
 
-static inline void
-gt_ht_cp_elem(GtHashtable *ht, htsize_t dest_idx, const void *src)
+/* finalizer of MurmurHash3, spreads the entropy of the user supplied hash
+   functions (some of which only mix their input weakly) over all bits, as
+   the low bits select the group and the high bits form the tag */
+static inline htsize_t
+gt_ht_mix(htsize_t h)
 {
-  memcpy(gt_ht_elem_ptr(ht, dest_idx), src, ht->table_info.elem_size);
+  h ^= h >> 16;
+  h *= 0x85ebca6bU;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35U;
+  h ^= h >> 16;
+  return h;
+}
+
+static inline htsize_t
+gt_ht_elem_hash(const GtHashtable *ht, const void *elem)
+{
+  return ht->table_info.keyhash(elem);
+}
+
+static inline htctrl_t
+gt_ht_tag(htsize_t hash)
+{
+  return (htctrl_t) (hash >> (sizeof (hash) * CHAR_BIT - 7));
+}
+
+/* bit i of the result is set iff slot i of <group> has control byte <c> */
+static inline htgroupmask_t
+gt_ht_group_match(const htctrl_t *group, htctrl_t c)
+{
+#ifdef __SSE2__
+  __m128i ctrl = _mm_loadu_si128((const __m128i *) group);
+  return (htgroupmask_t) _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl,
+                                                          _mm_set1_epi8(c)));
+#else
+  htgroupmask_t mask = 0;
+  unsigned int i;
+  for (i = 0; i < GROUP_WIDTH; i++) {
+    if (group[i] == c)
+      mask |= 1U << i;
+  }
+  return mask;
+#endif
 }
 
+/* bit i of the result is set iff slot i of <group> is empty or deleted */
+static inline htgroupmask_t
+gt_ht_group_match_free(const htctrl_t *group)
+{
+#ifdef __SSE2__
+  return (htgroupmask_t) _mm_movemask_epi8(
+                                 _mm_loadu_si128((const __m128i *) group));
+#else
+  htgroupmask_t mask = 0;
+  unsigned int i;
+  for (i = 0; i < GROUP_WIDTH; i++) {
+    if (group[i] < 0)
+      mask |= 1U << i;
+  }
+  return mask;
+#endif
+}
+
+static inline unsigned int
+gt_ht_lowest_bit(htgroupmask_t mask)
+{
+#ifdef __GNUC__
+  return (unsigned int) __builtin_ctz(mask);
+#else
+  unsigned int i = 0;
+  while (!(mask & 1U)) {
+    mask >>= 1;
+    i++;
+  }
+  return i;
+#endif
+}
+
+/* the groups are probed quadratically, which visits every group as their
+   number is a power of two */
+#define gt_ht_foreach_group_of_hash(ht, hash, group_start, code)            \
+  do {                                                                      \
+    htsize_t group_mask = (ht)->table_mask >> GROUP_WIDTH_LOG,              \
+      group = (hash) & group_mask, probe = 0, group_start;                  \
+    while (true) {                                                          \
+      group_start = group << GROUP_WIDTH_LOG;                               \
+      code;                                                                 \
+      group = (group + ++probe) & group_mask;                               \
+    }                                                                       \
+  } while (0)
+
 static void
-gt_ht_resize(GtHashtable *ht, unsigned short new_size_log);
+gt_ht_alloc_slots(GtHashtable *ht, htsize_t table_size)
+{
+  if (ht->no_ma) {
+    ht->table = realloc(ht->table, ht->table_info.elem_size * table_size);
+    ht->ctrl = realloc(ht->ctrl, sizeof (*ht->ctrl) * table_size);
+    ht->hashes = realloc(ht->hashes, sizeof (*ht->hashes) * table_size);
+    ht->seqs = realloc(ht->seqs, sizeof (*ht->seqs) * table_size);
+  } else {
+    ht->table = gt_realloc(ht->table, ht->table_info.elem_size * table_size);
+    ht->ctrl = gt_realloc(ht->ctrl, sizeof (*ht->ctrl) * table_size);
+    ht->hashes = gt_realloc(ht->hashes, sizeof (*ht->hashes) * table_size);
+    ht->seqs = gt_realloc(ht->seqs, sizeof (*ht->seqs) * table_size);
+  }
+  memset(ht->ctrl, (int) ctrl_empty, sizeof (*ht->ctrl) * table_size);
+}
 
 static void
 gt_ht_reinit(GtHashtable *ht, HashElemInfo table_info, unsigned short size_log,
@@ -97,32 +197,21 @@ gt_ht_reinit(GtHashtable *ht, HashElemInfo table_info, unsigned short size_log,
   htsize_t table_size;
   gt_assert(high_mul > low_mul);
   gt_assert(low_mul > 0 && high_mul < FILL_DIVISOR);
+  ht->order_size_log = size_log;
+  ht->next_seq = 0;
+  if (size_log < MIN_SIZE_LOG)
+    size_log = MIN_SIZE_LOG;
   ht->table_info = table_info;
   ht->table_size_log = size_log;
   ht->table_mask = (table_size = 1 << size_log) - 1;
-  if (ht->no_ma)
-    ht->table = realloc(ht->table, table_info.elem_size * table_size);
-  else
-    ht->table = gt_realloc(ht->table, table_info.elem_size * table_size);
+  gt_ht_alloc_slots(ht, table_size);
   ht->high_fill_mul = high_mul;
   ht->high_fill
     = (GtUint64)ht->high_fill_mul * table_size / FILL_DIVISOR;
   ht->low_fill_mul = low_mul;
   ht->low_fill
     = (GtUint64)ht->low_fill_mul * table_size / FILL_DIVISOR;
-  {
-    uint32_t i;
-    if (ht->no_ma)
-      ht->links.table = realloc(ht->links.table,
-                                sizeof (*(ht->links.table)) * table_size);
-    else
-      ht->links.table = gt_realloc(ht->links.table,
-                                   sizeof (*(ht->links.table)) * table_size);
-    for (i = 0; i < table_size; ++i)
-      ht->links.table[i] = free_mark;
-    ht->get_link = gt_ht_get_table_link;
-    ht->set_link = gt_ht_set_table_link;
-  }
+  ht->deleted_fill = 0;
 }
 
 static void
@@ -132,7 +221,10 @@ gt_ht_init(GtHashtable *ht, HashElemInfo table_info, unsigned short size_log,
   gt_assert(size_log < sizeof (htsize_t) * CHAR_BIT);
   ht->current_fill = 0;
   ht->reference_count = 0;
-  ht->table = ht->links.table = NULL;
+  ht->table = NULL;
+  ht->ctrl = NULL;
+  ht->hashes = NULL;
+  ht->seqs = NULL;
   gt_ht_reinit(ht, table_info, size_log, high_mul, low_mul);
 }
 
@@ -141,10 +233,14 @@ gt_ht_destruct(GtHashtable *ht)
 {
   if (ht->no_ma) {
     free(ht->table);
-    free(ht->links.table);
+    free(ht->ctrl);
+    free(ht->hashes);
+    free(ht->seqs);
   } else {
     gt_free(ht->table);
-    gt_free(ht->links.table);
+    gt_free(ht->ctrl);
+    gt_free(ht->hashes);
+    gt_free(ht->seqs);
   }
 }
 
@@ -192,109 +288,208 @@ GtHashtable* gt_hashtable_new_with_start_size(HashElemInfo table_info,
   return ht;
 }
 
-static int
-gt_ht_insert(GtHashtable *ht, const void *elem, void **stor_ptr);
+static inline void
+gt_ht_set_slot(GtHashtable *ht, htsize_t idx, const void *elem, htsize_t hash,
+               htsize_t seq)
+{
+  memcpy(gt_ht_elem_ptr(ht, idx), elem, ht->table_info.elem_size);
+  ht->hashes[idx] = hash;
+  ht->seqs[idx] = seq;
+  ht->ctrl[idx] = gt_ht_tag(gt_ht_mix(hash));
+}
 
-static int gt_hashtable_foreach_g(GtHashtable *ht, Elemvisitfunc visitor,
-                                  void *data, GtError *err, bool lock);
+/* returns the first empty or deleted slot on the probe sequence of <hash> */
+static htsize_t
+gt_ht_find_free_idx(const GtHashtable *ht, htsize_t hash)
+{
+  gt_assert(ht->current_fill < ht->table_mask + 1);
+  hash = gt_ht_mix(hash);
+  gt_ht_foreach_group_of_hash(ht, hash, group_start, {
+    htgroupmask_t free_slots
+      = gt_ht_group_match_free(ht->ctrl + group_start);
+    if (free_slots)
+      return group_start + gt_ht_lowest_bit(free_slots);
+  });
+  return no_idx;
+}
 
-static enum iterator_op
-gt_ht_insert_wrapper(void *elem, void *data, GT_UNUSED GtError *err)
+/* returns the slot holding an element equal to <elem> or <no_idx> */
+static htsize_t
+gt_ht_find(const GtHashtable *ht, const void *elem, htsize_t hash)
 {
-#ifndef NDEBUG
-  int ins_count =
-#endif
-    gt_ht_insert(data, elem, NULL);
-#ifndef NDEBUG
-  if (!ins_count)
-  {
-    fputs("Insertion mysteriously failed on hashtable resize.", stderr);
-    abort();
-  }
-#endif
-  return CONTINUE_ITERATION;
+  htsize_t mixed_hash = gt_ht_mix(hash);
+  htctrl_t tag = gt_ht_tag(mixed_hash);
+  gt_ht_foreach_group_of_hash(ht, mixed_hash, group_start, {
+    const htctrl_t *group = ht->ctrl + group_start;
+    htgroupmask_t match = gt_ht_group_match(group, tag);
+    while (match) {
+      htsize_t idx = group_start + gt_ht_lowest_bit(match);
+      if (ht->hashes[idx] == hash
+          && !ht->table_info.cmp(elem, gt_ht_elem_ptr(ht, idx)))
+        return idx;
+      match &= match - 1;
+    }
+    /* an element is never placed behind a group with an empty slot */
+    if (gt_ht_group_match(group, ctrl_empty))
+      return no_idx;
+  });
+  return no_idx;
 }
 
 static void
 gt_ht_resize(GtHashtable *ht, unsigned short new_size_log)
 {
   GtHashtable new_ht;
-#ifndef NDEBUG
-  htsize_t new_size = 1 << new_size_log;
-#endif
+  htsize_t i;
   gt_assert(ht);
-  if (new_size_log != ht->table_size_log)
-  {
-    /* save lock from old table */
-    GtRWLock *l = ht->lock;
-    new_ht.no_ma = ht->no_ma;
-    gt_ht_init(&new_ht, ht->table_info, new_size_log, ht->high_fill_mul,
-               ht->low_fill_mul);
-    gt_assert(ht->current_fill < new_size);
-    gt_hashtable_foreach_g(ht, gt_ht_insert_wrapper, &new_ht, NULL, false);
-    gt_ht_destruct(ht);
-    memcpy(ht, &new_ht, sizeof (*ht));
-    /* restore lock */
-    ht->lock = l;
-  }
+  new_ht.no_ma = ht->no_ma;
+  gt_ht_init(&new_ht, ht->table_info, new_size_log, ht->high_fill_mul,
+             ht->low_fill_mul);
+  gt_assert(ht->current_fill < new_ht.table_mask + 1);
+  if (ht->current_fill)
+    for (i = 0; i <= ht->table_mask; ++i)
+    {
+      if (ht->ctrl[i] >= 0)
+        gt_ht_set_slot(&new_ht, gt_ht_find_free_idx(&new_ht, ht->hashes[i]),
+                       gt_ht_elem_ptr(ht, i), ht->hashes[i], ht->seqs[i]);
+    }
+  new_ht.current_fill = ht->current_fill;
+  gt_ht_destruct(ht);
+  /* keep lock, reference count and iteration order of old table */
+  new_ht.lock = ht->lock;
+  new_ht.reference_count = ht->reference_count;
+  new_ht.order_size_log = ht->order_size_log;
+  new_ht.next_seq = ht->next_seq;
+  memcpy(ht, &new_ht, sizeof (*ht));
 }
 
 static inline htsize_t
-gt_ht_elem_hash_idx(const GtHashtable *ht, const void *elem)
-{
-  return ht->table_info.keyhash(elem) & ht->table_mask;
-}
-
-#define gt_ht_traverse_list_of_key(ht, elem, pre_loop, in_loop, post_loop) \
-  do {                                                                     \
-    GtHashtable *htref = (ht);                                             \
-    htsize_t elem_hash = gt_ht_elem_hash_idx(htref, (elem)),               \
-      idx, link = elem_hash;                                               \
-    pre_loop;                                                              \
-    do {                                                                   \
-      idx = link;                                                          \
-      link = HT_GET_LINK(htref, idx);                                      \
-      in_loop;                                                             \
-    }                                                                      \
-    while (!(link & mark_bit));                                            \
-    post_loop;                                                             \
-  } while (0)
+gt_ht_order_fill(unsigned short mul, unsigned short size_log)
+{
+  return (GtUint64) mul * ((GtUint64) 1 << size_log) / FILL_DIVISOR;
+}
 
-#if TJ_DEBUG > 1
-static void
-gt_ht_traverse_list_of_key_debug(GtHashtable *ht, const void *elem)
+/* returns the indices of all used slots in the iteration order of a chained
+   table of size 2^<size_log>, i.e. sorted by hash value modulo this size and
+   by insertion number */
+static htsize_t*
+gt_ht_iteration_order(const GtHashtable *ht, unsigned short size_log)
 {
-  GtHashtable *htref = (ht);
-  htsize_t elem_hash = gt_ht_elem_hash_idx(htref, (elem)),
-    idx, link = elem_hash;
-  do {
-    idx = link;
-    link = HT_GET_LINK(htref, idx);
-    if (link != free_mark
-        && !ht->table_info.cmp(elem, gt_ht_elem_ptr(ht, idx)))
+  htsize_t i, bucket, num_of_buckets = (htsize_t) 1 << size_log,
+           bucket_mask = num_of_buckets - 1, *order, *bucket_start;
+  if (ht->no_ma) {
+    order = malloc(sizeof (*order) * (ht->current_fill + 1));
+    bucket_start = calloc(num_of_buckets + 1, sizeof (*bucket_start));
+  } else {
+    order = gt_malloc(sizeof (*order) * (ht->current_fill + 1));
+    bucket_start = gt_calloc(num_of_buckets + 1, sizeof (*bucket_start));
+  }
+  /* distribute the slots to their buckets by counting sort, afterwards
+     <bucket_start[b]> is the first position of bucket <b> in <order> */
+  for (i = 0; i <= ht->table_mask; ++i)
+  {
+    if (ht->ctrl[i] >= 0)
+      bucket_start[ht->hashes[i] & bucket_mask]++;
+  }
+  for (bucket = 1; bucket <= num_of_buckets; ++bucket)
+    bucket_start[bucket] += bucket_start[bucket - 1];
+  for (i = 0; i <= ht->table_mask; ++i)
+  {
+    if (ht->ctrl[i] >= 0)
+      order[--bucket_start[ht->hashes[i] & bucket_mask]] = i;
+  }
+  /* buckets are short, sort them by insertion number */
+  for (bucket = 0; bucket < num_of_buckets; ++bucket)
+  {
+    for (i = bucket_start[bucket] + 1; i < bucket_start[bucket + 1]; ++i)
     {
-      fputs("found\n", stderr);
+      htsize_t j = i, idx = order[i];
+      for (; j > bucket_start[bucket]
+             && ht->seqs[order[j - 1]] > ht->seqs[idx]; --j)
+        order[j] = order[j - 1];
+      order[j] = idx;
     }
   }
-  while (!(link & mark_bit));
+  if (ht->no_ma)
+    free(bucket_start);
+  else
+    gt_free(bucket_start);
+  return order;
+}
+
+static void
+gt_ht_free_iteration_order(const GtHashtable *ht, htsize_t *order)
+{
+  if (ht->no_ma)
+    free(order);
+  else
+    gt_free(order);
+}
+
+/* replaces the insertion numbers by the ranks in the current iteration
+   order, which is kept if the buckets of a chained table of size
+   2^<size_log> get merged */
+static void
+gt_ht_renumber(GtHashtable *ht, unsigned short size_log)
+{
+  htsize_t i, *order = gt_ht_iteration_order(ht, size_log);
+  for (i = 0; i < ht->current_fill; ++i)
+    ht->seqs[order[i]] = i;
+  ht->next_seq = ht->current_fill;
+  gt_ht_free_iteration_order(ht, order);
+}
+
+/* makes sure one more element can be inserted, either by growing the table
+   or, if most of the used slots are deleted ones, by rebuilding it */
+static inline void
+gt_ht_reserve(GtHashtable *ht)
+{
+  /* growing the chained table only splits its buckets, which keeps the
+     order given by the insertion numbers */
+  if (ht->current_fill + 1 > gt_ht_order_fill(ORDER_HIGH_MUL,
+                                              ht->order_size_log))
+    ht->order_size_log++;
+  if (ht->current_fill + ht->deleted_fill + 1 > ht->high_fill)
+  {
+    if (2 * ht->current_fill >= ht->high_fill)
+      gt_ht_resize(ht, ht->table_size_log + 1);
+    else
+      gt_ht_resize(ht, ht->table_size_log);
+  }
+}
+
+static int
+gt_ht_insert(GtHashtable *ht, const void *elem, void **stor_ptr)
+{
+  htsize_t hash = gt_ht_elem_hash(ht, elem),
+           idx = gt_ht_find(ht, elem, hash);
+  if (idx != no_idx)
+  {
+    if (stor_ptr)
+      *stor_ptr = gt_ht_elem_ptr(ht, idx);
+    /* don't insert elements already present! */
+    return 0;
+  }
+  idx = gt_ht_find_free_idx(ht, hash);
+  if (ht->ctrl[idx] == ctrl_deleted)
+    --ht->deleted_fill;
+  if (ht->next_seq == no_idx)
+    gt_ht_renumber(ht, ht->order_size_log);
+  gt_ht_set_slot(ht, idx, elem, hash, ht->next_seq++);
+  if (stor_ptr)
+    *stor_ptr = gt_ht_elem_ptr(ht, idx);
+  ht->current_fill += 1;
+  return 1;
 }
-#endif
 
 void* gt_hashtable_get(GtHashtable *ht, const void *elem)
 {
+  htsize_t idx;
   gt_assert(ht);
   gt_rwlock_wrlock(ht->lock);
-#if TJ_DEBUG > 1
-  gt_ht_traverse_list_of_key_debug(ht, elem);
-#endif
-  gt_ht_traverse_list_of_key(ht, elem, ,
-                          if (link != free_mark
-                              && !ht->table_info.cmp(elem,
-                                                     gt_ht_elem_ptr(ht, idx))) {
-                            gt_rwlock_unlock(ht->lock);
-                            return gt_ht_elem_ptr(ht, idx); },);
+  idx = gt_ht_find(ht, elem, gt_ht_elem_hash(ht, elem));
   gt_rwlock_unlock(ht->lock);
-  return NULL;
+  return idx != no_idx ? gt_ht_elem_ptr(ht, idx) : NULL;
 }
 
 int gt_hashtable_add(GtHashtable *ht, const void *elem)
@@ -302,8 +497,7 @@ int gt_hashtable_add(GtHashtable *ht, const void *elem)
   int insert_count;
   gt_assert(ht && elem);
   gt_rwlock_wrlock(ht->lock);
-  if (ht->current_fill + 1 > ht->high_fill)
-    gt_ht_resize(ht, ht->table_size_log + 1);
+  gt_ht_reserve(ht);
   insert_count = gt_ht_insert(ht, elem, NULL);
   gt_rwlock_unlock(ht->lock);
   return insert_count;
@@ -315,105 +509,46 @@ int gt_hashtable_add_with_storage_ptr(GtHashtable *ht, const void *elem,
   int insert_count;
   gt_assert(ht && elem);
   gt_rwlock_wrlock(ht->lock);
-  if (ht->current_fill + 1 > ht->high_fill)
-    gt_ht_resize(ht, ht->table_size_log + 1);
+  gt_ht_reserve(ht);
   insert_count = gt_ht_insert(ht, elem, stor_ptr);
   gt_rwlock_unlock(ht->lock);
   return insert_count;
 }
 
-static htsize_t
-gt_ht_find_free_idx(GtHashtable *ht, htsize_t start_idx, int search_dir)
-{
-  htsize_t new_idx = start_idx;
-  gt_assert(ht->current_fill < ht->table_mask + 1);
-  do {
-    new_idx = (new_idx + search_dir) & ht->table_mask;
-  } while (HT_GET_LINK(ht, new_idx) != free_mark);
-  return new_idx;
-}
-
-static int
-gt_ht_insert(GtHashtable *ht, const void *elem, void **stor_ptr)
-{
-  htsize_t insert_pos;
-  do {
-    htsize_t elem_hash = gt_ht_elem_hash_idx(ht, elem), idx,
-      link = elem_hash;
-    if (HT_GET_LINK(ht, link) == free_mark)
-    {
-      /* we can insert at initial link and start a new chain */
-      insert_pos = link;
-      break;
-    }
-    else if (gt_ht_elem_hash_idx(ht, gt_ht_elem_ptr(ht, link)) != elem_hash)
-    {
-      /* relocate chained element */
-      htsize_t reloc_idx = link, reloc_referent, new_idx;
-      gt_ht_traverse_list_of_key(ht, gt_ht_elem_ptr(ht, reloc_idx),,
-                              if (link == reloc_idx)
-                                break;,
-                              reloc_referent = idx;);
-      new_idx = gt_ht_find_free_idx(ht, reloc_referent, -1);
-      gt_ht_cp_elem(ht, new_idx, gt_ht_elem_ptr(ht, reloc_idx));
-      HT_SET_LINK(ht, new_idx,
-                  HT_GET_LINK(ht, reloc_idx));
-      HT_SET_LINK(ht, reloc_referent, new_idx);
-      insert_pos = link;
-      break;
-    }
-    do {
-      idx = link;
-      link = HT_GET_LINK(ht, idx);
-      if (!ht->table_info.cmp(elem, gt_ht_elem_ptr(ht, idx))) {
-        if (stor_ptr)
-          *stor_ptr = gt_ht_elem_ptr(ht, idx);
-        /* don't insert elements already present! */
-        return 0;
-      }
-    } while (link != end_mark);
-    {
-      /* we can search, starting at idx, for a
-       * free position to insert elem */
-      htsize_t referent = idx,
-        new_idx = gt_ht_find_free_idx(ht, idx, +1);
-      HT_SET_LINK(ht, referent, new_idx);
-      insert_pos = new_idx;
-    }
-  } while (0);
-  gt_ht_cp_elem(ht, insert_pos, elem);
-  if (stor_ptr)
-    *stor_ptr = gt_ht_elem_ptr(ht, insert_pos);
-  HT_SET_LINK(ht, insert_pos, end_mark);
-  ht->current_fill += 1;
-  return 1;
-}
-
-static htsize_t
-gt_ht_remove(GtHashtable *ht, const void *elem);
-
-static inline void
-gt_ht_shrink(GtHashtable *ht);
-
-int gt_hashtable_remove(GtHashtable *ht, const void *elem)
+/* marks slot <idx> as unused, the element must have been freed already */
+static void
+gt_ht_clear_slot(GtHashtable *ht, htsize_t idx)
 {
-  htsize_t remove_pos;
-  int rval = 0;
-  gt_assert(ht && elem);
-  gt_rwlock_wrlock(ht->lock);
-  remove_pos = gt_ht_remove(ht, elem);
-  if (remove_pos != free_mark)
+  /* probing stops at a group with an empty slot anyway, so the slot only
+     needs to stay marked as used when its group is completely filled */
+  if (gt_ht_group_match(ht->ctrl + (idx & ~(htsize_t) (GROUP_WIDTH - 1)),
+                        ctrl_empty))
+    ht->ctrl[idx] = ctrl_empty;
+  else
   {
-    gt_ht_shrink(ht);
-    rval = 1;
+    ht->ctrl[idx] = ctrl_deleted;
+    ++ht->deleted_fill;
   }
-  gt_rwlock_unlock(ht->lock);
-  return rval;
+  --ht->current_fill;
 }
 
 static inline void
 gt_ht_shrink(GtHashtable *ht)
 {
+  if (ht->current_fill < gt_ht_order_fill(DEFAULT_LOW_MUL, ht->order_size_log)
+      && ht->order_size_log > MIN_SIZE_LOG)
+  {
+    unsigned short new_size_log = ht->order_size_log;
+    htsize_t low_fill = gt_ht_order_fill(DEFAULT_LOW_MUL, new_size_log),
+             old_low_fill;
+    do {
+      old_low_fill = low_fill;
+      --new_size_log;
+      low_fill >>= 1;
+    } while (ht->current_fill < old_low_fill && new_size_log > MIN_SIZE_LOG);
+    gt_ht_renumber(ht, ht->order_size_log);
+    ht->order_size_log = new_size_log;
+  }
   if (ht->current_fill < ht->low_fill
       && ht->table_size_log > MIN_SIZE_LOG)
   {
@@ -428,43 +563,25 @@ gt_ht_shrink(GtHashtable *ht)
   }
 }
 
-static htsize_t
-gt_ht_remove(GtHashtable *ht, const void *elem)
-{
-  htsize_t remove_pos = free_mark, referent = free_mark;
-  gt_ht_traverse_list_of_key(ht, elem,,
-                          if (link != free_mark
-                              && !ht->table_info.cmp(elem,
-                                                     gt_ht_elem_ptr(ht, idx)))
-                          { remove_pos = idx; break; }
-                          referent = idx;,);
-  /* was elem found? */
-  if (remove_pos != free_mark)
+int gt_hashtable_remove(GtHashtable *ht, const void *elem)
+{
+  htsize_t remove_pos;
+  int rval = 0;
+  gt_assert(ht && elem);
+  gt_rwlock_wrlock(ht->lock);
+  remove_pos = gt_ht_find(ht, elem, gt_ht_elem_hash(ht, elem));
+  if (remove_pos != no_idx)
   {
-    htsize_t chain_next = HT_GET_LINK(ht, remove_pos);
-    if (referent != free_mark)
-    {
-      HT_SET_LINK(ht, referent, chain_next);
-    }
-    else if (chain_next != end_mark)
-    {
-      /* handle removal of chain head, where there is a non-empty tail */
-      /* find next free field to move chain head to temporarily */
-      htsize_t cp_dest_idx = gt_ht_find_free_idx(ht, remove_pos, -1);
-      gt_ht_cp_elem(ht, cp_dest_idx, gt_ht_elem_ptr(ht, remove_pos));
-      gt_ht_cp_elem(ht, remove_pos, gt_ht_elem_ptr(ht, chain_next));
-      HT_SET_LINK(ht, remove_pos, HT_GET_LINK(ht, chain_next));
-      HT_SET_LINK(ht, chain_next, free_mark);
-      remove_pos = cp_dest_idx;
-    }
     if (ht->table_info.free_op.free_elem_with_data)
-      ht->table_info.free_op.free_elem_with_data(gt_ht_elem_ptr(ht, remove_pos),
+      ht->table_info.free_op.free_elem_with_data(gt_ht_elem_ptr(ht,
+                                                                remove_pos),
                                                  ht->table_info.table_data);
-    HT_SET_LINK(ht, remove_pos, free_mark);
-    --ht->current_fill;
-    return remove_pos;
+    gt_ht_clear_slot(ht, remove_pos);
+    gt_ht_shrink(ht);
+    rval = 1;
   }
-  return free_mark;
+  gt_rwlock_unlock(ht->lock);
+  return rval;
 }
 
 struct hash_to_array_data
@@ -493,70 +610,58 @@ int gt_hashtable_foreach_in_default_order(GtHashtable *ht, Elemvisitfunc iter,
 static int gt_hashtable_foreach_g(GtHashtable *ht, Elemvisitfunc visitor,
                                   void *data, GtError *err, bool lock)
 {
-  htsize_t i, table_size = ht->table_mask + 1, deletion_count = 0;
-  jmp_buf env;
+  htsize_t i = 0, num_of_elems, deletion_count = 0, *order;
+  int rval = 0;
   if (lock) {
     gt_rwlock_wrlock(ht->lock);
   }
-  while (setjmp(env))
-    ;
-  for (i = 0; i < table_size; ++i)
+  num_of_elems = ht->current_fill;
+  order = gt_ht_iteration_order(ht, ht->order_size_log);
+  while (!rval && i < num_of_elems)
   {
-    htsize_t idx = i, link = HT_GET_LINK(ht, i);
-    /* if i is occupied and forms a chain start */
-    if (link != free_mark
-        && gt_ht_elem_hash_idx(ht, gt_ht_elem_ptr(ht, i)) == i)
-      while (1)
+    htsize_t idx = order[i];
+    void *elem = gt_ht_elem_ptr(ht, idx);
+    switch (visitor(elem, data, err))
+    {
+    case CONTINUE_ITERATION:
+      break;
+    case STOP_ITERATION:
+      rval = -1;
+      break;
+    case DELETED_ELEM:
+      if (ht->table_info.free_op.free_elem_with_data)
+        ht->table_info.free_op.free_elem_with_data(elem,
+                                                   ht->table_info.table_data);
+      gt_ht_clear_slot(ht, idx);
+      ++deletion_count;
+      break;
+    case MODIFIED_KEY:
+      if (gt_ht_elem_hash(ht, elem) != ht->hashes[idx])
       {
-        void *elem;
-        elem = gt_ht_elem_ptr(ht, idx);
-        switch (visitor(elem, data, err))
-        {
-        case CONTINUE_ITERATION:
-          break;
-        case STOP_ITERATION:
-          if (lock) {
-           gt_rwlock_unlock(ht->lock);
-          }
-          return -1;
-        case DELETED_ELEM:
-          {
-            htsize_t remove_pos = gt_ht_remove(ht, elem);
-            ht->table_info.free_op.free_elem_with_data(
-              gt_ht_elem_ptr(ht, remove_pos), ht->table_info.table_data);
-            ++deletion_count;
-          }
-          break;
-        case MODIFIED_KEY:
-          if (gt_ht_elem_hash_idx(ht, elem) != i)
-          {
-            /* elem now belongs to new chain */
-            /* FIXME: handle deferred move */
-            fprintf(stderr, "Feature MODIFIED_KEY not implemented yet"
-                    " (%s:%d).\n", __FILE__, __LINE__);
-            /* push idx */
-            abort();
-          }
-          break;
-        case REDO_ITERATION:
-          longjmp(env, 1);
-          break;
-        }
-        idx = link;
-        if (idx == end_mark)
-          break;
-        link = HT_GET_LINK(ht, link);
+        /* elem now belongs to another probe sequence */
+        /* FIXME: handle deferred move */
+        fprintf(stderr, "Feature MODIFIED_KEY not implemented yet"
+                " (%s:%d).\n", __FILE__, __LINE__);
+        abort();
       }
+      break;
+    case REDO_ITERATION:
+      gt_ht_free_iteration_order(ht, order);
+      num_of_elems = ht->current_fill;
+      order = gt_ht_iteration_order(ht, ht->order_size_log);
+      i = 0;
+      continue;
+    }
+    ++i;
   }
-  /* FIXME: re-insert pushed indices and rectify affected chains */
+  gt_ht_free_iteration_order(ht, order);
   /* if hashtable shrunk below low_mark, resize */
-  if (deletion_count &&
-      ht->current_fill < ht->low_fill)
+  if (!rval && deletion_count)
     gt_ht_shrink(ht);
   if (lock) {
     gt_rwlock_unlock(ht->lock);
   }
-  return 0;
+  return rval;
 }
 
 int gt_hashtable_foreach_ordered(GtHashtable *ht, Elemvisitfunc iter,
@@ -616,7 +721,7 @@ size_t gt_hashtable_fill(GtHashtable *ht)
     if (ht->current_fill)                                       \
       for (i = 0; i < table_size; ++i)                          \
       {                                                         \
-        if (HT_GET_LINK(ht, i) != free_mark)                    \
+        if (ht->ctrl[i] >= 0)                                   \
         {                                                       \
           visitcode;                                            \
         }                                                       \
@@ -788,21 +893,6 @@ int gt_ht_cstr_elem_cmp(const void *elemA, const void *elemB)
   return strcmp(*(const char **)elemA, *(const char **)elemB);
 }
 
-/*
- * link table stuff
- */
-static htsize_t
-gt_ht_get_table_link(GtHashtable *ht, htsize_t idx)
-{
-  return ht->links.table[idx];
-}
-
-static void
-gt_ht_set_table_link(GtHashtable *ht, htsize_t idx, htsize_t link)
-{
-  ht->links.table[idx] = link;
-}
-
 struct gt_ht_elem_2cstr
 {
   char *key, *value;
@@ -911,6 +1001,70 @@ gt_hashtable_test(HashElemInfo table_info)
   return had_err;
 }
 
+static enum iterator_op
+gt_ht_delete_odd_keys(void *elem, GT_UNUSED void *data,
+                      GT_UNUSED GtError *err)
+{
+  return (*(GtUword *)elem & 1) ? DELETED_ELEM : CONTINUE_ITERATION;
+}
+
+static enum iterator_op
+gt_ht_count_elems(GT_UNUSED void *elem, void *data, GT_UNUSED GtError *err)
+{
+  (*(GtUword *)data)++;
+  return CONTINUE_ITERATION;
+}
+
+/* exercises resizing as well as deleted slots with many elements */
+static int
+gt_hashtable_test_many(void)
+{
+  static const HashElemInfo hash_ul = { gt_ht_ul_elem_hash, { NULL },
+                                        sizeof (GtUword), gt_ht_ul_elem_cmp,
+                                        NULL, NULL };
+  const GtUword num_of_keys = 10000;
+  GtUword i, count = 0;
+  GtHashtable *ht = gt_hashtable_new(hash_ul);
+  int had_err = 0;
+  do {
+    for (i = 0; i < num_of_keys; i++)
+      my_ensure(had_err, gt_hashtable_add(ht, &i));
+    if (had_err) break;
+    for (i = 0; i < num_of_keys; i++)
+      my_ensure(had_err, !gt_hashtable_add(ht, &i)
+                && gt_hashtable_get(ht, &i)
+                && *(GtUword *)gt_hashtable_get(ht, &i) == i);
+    if (had_err) break;
+    /* remove every key divisible by 3, then add them again */
+    for (i = 0; i < num_of_keys; i += 3)
+      my_ensure(had_err, gt_hashtable_remove(ht, &i));
+    if (had_err) break;
+    for (i = 0; i < num_of_keys; i++)
+      my_ensure(had_err, (gt_hashtable_get(ht, &i) == NULL) == (i % 3 == 0));
+    if (had_err) break;
+    for (i = 0; i < num_of_keys; i += 3)
+      my_ensure(had_err, gt_hashtable_add(ht, &i));
+    if (had_err) break;
+    my_ensure(had_err, gt_hashtable_fill(ht) == num_of_keys);
+    /* delete odd keys during iteration */
+    my_ensure(had_err, !gt_hashtable_foreach(ht, gt_ht_delete_odd_keys, NULL,
+                                             NULL));
+    my_ensure(had_err, gt_hashtable_fill(ht) == num_of_keys / 2);
+    my_ensure(had_err, !gt_hashtable_foreach(ht, gt_ht_count_elems, &count,
+                                             NULL));
+    my_ensure(had_err, count == num_of_keys / 2);
+    for (i = 0; i < num_of_keys; i++)
+      my_ensure(had_err, (gt_hashtable_get(ht, &i) != NULL) == (i % 2 == 0));
+    if (had_err) break;
+    /* shrink down to the minimal size */
+    for (i = 0; i < num_of_keys; i += 2)
+      my_ensure(had_err, gt_hashtable_remove(ht, &i));
+    my_ensure(had_err, !gt_hashtable_fill(ht));
+  } while (0);
+  gt_hashtable_delete(ht);
+  return had_err;
+}
+
 int gt_hashtable_unit_test(GT_UNUSED GtError *err)
 {
   int had_err;
@@ -929,5 +1083,9 @@ int gt_hashtable_unit_test(GT_UNUSED GtError *err)
   if (!had_err)
     had_err = gt_hashtable_test(hash_ptr);
 
+  /* many elements with deletions */
+  if (!had_err)
+    had_err = gt_hashtable_test_many();
+
   return had_err;
 }
@@ -0,0 +1,330 @@
+/*
+  Copyright (c) 2008 Thomas Jahns <Thomas.Jahns@gmx.net>
+  Copyright (c) 2008, 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <limits.h>
+#include <string.h>
+#include "core/hashtable_chained.h"
+#include "core/ma.h"
+#include "core/thread_api.h"
+#include "core/types_api.h"
+
+#define free_mark (~(htsize_t)0)
+#define end_mark (free_mark - 1)
+#define mark_bit ((free_mark >> 1) + 1)
+enum {
+  MIN_SIZE_LOG     =   4,
+  FILL_DIVISOR     = 256,
+  DEFAULT_LOW_MUL  =  32,       /**< will be used as quotient
+                                   DEFAULT_LOW_MUL/FILL_DIVISOR */
+  DEFAULT_HIGH_MUL = 192,
+};
+
+struct GtHashtableChained
+{
+  HashElemInfo table_info;
+  void *table;
+  htsize_t table_mask, high_fill, low_fill, current_fill;
+  htsize_t *links;
+  unsigned short table_size_log;
+  GtRWLock *lock;
+};
+
+static htsize_t
+gt_htc_get_table_link(GtHashtableChained *ht, htsize_t idx)
+{
+  return ht->links[idx];
+}
+
+static void
+gt_htc_set_table_link(GtHashtableChained *ht, htsize_t idx, htsize_t link)
+{
+  ht->links[idx] = link;
+}
+
+#define HT_GET_LINK(ht, idx) gt_htc_get_table_link(ht, idx)
+#define HT_SET_LINK(ht, idx, link) gt_htc_set_table_link(ht, idx, link)
+
+static inline void *
+gt_htc_elem_ptr(const GtHashtableChained *ht, htsize_t idx)
+{
+  return (char *)ht->table + ht->table_info.elem_size * idx;
+}
+
+static inline void
+gt_htc_cp_elem(GtHashtableChained *ht, htsize_t dest_idx, const void *src)
+{
+  memcpy(gt_htc_elem_ptr(ht, dest_idx), src, ht->table_info.elem_size);
+}
+
+static void
+gt_htc_init(GtHashtableChained *ht, HashElemInfo table_info,
+            unsigned short size_log)
+{
+  htsize_t i, table_size;
+  ht->table_info = table_info;
+  ht->table_size_log = size_log;
+  ht->table_mask = (table_size = 1 << size_log) - 1;
+  ht->table = gt_malloc(table_info.elem_size * table_size);
+  ht->high_fill = (GtUint64) DEFAULT_HIGH_MUL * table_size / FILL_DIVISOR;
+  ht->low_fill = (GtUint64) DEFAULT_LOW_MUL * table_size / FILL_DIVISOR;
+  ht->current_fill = 0;
+  ht->links = gt_malloc(sizeof (*ht->links) * table_size);
+  for (i = 0; i < table_size; ++i)
+    ht->links[i] = free_mark;
+}
+
+GtHashtableChained* gt_hashtable_chained_new(HashElemInfo table_info)
+{
+  GtHashtableChained *ht = gt_malloc(sizeof (*ht));
+  ht->lock = gt_rwlock_new();
+  gt_htc_init(ht, table_info, MIN_SIZE_LOG);
+  return ht;
+}
+
+static inline htsize_t
+gt_htc_elem_hash_idx(const GtHashtableChained *ht, const void *elem)
+{
+  return ht->table_info.keyhash(elem) & ht->table_mask;
+}
+
+#define gt_htc_traverse_list_of_key(ht, elem, pre_loop, in_loop, post_loop) \
+  do {                                                                      \
+    GtHashtableChained *htref = (ht);                                       \
+    htsize_t elem_hash = gt_htc_elem_hash_idx(htref, (elem)),               \
+      idx, link = elem_hash;                                                \
+    pre_loop;                                                               \
+    do {                                                                    \
+      idx = link;                                                           \
+      link = HT_GET_LINK(htref, idx);                                       \
+      in_loop;                                                              \
+    }                                                                       \
+    while (!(link & mark_bit));                                             \
+    post_loop;                                                              \
+  } while (0)
+
+static htsize_t
+gt_htc_find_free_idx(GtHashtableChained *ht, htsize_t start_idx,
+                     int search_dir)
+{
+  htsize_t new_idx = start_idx;
+  gt_assert(ht->current_fill < ht->table_mask + 1);
+  do {
+    new_idx = (new_idx + search_dir) & ht->table_mask;
+  } while (HT_GET_LINK(ht, new_idx) != free_mark);
+  return new_idx;
+}
+
+static int
+gt_htc_insert(GtHashtableChained *ht, const void *elem)
+{
+  htsize_t insert_pos;
+  do {
+    htsize_t elem_hash = gt_htc_elem_hash_idx(ht, elem), idx,
+      link = elem_hash;
+    if (HT_GET_LINK(ht, link) == free_mark)
+    {
+      /* we can insert at initial link and start a new chain */
+      insert_pos = link;
+      break;
+    }
+    else if (gt_htc_elem_hash_idx(ht, gt_htc_elem_ptr(ht, link)) != elem_hash)
+    {
+      /* relocate chained element */
+      htsize_t reloc_idx = link, reloc_referent, new_idx;
+      gt_htc_traverse_list_of_key(ht, gt_htc_elem_ptr(ht, reloc_idx),,
+                                  if (link == reloc_idx)
+                                    break;,
+                                  reloc_referent = idx;);
+      new_idx = gt_htc_find_free_idx(ht, reloc_referent, -1);
+      gt_htc_cp_elem(ht, new_idx, gt_htc_elem_ptr(ht, reloc_idx));
+      HT_SET_LINK(ht, new_idx, HT_GET_LINK(ht, reloc_idx));
+      HT_SET_LINK(ht, reloc_referent, new_idx);
+      insert_pos = link;
+      break;
+    }
+    do {
+      idx = link;
+      link = HT_GET_LINK(ht, idx);
+      if (!ht->table_info.cmp(elem, gt_htc_elem_ptr(ht, idx))) {
+        /* don't insert elements already present! */
+        return 0;
+      }
+    } while (link != end_mark);
+    {
+      /* we can search, starting at idx, for a
+       * free position to insert elem */
+      htsize_t referent = idx,
+        new_idx = gt_htc_find_free_idx(ht, idx, +1);
+      HT_SET_LINK(ht, referent, new_idx);
+      insert_pos = new_idx;
+    }
+  } while (0);
+  gt_htc_cp_elem(ht, insert_pos, elem);
+  HT_SET_LINK(ht, insert_pos, end_mark);
+  ht->current_fill += 1;
+  return 1;
+}
+
+static void
+gt_htc_resize(GtHashtableChained *ht, unsigned short new_size_log)
+{
+  GtHashtableChained new_ht;
+  htsize_t i, table_size = ht->table_mask + 1;
+  if (new_size_log == ht->table_size_log)
+    return;
+  gt_htc_init(&new_ht, ht->table_info, new_size_log);
+  gt_assert(ht->current_fill < new_ht.table_mask + 1);
+  for (i = 0; i < table_size; ++i)
+  {
+    if (HT_GET_LINK(ht, i) != free_mark)
+    {
+#ifndef NDEBUG
+      int ins_count =
+#endif
+        gt_htc_insert(&new_ht, gt_htc_elem_ptr(ht, i));
+      gt_assert(ins_count);
+    }
+  }
+  gt_free(ht->table);
+  gt_free(ht->links);
+  new_ht.lock = ht->lock;
+  memcpy(ht, &new_ht, sizeof (*ht));
+}
+
+void* gt_hashtable_chained_get(GtHashtableChained *ht, const void *elem)
+{
+  gt_assert(ht);
+  gt_rwlock_wrlock(ht->lock);
+  gt_htc_traverse_list_of_key(ht, elem, ,
+                              if (link != free_mark
+                                  && !ht->table_info.cmp(elem,
+                                                  gt_htc_elem_ptr(ht, idx))) {
+                                gt_rwlock_unlock(ht->lock);
+                                return gt_htc_elem_ptr(ht, idx); },);
+  gt_rwlock_unlock(ht->lock);
+  return NULL;
+}
+
+int gt_hashtable_chained_add(GtHashtableChained *ht, const void *elem)
+{
+  int insert_count;
+  gt_assert(ht && elem);
+  gt_rwlock_wrlock(ht->lock);
+  if (ht->current_fill + 1 > ht->high_fill)
+    gt_htc_resize(ht, ht->table_size_log + 1);
+  insert_count = gt_htc_insert(ht, elem);
+  gt_rwlock_unlock(ht->lock);
+  return insert_count;
+}
+
+static inline void
+gt_htc_shrink(GtHashtableChained *ht)
+{
+  if (ht->current_fill < ht->low_fill
+      && ht->table_size_log > MIN_SIZE_LOG)
+  {
+    unsigned short new_size_log = ht->table_size_log;
+    htsize_t low_fill = ht->low_fill, old_low_fill;
+    do {
+      old_low_fill = low_fill;
+      --new_size_log;
+      low_fill >>= 1;
+    } while (ht->current_fill < old_low_fill && new_size_log > MIN_SIZE_LOG);
+    gt_htc_resize(ht, new_size_log);
+  }
+}
+
+static htsize_t
+gt_htc_remove(GtHashtableChained *ht, const void *elem)
+{
+  htsize_t remove_pos = free_mark, referent = free_mark;
+  gt_htc_traverse_list_of_key(ht, elem,,
+                              if (link != free_mark
+                                  && !ht->table_info.cmp(elem,
+                                                  gt_htc_elem_ptr(ht, idx)))
+                              { remove_pos = idx; break; }
+                              referent = idx;,);
+  /* was elem found? */
+  if (remove_pos != free_mark)
+  {
+    htsize_t chain_next = HT_GET_LINK(ht, remove_pos);
+    if (referent != free_mark)
+    {
+      HT_SET_LINK(ht, referent, chain_next);
+    }
+    else if (chain_next != end_mark)
+    {
+      /* handle removal of chain head, where there is a non-empty tail */
+      /* find next free field to move chain head to temporarily */
+      htsize_t cp_dest_idx = gt_htc_find_free_idx(ht, remove_pos, -1);
+      gt_htc_cp_elem(ht, cp_dest_idx, gt_htc_elem_ptr(ht, remove_pos));
+      gt_htc_cp_elem(ht, remove_pos, gt_htc_elem_ptr(ht, chain_next));
+      HT_SET_LINK(ht, remove_pos, HT_GET_LINK(ht, chain_next));
+      HT_SET_LINK(ht, chain_next, free_mark);
+      remove_pos = cp_dest_idx;
+    }
+    if (ht->table_info.free_op.free_elem_with_data)
+      ht->table_info.free_op.free_elem_with_data(gt_htc_elem_ptr(ht,
+                                                                 remove_pos),
+                                                 ht->table_info.table_data);
+    HT_SET_LINK(ht, remove_pos, free_mark);
+    --ht->current_fill;
+    return remove_pos;
+  }
+  return free_mark;
+}
+
+int gt_hashtable_chained_remove(GtHashtableChained *ht, const void *elem)
+{
+  int rval = 0;
+  gt_assert(ht && elem);
+  gt_rwlock_wrlock(ht->lock);
+  if (gt_htc_remove(ht, elem) != free_mark)
+  {
+    gt_htc_shrink(ht);
+    rval = 1;
+  }
+  gt_rwlock_unlock(ht->lock);
+  return rval;
+}
+
+size_t gt_hashtable_chained_fill(GtHashtableChained *ht)
+{
+  gt_assert(ht);
+  return ht->current_fill;
+}
+
+void gt_hashtable_chained_delete(GtHashtableChained *ht)
+{
+  FreeFuncWData free_elem_with_data;
+  htsize_t i, table_size;
+  if (!ht) return;
+  free_elem_with_data = ht->table_info.free_op.free_elem_with_data;
+  table_size = ht->table_mask + 1;
+  if (free_elem_with_data && ht->current_fill)
+    for (i = 0; i < table_size; ++i)
+    {
+      if (HT_GET_LINK(ht, i) != free_mark)
+        free_elem_with_data(gt_htc_elem_ptr(ht, i), ht->table_info.table_data);
+    }
+  if (ht->table_info.table_data_free)
+    ht->table_info.table_data_free(ht->table_info.table_data);
+  gt_free(ht->table);
+  gt_free(ht->links);
+  gt_rwlock_delete(ht->lock);
+  gt_free(ht);
+}
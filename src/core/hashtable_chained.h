@@ -0,0 +1,40 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef HASHTABLE_CHAINED_H
+#define HASHTABLE_CHAINED_H
+
+#include "core/hashtable.h"
+
+/* The chained hash table formerly used to implement <GtHashtable>, which
+   links colliding elements through a separate table of indices. It is only
+   kept as a reference for benchmarking (see 'gt dev hashbench') and
+   implements the basic operations with the semantics of the corresponding
+   <GtHashtable> functions. */
+typedef struct GtHashtableChained GtHashtableChained;
+
+GtHashtableChained* gt_hashtable_chained_new(HashElemInfo table_info);
+void*               gt_hashtable_chained_get(GtHashtableChained *ht,
+                                             const void *elem);
+/* Returns 1 if add succeeded, 0 if <elem> is already in table. */
+int                 gt_hashtable_chained_add(GtHashtableChained *ht,
+                                             const void *elem);
+int                 gt_hashtable_chained_remove(GtHashtableChained *ht,
+                                                const void *elem);
+size_t              gt_hashtable_chained_fill(GtHashtableChained *ht);
+void                gt_hashtable_chained_delete(GtHashtableChained *ht);
+
+#endif
@@ -218,3 +218,14 @@ GtSequenceBuffer* gt_sequence_buffer_fasta_new(const GtStrArray *sequences)
   sb->pvt->lastspeciallength = 0;
   return sb;
 }
+
+GtSequenceBuffer* gt_sequence_buffer_fasta_new_continued(const GtStrArray
+                                                                    *sequences)
+{
+  GtSequenceBuffer *sb;
+  GtSequenceBufferFasta *sbf;
+  sb = gt_sequence_buffer_fasta_new(sequences);
+  sbf = gt_sequence_buffer_fasta_cast(sb);
+  sbf->firstoverallseq = false;
+  return sb;
+}
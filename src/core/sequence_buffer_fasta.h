@@ -26,6 +26,11 @@ typedef struct GtSequenceBufferFasta GtSequenceBufferFasta;
 
 const GtSequenceBufferClass* gt_sequence_buffer_fasta_class(void);
 GtSequenceBuffer*            gt_sequence_buffer_fasta_new(const GtStrArray*);
+/* Like gt_sequence_buffer_fasta_new(), but the files are parsed as if they
+   followed other, already parsed FASTA files. That is, a SEPARATOR is also
+   delivered before the first sequence. */
+GtSequenceBuffer*            gt_sequence_buffer_fasta_new_continued(
+                                                             const GtStrArray*);
 
 bool                         gt_sequence_buffer_fasta_guess(const char* txt);
 
@@ -0,0 +1,587 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <ctype.h>
+#include <limits.h>
+#include <string.h>
+#include "core/array.h"
+#include "core/dynalloc.h"
+#include "core/ensure.h"
+#include "core/fa.h"
+#include "core/file.h"
+#include "core/ma.h"
+#include "core/multithread_api.h"
+#include "core/sequence_buffer_fasta.h"
+#include "core/sequence_buffer_memory.h"
+#include "core/sequence_buffer_rep.h"
+#include "core/str_api.h"
+#include "core/thread_api.h"
+#include "core/unused_api.h"
+#include "core/xansi_api.h"
+
+/* The parsed contents of a file are stored with two bits per character:
+   For each of the symbols 0 to 3 of the alphabet, the first (uppercased)
+   original character mapped to it is the canonical character of the symbol.
+   Characters which are canonical (or their lowercase variants) are stored by
+   their symbol, all others (wildcards, characters of larger alphabets, and
+   separators) are stored as exceptions, that is, runs of original characters.
+   Lowercase characters are recorded as runs as well. Hence, a soft-masked DNA
+   sequence with few wildcards needs little more than two bits per character,
+   while protein sequences need about one byte per character.
+   In exceptions, separators are represented by the FASTA header start symbol,
+   which cannot occur as a sequence character. */
+#define GT_SEQUENCE_BUFFER_MEMORY_SEPARATOR '>'
+#define GT_SEQUENCE_BUFFER_MEMORY_NOF_CODES 4
+
+typedef struct {
+  GtUword start,
+          length,
+          offset; /* of the first character in the exception characters */
+} GtSequenceBufferMemoryRun;
+
+typedef struct {
+  GtUchar *twobit;
+  char *excchars,
+       canonical[GT_SEQUENCE_BUFFER_MEMORY_NOF_CODES];
+  size_t twobit_allocated,
+         excchars_allocated;
+  GtArray *exceptions, /* runs of characters not stored in <twobit> */
+          *lowercase;  /* runs of lowercase characters */
+  GtUword length,
+          nof_excchars,
+          chardist[UCHAR_MAX+1];
+  GtFilelengthvalues filelength;
+  GtStrArray *descs;
+} GtSequenceBufferMemoryFile;
+
+struct GtSequenceBufferMemoryData {
+  GtStrArray *filenametab;
+  GtSequenceBufferMemoryFile *files;
+  GtUword nof_files;
+  const GtUchar *symbolmap;
+  bool clip_desc;
+};
+
+struct GtSequenceBufferMemory {
+  const GtSequenceBuffer parent_instance;
+  const GtSequenceBufferMemoryData *data;
+  GtUword pos,
+          nextdesc,
+          nextexception,
+          nextlowercase;
+  bool nextfile;
+};
+
+#define gt_sequence_buffer_memory_cast(SB)\
+        gt_sequence_buffer_cast(gt_sequence_buffer_memory_class(), SB)
+
+static void sequence_buffer_memory_add_to_run(GtArray *runs, GtUword pos,
+                                              GtUword offset)
+{
+  GtSequenceBufferMemoryRun *last = NULL, run;
+  if (gt_array_size(runs) > 0)
+    last = gt_array_get_last(runs);
+  if (last != NULL && last->start + last->length == pos)
+    last->length++;
+  else {
+    run.start = pos;
+    run.length = 1UL;
+    run.offset = offset;
+    gt_array_add(runs, run);
+  }
+}
+
+/* appends <orig> (or a separator if <orig> is 0) to <file> */
+static void sequence_buffer_memory_append(GtSequenceBufferMemoryFile *file,
+                                          const GtUchar *symbolmap, char orig)
+{
+  GtUword pos = file->length;
+  GtUchar code = (GtUchar) GT_SEQUENCE_BUFFER_MEMORY_NOF_CODES;
+
+  if (pos % 4 == 0) {
+    if ((size_t) (pos / 4) == file->twobit_allocated) {
+      file->twobit = gt_dynalloc(file->twobit, &file->twobit_allocated,
+                                 (size_t) (pos / 4 + 1) *
+                                 sizeof (*file->twobit));
+    }
+    file->twobit[pos / 4] = 0;
+  }
+  if (orig != 0) {
+    char upper = (char) toupper((int) (unsigned char) orig);
+    code = symbolmap[(unsigned char) orig];
+    if (code < (GtUchar) GT_SEQUENCE_BUFFER_MEMORY_NOF_CODES) {
+      if (file->canonical[code] == 0 &&
+          symbolmap[(unsigned char) upper] == code) {
+        file->canonical[code] = upper;
+      }
+      if (file->canonical[code] != upper)
+        code = (GtUchar) GT_SEQUENCE_BUFFER_MEMORY_NOF_CODES;
+    }
+    if (islower((int) (unsigned char) orig))
+      sequence_buffer_memory_add_to_run(file->lowercase, pos, 0);
+  }
+  if (code < (GtUchar) GT_SEQUENCE_BUFFER_MEMORY_NOF_CODES)
+    file->twobit[pos / 4] |= (GtUchar) (code << (2 * (pos % 4)));
+  else {
+    if ((size_t) file->nof_excchars == file->excchars_allocated) {
+      file->excchars = gt_dynalloc(file->excchars, &file->excchars_allocated,
+                                   (size_t) (file->nof_excchars + 1) *
+                                   sizeof (*file->excchars));
+    }
+    sequence_buffer_memory_add_to_run(file->exceptions, pos,
+                                      file->nof_excchars);
+    if (orig == 0)
+      orig = GT_SEQUENCE_BUFFER_MEMORY_SEPARATOR;
+    file->excchars[file->nof_excchars++] = orig;
+  }
+  file->length++;
+}
+
+/* Parses file <filenum> of <data> completely. All files but the first are
+   parsed as continuations, so that the separator between two files is kept
+   at the same position as in a sequential parse of all files. */
+static int sequence_buffer_memory_parse_file(GtSequenceBufferMemoryData *data,
+                                             GtUword filenum, GtError *err)
+{
+  GtSequenceBufferMemoryFile *file = data->files + filenum;
+  GtSequenceBuffer *sb;
+  GtStrArray *filenametab;
+  GtDescBuffer *descbuffer;
+  bool skipdesc = (filenum > 0);
+  GtUchar cc;
+  char orig;
+  int rval;
+
+  filenametab = gt_str_array_new();
+  gt_str_array_add_cstr(filenametab, gt_str_array_get(data->filenametab,
+                                                      filenum));
+  if (filenum == 0)
+    sb = gt_sequence_buffer_fasta_new(filenametab);
+  else
+    sb = gt_sequence_buffer_fasta_new_continued(filenametab);
+  descbuffer = gt_desc_buffer_new();
+  if (data->clip_desc)
+    gt_desc_buffer_set_clip_at_whitespace(descbuffer);
+  gt_sequence_buffer_set_symbolmap(sb, data->symbolmap);
+  gt_sequence_buffer_set_filelengthtab(sb, &file->filelength);
+  gt_sequence_buffer_set_chardisttab(sb, file->chardist);
+  gt_sequence_buffer_set_desc_buffer(sb, descbuffer);
+
+  while ((rval = gt_sequence_buffer_next_with_original(sb, &cc, &orig,
+                                                       err)) == 1) {
+    sequence_buffer_memory_append(file, data->symbolmap,
+                                  cc == (GtUchar) SEPARATOR ? 0 : orig);
+    /* fetch descriptions in the same way as a consumer of a sequential
+       parse would, the first separator of a continued file ends a
+       sequence of the previous file */
+    if (cc == (GtUchar) SEPARATOR) {
+      if (skipdesc)
+        skipdesc = false;
+      else
+        gt_str_array_add_cstr(file->descs, gt_desc_buffer_get_next(descbuffer));
+    }
+  }
+  if (rval == 0 && !skipdesc)
+    gt_str_array_add_cstr(file->descs, gt_desc_buffer_get_next(descbuffer));
+
+  gt_sequence_buffer_delete(sb);
+  gt_desc_buffer_delete(descbuffer);
+  gt_str_array_delete(filenametab);
+  return rval < 0 ? -1 : 0;
+}
+
+typedef struct {
+  GtSequenceBufferMemoryData *data;
+  GtMutex *mutex;
+  GtUword nextfile,
+          errfile;
+  GtError *err;
+} GtSequenceBufferMemoryThreadInfo;
+
+static void* sequence_buffer_memory_parse_thread(void *data)
+{
+  GtSequenceBufferMemoryThreadInfo *info =
+                                      (GtSequenceBufferMemoryThreadInfo*) data;
+  GtError *err = gt_error_new();
+  GtUword filenum;
+
+  while (true) {
+    gt_mutex_lock(info->mutex);
+    filenum = info->nextfile++;
+    gt_mutex_unlock(info->mutex);
+    if (filenum >= info->data->nof_files)
+      break;
+    if (sequence_buffer_memory_parse_file(info->data, filenum, err) != 0) {
+      /* report the error for the first file, as a sequential parse would */
+      gt_mutex_lock(info->mutex);
+      if (filenum < info->errfile) {
+        info->errfile = filenum;
+        gt_error_set(info->err, "%s", gt_error_get(err));
+      }
+      gt_mutex_unlock(info->mutex);
+      gt_error_unset(err);
+    }
+  }
+  gt_error_delete(err);
+  return NULL;
+}
+
+static int sequence_buffer_memory_check_fasta(const char *filename,
+                                              GtError *err)
+{
+  GtFile *file;
+  char firstcontents[BUFSIZ];
+  memset(firstcontents, 0, BUFSIZ);
+  file = gt_file_open(gt_file_mode_determine(filename), filename, "rb", err);
+  if (!file)
+    return -1;
+  gt_file_xread(file, &firstcontents, BUFSIZ-1);
+  gt_file_delete(file);
+  if (!gt_sequence_buffer_fasta_guess(firstcontents)) {
+    gt_error_set(err, "file %s is not in FASTA format, which is required for "
+                      "parsing input files in parallel", filename);
+    return -1;
+  }
+  return 0;
+}
+
+GtSequenceBufferMemoryData* gt_sequence_buffer_memory_data_new(
+                                                const GtStrArray *filenametab,
+                                                const GtUchar *symbolmap,
+                                                bool clip_desc,
+                                                GtError *err)
+{
+  GtSequenceBufferMemoryData *data;
+  GtSequenceBufferMemoryThreadInfo info;
+  GtUword i;
+  int had_err = 0;
+  gt_assert(filenametab && symbolmap);
+  gt_error_check(err);
+
+  if (gt_str_array_size(filenametab) == 0) {
+    gt_error_set(err, "no sequence files given");
+    return NULL;
+  }
+  for (i = 0; i < gt_str_array_size(filenametab); i++) {
+    if (sequence_buffer_memory_check_fasta(gt_str_array_get(filenametab, i),
+                                           err) != 0) {
+      return NULL;
+    }
+  }
+  data = gt_malloc(sizeof *data);
+  data->filenametab = gt_str_array_ref((GtStrArray*) filenametab);
+  data->nof_files = gt_str_array_size(filenametab);
+  data->files = gt_calloc((size_t) data->nof_files, sizeof (*data->files));
+  for (i = 0; i < data->nof_files; i++) {
+    data->files[i].descs = gt_str_array_new();
+    data->files[i].exceptions =
+                            gt_array_new(sizeof (GtSequenceBufferMemoryRun));
+    data->files[i].lowercase = gt_array_new(sizeof (GtSequenceBufferMemoryRun));
+  }
+  data->symbolmap = symbolmap;
+  data->clip_desc = clip_desc;
+
+  info.data = data;
+  info.mutex = gt_mutex_new();
+  info.nextfile = 0;
+  info.errfile = GT_UWORD_MAX;
+  info.err = err;
+  if (gt_multithread(sequence_buffer_memory_parse_thread, &info, err) != 0
+        || info.errfile != GT_UWORD_MAX) {
+    had_err = -1;
+  }
+  gt_mutex_delete(info.mutex);
+  if (had_err) {
+    gt_sequence_buffer_memory_data_delete(data);
+    return NULL;
+  }
+  return data;
+}
+
+void gt_sequence_buffer_memory_data_delete(GtSequenceBufferMemoryData *data)
+{
+  GtUword i;
+  if (!data) return;
+  for (i = 0; i < data->nof_files; i++) {
+    gt_free(data->files[i].twobit);
+    gt_free(data->files[i].excchars);
+    gt_array_delete(data->files[i].exceptions);
+    gt_array_delete(data->files[i].lowercase);
+    gt_str_array_delete(data->files[i].descs);
+  }
+  gt_free(data->files);
+  gt_str_array_delete(data->filenametab);
+  gt_free(data);
+}
+
+static void sequence_buffer_memory_add_desc(GtSequenceBuffer *sb,
+                                            const GtSequenceBufferMemoryFile
+                                                                         *file)
+{
+  GtSequenceBufferMemory *sbm = gt_sequence_buffer_memory_cast(sb);
+  const char *desc;
+  if (sb->pvt->descptr == NULL ||
+      sbm->nextdesc >= gt_str_array_size(file->descs)) {
+    return;
+  }
+  for (desc = gt_str_array_get(file->descs, sbm->nextdesc++); *desc != '\0';
+       desc++) {
+    gt_desc_buffer_append_char(sb->pvt->descptr, *desc);
+  }
+  gt_desc_buffer_finish(sb->pvt->descptr);
+}
+
+/* returns the original character at the current position of <sbm> in <file>,
+   or 0 for a separator */
+static char sequence_buffer_memory_get(GtSequenceBufferMemory *sbm,
+                                       const GtSequenceBufferMemoryFile *file)
+{
+  const GtSequenceBufferMemoryRun *run;
+  GtUword pos = sbm->pos;
+  char cc;
+
+  while (sbm->nextexception < gt_array_size(file->exceptions)) {
+    run = gt_array_get(file->exceptions, sbm->nextexception);
+    if (pos < run->start)
+      break;
+    if (pos < run->start + run->length) {
+      cc = file->excchars[run->offset + pos - run->start];
+      return cc == GT_SEQUENCE_BUFFER_MEMORY_SEPARATOR ? 0 : cc;
+    }
+    sbm->nextexception++;
+  }
+  cc = file->canonical[(file->twobit[pos / 4] >> (2 * (pos % 4))) & 3];
+  while (sbm->nextlowercase < gt_array_size(file->lowercase)) {
+    run = gt_array_get(file->lowercase, sbm->nextlowercase);
+    if (pos < run->start)
+      break;
+    if (pos < run->start + run->length) {
+      cc = (char) tolower((int) (unsigned char) cc);
+      break;
+    }
+    sbm->nextlowercase++;
+  }
+  return cc;
+}
+
+static int gt_sequence_buffer_memory_advance(GtSequenceBuffer *sb,
+                                             GtError *err)
+{
+  GtUword currentoutpos = 0, i;
+  GtSequenceBufferMembers *pvt;
+  GtSequenceBufferMemory *sbm;
+  const GtSequenceBufferMemoryFile *file;
+  char cc;
+
+  gt_error_check(err);
+  sbm = gt_sequence_buffer_memory_cast(sb);
+  pvt = sb->pvt;
+  while (currentoutpos < (GtUword) OUTBUFSIZE) {
+    file = sbm->data->files + pvt->filenum;
+    if (sbm->nextfile) {
+      sbm->nextfile = false;
+      sbm->pos = 0;
+      sbm->nextdesc = 0;
+      sbm->nextexception = 0;
+      sbm->nextlowercase = 0;
+      if (pvt->filelengthtab != NULL)
+        pvt->filelengthtab[pvt->filenum] = file->filelength;
+      /* the description of the very first sequence is not preceded by a
+         separator */
+      if (pvt->filenum == 0)
+        sequence_buffer_memory_add_desc(sb, file);
+    }
+    if (sbm->pos == file->length) {
+      if (pvt->chardisttab != NULL) {
+        for (i = 0; i <= (GtUword) UCHAR_MAX; i++)
+          pvt->chardisttab[i] += file->chardist[i];
+      }
+      if ((GtUword) pvt->filenum == sbm->data->nof_files - 1) {
+        pvt->complete = true;
+        break;
+      }
+      pvt->filenum++;
+      sbm->nextfile = true;
+      continue;
+    }
+    if ((cc = sequence_buffer_memory_get(sbm, file)) == 0) {
+      /* separators have no original character */
+      pvt->outbuf[currentoutpos] = (GtUchar) SEPARATOR;
+      pvt->outbuforig[currentoutpos] = 0;
+      sequence_buffer_memory_add_desc(sb, file);
+    } else {
+      pvt->outbuf[currentoutpos] = sbm->data->symbolmap[(unsigned char) cc];
+      pvt->outbuforig[currentoutpos] = (unsigned char) cc;
+      pvt->counter++;
+    }
+    sbm->pos++;
+    currentoutpos++;
+  }
+  pvt->nextfree = currentoutpos;
+  return 0;
+}
+
+static GtUword gt_sequence_buffer_memory_get_file_index(GtSequenceBuffer *sb)
+{
+  gt_assert(sb);
+  return (GtUword) sb->pvt->filenum;
+}
+
+static void gt_sequence_buffer_memory_free(GT_UNUSED GtSequenceBuffer *sb)
+{
+  /* nothing to do, the data is owned by the caller */
+}
+
+const GtSequenceBufferClass* gt_sequence_buffer_memory_class(void)
+{
+  static const GtSequenceBufferClass sbc = { sizeof (GtSequenceBufferMemory),
+                                       gt_sequence_buffer_memory_advance,
+                                       gt_sequence_buffer_memory_get_file_index,
+                                       gt_sequence_buffer_memory_free };
+  return &sbc;
+}
+
+GtSequenceBuffer* gt_sequence_buffer_memory_new(
+                                         const GtSequenceBufferMemoryData *data)
+{
+  GtSequenceBuffer *sb;
+  GtSequenceBufferMemory *sbm;
+  gt_assert(data);
+  sb = gt_sequence_buffer_create(gt_sequence_buffer_memory_class());
+  sbm = gt_sequence_buffer_memory_cast(sb);
+  sbm->data = data;
+  sbm->nextfile = true;
+  sb->pvt->filenametab = data->filenametab;
+  sb->pvt->filenum = 0;
+  sb->pvt->nextread = sb->pvt->nextfree = 0;
+  sb->pvt->complete = false;
+  sb->pvt->lastspeciallength = 0;
+  return sb;
+}
+
+/* reads all of <sb> and collects characters, descriptions, file lengths and
+   character distribution in the given structures */
+static int sequence_buffer_memory_read_all(GtSequenceBuffer *sb, GtStr *seq,
+                                           GtStrArray *descs,
+                                           GtFilelengthvalues *filelengthtab,
+                                           GtUword *chardist, GtError *err)
+{
+  GtDescBuffer *descbuffer = gt_desc_buffer_new();
+  GtUchar cc;
+  char orig;
+  int rval;
+  gt_sequence_buffer_set_filelengthtab(sb, filelengthtab);
+  gt_sequence_buffer_set_chardisttab(sb, chardist);
+  gt_sequence_buffer_set_desc_buffer(sb, descbuffer);
+  while ((rval = gt_sequence_buffer_next_with_original(sb, &cc, &orig,
+                                                       err)) == 1) {
+    gt_str_append_char(seq, cc == (GtUchar) SEPARATOR ? '|' : orig);
+    if (cc == (GtUchar) SEPARATOR)
+      gt_str_array_add_cstr(descs, gt_desc_buffer_get_next(descbuffer));
+  }
+  if (rval == 0)
+    gt_str_array_add_cstr(descs, gt_desc_buffer_get_next(descbuffer));
+  gt_desc_buffer_delete(descbuffer);
+  return rval;
+}
+
+int gt_sequence_buffer_memory_unit_test(GtError *err)
+{
+  static const char *contents[] = { ">seq1 first\nacgtn\nACGT\n>seq2\nggcc\n"
+                                    "NNnnACgtRYryTTuUt\n",
+                                    ">seq3 third sequence\nttttt\n",
+                                    ">seq4\naaaa\n>seq5 fifth\ncc\n" };
+  GtUchar symbolmap[UCHAR_MAX+1];
+  GtFilelengthvalues flv_seq[3], flv_mem[3];
+  GtUword chardist_seq[UCHAR_MAX+1], chardist_mem[UCHAR_MAX+1], i;
+  GtSequenceBufferMemoryData *data = NULL;
+  GtSequenceBuffer *sb;
+  GtStrArray *files, *descs_seq, *descs_mem;
+  GtStr *seq_seq, *seq_mem, *tmpfilename;
+  FILE *tmpfp;
+  int had_err = 0;
+  gt_error_check(err);
+
+  memset(symbolmap, (int) WILDCARD, sizeof (symbolmap));
+  symbolmap['a'] = symbolmap['A'] = 0;
+  symbolmap['c'] = symbolmap['C'] = 1;
+  symbolmap['g'] = symbolmap['G'] = 2;
+  symbolmap['t'] = symbolmap['T'] = symbolmap['u'] = symbolmap['U'] = 3;
+  memset(flv_seq, 0, sizeof (flv_seq));
+  memset(flv_mem, 0, sizeof (flv_mem));
+  memset(chardist_seq, 0, sizeof (chardist_seq));
+  memset(chardist_mem, 0, sizeof (chardist_mem));
+  files = gt_str_array_new();
+  descs_seq = gt_str_array_new();
+  descs_mem = gt_str_array_new();
+  seq_seq = gt_str_new();
+  seq_mem = gt_str_new();
+  tmpfilename = gt_str_new();
+  for (i = 0; i < 3UL; i++) {
+    tmpfp = gt_xtmpfp(tmpfilename);
+    gt_xfputs(contents[i], tmpfp);
+    gt_fa_xfclose(tmpfp);
+    gt_str_array_add(files, tmpfilename);
+    gt_str_reset(tmpfilename);
+  }
+
+  /* sequential parse as reference */
+  sb = gt_sequence_buffer_fasta_new(files);
+  gt_sequence_buffer_set_symbolmap(sb, symbolmap);
+  had_err = sequence_buffer_memory_read_all(sb, seq_seq, descs_seq, flv_seq,
+                                            chardist_seq, err);
+  gt_sequence_buffer_delete(sb);
+
+  if (!had_err) {
+    data = gt_sequence_buffer_memory_data_new(files, symbolmap, false, err);
+    gt_ensure(data != NULL);
+  }
+  /* traverse twice, as done when encoding */
+  for (i = 0; !had_err && i < 2UL; i++) {
+    gt_str_reset(seq_mem);
+    gt_str_array_reset(descs_mem);
+    memset(chardist_mem, 0, sizeof (chardist_mem));
+    sb = gt_sequence_buffer_memory_new(data);
+    had_err = sequence_buffer_memory_read_all(sb, seq_mem, descs_mem, flv_mem,
+                                              chardist_mem, err);
+    gt_sequence_buffer_delete(sb);
+    gt_ensure(strcmp(gt_str_get(seq_seq), gt_str_get(seq_mem)) == 0);
+    gt_ensure(gt_str_array_size(descs_seq) == 5UL);
+    gt_ensure(gt_str_array_size(descs_seq) == gt_str_array_size(descs_mem));
+    gt_ensure(strcmp(gt_str_array_get(descs_mem, 2), "seq3 third sequence")
+                == 0);
+    gt_ensure(memcmp(flv_seq, flv_mem, sizeof (flv_seq)) == 0);
+    gt_ensure(memcmp(chardist_seq, chardist_mem, sizeof (chardist_seq)) == 0);
+  }
+  if (!had_err) {
+    GtUword j;
+    for (j = 0; j < gt_str_array_size(descs_seq); j++) {
+      gt_ensure(strcmp(gt_str_array_get(descs_seq, j),
+                       gt_str_array_get(descs_mem, j)) == 0);
+    }
+  }
+  gt_sequence_buffer_memory_data_delete(data);
+
+  for (i = 0; i < gt_str_array_size(files); i++)
+    gt_xremove(gt_str_array_get(files, i));
+  gt_str_array_delete(files);
+  gt_str_array_delete(descs_seq);
+  gt_str_array_delete(descs_mem);
+  gt_str_delete(seq_seq);
+  gt_str_delete(seq_mem);
+  gt_str_delete(tmpfilename);
+  return had_err;
+}
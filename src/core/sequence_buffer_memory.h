@@ -0,0 +1,58 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef SEQUENCE_BUFFER_MEMORY_H
+#define SEQUENCE_BUFFER_MEMORY_H
+
+#include "core/sequence_buffer.h"
+#include "core/str_array_api.h"
+
+/* A <GtSequenceBufferMemoryData> holds the completely parsed contents of a
+   set of FASTA files. The files are parsed by <gt_jobs> threads in parallel,
+   such that each file is read (and decompressed) only once, even if the
+   contents are traversed several times. The sequences of each file are kept
+   in memory with two bits per character, plus runs of wildcards, lowercase
+   characters and separators. For DNA this is about a quarter of the input
+   size, for protein sequences about the input size. */
+typedef struct GtSequenceBufferMemoryData GtSequenceBufferMemoryData;
+
+/* implements the ``sequence buffer'' interface for parsed FASTA files */
+typedef struct GtSequenceBufferMemory GtSequenceBufferMemory;
+
+/* Parses the FASTA files in <filenametab>, mapping the sequences using
+   <symbolmap> (which must not be NULL and must stay valid as long as the
+   result). Descriptions are clipped after the first whitespace if
+   <clip_desc> is true. Returns NULL on error (<err> is set accordingly). */
+GtSequenceBufferMemoryData* gt_sequence_buffer_memory_data_new(
+                                                const GtStrArray *filenametab,
+                                                const GtUchar *symbolmap,
+                                                bool clip_desc,
+                                                GtError *err);
+void                        gt_sequence_buffer_memory_data_delete(
+                                              GtSequenceBufferMemoryData *data);
+
+const GtSequenceBufferClass* gt_sequence_buffer_memory_class(void);
+/* Returns a <GtSequenceBuffer> delivering the contents of <data> in the same
+   way as a FASTA sequence buffer on the original files would, including file
+   lengths, character distribution and descriptions. The symbol map given to
+   gt_sequence_buffer_memory_data_new() is always applied. <data> must not be
+   deleted before the returned buffer. */
+GtSequenceBuffer*            gt_sequence_buffer_memory_new(
+                                        const GtSequenceBufferMemoryData *data);
+
+int                          gt_sequence_buffer_memory_unit_test(GtError *err);
+
+#endif
@@ -15,6 +15,7 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <limits.h>
 #include <math.h>
 #include <string.h>
 #include "core/assert_api.h"
@@ -33,6 +34,9 @@ struct GtStr {
   unsigned int reference_count;
 };
 
+/* reference count marking permanent strings, see <gt_str_make_permanent()> */
+#define GT_STR_PERMANENT  UINT_MAX
+
 GtStr* gt_str_new(void)
 {
   GtStr *s = gt_malloc(sizeof *s);      /* create new string object */
@@ -242,10 +246,25 @@ GtStr* gt_str_clone(const GtStr *s)
 GtStr* gt_str_ref(GtStr *s)
 {
   if (!s) return NULL;
-  s->reference_count++; /* increase the reference counter */
+  if (s->reference_count != GT_STR_PERMANENT)
+    s->reference_count++; /* increase the reference counter */
   return s;
 }
 
+void gt_str_make_permanent(GtStr *s)
+{
+  gt_assert(s && !s->reference_count);
+  s->reference_count = GT_STR_PERMANENT;
+}
+
+void gt_str_delete_permanent(GtStr *s)
+{
+  if (!s) return;
+  gt_assert(s->reference_count == GT_STR_PERMANENT);
+  s->reference_count = 0;
+  gt_str_delete(s);
+}
+
 int gt_str_read_next_line(GtStr *s, FILE *fpin)
 {
   int cc;
@@ -453,6 +472,8 @@ int gt_str_unit_test(GtError *err)
 void gt_str_delete(GtStr *s)
 {
   if (!s) return;           /* return without action if 's' is NULL */
+  if (s->reference_count == GT_STR_PERMANENT)
+    return;                 /* permanent strings are never freed here */
   if (s->reference_count) { /* there are multiple references to this string */
     s->reference_count--;   /* decrement the reference counter */
     return;                 /* return without freeing the object */
@@ -31,6 +31,14 @@ void          gt_str_clip_suffix(GtStr *s, char c);
    is returned, otherwise 0. */
 int           gt_str_read_next_line(GtStr *str, FILE *fpin);
 int           gt_str_read_next_line_generic(GtStr*, GtFile*);
+/* Make <s> permanent: afterwards <gt_str_ref()> and <gt_str_delete()> leave
+   <s> untouched, so that it can be shared between threads without
+   synchronizing its reference count. <s> must not be modified anymore and has
+   to be freed with <gt_str_delete_permanent()>. Used for interned strings, see
+   <gt_symbol_str()>. */
+void          gt_str_make_permanent(GtStr *s);
+/* Free the permanent string <s>. */
+void          gt_str_delete_permanent(GtStr *s);
 int           gt_str_unit_test(GtError*);
 
 #endif
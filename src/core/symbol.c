@@ -17,18 +17,25 @@
 
 #include <string.h>
 #include "core/cstr_table.h"
+#include "core/hashmap.h"
 #include "core/mathsupport.h"
 #include "core/multithread_api.h"
+#include "core/str.h"
 #include "core/symbol.h"
 #include "core/unused_api.h"
 
 static GtCstrTable *symbols = NULL;
+static GtHashmap *str_symbols = NULL;
 static GtMutex *symbol_mutex = NULL;
 
 void gt_symbol_init(void)
 {
   if (!symbols)
     symbols = gt_cstr_table_new();
+  if (!str_symbols) {
+    str_symbols = gt_hashmap_new(GT_HASH_STRING, NULL,
+                                 (GtFree) gt_str_delete_permanent);
+  }
   if (!symbol_mutex)
     symbol_mutex = gt_mutex_new();
 }
@@ -47,9 +54,25 @@ const char* gt_symbol(const char *cstr)
   return symbol;
 }
 
+GtStr* gt_symbol_str(const char *cstr)
+{
+  GtStr *symbol;
+  if (!cstr)
+    return NULL;
+  gt_mutex_lock(symbol_mutex);
+  if (!(symbol = gt_hashmap_get(str_symbols, cstr))) {
+    symbol = gt_str_new_cstr(cstr);
+    gt_str_make_permanent(symbol);
+    gt_hashmap_add(str_symbols, gt_str_get(symbol), symbol);
+  }
+  gt_mutex_unlock(symbol_mutex);
+  return symbol;
+}
+
 void gt_symbol_clean(void)
 {
   gt_cstr_table_delete(symbols);
+  gt_hashmap_delete(str_symbols);
   gt_mutex_delete(symbol_mutex);
 }
 
@@ -59,7 +82,7 @@ void gt_symbol_clean(void)
 
 static void* test_symbol(GT_UNUSED void *data)
 {
-  GtStr *symbol;
+  GtStr *symbol, *str_symbol;
   GtUword i;
   symbol = gt_str_new();
   for (i = 0; i < NUMBER_OF_SYMBOLS; i++) {
@@ -67,6 +90,10 @@ static void* test_symbol(GT_UNUSED void *data)
     gt_str_append_ulong(symbol, gt_rand_max(MAX_SYMBOL));
     gt_symbol(gt_str_get(symbol));
     gt_assert(!strcmp(gt_symbol(gt_str_get(symbol)), gt_str_get(symbol)));
+    str_symbol = gt_str_ref(gt_symbol_str(gt_str_get(symbol)));
+    gt_assert(str_symbol == gt_symbol_str(gt_str_get(symbol)));
+    gt_assert(!gt_str_cmp(str_symbol, symbol));
+    gt_str_delete(str_symbol);
   }
   gt_str_delete(symbol);
   return NULL;
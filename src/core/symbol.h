@@ -19,10 +19,21 @@
 #define SYMBOL_H
 
 #include "core/error_api.h"
+#include "core/str_api.h"
 #include "core/symbol_api.h"
 
 void        gt_symbol_init(void);
 
+/* Return the interned string for <cstr>, that is, the same <GtStr*> is
+   returned for all equal <cstr>s, regardless of the calling thread. Hence,
+   interned strings can be compared for equality by a simple pointer comparison
+   (which <gt_str_cmp()> does first). The returned string is permanent (see
+   <gt_str_make_permanent()>) and must not be modified. It can be passed to
+   <gt_str_ref()> and <gt_str_delete()> like any other string, but is only freed
+   by <gt_symbol_clean()>. Like for <gt_symbol()>, use it only for a limited
+   set of <cstr>s which occur very often (e.g., sequence IDs and sources). */
+GtStr*      gt_symbol_str(const char *cstr);
+
 /* Free (and thereby invalidate) all created symbols! */
 void        gt_symbol_clean(void);
 
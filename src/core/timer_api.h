@@ -48,6 +48,9 @@ void     gt_timer_show(GtTimer *timer, FILE *fp);
 void     gt_timer_show_formatted(GtTimer *timer, const char *fmt, FILE *fp);
 /* Like <gt_timer_show_formatted()>, but appends the output to <str>. */
 void     gt_timer_get_formatted(GtTimer *t, const char *fmt, GtStr *str);
+/* Return the time elapsed on <timer> in seconds, including fractions of a
+   second. The timer is then stopped. */
+double   gt_timer_get_elapsed_seconds(GtTimer *timer);
 /* Output the current state of <timer> on <fp> since the last call of
    <gt_timer_show_progress()> or the last start of <timer>, along with the
    current description. The timer is not stopped, but updated with <desc> to be
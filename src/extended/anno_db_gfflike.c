@@ -26,6 +26,7 @@
 #include "core/hashmap-generic.h"
 #include "core/log_api.h"
 #include "core/ma.h"
+#include "core/minmax.h"
 #include "core/range.h"
 #include "core/strand_api.h"
 #include "core/thread_api.h"
@@ -54,6 +55,7 @@ struct GtAnnoDBGFFlike {
   const GtAnnoDBSchema parent_instance;
   GtRDB *db;
   GtRDBVisitor *visitor;
+  bool rtree;
 };
 
 typedef struct {
@@ -61,6 +63,12 @@ typedef struct {
   GtAnnoDBGFFlike *annodb;
 } GFFlikeSetupVisitor;
 
+typedef struct {
+  const GtRDBVisitor parent_instance;
+  bool drop,
+       rtree; /* set when (re)creating: range queries can use the R*Tree */
+} GFFlikeIndexVisitor;
+
 typedef struct {
   const GtFeatureIndex parent_instance;
   GtHashmap *node_to_parent_array,
@@ -77,12 +85,35 @@ typedef struct {
   GtFeatureNodeObserver *obs;
   GtRDB *db;
   GtMutex *dblock;
-  bool transaction_lock;
+  bool transaction_lock,
+       rtree; /* the range query uses the R*Tree */
+  /* bulk loading state */
+  bool bulk;
+  GtUword bulk_batchsize,
+          bulk_uncommitted,
+          bulk_rows;
+  GtArray *bulk_attrib_ids,
+          *bulk_parents;
+  GtStrArray *bulk_attrib_keys,
+             *bulk_attrib_values;
+  GtRDBStmt *bulk_begin,
+            *bulk_commit,
+            *bulk_attrib_insert,
+            *bulk_parent_insert;
 } GtFeatureIndexGFFlike;
 
 const GtAnnoDBSchemaClass* gt_anno_db_gfflike_class(void);
 static const GtRDBVisitorClass* gfflike_setup_visitor_class(void);
+static const GtRDBVisitorClass* gfflike_index_visitor_class(void);
 static const GtFeatureIndexClass* feature_index_gfflike_class(void);
+static int prepstmt_range_init(GtFeatureIndexGFFlike *fis, bool rtree,
+                               GtError *err);
+
+/* maximal number of feature IDs looked up with a single query */
+#define GT_ANNO_DB_GFFLIKE_ID_BATCH 512
+
+/* number of rows written by a multi-row insert during bulk loading */
+#define GT_ANNO_DB_GFFLIKE_INSERT_ROWS 64
 
 #define anno_db_gfflike_cast(V)\
         gt_anno_db_schema_cast(gt_anno_db_gfflike_class(), V)
@@ -90,6 +121,9 @@ static const GtFeatureIndexClass* feature_index_gfflike_class(void);
 #define gfflike_setup_visitor_cast(V)\
         gt_rdb_visitor_cast(gfflike_setup_visitor_class(), V)
 
+#define gfflike_index_visitor_cast(V)\
+        gt_rdb_visitor_cast(gfflike_index_visitor_class(), V)
+
 #define feature_index_gfflike_cast(V)\
         gt_feature_index_cast(feature_index_gfflike_class(), V)
 
@@ -299,6 +333,88 @@ static int anno_db_gfflike_create_indexes_sqlite(GtRDBSqlite *db, GtError *err)
   return 0;
 }
 
+/* Returns true if the R*Tree over the feature ranges and both triggers keeping
+   it up to date exist, false if not or on error. */
+static bool anno_db_gfflike_has_rtree_sqlite(GtRDBSqlite *db, GtError *err)
+{
+  GtRDBStmt *stmt;
+  int nof_objects = 0;
+  gt_error_check(err);
+  stmt = gt_rdb_prepare((GtRDB*) db,
+                           "SELECT COUNT(name) FROM sqlite_master "
+                           "WHERE name IN ('features_rtree', "
+                                          "'features_rtree_delete', "
+                                          "'features_rtree_insert')",
+                           0,
+                           err);
+  if (!stmt || gt_rdb_stmt_exec(stmt, err) < 0 ||
+      gt_rdb_stmt_get_int(stmt, 0, &nof_objects, err) != 0) {
+    nof_objects = 0;
+  }
+  gt_rdb_stmt_delete(stmt);
+  return nof_objects == 3;
+}
+
+/* Sets up an R*Tree over the feature ranges, with the sequence region as an
+   additional dimension so that range queries only touch the boxes of the
+   requested sequence region. It is kept up to date by triggers on the
+   <features> table. The database is only modified if <create> is true: then
+   a missing R*Tree is created, and if the insert trigger is missing (new
+   R*Tree, or after a bulk load) the features added since are indexed first.
+   The insert trigger is created last, so an incomplete setup is caught up
+   later. Returns true if range queries can use the R*Tree. On any failure
+   (e.g., the SQLite library was built without R*Tree support, or the
+   database is read-only) false is returned and range queries use the plain
+   indexes. */
+static bool anno_db_gfflike_setup_rtree_sqlite(GtRDBSqlite *db, bool create)
+{
+  static const char *queries[] = {
+    "CREATE VIRTUAL TABLE IF NOT EXISTS features_rtree "
+    "USING rtree(id, seqid_min, seqid_max, start, end)",
+    "CREATE TRIGGER IF NOT EXISTS features_rtree_delete "
+    "AFTER DELETE ON features BEGIN "
+      "DELETE FROM features_rtree WHERE id = old.id; "
+    "END",
+    /* feature IDs are assigned in increasing order, so everything not yet in
+       the R*Tree comes after its largest ID */
+    "INSERT INTO features_rtree "
+    "SELECT id, seqid, seqid, start, end "
+    "FROM features "
+    "WHERE id > (SELECT COALESCE(MAX(id), 0) FROM features_rtree) "
+    "AND NOT EXISTS (SELECT name FROM sqlite_master "
+                    "WHERE type = 'trigger' "
+                    "AND name = 'features_rtree_insert')",
+    "CREATE TRIGGER IF NOT EXISTS features_rtree_insert "
+    "AFTER INSERT ON features BEGIN "
+      "INSERT INTO features_rtree "
+      "VALUES (new.id, new.seqid, new.seqid, new.start, new.end); "
+    "END"
+  };
+  GtError *err;
+  GtRDBStmt *stmt;
+  GtUword i;
+  bool rtree;
+  gt_assert(db);
+
+  err = gt_error_new();
+  rtree = anno_db_gfflike_has_rtree_sqlite(db, err);
+  if (!rtree && create && !gt_error_is_set(err)) {
+    for (i = 0; !gt_error_is_set(err) &&
+                i < sizeof (queries) / sizeof (queries[0]); i++) {
+      stmt = gt_rdb_prepare((GtRDB*) db, queries[i], 0, err);
+      if (stmt)
+        (void) gt_rdb_stmt_exec(stmt, err);
+      gt_rdb_stmt_delete(stmt);
+    }
+    if (!gt_error_is_set(err))
+      rtree = anno_db_gfflike_has_rtree_sqlite(db, err);
+  }
+  if (gt_error_is_set(err))
+    gt_log_log("using plain indexes for range queries: %s", gt_error_get(err));
+  gt_error_delete(err);
+  return rtree;
+}
+
 static int anno_db_gfflike_validate_mysql(GtRDBMySQL *db, GtError *err,
                                           bool *check)
 {
@@ -546,12 +662,13 @@ static int anno_db_gfflike_create_indexes_mysql(GtRDBMySQL *db, GtError *err)
   return 0;
 }
 
-int anno_db_gfflike_init_sqlite(GT_UNUSED GtRDBVisitor *rdbv, GtRDBSqlite *db,
+int anno_db_gfflike_init_sqlite(GtRDBVisitor *rdbv, GtRDBSqlite *db,
                                 GtError *err)
 {
+  GFFlikeSetupVisitor *sv = gfflike_setup_visitor_cast(rdbv);
   GtCstrTable *cst = NULL;
   GtStrArray *arr = NULL;
-  bool check = true;
+  bool check = true, created = false;
   int had_err = 0;
   gt_assert(db);
 
@@ -567,6 +684,7 @@ int anno_db_gfflike_init_sqlite(GT_UNUSED GtRDBVisitor *rdbv, GtRDBSqlite *db,
   if (!had_err) {
     if (gt_str_array_size(arr) == 0) {
       had_err = anno_db_gfflike_create_tables_sqlite(db, err);
+      created = true;
     }
   }
   gt_cstr_table_delete(cst);
@@ -581,18 +699,26 @@ int anno_db_gfflike_init_sqlite(GT_UNUSED GtRDBVisitor *rdbv, GtRDBSqlite *db,
   if (!had_err) {
     had_err = anno_db_gfflike_create_indexes_sqlite(db, err);
   }
+  if (!had_err) {
+    /* the R*Tree of an existing database is only set up when it is indexed
+       after a bulk load, so that opening it for queries does not write to it
+       (which fails for read-only databases) */
+    sv->annodb->rtree = anno_db_gfflike_setup_rtree_sqlite(db, created);
+  }
 
   return had_err;
 }
 
-int anno_db_gfflike_init_mysql(GT_UNUSED GtRDBVisitor *rdbv, GtRDBMySQL *db,
+int anno_db_gfflike_init_mysql(GtRDBVisitor *rdbv, GtRDBMySQL *db,
                                GtError *err)
 {
+  GFFlikeSetupVisitor *sv = gfflike_setup_visitor_cast(rdbv);
   GtCstrTable *cst = NULL;
   GtStrArray *arr = NULL;
   bool check = true;
   int had_err = 0;
   gt_assert(db);
+  sv->annodb->rtree = false;
 
   cst = gt_rdb_get_tables((GtRDB*) db, err);
   if (!cst) {
@@ -623,6 +749,145 @@ int anno_db_gfflike_init_mysql(GT_UNUSED GtRDBVisitor *rdbv, GtRDBMySQL *db,
   return had_err;
 }
 
+/* secondary indexes which are not needed while bulk loading */
+static const struct {
+  const char *name,
+             *table;
+} gfflike_deferred_indexes[] = {
+  { "feature_all",     "features" },
+  { "feature_seqid",   "features" },
+  { "attribs_value",   "attributes" },
+  { "attribs_key",     "attributes" },
+  { "attribs_feature", "attributes" },
+  { "parent_id",       "parents" }
+};
+
+static int anno_db_gfflike_drop_indexes_sqlite(GtRDBSqlite *db, GtError *err)
+{
+  int had_err = 0;
+  GtUword i;
+  GtRDBStmt *stmt;
+  GtStr *query;
+  gt_assert(db);
+
+  query = gt_str_new();
+  for (i = 0; !had_err && i < sizeof (gfflike_deferred_indexes)
+                               / sizeof (gfflike_deferred_indexes[0]); i++) {
+    gt_str_reset(query);
+    gt_str_append_cstr(query, "DROP INDEX IF EXISTS ");
+    gt_str_append_cstr(query, gfflike_deferred_indexes[i].name);
+    stmt = gt_rdb_prepare((GtRDB*) db, gt_str_get(query), 0, err);
+    if (!stmt || gt_rdb_stmt_exec(stmt, err) < 0)
+      had_err = -1;
+    gt_rdb_stmt_delete(stmt);
+  }
+  gt_str_delete(query);
+  if (!had_err) {
+    /* the R*Tree is caught up when the trigger is created again */
+    stmt = gt_rdb_prepare((GtRDB*) db,
+                             "DROP TRIGGER IF EXISTS features_rtree_insert",
+                             0,
+                             err);
+    if (!stmt || gt_rdb_stmt_exec(stmt, err) < 0)
+      had_err = -1;
+    gt_rdb_stmt_delete(stmt);
+  }
+  return had_err;
+}
+
+static int anno_db_gfflike_drop_indexes_mysql(GtRDBMySQL *db, GtError *err)
+{
+  int had_err = 0;
+  GtUword i;
+  GtRDBStmt *stmt;
+  GtCstrTable *cst;
+  GtStr *query;
+  gt_assert(db);
+
+  if (!(cst = gt_rdb_get_indexes((GtRDB*) db, err))) {
+    return -1;
+  }
+  query = gt_str_new();
+  for (i = 0; !had_err && i < sizeof (gfflike_deferred_indexes)
+                               / sizeof (gfflike_deferred_indexes[0]); i++) {
+    if (!gt_cstr_table_get(cst, gfflike_deferred_indexes[i].name))
+      continue;
+    gt_str_reset(query);
+    gt_str_append_cstr(query, "DROP INDEX ");
+    gt_str_append_cstr(query, gfflike_deferred_indexes[i].name);
+    gt_str_append_cstr(query, " ON ");
+    gt_str_append_cstr(query, gfflike_deferred_indexes[i].table);
+    stmt = gt_rdb_prepare((GtRDB*) db, gt_str_get(query), 0, err);
+    if (!stmt || gt_rdb_stmt_exec(stmt, err) < 0)
+      had_err = -1;
+    gt_rdb_stmt_delete(stmt);
+  }
+  gt_str_delete(query);
+  gt_cstr_table_delete(cst);
+  return had_err;
+}
+
+static int anno_db_gfflike_index_sqlite(GtRDBVisitor *rdbv, GtRDBSqlite *db,
+                                        GtError *err)
+{
+  GFFlikeIndexVisitor *iv = gfflike_index_visitor_cast(rdbv);
+  int had_err = 0;
+  gt_assert(db);
+
+  if (iv->drop)
+    return anno_db_gfflike_drop_indexes_sqlite(db, err);
+  had_err = anno_db_gfflike_create_indexes_sqlite(db, err);
+  if (!had_err)
+    iv->rtree = anno_db_gfflike_setup_rtree_sqlite(db, true);
+  return had_err;
+}
+
+static int anno_db_gfflike_index_mysql(GtRDBVisitor *rdbv, GtRDBMySQL *db,
+                                       GtError *err)
+{
+  GFFlikeIndexVisitor *iv = gfflike_index_visitor_cast(rdbv);
+  gt_assert(db);
+
+  if (iv->drop)
+    return anno_db_gfflike_drop_indexes_mysql(db, err);
+  return anno_db_gfflike_create_indexes_mysql(db, err);
+}
+
+static const GtRDBVisitorClass* gfflike_index_visitor_class()
+{
+  static const GtRDBVisitorClass *ivc = NULL;
+  gt_class_alloc_lock_enter();
+  if (!ivc) {
+    ivc = gt_rdb_visitor_class_new(sizeof (GFFlikeIndexVisitor),
+                                   NULL,
+                                   anno_db_gfflike_index_sqlite,
+                                   anno_db_gfflike_index_mysql);
+  }
+  gt_class_alloc_lock_leave();
+  return ivc;
+}
+
+/* Drops (if <drop> is true) or (re)creates the secondary indexes of <db>.
+   If <rtree> is not <NULL>, it is set to true if range queries can use the
+   R*Tree afterwards. */
+static int anno_db_gfflike_update_indexes(GtRDB *db, bool drop, bool *rtree,
+                                          GtError *err)
+{
+  GtRDBVisitor *v;
+  GFFlikeIndexVisitor *iv;
+  int had_err;
+  gt_assert(db);
+  v = gt_rdb_visitor_create(gfflike_index_visitor_class());
+  iv = gfflike_index_visitor_cast(v);
+  iv->drop = drop;
+  iv->rtree = false;
+  had_err = gt_rdb_accept(db, v, err);
+  if (rtree)
+    *rtree = iv->rtree;
+  gt_rdb_visitor_delete(v);
+  return had_err;
+}
+
 void anno_db_gfflike_free(GtAnnoDBSchema *s)
 {
   GtAnnoDBGFFlike *adg = anno_db_gfflike_cast(s);
@@ -712,6 +977,139 @@ gt_feature_index_gfflike_insert_helper(GtFeatureIndexGFFlike *fis,
   return *id;
 }
 
+typedef struct {
+  GtUword child,
+          parent;
+} GFFlikeParentLink;
+
+/* Writes out the buffered attribute rows, as one multi-row insert if the
+   buffer is full. */
+static int bulk_flush_attributes(GtFeatureIndexGFFlike *fi, GtError *err)
+{
+  GtRDBStmt *stmt;
+  GtUword i, n;
+  int rval = 0;
+  gt_assert(fi && fi->bulk);
+  n = gt_array_size(fi->bulk_attrib_ids);
+  if (n == GT_ANNO_DB_GFFLIKE_INSERT_ROWS) {
+    stmt = fi->bulk_attrib_insert;
+    gt_rdb_stmt_reset(stmt, err);
+    for (i = 0; i < n; i++) {
+      gt_rdb_stmt_bind_int(stmt, 3 * i,
+                           *(GtUword*) gt_array_get(fi->bulk_attrib_ids, i),
+                           err);
+      gt_rdb_stmt_bind_string(stmt, 3 * i + 1,
+                              gt_str_array_get(fi->bulk_attrib_keys, i), err);
+      gt_rdb_stmt_bind_string(stmt, 3 * i + 2,
+                              gt_str_array_get(fi->bulk_attrib_values, i),
+                              err);
+    }
+    rval = gt_rdb_stmt_exec(stmt, err);
+  } else {
+    stmt = fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT];
+    for (i = 0; rval >= 0 && i < n; i++) {
+      gt_rdb_stmt_reset(stmt, err);
+      gt_rdb_stmt_bind_int(stmt, 0,
+                           *(GtUword*) gt_array_get(fi->bulk_attrib_ids, i),
+                           err);
+      gt_rdb_stmt_bind_string(stmt, 1,
+                              gt_str_array_get(fi->bulk_attrib_keys, i), err);
+      gt_rdb_stmt_bind_string(stmt, 2,
+                              gt_str_array_get(fi->bulk_attrib_values, i),
+                              err);
+      rval = gt_rdb_stmt_exec(stmt, err);
+    }
+  }
+  gt_array_reset(fi->bulk_attrib_ids);
+  gt_str_array_reset(fi->bulk_attrib_keys);
+  gt_str_array_reset(fi->bulk_attrib_values);
+  return (rval < 0) ? -1 : 0;
+}
+
+/* Writes out the buffered parent rows, as one multi-row insert if the buffer
+   is full. */
+static int bulk_flush_parents(GtFeatureIndexGFFlike *fi, GtError *err)
+{
+  GtRDBStmt *stmt;
+  GFFlikeParentLink *link;
+  GtUword i, n;
+  int rval = 0;
+  gt_assert(fi && fi->bulk);
+  n = gt_array_size(fi->bulk_parents);
+  if (n == GT_ANNO_DB_GFFLIKE_INSERT_ROWS) {
+    stmt = fi->bulk_parent_insert;
+    gt_rdb_stmt_reset(stmt, err);
+    for (i = 0; i < n; i++) {
+      link = gt_array_get(fi->bulk_parents, i);
+      gt_rdb_stmt_bind_int(stmt, 2 * i, link->child, err);
+      gt_rdb_stmt_bind_int(stmt, 2 * i + 1, link->parent, err);
+    }
+    rval = gt_rdb_stmt_exec(stmt, err);
+  } else {
+    stmt = fi->stmts[GT_PSTMT_PARENT_INSERT];
+    for (i = 0; rval >= 0 && i < n; i++) {
+      link = gt_array_get(fi->bulk_parents, i);
+      gt_rdb_stmt_reset(stmt, err);
+      gt_rdb_stmt_bind_int(stmt, 0, link->child, err);
+      gt_rdb_stmt_bind_int(stmt, 1, link->parent, err);
+      rval = gt_rdb_stmt_exec(stmt, err);
+    }
+  }
+  gt_array_reset(fi->bulk_parents);
+  return (rval < 0) ? -1 : 0;
+}
+
+static int bulk_add_attribute(GtFeatureIndexGFFlike *fi, GtUword id,
+                              const char *key, const char *value, GtError *err)
+{
+  gt_assert(fi && fi->bulk && key && value);
+  gt_array_add(fi->bulk_attrib_ids, id);
+  gt_str_array_add_cstr(fi->bulk_attrib_keys, key);
+  gt_str_array_add_cstr(fi->bulk_attrib_values, value);
+  fi->bulk_uncommitted++;
+  if (gt_array_size(fi->bulk_attrib_ids) == GT_ANNO_DB_GFFLIKE_INSERT_ROWS)
+    return bulk_flush_attributes(fi, err);
+  return 0;
+}
+
+static int bulk_add_parent(GtFeatureIndexGFFlike *fi, GtUword child,
+                           GtUword parent, GtError *err)
+{
+  GFFlikeParentLink link;
+  gt_assert(fi && fi->bulk);
+  link.child = child;
+  link.parent = parent;
+  gt_array_add(fi->bulk_parents, link);
+  fi->bulk_uncommitted++;
+  if (gt_array_size(fi->bulk_parents) == GT_ANNO_DB_GFFLIKE_INSERT_ROWS)
+    return bulk_flush_parents(fi, err);
+  return 0;
+}
+
+/* Writes out all buffered rows and commits the current transaction. A new
+   transaction is started if <restart> is true. */
+static int bulk_commit(GtFeatureIndexGFFlike *fi, bool restart, GtError *err)
+{
+  int had_err = 0;
+  gt_assert(fi && fi->bulk);
+  had_err = bulk_flush_attributes(fi, err);
+  if (!had_err)
+    had_err = bulk_flush_parents(fi, err);
+  if (!had_err) {
+    gt_rdb_stmt_reset(fi->bulk_commit, err);
+    if (gt_rdb_stmt_exec(fi->bulk_commit, err) < 0)
+      had_err = -1;
+  }
+  if (!had_err && restart) {
+    gt_rdb_stmt_reset(fi->bulk_begin, err);
+    if (gt_rdb_stmt_exec(fi->bulk_begin, err) < 0)
+      had_err = -1;
+  }
+  fi->bulk_rows += fi->bulk_uncommitted;
+  fi->bulk_uncommitted = 0;
+  return had_err;
+}
+
 static int get_parents(GtFeatureNode *gn, void *data, GT_UNUSED GtError *err)
 {
   GtHashmap *parentindex = (GtHashmap*) data;
@@ -758,11 +1156,15 @@ static int set_parents(void *key, void *value, void *data,
       parent_id = node_ul_gt_hashmap_get(fi->cache_node2id, parent);
       gt_assert(parent_id);
       /* insert parents */
-      gt_rdb_stmt_reset(fi->stmts[GT_PSTMT_PARENT_INSERT], err);
-      gt_rdb_stmt_bind_int(fi->stmts[GT_PSTMT_PARENT_INSERT], 0, *num, err);
-      gt_rdb_stmt_bind_int(fi->stmts[GT_PSTMT_PARENT_INSERT], 1, *parent_id,
-                           err);
-      rval = gt_rdb_stmt_exec(fi->stmts[GT_PSTMT_PARENT_INSERT], err);
+      if (fi->bulk) {
+        rval = bulk_add_parent(fi, *num, *parent_id, err);
+      } else {
+        gt_rdb_stmt_reset(fi->stmts[GT_PSTMT_PARENT_INSERT], err);
+        gt_rdb_stmt_bind_int(fi->stmts[GT_PSTMT_PARENT_INSERT], 0, *num, err);
+        gt_rdb_stmt_bind_int(fi->stmts[GT_PSTMT_PARENT_INSERT], 1, *parent_id,
+                             err);
+        rval = gt_rdb_stmt_exec(fi->stmts[GT_PSTMT_PARENT_INSERT], err);
+      }
     }
   }
   return had_err;
@@ -869,17 +1271,24 @@ static int insert_single_node(GtFeatureIndexGFFlike *fi,
   ul_node_gt_hashmap_add(fi->cache_id2node, *id, fn);
 
   /* insert attributes */
+  if (fi->bulk)
+    fi->bulk_uncommitted++;
   attribs = gt_feature_node_get_attribute_list(fn);
   for (i=0;i<gt_str_array_size(attribs);i++) {
     const char *attr;
-    gt_rdb_stmt_reset(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], err);
     attr = gt_str_array_get(attribs, i);
-    gt_rdb_stmt_bind_int(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], 0, *id, err);
-    gt_rdb_stmt_bind_string(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], 1, attr,
-                            err);
-    gt_rdb_stmt_bind_string(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], 2,
-                            gt_feature_node_get_attribute(fn, attr), err);
-    rval = gt_rdb_stmt_exec(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], err);
+    if (fi->bulk) {
+      rval = bulk_add_attribute(fi, *id, attr,
+                                gt_feature_node_get_attribute(fn, attr), err);
+    } else {
+      gt_rdb_stmt_reset(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], err);
+      gt_rdb_stmt_bind_int(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], 0, *id, err);
+      gt_rdb_stmt_bind_string(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], 1, attr,
+                              err);
+      gt_rdb_stmt_bind_string(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], 2,
+                              gt_feature_node_get_attribute(fn, attr), err);
+      rval = gt_rdb_stmt_exec(fi->stmts[GT_PSTMT_ATTRIBUTE_INSERT], err);
+    }
     if (rval < 0)
       had_err = -1;
   }
@@ -898,7 +1307,8 @@ static int insert_feature_node(GtFeatureIndexGFFlike *fi,
   GtUword num;
 
   /* TODO: locking! subgraph insertion is a transaction
-      we also need to avoid nesting */
+      we also need to avoid nesting (in bulk loading mode, transactions are
+      only committed between subgraphs) */
 
   /* collect relationships */
   gt_hashmap_reset(fi->node_to_parent_array);
@@ -923,6 +1333,11 @@ static int insert_feature_node(GtFeatureIndexGFFlike *fi,
     gt_hashmap_foreach(fi->node_to_parent_array, set_parents, fi, err);
 
   /* TODO: locking! commit this subgraph to DB */
+  if (!had_err && fi->bulk && fi->bulk_uncommitted >= fi->bulk_batchsize) {
+    gt_mutex_lock(fi->dblock);
+    had_err = bulk_commit(fi, true, err);
+    gt_mutex_unlock(fi->dblock);
+  }
 
   gt_feature_node_iterator_delete(fni);
   gt_hashmap_reset(fi->node_to_parent_array);
@@ -1031,6 +1446,121 @@ int gt_feature_index_gfflike_add_feature_node(GtFeatureIndex *gfi,
   return had_err;
 }
 
+/* Prepares a multi-row insert of <GT_ANNO_DB_GFFLIKE_INSERT_ROWS> rows of
+   <nof_columns> values each. */
+static GtRDBStmt* prepare_multi_row_insert(GtRDB *db, const char *prefix,
+                                           GtUword nof_columns, GtError *err)
+{
+  GtRDBStmt *stmt;
+  GtStr *query;
+  GtUword i, j;
+  gt_assert(db && prefix && nof_columns > 0);
+  query = gt_str_new_cstr(prefix);
+  gt_str_append_cstr(query, " VALUES ");
+  for (i = 0; i < GT_ANNO_DB_GFFLIKE_INSERT_ROWS; i++) {
+    gt_str_append_cstr(query, i ? ", (?" : "(?");
+    for (j = 1; j < nof_columns; j++)
+      gt_str_append_cstr(query, ", ?");
+    gt_str_append_char(query, ')');
+  }
+  stmt = gt_rdb_prepare(db, gt_str_get(query),
+                        GT_ANNO_DB_GFFLIKE_INSERT_ROWS * nof_columns, err);
+  gt_str_delete(query);
+  return stmt;
+}
+
+static void bulk_load_cleanup(GtFeatureIndexGFFlike *fi)
+{
+  gt_assert(fi);
+  gt_rdb_stmt_delete(fi->bulk_begin);
+  gt_rdb_stmt_delete(fi->bulk_commit);
+  gt_rdb_stmt_delete(fi->bulk_attrib_insert);
+  gt_rdb_stmt_delete(fi->bulk_parent_insert);
+  gt_array_delete(fi->bulk_attrib_ids);
+  gt_array_delete(fi->bulk_parents);
+  gt_str_array_delete(fi->bulk_attrib_keys);
+  gt_str_array_delete(fi->bulk_attrib_values);
+  fi->bulk_begin = fi->bulk_commit = NULL;
+  fi->bulk_attrib_insert = fi->bulk_parent_insert = NULL;
+  fi->bulk_attrib_ids = fi->bulk_parents = NULL;
+  fi->bulk_attrib_keys = fi->bulk_attrib_values = NULL;
+  fi->bulk = false;
+}
+
+int gt_feature_index_gfflike_start_bulk_load(GtFeatureIndex *gfi,
+                                             GtUword batchsize,
+                                             GtError *err)
+{
+  GtFeatureIndexGFFlike *fi;
+  int had_err = 0;
+  gt_assert(gfi && batchsize > 0);
+  gt_error_check(err);
+
+  fi = feature_index_gfflike_cast(gfi);
+  gt_assert(!fi->bulk);
+  gt_mutex_lock(fi->dblock);
+  had_err = anno_db_gfflike_update_indexes(fi->db, true, NULL, err);
+  if (!had_err) {
+    fi->bulk_begin = gt_rdb_prepare(fi->db, "BEGIN", 0, err);
+    fi->bulk_commit = gt_rdb_prepare(fi->db, "COMMIT", 0, err);
+    fi->bulk_attrib_insert =
+                  prepare_multi_row_insert(fi->db,
+                                           "INSERT INTO attributes "
+                                           "(feature_id, keystr, value)",
+                                           3, err);
+    fi->bulk_parent_insert =
+                  prepare_multi_row_insert(fi->db,
+                                           "INSERT INTO parents "
+                                           "(feature_id, parent)",
+                                           2, err);
+    fi->bulk_attrib_ids = gt_array_new(sizeof (GtUword));
+    fi->bulk_parents = gt_array_new(sizeof (GFFlikeParentLink));
+    fi->bulk_attrib_keys = gt_str_array_new();
+    fi->bulk_attrib_values = gt_str_array_new();
+    if (!fi->bulk_begin || !fi->bulk_commit || !fi->bulk_attrib_insert
+          || !fi->bulk_parent_insert) {
+      had_err = -1;
+    }
+  }
+  if (!had_err && gt_rdb_stmt_exec(fi->bulk_begin, err) < 0)
+    had_err = -1;
+  if (!had_err) {
+    fi->bulk = true;
+    fi->bulk_batchsize = batchsize;
+    fi->bulk_uncommitted = fi->bulk_rows = 0;
+  } else {
+    bulk_load_cleanup(fi);
+  }
+  gt_mutex_unlock(fi->dblock);
+  return had_err;
+}
+
+int gt_feature_index_gfflike_finish_bulk_load(GtFeatureIndex *gfi,
+                                              GtUword *nof_rows,
+                                              GtError *err)
+{
+  GtFeatureIndexGFFlike *fi;
+  int had_err = 0;
+  bool rtree = false;
+  gt_assert(gfi);
+  gt_error_check(err);
+
+  fi = feature_index_gfflike_cast(gfi);
+  if (!fi->bulk)
+    return 0;
+  gt_mutex_lock(fi->dblock);
+  had_err = bulk_commit(fi, false, err);
+  if (nof_rows)
+    *nof_rows = fi->bulk_rows;
+  bulk_load_cleanup(fi);
+  if (!had_err)
+    had_err = anno_db_gfflike_update_indexes(fi->db, false, &rtree, err);
+  if (!had_err && rtree != fi->rtree)
+    had_err = prepstmt_range_init(fi, rtree, err);
+  gt_mutex_unlock(fi->dblock);
+  return had_err;
+}
+
 static int remove_node_by_id(GtFeatureIndexGFFlike *fis, GtUword id,
                              GtError *err)
 {
@@ -1254,6 +1784,9 @@ static int gt_feature_index_gfflike_save(GtFeatureIndex *fi,
   oci = (ObserverCallbackInfo*) fig->obs->data;
 
   gt_mutex_lock(fig->dblock);
+  /* changes are saved in transactions of their own */
+  if (fig->bulk)
+    had_err = bulk_commit(fig, false, err);
   stmt_b = gt_rdb_prepare(fig->db, "BEGIN TRANSACTION;", 0, err);
   stmt_e = gt_rdb_prepare(fig->db, "END TRANSACTION;", 0, err);
   gt_rdb_stmt_exec(stmt_b, err);
@@ -1289,25 +1822,138 @@ static int gt_feature_index_gfflike_save(GtFeatureIndex *fi,
 
   gt_rdb_stmt_delete(stmt_e);
   gt_rdb_stmt_delete(stmt_b);
+  if (fig->bulk) {
+    gt_rdb_stmt_reset(fig->bulk_begin, err);
+    gt_rdb_stmt_exec(fig->bulk_begin, err);
+  }
   gt_mutex_lock(fig->dblock);
 
   return had_err;
 }
 
+/* Prepares <prefix> followed by a parenthesized list of the feature IDs
+   <ids>[<from>..<to>-1] and <suffix> (if not <NULL>), to look up data for
+   many features with one query. */
+static GtRDBStmt* prepare_for_id_batch(GtRDB *db, const char *prefix,
+                                       GtArray *ids, GtUword from, GtUword to,
+                                       const char *suffix, GtError *err)
+{
+  GtRDBStmt *stmt;
+  GtStr *query;
+  GtUword i;
+  gt_assert(db && prefix && ids && from < to);
+  query = gt_str_new_cstr(prefix);
+  gt_str_append_cstr(query, " (");
+  for (i = from; i < to; i++) {
+    if (i > from)
+      gt_str_append_char(query, ',');
+    gt_str_append_ulong(query, *(GtUword*) gt_array_get(ids, i));
+  }
+  gt_str_append_char(query, ')');
+  if (suffix) {
+    gt_str_append_char(query, ' ');
+    gt_str_append_cstr(query, suffix);
+  }
+  stmt = gt_rdb_prepare(db, gt_str_get(query), 0, err);
+  gt_str_delete(query);
+  return stmt;
+}
+
+/* Assigns the attributes of all freshly built nodes in <ids>. */
+static int assign_attributes_batched(GtFeatureIndexGFFlike *fi, GtArray *ids,
+                                     GtError *err)
+{
+  int had_err = 0, rval;
+  GtUword from, to;
+  GtStr *key, *value;
+  gt_assert(fi && ids);
+  key = gt_str_new();
+  value = gt_str_new();
+  for (from = 0; !had_err && from < gt_array_size(ids); from = to) {
+    GtRDBStmt *stmt;
+    to = MIN(from + GT_ANNO_DB_GFFLIKE_ID_BATCH, gt_array_size(ids));
+    stmt = prepare_for_id_batch(fi->db,
+                                "SELECT feature_id, keystr, value "
+                                "FROM attributes WHERE feature_id IN",
+                                ids, from, to, NULL, err);
+    if (!stmt) {
+      had_err = -1;
+      break;
+    }
+    while ((rval = gt_rdb_stmt_exec(stmt, err)) == 0) {
+      GtUword id = GT_UNDEF_UWORD;
+      GtFeatureNode *fn;
+      gt_rdb_stmt_get_ulong(stmt, 0, &id, err);
+      gt_rdb_stmt_get_string(stmt, 1, key, err);
+      gt_rdb_stmt_get_string(stmt, 2, value, err);
+      fn = *(GtFeatureNode**) ul_node_gt_hashmap_get(fi->cache_id2node, id);
+      gt_assert(fn);
+      gt_feature_node_set_attribute(fn, gt_str_get(key), gt_str_get(value));
+      gt_str_reset(key);
+      gt_str_reset(value);
+    }
+    if (rval < 0)
+      had_err = -1;
+    gt_rdb_stmt_delete(stmt);
+  }
+  gt_str_delete(key);
+  gt_str_delete(value);
+  return had_err;
+}
+
+/* Attaches all nodes in <ids> to their parents, in the order of <ids>.
+   Every node which became a child is added to <seen_as_children>. */
+static int assign_parents_batched(GtFeatureIndexGFFlike *fi, GtArray *ids,
+                                  GtHashtable *seen_as_children, GtError *err)
+{
+  int had_err = 0, rval;
+  GtUword from, to;
+  gt_assert(fi && ids && seen_as_children);
+  for (from = 0; !had_err && from < gt_array_size(ids); from = to) {
+    GtRDBStmt *stmt;
+    to = MIN(from + GT_ANNO_DB_GFFLIKE_ID_BATCH, gt_array_size(ids));
+    stmt = prepare_for_id_batch(fi->db,
+                                "SELECT feature_id, parent "
+                                "FROM parents WHERE feature_id IN",
+                                ids, from, to, "ORDER BY feature_id", err);
+    if (!stmt) {
+      had_err = -1;
+      break;
+    }
+    while ((rval = gt_rdb_stmt_exec(stmt, err)) == 0) {
+      GtUword id = GT_UNDEF_UWORD, par_id = GT_UNDEF_UWORD;
+      GtFeatureNode *newfn, *parent;
+      gt_rdb_stmt_get_ulong(stmt, 0, &id, err);
+      gt_rdb_stmt_get_ulong(stmt, 1, &par_id, err);
+      newfn = *(GtFeatureNode**) ul_node_gt_hashmap_get(fi->cache_id2node, id);
+      parent = *(GtFeatureNode**) ul_node_gt_hashmap_get(fi->cache_id2node,
+                                                         par_id);
+      gt_assert(newfn && parent);
+      /* if a child has multiple parents, increase refcount */
+      if (gt_hashtable_get(seen_as_children, &newfn)) {
+        gt_genome_node_ref((GtGenomeNode*) newfn);
+      }
+      gt_feature_node_add_child(parent, newfn);
+      gt_hashtable_add(seen_as_children, &newfn);
+    }
+    if (rval < 0)
+      had_err = -1;
+    gt_rdb_stmt_delete(stmt);
+  }
+  return had_err;
+}
+
 static int get_nodes_for_stmt(GtFeatureIndexGFFlike *fi,
                               GtArray *results,
                               GtRDBStmt *stmt,
                               GtError *err)
 {
-  GtRDBStmt *attr_stmt, *parent_stmt;
   int had_err = 0;
   GtUword i;
-  GtArray *nodes;
-  bool is_child;
+  GtArray *nodes, *new_nodes;
   gt_assert(fi && results && stmt);
-  attr_stmt = fi->stmts[GT_PSTMT_GET_ATTRIBUTE_SELECT];
-  parent_stmt = fi->stmts[GT_PSTMT_GET_PARENTS_SELECT];
   nodes = gt_array_new(sizeof (GtUword));
+  new_nodes = gt_array_new(sizeof (GtUword));
   HashElemInfo node_hashtype = {
     gt_ht_ptr_elem_hash,
     { NULL },
@@ -1366,20 +2012,8 @@ static int get_nodes_for_stmt(GtFeatureIndexGFFlike *fi,
         node_ul_gt_hashmap_add(fi->cache_node2id, newfn, id);
       }
 
-      /* assign attributes */
-      gt_rdb_stmt_reset(attr_stmt, err);
-      gt_rdb_stmt_bind_ulong(attr_stmt, 0, id, err);
-      while (gt_rdb_stmt_exec(attr_stmt, err) == 0) {
-        GtStr *key, *value;
-        key = gt_str_new();
-        value = gt_str_new();
-        gt_rdb_stmt_get_string(attr_stmt, 0, key, err);
-        gt_rdb_stmt_get_string(attr_stmt, 1, value, err);
-        gt_feature_node_set_attribute(newfn, gt_str_get(key),
-                                      gt_str_get(value));
-        gt_str_delete(key);
-        gt_str_delete(value);
-      }
+      /* attributes are assigned for all new nodes at once below */
+      gt_array_add(new_nodes, id);
 
       /* is this a multi-feature? */
       if (is_multi) {
@@ -1400,32 +2034,20 @@ static int get_nodes_for_stmt(GtFeatureIndexGFFlike *fi,
     gt_str_delete(type_str);
   }
 
+  /* fetch attributes and parents for the whole result with one query per
+     batch of IDs instead of one query per node */
+  if (!had_err)
+    had_err = assign_attributes_batched(fi, new_nodes, err);
+
   /* rebuild DAG */
+  if (!had_err)
+    had_err = assign_parents_batched(fi, nodes, seen_as_children, err);
   for (i=0;i<gt_array_size(nodes);i++) {
     GtUword id = *(GtUword*) gt_array_get(nodes, i);
-    is_child = false;
     GtFeatureNode *newfn = *(GtFeatureNode**)
                                   ul_node_gt_hashmap_get(fi->cache_id2node, id);
     gt_assert(newfn);
-    /* assign parents */
-    gt_rdb_stmt_reset(parent_stmt, err);
-    gt_rdb_stmt_bind_ulong(parent_stmt, 0, id, err);
-    while (gt_rdb_stmt_exec(parent_stmt, err) == 0) {
-      GtUword par_id;
-      GtFeatureNode *parent;
-      is_child = true;
-      gt_rdb_stmt_get_ulong(parent_stmt, 0, &par_id, err);
-      parent = *(GtFeatureNode**) ul_node_gt_hashmap_get(fi->cache_id2node,
-                                                       par_id);
-      gt_assert(parent);
-      /* if a child has multiple parents, increase refcount */
-      if (gt_hashtable_get(seen_as_children, &newfn)) {
-        gt_genome_node_ref((GtGenomeNode*) newfn);
-      }
-      gt_feature_node_add_child(parent, newfn);
-      gt_hashtable_add(seen_as_children, &newfn);
-    }
-    if (!is_child) {
+    if (!gt_hashtable_get(seen_as_children, &newfn)) {
       GtGenomeNode *newgn = (GtGenomeNode*) newfn;
       gt_array_add(results, newgn);
     }
@@ -1437,6 +2059,7 @@ static int get_nodes_for_stmt(GtFeatureIndexGFFlike *fi,
     gt_feature_node_set_observer(newfn, fi->obs);
   }
   gt_array_delete(nodes);
+  gt_array_delete(new_nodes);
   gt_hashtable_delete(seen_as_children);
   return had_err;
 }
@@ -1650,6 +2273,8 @@ void gt_feature_index_gfflike_delete(GtFeatureIndex *gfi)
   GtUword i;
   if (!gfi) return;
   fi = feature_index_gfflike_cast(gfi);
+  if (fi->bulk)
+    (void) gt_feature_index_gfflike_finish_bulk_load(gfi, NULL, NULL);
   for (i=0;i<GT_PSTMT_NOF_STATEMENTS;i++) {
     gt_rdb_stmt_delete(fi->stmts[i]);
   }
@@ -1680,6 +2305,7 @@ const GtFeatureIndexClass* feature_index_gfflike_class(void)
                                 gt_feature_index_gfflike_remove_node,
                                 gt_feature_index_gfflike_get_features_for_seqid,
                                 gt_feature_index_gfflike_get_features_for_range,
+                                NULL,
                                 gt_feature_index_gfflike_get_first_seqid,
                                 gt_feature_index_gfflike_save,
                                 gt_feature_index_gfflike_get_seqids,
@@ -1691,7 +2317,66 @@ const GtFeatureIndexClass* feature_index_gfflike_class(void)
   return fic;
 }
 
-static int prepstmt_init(GtFeatureIndexGFFlike *fis, GtError *err)
+/* (re)prepares the range query, using the R*Tree if <rtree> is true */
+static int prepstmt_range_init(GtFeatureIndexGFFlike *fis, bool rtree,
+                               GtError *err)
+{
+  GtRDBStmt *r;
+  gt_assert(fis);
+  gt_rdb_stmt_delete(fis->stmts[GT_PSTMT_GET_RANGE_SELECT]);
+  if (rtree) {
+    /* the R*Tree stores single precision boxes rounded outwards, so the
+       exact coordinates are checked again on the features table */
+    r = fis->stmts[GT_PSTMT_GET_RANGE_SELECT] = gt_rdb_prepare(fis->db,
+                        "SELECT f.id, s.sequenceregion_name, src.source_name, "
+                        "       t.type_name, f.start, f.end, f.score, "
+                        "       f.strand, f.phase, f.is_multi, "
+                        "       f.multi_representative "
+                        "FROM sequenceregions s "
+                        "     CROSS JOIN features_rtree r "
+                        "     CROSS JOIN features f, "
+                        "     sources src, types t "
+                        "WHERE s.sequenceregion_name = ?1 "
+                        "AND r.seqid_min <= s.sequenceregion_id "
+                        "AND r.seqid_max >= s.sequenceregion_id "
+                        "AND (r.start <= ?2 AND r.end >= ?3) "
+                        "AND f.id = r.id "
+                        "AND s.sequenceregion_id = f.seqid "
+                        "AND (f.start <= ?2 AND f.end >= ?3) "
+                        "AND src.source_id = f.source "
+                        "AND t.type_id = f.type "
+                        "ORDER BY f.id ASC",
+                         3,
+                         err);
+    if (!r) {
+      /* fall back to the plain indexes */
+      gt_error_unset(err);
+      rtree = false;
+    }
+  }
+  if (!rtree) {
+    r = fis->stmts[GT_PSTMT_GET_RANGE_SELECT] = gt_rdb_prepare(fis->db,
+                        "SELECT f.id, s.sequenceregion_name, src.source_name, "
+                        "       t.type_name, f.start, f.end, f.score, "
+                        "       f.strand, f.phase, f.is_multi, "
+                        "       f.multi_representative "
+                        "FROM sequenceregions s, features f, "
+                        "     sources src, types t "
+                        "WHERE s.sequenceregion_name = ?  "
+                        "AND s.sequenceregion_id = f.seqid "
+                        "AND (f.start <= ? AND f.end >= ?) "
+                        "AND src.source_id = f.source "
+                        "AND t.type_id = f.type "
+                        "ORDER BY f.id ASC",
+                         3,
+                         err);
+  }
+  fis->rtree = rtree;
+  return r ? 0 : -1;
+}
+
+static int prepstmt_init(GtFeatureIndexGFFlike *fis, bool rtree,
+                         GtError *err)
 {
   GtRDBStmt *r;
   gt_assert(fis);
@@ -1770,22 +2455,7 @@ static int prepstmt_init(GtFeatureIndexGFFlike *fis, GtError *err)
                          3,
                          err);
   if (!r) return -1;
-  r = fis->stmts[GT_PSTMT_GET_RANGE_SELECT] = gt_rdb_prepare(fis->db,
-                        "SELECT f.id, s.sequenceregion_name, src.source_name, "
-                        "       t.type_name, f.start, f.end, f.score, "
-                        "       f.strand, f.phase, f.is_multi, "
-                        "       f.multi_representative "
-                        "FROM sequenceregions s, features f, "
-                        "     sources src, types t "
-                        "WHERE s.sequenceregion_name = ?  "
-                        "AND s.sequenceregion_id = f.seqid "
-                        "AND (f.start <= ? AND f.end >= ?) "
-                        "AND src.source_id = f.source "
-                        "AND t.type_id = f.type "
-                        "ORDER BY f.id ASC",
-                         3,
-                         err);
-  if (!r) return -1;
+  if (prepstmt_range_init(fis, rtree, err)) return -1;
   r = fis->stmts[GT_PSTMT_GET_ALL] = gt_rdb_prepare(fis->db,
                         "SELECT f.id, s.sequenceregion_name, src.source_name, "
                         "       t.type_name, f.start, f.end, f.score, "
@@ -1800,18 +2470,6 @@ static int prepstmt_init(GtFeatureIndexGFFlike *fis, GtError *err)
                          0,
                          err);
   if (!r) return -1;
-  r = fis->stmts[GT_PSTMT_GET_ATTRIBUTE_SELECT] = gt_rdb_prepare(fis->db,
-                        "SELECT keystr, value FROM attributes "
-                        "WHERE feature_id = ?",
-                         1,
-                         err);
-  if (!r) return -1;
-  r = fis->stmts[GT_PSTMT_GET_PARENTS_SELECT] = gt_rdb_prepare(fis->db,
-                        "SELECT parent FROM parents "
-                        "WHERE feature_id = ?",
-                         1,
-                         err);
-  if (!r) return -1;
   r = fis->stmts[GT_PSTMT_GET_PARENTS_COUNT] = gt_rdb_prepare(fis->db,
                         "SELECT COUNT(parent) FROM parents "
                         "WHERE feature_id = ?",
@@ -1979,7 +2637,7 @@ GtFeatureIndex* anno_db_gfflike_build(GtAnnoDBSchema *schema, GtRDB *db,
     fis->obs->child_added = node_child_add_callback;
     fis->db = gt_rdb_ref(db);
 
-    if (prepstmt_init(fis, err)) {
+    if (prepstmt_init(fis, adg->rtree, err)) {
       gt_feature_index_delete(fi);
       fi = NULL;
     }
@@ -2031,6 +2689,85 @@ GtAnnoDBSchema* gt_anno_db_gfflike_new(void)
   return s;
 }
 
+#ifdef HAVE_SQLITE
+static GtUword anno_db_gfflike_count_rows(GtRDB *rdb, const char *table,
+                                          GtError *err)
+{
+  GtRDBStmt *stmt;
+  GtStr *query;
+  GtUword nof_rows = GT_UNDEF_UWORD;
+  query = gt_str_new_cstr("SELECT COUNT(*) FROM ");
+  gt_str_append_cstr(query, table);
+  stmt = gt_rdb_prepare(rdb, gt_str_get(query), 0, err);
+  if (stmt && gt_rdb_stmt_exec(stmt, err) == 0)
+    (void) gt_rdb_stmt_get_ulong(stmt, 0, &nof_rows, err);
+  gt_rdb_stmt_delete(stmt);
+  gt_str_delete(query);
+  return nof_rows;
+}
+
+/* checks that range queries on a new database use the R*Tree, and that it
+   holds all features after a bulk load */
+static int anno_db_gfflike_rtree_unit_test(GtAnnoDBSchema *adb, GtError *err)
+{
+  GtFeatureIndex *fi = NULL;
+  GtRDB *rdb;
+  GtStr *tmpfilename, *seqid;
+  GtGenomeNode *gn;
+  GtUword i;
+  int had_err = 0;
+  gt_error_check(err);
+
+  tmpfilename = gt_str_new();
+  gt_fa_xfclose(gt_xtmpfp(tmpfilename));
+  seqid = gt_str_new_cstr("rtree");
+  rdb = gt_rdb_sqlite_new(gt_str_get(tmpfilename), err);
+  gt_ensure(rdb != NULL);
+  if (!had_err) {
+    fi = gt_anno_db_schema_get_feature_index(adb, rdb, err);
+    gt_ensure(fi != NULL);
+  }
+  if (!had_err) {
+    gt_ensure(((GtFeatureIndexGFFlike*) feature_index_gfflike_cast(fi))->rtree);
+    gt_ensure(anno_db_gfflike_count_rows(rdb, "features_rtree", err) == 0);
+  }
+  if (!had_err)
+    had_err = gt_feature_index_gfflike_start_bulk_load(fi, 2, err);
+  if (!had_err) {
+    gn = gt_region_node_new(seqid, 1, 1000);
+    had_err = gt_feature_index_add_region_node(fi, (GtRegionNode*) gn, err);
+    gt_genome_node_delete(gn);
+  }
+  for (i = 0; !had_err && i < 5UL; i++) {
+    gn = gt_feature_node_new(seqid, "gene", i * 100 + 1, i * 100 + 50,
+                             GT_STRAND_FORWARD);
+    had_err = gt_feature_index_add_feature_node(fi, (GtFeatureNode*) gn, err);
+    gt_genome_node_delete(gn);
+  }
+  if (!had_err)
+    had_err = gt_feature_index_gfflike_finish_bulk_load(fi, NULL, err);
+  if (!had_err) {
+    gt_ensure(((GtFeatureIndexGFFlike*) feature_index_gfflike_cast(fi))->rtree);
+    gt_ensure(anno_db_gfflike_count_rows(rdb, "features_rtree", err) == 5UL);
+  }
+  if (!had_err) {
+    GtArray *results = gt_array_new(sizeof (GtFeatureNode*));
+    GtRange range = { 101, 250 };
+    had_err = gt_feature_index_get_features_for_range(fi, results, "rtree",
+                                                      &range, err);
+    gt_ensure(gt_array_size(results) == 2UL);
+    gt_array_delete(results);
+  }
+
+  gt_feature_index_delete(fi);
+  gt_rdb_delete(rdb);
+  gt_xremove(gt_str_get(tmpfilename));
+  gt_str_delete(tmpfilename);
+  gt_str_delete(seqid);
+  return had_err;
+}
+#endif
+
 int gt_anno_db_gfflike_unit_test(GtError *err)
 {
   int had_err = 0, status = 0;
@@ -2070,6 +2807,13 @@ int gt_anno_db_gfflike_unit_test(GtError *err)
     gt_ensure(status == 0);
   }
 
+#ifdef HAVE_SQLITE
+  if (!had_err) {
+    status = anno_db_gfflike_rtree_unit_test(adb, testerr);
+    gt_ensure(status == 0);
+  }
+#endif
+
   gt_xremove(gt_str_get(tmpfilename));
   gt_str_delete(tmpfilename);
   gt_feature_index_delete(fi);
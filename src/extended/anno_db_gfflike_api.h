@@ -36,6 +36,26 @@ int             gt_feature_index_gfflike_get_all_features(GtFeatureIndex *gfi,
                                                           GtArray *results,
                                                           GtError *err);
 
+/* Switches <gfi> to bulk loading mode. The secondary indexes of the database
+   are dropped, and subsequently added nodes are written in transactions of at
+   least <batchsize> rows, using multi-row inserts for attributes and parent
+   relations. Transactions are only committed between complete subgraphs.
+   Until <gt_feature_index_gfflike_finish_bulk_load()> is called, queries on
+   <gfi> may not return the nodes added since. Returns 0 on success, a
+   negative value otherwise. The message in <err> is set accordingly. */
+int             gt_feature_index_gfflike_start_bulk_load(GtFeatureIndex *gfi,
+                                                         GtUword batchsize,
+                                                         GtError *err);
+
+/* Commits all nodes added to <gfi> in bulk loading mode and recreates the
+   secondary indexes. If <nof_rows> is not <NULL>, the number of rows written
+   during bulk loading is stored in it. Does nothing if <gfi> is not in bulk
+   loading mode. Returns 0 on success, a negative value otherwise. The message
+   in <err> is set accordingly. */
+int             gt_feature_index_gfflike_finish_bulk_load(GtFeatureIndex *gfi,
+                                                          GtUword *nof_rows,
+                                                          GtError *err);
+
 int             gt_anno_db_gfflike_unit_test(GtError *err);
 
 #endif
@@ -33,8 +33,6 @@ enum GtAnnoDBPreparedStmt {
   GT_PSTMT_ATTRIBUTE_INSERT,
   GT_PSTMT_GET_ALL,
   GT_PSTMT_GET_RANGE_SELECT,
-  GT_PSTMT_GET_ATTRIBUTE_SELECT,
-  GT_PSTMT_GET_PARENTS_SELECT,
   GT_PSTMT_GET_PARENTS_COUNT,
   GT_PSTMT_GET_SEQIDS_SELECT,
   GT_PSTMT_GET_BY_SEQID_SELECT,
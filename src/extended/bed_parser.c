@@ -22,6 +22,7 @@
 #include "core/parseutils.h"
 #include "core/splitter.h"
 #include "core/str.h"
+#include "core/symbol.h"
 #include "extended/bed_parser.h"
 #include "extended/feature_node.h"
 #include "extended/genome_node.h"
@@ -180,7 +181,7 @@ static GtStr* get_seqid(GtBEDParser *bed_parser)
   GtStr *seqid = gt_hashmap_get(bed_parser->seqid_to_str_mapping,
                                 gt_str_get(bed_parser->word));
   if (!seqid) {
-    seqid = gt_str_new_cstr(gt_str_get(bed_parser->word));
+    seqid = gt_symbol_str(gt_str_get(bed_parser->word));
     gt_hashmap_add(bed_parser->seqid_to_str_mapping, gt_str_get(seqid), seqid);
   }
   gt_assert(seqid);
@@ -0,0 +1,67 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef BINARY_FORMAT_H
+#define BINARY_FORMAT_H
+
+/* The binary node format stores a stream of genome nodes compactly, for
+   intermediate files in pipelines of GenomeTools invocations. It is written
+   by the <GtBinaryVisitor> and read by the <GtBinaryParser>.
+
+   A file starts with the <GT_BINARY_MAGIC> bytes followed by a version byte
+   and a sequence of records. Each record starts with a record type byte,
+   see below. Numbers are stored as variable length integers (7 bits per byte,
+   least significant group first, the highest bit marks continuation), signed
+   numbers are zigzag encoded beforehand. Strings which occur often (sequence
+   IDs, sources, types, attribute tags, file names) are stored in a string
+   table built up while reading: a reference is either 0, followed by the
+   length and the characters of a new table entry, or the table index plus 1.
+   Other strings are stored as length and characters.
+
+   A feature record stores a complete feature node graph (including pseudo
+   nodes and nodes with multiple parents): the sequence ID reference and the
+   number of nodes, followed by the nodes in depth-first order. Every node
+   stores its flags (see below), type reference (unless pseudo), source
+   reference (if any), start (as difference to the start of the previous
+   node), length, score (as IEEE float, little endian), the index of its
+   multi-feature representative, its attributes, its origin (file name
+   reference and difference to the previous line number) and the indices of
+   its children.
+   Region, comment, meta, and sequence records store the corresponding
+   contents and the origin (if any). EOF nodes are not stored. */
+
+#define GT_BINARY_MAGIC         "\x89GTNB\r\n\n"
+#define GT_BINARY_MAGIC_LENGTH  8
+#define GT_BINARY_VERSION       1
+
+/* record types */
+#define GT_BINARY_FEATURE       1
+#define GT_BINARY_REGION        2
+#define GT_BINARY_COMMENT       3
+#define GT_BINARY_META          4
+#define GT_BINARY_SEQUENCE      5
+
+/* feature node flags */
+#define GT_BINARY_STRAND_MASK   0x7
+#define GT_BINARY_PHASE_OFFSET  3
+#define GT_BINARY_PHASE_MASK    0x3
+#define GT_BINARY_HAS_SCORE     (1 << 5)
+#define GT_BINARY_IS_PSEUDO     (1 << 6)
+#define GT_BINARY_IS_MULTI      (1 << 7)
+#define GT_BINARY_HAS_SOURCE    (1 << 8)
+#define GT_BINARY_HAS_ORIGIN    (1 << 9)
+
+#endif
@@ -0,0 +1,612 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "core/array.h"
+#include "core/assert_api.h"
+#include "core/ma.h"
+#include "core/str.h"
+#include "core/symbol.h"
+#include "extended/binary_format.h"
+#include "extended/binary_parser.h"
+#include "extended/comment_node_api.h"
+#include "extended/eof_node_api.h"
+#include "extended/feature_node.h"
+#include "extended/genome_node.h"
+#include "extended/meta_node_api.h"
+#include "extended/region_node_api.h"
+#include "extended/sequence_node_api.h"
+
+typedef struct {
+  GtFeatureNode *fn;
+  GtUword representative, /* index + 1, 0 if the node represents itself */
+          firstedge,      /* index of the first edge to a child */
+          nof_children,
+          nof_pending;    /* parents not yet reached in the cycle check */
+  bool is_multi,
+       has_parent;
+} GtBinaryParserNode;
+
+struct GtBinaryParser {
+  unsigned char buf[BUFSIZ];
+  size_t buflen,
+         bufpos;
+  GtArray *strings, /* the string table, contains interned strings */
+          *nodes,
+          *edges,
+          *stack;   /* used for the cycle check */
+  GtStr *strbuf;
+  GtUword prev_start,
+          prev_line;
+  bool header_pending,
+       eof_emitted;
+};
+
+GtBinaryParser* gt_binary_parser_new(void)
+{
+  GtBinaryParser *parser = gt_malloc(sizeof *parser);
+  parser->strings = gt_array_new(sizeof (GtStr*));
+  parser->nodes = gt_array_new(sizeof (GtBinaryParserNode));
+  parser->edges = gt_array_new(sizeof (GtUword));
+  parser->stack = gt_array_new(sizeof (GtUword));
+  parser->strbuf = gt_str_new();
+  gt_binary_parser_reset(parser);
+  return parser;
+}
+
+bool gt_binary_parser_detect(GtFile *fpin)
+{
+  int cc = gt_file_xfgetc(fpin);
+  if (cc == (unsigned char) GT_BINARY_MAGIC[0])
+    return true;
+  if (cc != EOF)
+    gt_file_unget_char(fpin, (char) cc);
+  return false;
+}
+
+static int binary_parser_corrupt(GtStr *filenamestr, GtError *err)
+{
+  gt_error_set(err, "binary file \"%s\" is corrupt", gt_str_get(filenamestr));
+  return -1;
+}
+
+/* returns the next byte or <EOF> */
+static int binary_parser_get_byte(GtBinaryParser *parser, GtFile *fpin)
+{
+  if (parser->bufpos == parser->buflen) {
+    int rval = gt_file_xread(fpin, parser->buf, sizeof (parser->buf));
+    if (rval <= 0)
+      return EOF;
+    parser->buflen = (size_t) rval;
+    parser->bufpos = 0;
+  }
+  return parser->buf[parser->bufpos++];
+}
+
+static int binary_parser_get_uword(GtBinaryParser *parser, GtUword *value,
+                                   GtFile *fpin, GtStr *filenamestr,
+                                   GtError *err)
+{
+  GtUword result = 0;
+  unsigned int shift = 0;
+  int cc;
+  do {
+    if ((cc = binary_parser_get_byte(parser, fpin)) == EOF ||
+        shift >= sizeof (GtUword) * CHAR_BIT) {
+      return binary_parser_corrupt(filenamestr, err);
+    }
+    result |= ((GtUword) (cc & 0x7f)) << shift;
+    shift += 7;
+  } while (cc & 0x80);
+  *value = result;
+  return 0;
+}
+
+static int binary_parser_get_delta(GtBinaryParser *parser, GtUword *value,
+                                   GtUword prev, GtFile *fpin,
+                                   GtStr *filenamestr, GtError *err)
+{
+  GtUword zigzag;
+  if (binary_parser_get_uword(parser, &zigzag, fpin, filenamestr, err))
+    return -1;
+  if (zigzag & 1)
+    *value = prev - ((zigzag + 1) >> 1);
+  else
+    *value = prev + (zigzag >> 1);
+  return 0;
+}
+
+/* reads a string into the string buffer of <parser> */
+static int binary_parser_get_cstr(GtBinaryParser *parser, GtFile *fpin,
+                                  GtStr *filenamestr, GtError *err)
+{
+  GtUword length;
+  gt_str_reset(parser->strbuf);
+  if (binary_parser_get_uword(parser, &length, fpin, filenamestr, err))
+    return -1;
+  while (length) {
+    size_t available;
+    if (parser->bufpos == parser->buflen) {
+      int cc = binary_parser_get_byte(parser, fpin);
+      if (cc == EOF)
+        return binary_parser_corrupt(filenamestr, err);
+      parser->bufpos--;
+    }
+    available = parser->buflen - parser->bufpos;
+    if (available > length)
+      available = length;
+    gt_str_append_cstr_nt(parser->strbuf,
+                          (const char*) parser->buf + parser->bufpos,
+                          available);
+    parser->bufpos += available;
+    length -= available;
+  }
+  return 0;
+}
+
+static GtStr* binary_parser_get_symbol(GtBinaryParser *parser, GtFile *fpin,
+                                       GtStr *filenamestr, GtError *err)
+{
+  GtStr *symbol;
+  GtUword idx;
+  if (binary_parser_get_uword(parser, &idx, fpin, filenamestr, err))
+    return NULL;
+  if (!idx) {
+    if (binary_parser_get_cstr(parser, fpin, filenamestr, err))
+      return NULL;
+    symbol = gt_symbol_str(gt_str_get(parser->strbuf));
+    gt_array_add(parser->strings, symbol);
+    return symbol;
+  }
+  if (idx > gt_array_size(parser->strings)) {
+    binary_parser_corrupt(filenamestr, err);
+    return NULL;
+  }
+  return *(GtStr**) gt_array_get(parser->strings, idx - 1);
+}
+
+static int binary_parser_get_origin(GtBinaryParser *parser, GtGenomeNode *gn,
+                                    GtFile *fpin, GtStr *filenamestr,
+                                    GtError *err)
+{
+  GtStr *filename;
+  GtUword line;
+  if (!(filename = binary_parser_get_symbol(parser, fpin, filenamestr, err)) ||
+      binary_parser_get_delta(parser, &line, parser->prev_line, fpin,
+                              filenamestr, err)) {
+    return -1;
+  }
+  if (!line || line > UINT_MAX)
+    return binary_parser_corrupt(filenamestr, err);
+  gt_genome_node_set_origin(gn, filename, (unsigned int) line);
+  parser->prev_line = line;
+  return 0;
+}
+
+static int binary_parser_get_record_origin(GtBinaryParser *parser,
+                                           GtGenomeNode *gn, GtFile *fpin,
+                                           GtStr *filenamestr, GtError *err)
+{
+  int cc = binary_parser_get_byte(parser, fpin);
+  if (cc == EOF || cc > 1)
+    return binary_parser_corrupt(filenamestr, err);
+  if (cc)
+    return binary_parser_get_origin(parser, gn, fpin, filenamestr, err);
+  return 0;
+}
+
+static int binary_parser_get_range(GtBinaryParser *parser, GtRange *range,
+                                   GtUword prev_start, GtFile *fpin,
+                                   GtStr *filenamestr, GtError *err)
+{
+  GtUword length;
+  if (binary_parser_get_delta(parser, &range->start, prev_start, fpin,
+                              filenamestr, err) ||
+      binary_parser_get_uword(parser, &length, fpin, filenamestr, err)) {
+    return -1;
+  }
+  range->end = range->start + length;
+  if (range->end < range->start)
+    return binary_parser_corrupt(filenamestr, err);
+  return 0;
+}
+
+static GtFeatureNode* binary_parser_get_feature_node(GtBinaryParser *parser,
+                                                     GtStr *seqid,
+                                                     GtUword nof_nodes,
+                                                     GtCstrTable *used_types,
+                                                     GtFile *fpin,
+                                                     GtStr *filenamestr,
+                                                     GtError *err)
+{
+  GtBinaryParserNode node;
+  GtGenomeNode *gn;
+  GtFeatureNode *fn;
+  GtStr *type = NULL, *source = NULL;
+  GtUword flags, representative = 0, nof_attributes, nof_children, i;
+  GtRange range;
+  float score = 0.0;
+  int had_err = 0;
+
+  if (binary_parser_get_uword(parser, &flags, fpin, filenamestr, err))
+    return NULL;
+  if ((flags & GT_BINARY_STRAND_MASK) >= GT_NUM_OF_STRAND_TYPES)
+    had_err = binary_parser_corrupt(filenamestr, err);
+  if (!had_err && !(flags & GT_BINARY_IS_PSEUDO) &&
+      !(type = binary_parser_get_symbol(parser, fpin, filenamestr, err))) {
+    had_err = -1;
+  }
+  if (!had_err && (flags & GT_BINARY_HAS_SOURCE) &&
+      !(source = binary_parser_get_symbol(parser, fpin, filenamestr, err))) {
+    had_err = -1;
+  }
+  if (!had_err) {
+    had_err = binary_parser_get_range(parser, &range, parser->prev_start, fpin,
+                                      filenamestr, err);
+  }
+  if (!had_err && (flags & GT_BINARY_HAS_SCORE)) {
+    uint32_t bits = 0;
+    for (i = 0; !had_err && i < sizeof (bits); i++) {
+      int cc = binary_parser_get_byte(parser, fpin);
+      if (cc == EOF)
+        had_err = binary_parser_corrupt(filenamestr, err);
+      else
+        bits |= ((uint32_t) cc) << (8 * i);
+    }
+    memcpy(&score, &bits, sizeof (score));
+  }
+  if (!had_err && (flags & GT_BINARY_IS_MULTI)) {
+    had_err = binary_parser_get_uword(parser, &representative, fpin,
+                                      filenamestr, err);
+    if (!had_err && representative > nof_nodes)
+      had_err = binary_parser_corrupt(filenamestr, err);
+  }
+  if (had_err)
+    return NULL;
+
+  parser->prev_start = range.start;
+  if (flags & GT_BINARY_IS_PSEUDO) {
+    gn = gt_feature_node_new_pseudo(seqid, range.start, range.end,
+                                    flags & GT_BINARY_STRAND_MASK);
+  }
+  else {
+    gn = gt_feature_node_new(seqid, gt_str_get(type), range.start, range.end,
+                             flags & GT_BINARY_STRAND_MASK);
+    if (!gt_cstr_table_get(used_types, gt_str_get(type)))
+      gt_cstr_table_add(used_types, gt_str_get(type));
+  }
+  fn = gt_feature_node_cast(gn);
+  if (source)
+    gt_feature_node_set_source(fn, source);
+  if (flags & GT_BINARY_HAS_SCORE)
+    gt_feature_node_set_score(fn, score);
+  gt_feature_node_set_phase(fn, (flags >> GT_BINARY_PHASE_OFFSET) &
+                                GT_BINARY_PHASE_MASK);
+  node.fn = fn;
+  node.representative = representative;
+  node.is_multi = flags & GT_BINARY_IS_MULTI ? true : false;
+  node.has_parent = false;
+  gt_array_add(parser->nodes, node);
+
+  had_err = binary_parser_get_uword(parser, &nof_attributes, fpin, filenamestr,
+                                    err);
+  for (i = 0; !had_err && i < nof_attributes; i++) {
+    GtStr *tag;
+    if (!(tag = binary_parser_get_symbol(parser, fpin, filenamestr, err)) ||
+        binary_parser_get_cstr(parser, fpin, filenamestr, err)) {
+      had_err = -1;
+    }
+    else if (!*gt_str_get(tag) || !*gt_str_get(parser->strbuf) ||
+             gt_feature_node_get_attribute(fn, gt_str_get(tag))) {
+      had_err = binary_parser_corrupt(filenamestr, err);
+    }
+    else
+      gt_feature_node_add_attribute(fn, gt_str_get(tag),
+                                    gt_str_get(parser->strbuf));
+  }
+  if (!had_err && (flags & GT_BINARY_HAS_ORIGIN))
+    had_err = binary_parser_get_origin(parser, gn, fpin, filenamestr, err);
+  if (!had_err) {
+    had_err = binary_parser_get_uword(parser, &nof_children, fpin, filenamestr,
+                                      err);
+  }
+  for (i = 0; !had_err && i < nof_children; i++) {
+    GtUword child;
+    had_err = binary_parser_get_uword(parser, &child, fpin, filenamestr, err);
+    /* the root cannot be a child */
+    if (!had_err && (!child || child >= nof_nodes))
+      had_err = binary_parser_corrupt(filenamestr, err);
+    if (!had_err) {
+      GtUword parent = gt_array_size(parser->nodes) - 1;
+      gt_array_add(parser->edges, parent);
+      gt_array_add(parser->edges, child);
+    }
+  }
+  return had_err ? NULL : fn;
+}
+
+/* Returns <true> if the nodes, which all have a parent except the root, form a
+   directed acyclic graph. Nodes are visited from the root on once all of their
+   parents have been visited (Kahn's algorithm), which reaches every node iff
+   there is no cycle. The edges are grouped by parent in ascending order. */
+static bool binary_parser_is_acyclic(GtBinaryParser *parser)
+{
+  GtBinaryParserNode *nodes = gt_array_get_first(parser->nodes);
+  GtUword *edges = gt_array_size(parser->edges)
+                   ? gt_array_get_first(parser->edges) : NULL,
+          nof_nodes = gt_array_size(parser->nodes),
+          nof_edges = gt_array_size(parser->edges),
+          nof_visited = 0,
+          i;
+
+  for (i = 0; i < nof_nodes; i++) {
+    nodes[i].nof_children = 0;
+    nodes[i].nof_pending = 0;
+  }
+  for (i = 0; i < nof_edges; i += 2) {
+    GtBinaryParserNode *parent = nodes + edges[i];
+    if (!parent->nof_children)
+      parent->firstedge = i;
+    parent->nof_children++;
+    nodes[edges[i+1]].nof_pending++;
+  }
+  gt_array_reset(parser->stack);
+  i = 0;
+  gt_array_add(parser->stack, i);
+  while (gt_array_size(parser->stack)) {
+    GtUword node = *(GtUword*) gt_array_pop(parser->stack), e;
+    nof_visited++;
+    for (e = 0; e < nodes[node].nof_children; e++) {
+      GtUword child = edges[nodes[node].firstedge + 2 * e + 1];
+      if (--nodes[child].nof_pending == 0)
+        gt_array_add(parser->stack, child);
+    }
+  }
+  return nof_visited == nof_nodes;
+}
+
+static int binary_parser_link_nodes(GtBinaryParser *parser,
+                                    GtStr *filenamestr, GtError *err)
+{
+  GtBinaryParserNode *nodes = gt_array_get_first(parser->nodes);
+  GtUword *edges = gt_array_size(parser->edges)
+                   ? gt_array_get_first(parser->edges) : NULL,
+          nof_nodes = gt_array_size(parser->nodes),
+          nof_edges = gt_array_size(parser->edges),
+          i;
+
+  /* make sure that every node except the root has a parent which comes before
+     it (i.e., it is reachable from the root) and that pseudo nodes are neither
+     children nor representatives */
+  for (i = 0; i < nof_edges; i += 2) {
+    GtUword parent = edges[i], child = edges[i+1];
+    if (gt_feature_node_is_pseudo(nodes[child].fn) ||
+        (!nodes[child].has_parent && parent >= child)) {
+      return binary_parser_corrupt(filenamestr, err);
+    }
+    nodes[child].has_parent = true;
+  }
+  for (i = 0; i < nof_nodes; i++) {
+    GtUword rep = nodes[i].representative;
+    if ((i && !nodes[i].has_parent) ||
+        (rep && gt_feature_node_is_pseudo(nodes[rep-1].fn))) {
+      return binary_parser_corrupt(filenamestr, err);
+    }
+    nodes[i].has_parent = false;
+  }
+  /* further parents must not be descendants of a node */
+  if (!binary_parser_is_acyclic(parser))
+    return binary_parser_corrupt(filenamestr, err);
+
+  /* the graph is valid, build it */
+  for (i = 0; i < nof_edges; i += 2) {
+    GtBinaryParserNode *child = nodes + edges[i+1];
+    if (child->has_parent) /* multiple parents, see gff3_parser.c */
+      gt_genome_node_ref((GtGenomeNode*) child->fn);
+    gt_feature_node_add_child(nodes[edges[i]].fn, child->fn);
+    child->has_parent = true;
+  }
+  for (i = 0; i < nof_nodes; i++) {
+    GtUword rep = nodes[i].representative;
+    if (nodes[i].is_multi && (!rep || rep == i + 1))
+      gt_feature_node_make_multi_representative(nodes[i].fn);
+  }
+  for (i = 0; i < nof_nodes; i++) {
+    GtUword rep = nodes[i].representative;
+    if (nodes[i].is_multi && rep && rep != i + 1) {
+      if (!gt_feature_node_is_multi(nodes[rep-1].fn))
+        gt_feature_node_make_multi_representative(nodes[rep-1].fn);
+      gt_feature_node_set_multi_representative(nodes[i].fn, nodes[rep-1].fn);
+    }
+  }
+  return 0;
+}
+
+static int binary_parser_parse_feature(GtBinaryParser *parser,
+                                       GtQueue *genome_nodes,
+                                       GtCstrTable *used_types, GtFile *fpin,
+                                       GtStr *filenamestr, GtError *err)
+{
+  GtStr *seqid;
+  GtUword nof_nodes, i;
+  int had_err = 0;
+  if (!(seqid = binary_parser_get_symbol(parser, fpin, filenamestr, err)) ||
+      binary_parser_get_uword(parser, &nof_nodes, fpin, filenamestr, err)) {
+    return -1;
+  }
+  if (!nof_nodes)
+    return binary_parser_corrupt(filenamestr, err);
+  gt_array_reset(parser->nodes);
+  gt_array_reset(parser->edges);
+  for (i = 0; !had_err && i < nof_nodes; i++) {
+    if (!binary_parser_get_feature_node(parser, seqid, nof_nodes, used_types,
+                                        fpin, filenamestr, err)) {
+      had_err = -1;
+    }
+  }
+  if (!had_err)
+    had_err = binary_parser_link_nodes(parser, filenamestr, err);
+  if (!had_err) {
+    gt_queue_add(genome_nodes, ((GtBinaryParserNode*)
+                                gt_array_get(parser->nodes, 0))->fn);
+  }
+  else {
+    /* the nodes have not been linked */
+    for (i = 0; i < gt_array_size(parser->nodes); i++) {
+      gt_genome_node_delete((GtGenomeNode*) ((GtBinaryParserNode*)
+                                             gt_array_get(parser->nodes, i))
+                                            ->fn);
+    }
+  }
+  return had_err;
+}
+
+static int binary_parser_read_header(GtBinaryParser *parser, GtFile *fpin,
+                                     GtStr *filenamestr, GtError *err)
+{
+  unsigned int i;
+  int cc;
+  /* the first byte has been consumed by gt_binary_parser_detect() */
+  for (i = 1; i < GT_BINARY_MAGIC_LENGTH; i++) {
+    if (binary_parser_get_byte(parser, fpin) !=
+        (unsigned char) GT_BINARY_MAGIC[i]) {
+      return binary_parser_corrupt(filenamestr, err);
+    }
+  }
+  if ((cc = binary_parser_get_byte(parser, fpin)) != GT_BINARY_VERSION) {
+    if (cc == EOF)
+      return binary_parser_corrupt(filenamestr, err);
+    gt_error_set(err, "binary file \"%s\" has unsupported format version %d",
+                 gt_str_get(filenamestr), cc);
+    return -1;
+  }
+  parser->header_pending = false;
+  return 0;
+}
+
+int gt_binary_parser_parse_genome_nodes(GtBinaryParser *parser,
+                                        int *status_code,
+                                        GtQueue *genome_nodes,
+                                        GtCstrTable *used_types,
+                                        GtStr *filenamestr, GtFile *fpin,
+                                        GtError *err)
+{
+  GtGenomeNode *gn = NULL;
+  GtRange range;
+  GtStr *str;
+  int had_err = 0, cc;
+  gt_error_check(err);
+  gt_assert(parser && status_code && genome_nodes && used_types);
+
+  if (parser->header_pending)
+    had_err = binary_parser_read_header(parser, fpin, filenamestr, err);
+  if (!had_err) {
+    switch ((cc = binary_parser_get_byte(parser, fpin))) {
+      case EOF:
+        if (!parser->eof_emitted) {
+          gn = gt_eof_node_new();
+          gt_genome_node_set_origin(gn, filenamestr, 1);
+          parser->eof_emitted = true;
+        }
+        break;
+      case GT_BINARY_FEATURE:
+        had_err = binary_parser_parse_feature(parser, genome_nodes, used_types,
+                                              fpin, filenamestr, err);
+        break;
+      case GT_BINARY_REGION:
+        if (!(str = binary_parser_get_symbol(parser, fpin, filenamestr, err)) ||
+            binary_parser_get_uword(parser, &range.start, fpin, filenamestr,
+                                    err) ||
+            binary_parser_get_uword(parser, &range.end, fpin, filenamestr,
+                                    err)) {
+          had_err = -1;
+        }
+        else if ((range.end += range.start) < range.start)
+          had_err = binary_parser_corrupt(filenamestr, err);
+        else
+          gn = gt_region_node_new(str, range.start, range.end);
+        break;
+      case GT_BINARY_COMMENT:
+        if (!(had_err = binary_parser_get_cstr(parser, fpin, filenamestr, err)))
+          gn = gt_comment_node_new(gt_str_get(parser->strbuf));
+        break;
+      case GT_BINARY_META:
+        if (!(str = binary_parser_get_symbol(parser, fpin, filenamestr, err)) ||
+            binary_parser_get_cstr(parser, fpin, filenamestr, err)) {
+          had_err = -1;
+        }
+        else
+          gn = gt_meta_node_new(gt_str_get(str), gt_str_get(parser->strbuf));
+        break;
+      case GT_BINARY_SEQUENCE:
+        if (!(had_err = binary_parser_get_cstr(parser, fpin, filenamestr,
+                                               err))) {
+          str = gt_str_clone(parser->strbuf); /* the description */
+          if (!(had_err = binary_parser_get_cstr(parser, fpin, filenamestr,
+                                                 err))) {
+            GtStr *sequence = gt_str_clone(parser->strbuf);
+            gn = gt_sequence_node_new(gt_str_get(str), sequence);
+            gt_str_delete(sequence);
+          }
+          gt_str_delete(str);
+        }
+        break;
+      default:
+        had_err = binary_parser_corrupt(filenamestr, err);
+    }
+  }
+  if (!had_err && gn && cc != EOF) {
+    had_err = binary_parser_get_record_origin(parser, gn, fpin, filenamestr,
+                                              err);
+  }
+  if (had_err) {
+    gt_genome_node_delete(gn);
+    while (gt_queue_size(genome_nodes))
+      gt_genome_node_delete(gt_queue_get(genome_nodes));
+  }
+  else if (gn)
+    gt_queue_add(genome_nodes, gn);
+  if (gt_queue_size(genome_nodes))
+    *status_code = 0; /* at least one node is available */
+  else
+    *status_code = EOF;
+  return had_err;
+}
+
+void gt_binary_parser_reset(GtBinaryParser *parser)
+{
+  gt_assert(parser);
+  parser->buflen = parser->bufpos = 0;
+  gt_array_reset(parser->strings);
+  parser->prev_start = 0;
+  parser->prev_line = 0;
+  parser->header_pending = true;
+  parser->eof_emitted = false;
+}
+
+void gt_binary_parser_delete(GtBinaryParser *parser)
+{
+  if (!parser) return;
+  gt_array_delete(parser->strings);
+  gt_array_delete(parser->nodes);
+  gt_array_delete(parser->edges);
+  gt_array_delete(parser->stack);
+  gt_str_delete(parser->strbuf);
+  gt_free(parser);
+}
@@ -0,0 +1,52 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef BINARY_PARSER_H
+#define BINARY_PARSER_H
+
+#include "core/cstr_table.h"
+#include "core/error_api.h"
+#include "core/file.h"
+#include "core/queue.h"
+
+/* A <GtBinaryParser> reads genome nodes stored in the binary node format (see
+   binary_format.h). The nodes are not validated, they are recreated exactly as
+   they have been written by the <GtBinaryVisitor>, including their origin. */
+typedef struct GtBinaryParser GtBinaryParser;
+
+GtBinaryParser* gt_binary_parser_new(void);
+/* Return <true> if <fpin> starts with the binary node format magic. If so, the
+   first byte of <fpin> has been consumed and the file can be parsed with
+   <gt_binary_parser_parse_genome_nodes()>. Otherwise, <fpin> is unchanged. */
+bool            gt_binary_parser_detect(GtFile *fpin);
+/* Read the next record from <fpin> (with name <filenamestr>) and add the
+   resulting genome nodes to <genome_nodes>. An EOF node is added after the
+   last record. The types of the feature nodes are added to <used_types>.
+   <status_code> is set to <EOF> if <genome_nodes> is empty afterwards and to 0
+   otherwise.
+   Returns -1 and sets <err> if the file is corrupt. */
+int             gt_binary_parser_parse_genome_nodes(GtBinaryParser*,
+                                                    int *status_code,
+                                                    GtQueue *genome_nodes,
+                                                    GtCstrTable *used_types,
+                                                    GtStr *filenamestr,
+                                                    GtFile *fpin,
+                                                    GtError *err);
+/* Reset the parser to read a new file. */
+void            gt_binary_parser_reset(GtBinaryParser*);
+void            gt_binary_parser_delete(GtBinaryParser*);
+
+#endif
@@ -0,0 +1,398 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "core/array.h"
+#include "core/assert_api.h"
+#include "core/class_alloc_lock.h"
+#include "core/cstr_api.h"
+#include "core/hashmap.h"
+#include "core/ma.h"
+#include "core/str.h"
+#include "core/unused_api.h"
+#include "extended/binary_format.h"
+#include "extended/binary_visitor.h"
+#include "extended/comment_node_api.h"
+#include "extended/feature_node.h"
+#include "extended/feature_node_iterator_api.h"
+#include "extended/genome_node.h"
+#include "extended/meta_node_api.h"
+#include "extended/node_visitor_api.h"
+#include "extended/region_node_api.h"
+#include "extended/sequence_node_api.h"
+
+/* the output buffer is written when it exceeds this size */
+#define BINARY_VISITOR_FLUSH_SIZE  65536
+
+struct GtBinaryVisitor {
+  const GtNodeVisitor parent_instance;
+  GtFile *outfp;
+  GtStr *outbuf;
+  GtHashmap *string_table;        /* maps strings to their index + 1 */
+  GtUword nof_strings,
+          prev_start,
+          prev_line;
+  GtHashmap *node_to_index;       /* used for each feature node graph */
+  GtArray *nodes;
+};
+
+#define binary_visitor_cast(NV)\
+        gt_node_visitor_cast(gt_binary_visitor_class(), NV)
+
+static void binary_visitor_put_uword(GtStr *outbuf, GtUword value)
+{
+  while (value >= 0x80) {
+    gt_str_append_char(outbuf, (char) ((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  gt_str_append_char(outbuf, (char) value);
+}
+
+/* zigzag encoding of the difference <value> - <prev> */
+static void binary_visitor_put_delta(GtStr *outbuf, GtUword value,
+                                     GtUword prev)
+{
+  if (value >= prev)
+    binary_visitor_put_uword(outbuf, (value - prev) << 1);
+  else
+    binary_visitor_put_uword(outbuf, ((prev - value) << 1) - 1);
+}
+
+static void binary_visitor_put_cstr(GtStr *outbuf, const char *cstr)
+{
+  GtUword length = strlen(cstr);
+  binary_visitor_put_uword(outbuf, length);
+  gt_str_append_cstr_nt(outbuf, cstr, length);
+}
+
+static void binary_visitor_put_symbol(GtBinaryVisitor *bv, const char *cstr)
+{
+  GtUword idx = (GtUword) gt_hashmap_get(bv->string_table, cstr);
+  if (idx)
+    binary_visitor_put_uword(bv->outbuf, idx);
+  else {
+    binary_visitor_put_uword(bv->outbuf, 0);
+    binary_visitor_put_cstr(bv->outbuf, cstr);
+    gt_hashmap_add(bv->string_table, gt_cstr_dup(cstr),
+                   (void*) ++bv->nof_strings);
+  }
+}
+
+static void binary_visitor_put_origin(GtBinaryVisitor *bv, GtGenomeNode *gn)
+{
+  GtUword line = gt_genome_node_get_line_number(gn);
+  binary_visitor_put_symbol(bv, gt_genome_node_get_filename(gn));
+  binary_visitor_put_delta(bv->outbuf, line, bv->prev_line);
+  bv->prev_line = line;
+}
+
+/* nodes without origin are reported as "generated" */
+static bool binary_visitor_has_origin(GtGenomeNode *gn)
+{
+  return gt_genome_node_get_line_number(gn) != 0;
+}
+
+static void binary_visitor_put_record_origin(GtBinaryVisitor *bv,
+                                             GtGenomeNode *gn)
+{
+  if (binary_visitor_has_origin(gn)) {
+    gt_str_append_char(bv->outbuf, 1);
+    binary_visitor_put_origin(bv, gn);
+  }
+  else
+    gt_str_append_char(bv->outbuf, 0);
+}
+
+static void binary_visitor_flush(GtBinaryVisitor *bv)
+{
+  if (gt_str_length(bv->outbuf)) {
+    gt_file_xwrite(bv->outfp, gt_str_get_mem(bv->outbuf),
+                   gt_str_length(bv->outbuf));
+    gt_str_reset(bv->outbuf);
+  }
+}
+
+static void binary_visitor_start_record(GtBinaryVisitor *bv, char type)
+{
+  gt_str_append_char(bv->outbuf, type);
+}
+
+static void binary_visitor_end_record(GtBinaryVisitor *bv)
+{
+  if (gt_str_length(bv->outbuf) >= BINARY_VISITOR_FLUSH_SIZE)
+    binary_visitor_flush(bv);
+}
+
+static void binary_visitor_free(GtNodeVisitor *nv)
+{
+  GtBinaryVisitor *bv = binary_visitor_cast(nv);
+  binary_visitor_flush(bv);
+  gt_str_delete(bv->outbuf);
+  gt_hashmap_delete(bv->string_table);
+  gt_hashmap_delete(bv->node_to_index);
+  gt_array_delete(bv->nodes);
+}
+
+/* number the nodes of the graph below <fn> in depth-first order, nodes with
+   multiple parents are numbered only once */
+static void binary_visitor_number_nodes(GtBinaryVisitor *bv,
+                                        GtFeatureNode *fn)
+{
+  GtFeatureNodeIterator *fni;
+  GtFeatureNode *child;
+  gt_array_add(bv->nodes, fn);
+  gt_hashmap_add(bv->node_to_index, fn,
+                 (void*) gt_array_size(bv->nodes));
+  fni = gt_feature_node_iterator_new_direct(fn);
+  while ((child = gt_feature_node_iterator_next(fni))) {
+    if (!gt_hashmap_get(bv->node_to_index, child))
+      binary_visitor_number_nodes(bv, child);
+  }
+  gt_feature_node_iterator_delete(fni);
+}
+
+static void binary_visitor_count_attribute(GT_UNUSED const char *tag,
+                                           GT_UNUSED const char *value,
+                                           void *data)
+{
+  GtUword *nof_attributes = data;
+  (*nof_attributes)++;
+}
+
+static void binary_visitor_put_attribute(const char *tag, const char *value,
+                                         void *data)
+{
+  GtBinaryVisitor *bv = data;
+  binary_visitor_put_symbol(bv, tag);
+  binary_visitor_put_cstr(bv->outbuf, value);
+}
+
+static void binary_visitor_put_feature_node(GtBinaryVisitor *bv,
+                                            GtFeatureNode *fn)
+{
+  GtGenomeNode *gn = (GtGenomeNode*) fn;
+  GtFeatureNodeIterator *fni;
+  GtFeatureNode *child;
+  GtRange range;
+  GtUword flags, nof_attributes, i;
+
+  flags = (GtUword) gt_feature_node_get_strand(fn) |
+          ((GtUword) gt_feature_node_get_phase(fn) << GT_BINARY_PHASE_OFFSET);
+  if (gt_feature_node_score_is_defined(fn))
+    flags |= GT_BINARY_HAS_SCORE;
+  if (gt_feature_node_is_pseudo(fn))
+    flags |= GT_BINARY_IS_PSEUDO;
+  else if (gt_feature_node_is_multi(fn))
+    flags |= GT_BINARY_IS_MULTI;
+  if (gt_feature_node_has_source(fn))
+    flags |= GT_BINARY_HAS_SOURCE;
+  if (binary_visitor_has_origin(gn))
+    flags |= GT_BINARY_HAS_ORIGIN;
+  binary_visitor_put_uword(bv->outbuf, flags);
+
+  if (!(flags & GT_BINARY_IS_PSEUDO))
+    binary_visitor_put_symbol(bv, gt_feature_node_get_type(fn));
+  if (flags & GT_BINARY_HAS_SOURCE)
+    binary_visitor_put_symbol(bv, gt_feature_node_get_source(fn));
+  range = gt_genome_node_get_range(gn);
+  binary_visitor_put_delta(bv->outbuf, range.start, bv->prev_start);
+  binary_visitor_put_uword(bv->outbuf, range.end - range.start);
+  bv->prev_start = range.start;
+  if (flags & GT_BINARY_HAS_SCORE) {
+    float score = gt_feature_node_get_score(fn);
+    uint32_t bits;
+    gt_assert(sizeof (score) == sizeof (bits));
+    memcpy(&bits, &score, sizeof (bits));
+    for (i = 0; i < sizeof (bits); i++)
+      gt_str_append_char(bv->outbuf, (char) ((bits >> (8 * i)) & 0xff));
+  }
+  if (flags & GT_BINARY_IS_MULTI) {
+    GtFeatureNode *rep = gt_feature_node_get_multi_representative(fn);
+    /* the representative is part of this graph, see
+       binary_visitor_check_representatives() */
+    binary_visitor_put_uword(bv->outbuf,
+                             (GtUword) gt_hashmap_get(bv->node_to_index, rep));
+  }
+
+  /* the attributes are few, count them first */
+  nof_attributes = 0;
+  gt_feature_node_foreach_attribute(fn, binary_visitor_count_attribute,
+                                    &nof_attributes);
+  binary_visitor_put_uword(bv->outbuf, nof_attributes);
+  gt_feature_node_foreach_attribute(fn, binary_visitor_put_attribute, bv);
+
+  if (flags & GT_BINARY_HAS_ORIGIN)
+    binary_visitor_put_origin(bv, gn);
+
+  binary_visitor_put_uword(bv->outbuf, gt_feature_node_number_of_children(fn));
+  fni = gt_feature_node_iterator_new_direct(fn);
+  while ((child = gt_feature_node_iterator_next(fni))) {
+    binary_visitor_put_uword(bv->outbuf,
+                             (GtUword) gt_hashmap_get(bv->node_to_index,
+                                                      child) - 1);
+  }
+  gt_feature_node_iterator_delete(fni);
+}
+
+/* the format only stores representatives by their index in the graph */
+static int binary_visitor_check_representatives(GtBinaryVisitor *bv,
+                                                GtError *err)
+{
+  GtUword i;
+  gt_error_check(err);
+  for (i = 0; i < gt_array_size(bv->nodes); i++) {
+    GtFeatureNode *fn = *(GtFeatureNode**) gt_array_get(bv->nodes, i);
+    GtGenomeNode *gn = (GtGenomeNode*) fn;
+    if (gt_feature_node_is_multi(fn) &&
+        !gt_hashmap_get(bv->node_to_index,
+                        gt_feature_node_get_multi_representative(fn))) {
+      gt_error_set(err, "the multi-feature representative of the %s feature "
+                   "on line %u in file \"%s\" is not part of its feature "
+                   "graph, which cannot be stored in binary format",
+                   gt_feature_node_get_type(fn),
+                   gt_genome_node_get_line_number(gn),
+                   gt_genome_node_get_filename(gn));
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int binary_visitor_feature_node(GtNodeVisitor *nv, GtFeatureNode *fn,
+                                       GtError *err)
+{
+  GtBinaryVisitor *bv;
+  GtUword i;
+  gt_error_check(err);
+  bv = binary_visitor_cast(nv);
+  binary_visitor_number_nodes(bv, fn);
+  if (binary_visitor_check_representatives(bv, err)) {
+    gt_hashmap_reset(bv->node_to_index);
+    gt_array_reset(bv->nodes);
+    return -1;
+  }
+  binary_visitor_start_record(bv, GT_BINARY_FEATURE);
+  binary_visitor_put_symbol(bv, gt_str_get(gt_genome_node_get_seqid(
+                                                         (GtGenomeNode*) fn)));
+  binary_visitor_put_uword(bv->outbuf, gt_array_size(bv->nodes));
+  for (i = 0; i < gt_array_size(bv->nodes); i++) {
+    binary_visitor_put_feature_node(bv, *(GtFeatureNode**)
+                                        gt_array_get(bv->nodes, i));
+  }
+  binary_visitor_end_record(bv);
+  gt_hashmap_reset(bv->node_to_index);
+  gt_array_reset(bv->nodes);
+  return 0;
+}
+
+static int binary_visitor_region_node(GtNodeVisitor *nv, GtRegionNode *rn,
+                                      GT_UNUSED GtError *err)
+{
+  GtBinaryVisitor *bv;
+  GtGenomeNode *gn = (GtGenomeNode*) rn;
+  GtRange range;
+  gt_error_check(err);
+  bv = binary_visitor_cast(nv);
+  binary_visitor_start_record(bv, GT_BINARY_REGION);
+  binary_visitor_put_symbol(bv, gt_str_get(gt_genome_node_get_seqid(gn)));
+  range = gt_genome_node_get_range(gn);
+  binary_visitor_put_uword(bv->outbuf, range.start);
+  binary_visitor_put_uword(bv->outbuf, range.end - range.start);
+  binary_visitor_put_record_origin(bv, gn);
+  binary_visitor_end_record(bv);
+  return 0;
+}
+
+static int binary_visitor_comment_node(GtNodeVisitor *nv, GtCommentNode *cn,
+                                       GT_UNUSED GtError *err)
+{
+  GtBinaryVisitor *bv;
+  gt_error_check(err);
+  bv = binary_visitor_cast(nv);
+  binary_visitor_start_record(bv, GT_BINARY_COMMENT);
+  binary_visitor_put_cstr(bv->outbuf, gt_comment_node_get_comment(cn));
+  binary_visitor_put_record_origin(bv, (GtGenomeNode*) cn);
+  binary_visitor_end_record(bv);
+  return 0;
+}
+
+static int binary_visitor_meta_node(GtNodeVisitor *nv, GtMetaNode *mn,
+                                    GT_UNUSED GtError *err)
+{
+  GtBinaryVisitor *bv;
+  gt_error_check(err);
+  bv = binary_visitor_cast(nv);
+  binary_visitor_start_record(bv, GT_BINARY_META);
+  binary_visitor_put_symbol(bv, gt_meta_node_get_directive(mn));
+  binary_visitor_put_cstr(bv->outbuf, gt_meta_node_get_data(mn));
+  binary_visitor_put_record_origin(bv, (GtGenomeNode*) mn);
+  binary_visitor_end_record(bv);
+  return 0;
+}
+
+static int binary_visitor_sequence_node(GtNodeVisitor *nv, GtSequenceNode *sn,
+                                        GT_UNUSED GtError *err)
+{
+  GtBinaryVisitor *bv;
+  GtUword length;
+  gt_error_check(err);
+  bv = binary_visitor_cast(nv);
+  binary_visitor_start_record(bv, GT_BINARY_SEQUENCE);
+  binary_visitor_put_cstr(bv->outbuf, gt_sequence_node_get_description(sn));
+  length = gt_sequence_node_get_sequence_length(sn);
+  binary_visitor_put_uword(bv->outbuf, length);
+  gt_str_append_cstr_nt(bv->outbuf, gt_sequence_node_get_sequence(sn), length);
+  binary_visitor_put_record_origin(bv, (GtGenomeNode*) sn);
+  binary_visitor_end_record(bv);
+  return 0;
+}
+
+const GtNodeVisitorClass* gt_binary_visitor_class(void)
+{
+  static GtNodeVisitorClass *nvc = NULL;
+  gt_class_alloc_lock_enter();
+  if (!nvc) {
+    nvc = gt_node_visitor_class_new(sizeof (GtBinaryVisitor),
+                                    binary_visitor_free,
+                                    binary_visitor_comment_node,
+                                    binary_visitor_feature_node,
+                                    binary_visitor_region_node,
+                                    binary_visitor_sequence_node,
+                                    NULL);
+    gt_node_visitor_class_set_meta_node_func(nvc, binary_visitor_meta_node);
+  }
+  gt_class_alloc_lock_leave();
+  return nvc;
+}
+
+GtNodeVisitor* gt_binary_visitor_new(GtFile *outfp)
+{
+  GtNodeVisitor *nv = gt_node_visitor_create(gt_binary_visitor_class());
+  GtBinaryVisitor *bv = binary_visitor_cast(nv);
+  bv->outfp = outfp;
+  bv->outbuf = gt_str_new();
+  /* written even if no node is visited, to produce a valid empty file */
+  gt_str_append_cstr_nt(bv->outbuf, GT_BINARY_MAGIC, GT_BINARY_MAGIC_LENGTH);
+  gt_str_append_char(bv->outbuf, GT_BINARY_VERSION);
+  bv->string_table = gt_hashmap_new(GT_HASH_STRING, gt_free_func, NULL);
+  bv->nof_strings = 0;
+  bv->prev_start = 0;
+  bv->prev_line = 0;
+  bv->node_to_index = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  bv->nodes = gt_array_new(sizeof (GtFeatureNode*));
+  return nv;
+}
@@ -0,0 +1,34 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef BINARY_VISITOR_H
+#define BINARY_VISITOR_H
+
+#include "core/file_api.h"
+#include "extended/node_visitor_api.h"
+
+/* Implements the <GtNodeVisitor> interface with a visitor that writes the
+   visited nodes in the binary node format (see binary_format.h). Normally, a
+   <GtBinaryOutStream> is used to produce binary output. */
+typedef struct GtBinaryVisitor GtBinaryVisitor;
+
+const GtNodeVisitorClass* gt_binary_visitor_class(void);
+/* Create a new <GtNodeVisitor*> which writes the binary representation of the
+   visited nodes to <outfp> (<stdout> if <outfp> is <NULL>). The output is
+   buffered and completely written when the visitor is deleted. */
+GtNodeVisitor*            gt_binary_visitor_new(GtFile *outfp);
+
+#endif
@@ -51,6 +51,14 @@ void gt_evaluator_add_predicted(GtEvaluator *evaluator, GtUword inc)
   evaluator->P += inc;
 }
 
+void gt_evaluator_add(GtEvaluator *dest, const GtEvaluator *src)
+{
+  gt_assert(dest && src);
+  dest->T += src->T;
+  dest->A += src->A;
+  dest->P += src->P;
+}
+
 double gt_evaluator_get_sensitivity(const GtEvaluator *evaluator)
 {
   double sensitivity = 1.0;
@@ -154,6 +162,16 @@ int gt_evaluator_unit_test(GtError *err)
   gt_ensure(gt_evaluator_get_sensitivity(evaluator) == 1.0);
   gt_ensure(gt_evaluator_get_specificity(evaluator) == 1.0);
 
+  if (!had_err) {
+    GtEvaluator *other = gt_evaluator_new();
+    gt_evaluator_add_actual(other, 4);
+    gt_evaluator_add_predicted(other, 12);
+    gt_evaluator_add(other, evaluator);
+    gt_ensure(gt_evaluator_get_sensitivity(other) == 0.5);
+    gt_ensure(gt_evaluator_get_specificity(other) == 0.25);
+    gt_evaluator_delete(other);
+  }
+
   gt_evaluator_delete(evaluator);
 
   return had_err;
@@ -27,6 +27,8 @@ GtEvaluator* gt_evaluator_new(void);
 void         gt_evaluator_add_true(GtEvaluator*);
 void         gt_evaluator_add_actual(GtEvaluator*, GtUword);
 void         gt_evaluator_add_predicted(GtEvaluator*, GtUword);
+/* add the true, actual, and predicted counts of <src> to <dest> */
+void         gt_evaluator_add(GtEvaluator *dest, const GtEvaluator *src);
 double       gt_evaluator_get_sensitivity(const GtEvaluator*);
 double       gt_evaluator_get_specificity(const GtEvaluator*);
 void         gt_evaluator_show_sensitivity(const GtEvaluator*, GtFile*);
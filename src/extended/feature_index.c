@@ -21,6 +21,7 @@
 #include "core/array.h"
 #include "core/ensure.h"
 #include "core/ma.h"
+#include "core/minmax.h"
 #include "core/multithread_api.h"
 #include "core/unused_api.h"
 #include "core/yarandom.h"
@@ -40,6 +41,7 @@ struct GtFeatureIndexClass {
   GtFeatureIndexRemoveNodeFunc remove_node;
   GtFeatureIndexGetFeatsForSeqidFunc get_features_for_seqid;
   GtFeatureIndexGetFeatsForRangeFunc get_features_for_range;
+  GtFeatureIndexGetCountsForRangeFunc get_counts_for_range;
   GtFeatureIndexGetFirstSeqidFunc get_first_seqid;
   GtFeatureIndexSaveFunc save_func;
   GtFeatureIndexGetSeqidsFunc get_seqids;
@@ -65,6 +67,8 @@ const GtFeatureIndexClass* gt_feature_index_class_new(size_t size,
                                                  get_features_for_seqid,
                                          GtFeatureIndexGetFeatsForRangeFunc
                                                  get_features_for_range,
+                                         GtFeatureIndexGetCountsForRangeFunc
+                                                 get_counts_for_range,
                                          GtFeatureIndexGetFirstSeqidFunc
                                                  get_first_seqid,
                                          GtFeatureIndexSaveFunc
@@ -87,6 +91,7 @@ const GtFeatureIndexClass* gt_feature_index_class_new(size_t size,
   c_class->remove_node = remove_node;
   c_class->get_features_for_seqid = get_features_for_seqid;
   c_class->get_features_for_range = get_features_for_range;
+  c_class->get_counts_for_range = get_counts_for_range;
   c_class->get_first_seqid = get_first_seqid;
   c_class->save_func = save_func;
   c_class->get_seqids = get_seqids;
@@ -231,6 +236,61 @@ int gt_feature_index_get_features_for_range(GtFeatureIndex *feature_index,
   return ret;
 }
 
+void gt_feature_index_bin_features(GtArray *features, GtUword *counts,
+                                   GtUword nof_bins, const GtRange *range)
+{
+  GtUword i, first, last;
+  double binlen;
+  gt_assert(features && counts && nof_bins > 0 && range);
+  binlen = (double) gt_range_length(range) / nof_bins;
+  /* mark start and end of each feature, then sum up */
+  for (i = 0; i < gt_array_size(features); i++) {
+    GtRange rng = gt_genome_node_get_range(*(GtGenomeNode**)
+                                                 gt_array_get(features, i));
+    if (!gt_range_overlap(&rng, range))
+      continue;
+    first = (GtUword) ((MAX(rng.start, range->start) - range->start) / binlen);
+    last = (GtUword) ((MIN(rng.end, range->end) - range->start) / binlen);
+    counts[MIN(first, nof_bins - 1)]++;
+    if (last + 1 < nof_bins)
+      counts[last + 1]--;
+  }
+  for (i = 1; i < nof_bins; i++)
+    counts[i] += counts[i-1];
+}
+
+int gt_feature_index_get_feature_counts_for_range(GtFeatureIndex
+                                                                *feature_index,
+                                                  GtUword *counts,
+                                                  GtUword nof_bins,
+                                                  const char *seqid,
+                                                  const GtRange *range,
+                                                  GtError *err)
+{
+  int ret = 0;
+  gt_assert(feature_index && feature_index->c_class && counts && nof_bins > 0
+              && seqid && range);
+  gt_assert(gt_range_length(range) > 0);
+  memset(counts, 0, nof_bins * sizeof (GtUword));
+  gt_rwlock_rdlock(feature_index->pvt->lock);
+  if (feature_index->c_class->get_counts_for_range) {
+    ret = feature_index->c_class->get_counts_for_range(feature_index, counts,
+                                                       nof_bins, seqid, range,
+                                                       err);
+  } else {
+    /* no precomputed counts available, count the features themselves */
+    GtArray *features = gt_array_new(sizeof (GtGenomeNode*));
+    ret = feature_index->c_class->get_features_for_range(feature_index,
+                                                         features, seqid,
+                                                         range, err);
+    if (!ret)
+      gt_feature_index_bin_features(features, counts, nof_bins, range);
+    gt_array_delete(features);
+  }
+  gt_rwlock_unlock(feature_index->pvt->lock);
+  return ret;
+}
+
 char* gt_feature_index_get_first_seqid(const GtFeatureIndex
                                              *feature_index,
                                               GtError *err)
@@ -320,6 +380,7 @@ void* gt_feature_index_cast(GT_UNUSED const GtFeatureIndexClass *fic,
 #define GT_FI_TEST_FEATURE_WIDTH 2000
 #define GT_FI_TEST_QUERY_WIDTH 50000
 #define GT_FI_TEST_SEQID "testseqid"
+#define GT_FI_TEST_NOF_BINS 500
 
 typedef struct {
   GtFeatureIndex *fi;
@@ -397,6 +458,21 @@ static void* gt_feature_index_unit_test_query(void *data)
   if (gt_array_size(arr) != gt_array_size(arr_ref))
     had_err = -1;
 
+  /* feature counts must match the reference set at fine resolution */
+  if (!had_err) {
+    GtUword counts[GT_FI_TEST_NOF_BINS], counts_ref[GT_FI_TEST_NOF_BINS];
+    memset(counts_ref, 0, sizeof (counts_ref));
+    gt_feature_index_bin_features(arr_ref, counts_ref, GT_FI_TEST_NOF_BINS,
+                                  &rng);
+    if (gt_feature_index_get_feature_counts_for_range(shm->fi, counts,
+                                                      GT_FI_TEST_NOF_BINS,
+                                                      GT_FI_TEST_SEQID, &rng,
+                                                      err) != 0
+          || memcmp(counts, counts_ref, sizeof (counts)) != 0) {
+      had_err = -1;
+    }
+  }
+
   /* nodes must be the same (note that we should not rely on ptr equality) */
   if (!had_err) {
     gt_array_sort(arr_ref, cmp_range_start);
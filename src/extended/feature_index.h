@@ -24,6 +24,18 @@ typedef struct GtFeatureIndexClass GtFeatureIndexClass;
 #include "extended/feature_index_api.h"
 
 GtFeatureIndex* gt_feature_index_ref(GtFeatureIndex*);
+/* Fills <counts> with the number of features on sequence region <seqid>
+   overlapping each of <nof_bins> equally sized bins covering <range>.
+   Implementations may use precomputed counts at a coarser resolution, in which
+   case the result is an approximation of the number of overlapping features.
+   Returns 0 on success, -1 on error (<err> is set accordingly). */
+int             gt_feature_index_get_feature_counts_for_range(
+                                                 GtFeatureIndex *feature_index,
+                                                 GtUword *counts,
+                                                 GtUword nof_bins,
+                                                 const char *seqid,
+                                                 const GtRange *range,
+                                                 GtError *err);
 int             gt_feature_index_unit_test(GtFeatureIndex *fi, GtError *err);
 int             gt_feature_index_mt_unit_test(GtFeatureIndex *fi, GtError *err);
 
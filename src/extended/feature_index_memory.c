@@ -18,6 +18,7 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <stdlib.h>
 #include <string.h>
 #include "core/class_alloc_lock.h"
 #include "core/cstr_table.h"
@@ -50,20 +51,50 @@ struct GtFeatureIndexMemory {
 #define gt_feature_index_memory_cast(FI)\
         gt_feature_index_cast(gt_feature_index_memory_class(), FI)
 
+/* resolution of the precomputed feature counts */
+#define GT_FEATURE_INDEX_MEMORY_BINSIZE 1000UL
+
 typedef struct {
   GtIntervalTree *features;
   GtRegionNode *region;
   GtRange dyn_range;
+  GtUword *bincounts,
+          nof_bins;
 } RegionInfo;
 
 static void region_info_delete(RegionInfo *info)
 {
   gt_interval_tree_delete(info->features);
+  gt_free(info->bincounts);
   if (info->region)
     gt_genome_node_delete((GtGenomeNode*)info->region);
   gt_free(info);
 }
 
+static void region_info_update_bincounts(RegionInfo *info, GtRange range,
+                                         bool add)
+{
+  GtUword i, lastbin;
+  gt_assert(info);
+  lastbin = range.end / GT_FEATURE_INDEX_MEMORY_BINSIZE;
+  if (lastbin >= info->nof_bins) {
+    GtUword newsize = MAX(lastbin + 1, 2 * info->nof_bins);
+    info->bincounts = gt_realloc(info->bincounts,
+                                 newsize * sizeof (*info->bincounts));
+    for (i = info->nof_bins; i < newsize; i++)
+      info->bincounts[i] = 0;
+    info->nof_bins = newsize;
+  }
+  for (i = range.start / GT_FEATURE_INDEX_MEMORY_BINSIZE; i <= lastbin; i++) {
+    if (add)
+      info->bincounts[i]++;
+    else {
+      gt_assert(info->bincounts[i] > 0);
+      info->bincounts[i]--;
+    }
+  }
+}
+
 int gt_feature_index_memory_add_region_node(GtFeatureIndex *gfi,
                                             GtRegionNode *rn,
                                             GT_UNUSED GtError *err)
@@ -131,6 +162,7 @@ int gt_feature_index_memory_add_feature_node(GtFeatureIndex *gfi,
   /* update dynamic range */
   info->dyn_range.start = MIN(info->dyn_range.start, node_range.start);
   info->dyn_range.end = MAX(info->dyn_range.end, node_range.end);
+  region_info_update_bincounts(info, node_range, true);
   return 0;
 }
 
@@ -178,8 +210,10 @@ int gt_feature_index_memory_remove_node(GtFeatureIndex *gfi,
                                    node_range.end,
                                    &info);
 
-  if (info.node)
+  if (info.node) {
     gt_interval_tree_remove(rinfo->features, info.node);
+    region_info_update_bincounts(rinfo, node_range, false);
+  }
   return 0;
 }
 
@@ -243,6 +277,50 @@ int gt_feature_index_memory_get_features_for_range(GtFeatureIndex *gfi,
   return 0;
 }
 
+int gt_feature_index_memory_get_counts_for_range(GtFeatureIndex *gfi,
+                                                 GtUword *counts,
+                                                 GtUword nof_bins,
+                                                 const char *seqid,
+                                                 const GtRange *qry_range,
+                                                 GtError *err)
+{
+  RegionInfo *ri;
+  GtFeatureIndexMemory *fi;
+  GtUword i, lastbin;
+  double binlen;
+  gt_error_check(err);
+  gt_assert(gfi && counts && nof_bins > 0 && qry_range);
+
+  fi = gt_feature_index_memory_cast(gfi);
+  ri = (RegionInfo*) gt_hashmap_get(fi->regions, seqid);
+  if (!ri) {
+    gt_error_set(err, "feature index does not contain the given sequence id");
+    return -1;
+  }
+  binlen = (double) gt_range_length(qry_range) / nof_bins;
+  if (binlen < GT_FEATURE_INDEX_MEMORY_BINSIZE) {
+    /* precomputed counts are too coarse, count the features themselves */
+    GtArray *features = gt_array_new(sizeof (GtGenomeNode*));
+    gt_interval_tree_find_all_overlapping(ri->features, qry_range->start,
+                                          qry_range->end, features);
+    gt_feature_index_bin_features(features, counts, nof_bins, qry_range);
+    gt_array_delete(features);
+    return 0;
+  }
+  /* each requested bin spans several precomputed bins, report the maximal
+     number of features overlapping any of them */
+  lastbin = MIN(qry_range->end / GT_FEATURE_INDEX_MEMORY_BINSIZE,
+                ri->nof_bins - 1);
+  for (i = qry_range->start / GT_FEATURE_INDEX_MEMORY_BINSIZE;
+       ri->nof_bins > 0 && i <= lastbin; i++) {
+    GtUword pos = MAX(i * GT_FEATURE_INDEX_MEMORY_BINSIZE, qry_range->start),
+            bin = MIN((GtUword) ((pos - qry_range->start) / binlen),
+                      nof_bins - 1);
+    counts[bin] = MAX(counts[bin], ri->bincounts[i]);
+  }
+  return 0;
+}
+
 GtFeatureNode*  gt_feature_index_memory_get_node_by_ptr(GtFeatureIndexMemory
                                                                           *fim,
                                                         GtFeatureNode *ptr,
@@ -371,6 +449,7 @@ const GtFeatureIndexClass* gt_feature_index_memory_class(void)
                      gt_feature_index_memory_remove_node,
                      gt_feature_index_memory_get_features_for_seqid,
                      gt_feature_index_memory_get_features_for_range,
+                     gt_feature_index_memory_get_counts_for_range,
                      gt_feature_index_memory_get_first_seqid,
                      NULL,
                      gt_feature_index_memory_get_seqids,
@@ -430,6 +509,67 @@ int gt_feature_index_memory_unit_test(GtError *err)
                                                 testerr);
   gt_ensure(tmp == NULL);
   gt_ensure(gt_error_is_set(testerr));
+
+  /* test precomputed feature counts (gene spans 1000-9000) */
+  if (!had_err) {
+    GtUword counts[20], i;
+    GtRange rng = {1, 20000};
+    gt_ensure(!gt_feature_index_get_feature_counts_for_range(fi, counts, 20,
+                                                             "ctg123", &rng,
+                                                             err));
+    for (i = 0; i < 20; i++) {
+      gt_ensure(counts[i] == (i < 9 ? 1 : 0));
+    }
+    gt_ensure(!gt_feature_index_remove_node(fi, fn, err));
+    gt_ensure(!gt_feature_index_get_feature_counts_for_range(fi, counts, 20,
+                                                             "ctg123", &rng,
+                                                             err));
+    for (i = 0; i < 20; i++) {
+      gt_ensure(counts[i] == 0);
+    }
+  }
+
+  /* compare precomputed counts (10 precomputed bins per requested bin) with
+     the counts of the features themselves, binned at the resolution of the
+     precomputed counts */
+  if (!had_err) {
+    GtStr *seqid = gt_str_new_cstr("bincounts");
+    GtArray *features = gt_array_new(sizeof (GtFeatureNode*));
+    GtUword fine[200], coarse[20], maxcount, i, j;
+    GtRange rng;
+    rng.start = 100 * GT_FEATURE_INDEX_MEMORY_BINSIZE;
+    rng.end = rng.start + 200 * GT_FEATURE_INDEX_MEMORY_BINSIZE - 1;
+    for (i = 0; !had_err && i < 500UL; i++) {
+      GtUword start, end;
+      GtGenomeNode *gn;
+      start = 50 * GT_FEATURE_INDEX_MEMORY_BINSIZE +
+              random() % (300 * GT_FEATURE_INDEX_MEMORY_BINSIZE);
+      end = start + random() % (3 * GT_FEATURE_INDEX_MEMORY_BINSIZE);
+      gn = gt_feature_node_new(seqid, "gene", start, end, GT_STRAND_FORWARD);
+      gt_ensure(!gt_feature_index_add_feature_node(fi, (GtFeatureNode*) gn,
+                                                   err));
+      gt_genome_node_delete(gn);
+    }
+    gt_ensure(!gt_feature_index_get_features_for_range(fi, features,
+                                                       "bincounts", &rng, err));
+    gt_ensure(!gt_feature_index_get_feature_counts_for_range(fi, coarse, 20,
+                                                             "bincounts", &rng,
+                                                             err));
+    if (!had_err) {
+      memset(fine, 0, sizeof (fine));
+      gt_feature_index_bin_features(features, fine, 200, &rng);
+      for (i = 0; i < 20; i++) {
+        maxcount = 0;
+        for (j = 0; j < 10; j++)
+          maxcount = MAX(maxcount, fine[10 * i + j]);
+        gt_ensure(maxcount > 0);
+        gt_ensure(coarse[i] == maxcount);
+      }
+    }
+    gt_array_delete(features);
+    gt_str_delete(seqid);
+  }
+
   gt_genome_node_delete((GtGenomeNode*) fn);
   gt_feature_index_delete(fi);
 
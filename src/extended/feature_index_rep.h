@@ -38,6 +38,12 @@ typedef int         (*GtFeatureIndexGetFeatsForRangeFunc)(GtFeatureIndex*,
                                                           const char*,
                                                           const GtRange*,
                                                           GtError*);
+typedef int         (*GtFeatureIndexGetCountsForRangeFunc)(GtFeatureIndex*,
+                                                           GtUword*,
+                                                           GtUword,
+                                                           const char*,
+                                                           const GtRange*,
+                                                           GtError*);
 typedef char*       (*GtFeatureIndexGetFirstSeqidFunc)(const GtFeatureIndex*,
                                                        GtError*);
 typedef int         (*GtFeatureIndexSaveFunc)(GtFeatureIndex*, GtError*);
@@ -75,6 +81,8 @@ const GtFeatureIndexClass* gt_feature_index_class_new(size_t size,
                                                  get_features_for_seqid,
                                          GtFeatureIndexGetFeatsForRangeFunc
                                                  get_features_for_range,
+                                         GtFeatureIndexGetCountsForRangeFunc
+                                                 get_counts_for_range,
                                          GtFeatureIndexGetFirstSeqidFunc
                                                  get_first_seqid,
                                          GtFeatureIndexSaveFunc
@@ -92,5 +100,12 @@ const GtFeatureIndexClass* gt_feature_index_class_new(size_t size,
 GtFeatureIndex* gt_feature_index_create(const GtFeatureIndexClass*);
 void*           gt_feature_index_cast(const GtFeatureIndexClass*,
                                       GtFeatureIndex*);
+/* Sets each of the <nof_bins> elements of <counts>, which must be zeroed, to
+   the number of features in <features> overlapping the respective bin, with
+   the bins splitting <range> into equally sized parts. */
+void            gt_feature_index_bin_features(GtArray *features,
+                                              GtUword *counts,
+                                              GtUword nof_bins,
+                                              const GtRange *range);
 
 #endif
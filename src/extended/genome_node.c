@@ -142,16 +142,19 @@ int gt_genome_node_cmp(GtGenomeNode *gn_a, GtGenomeNode *gn_b)
 {
   GtRange range_a, range_b;
   int rval;
-  const char *id_a, *id_b;
+  GtStr *idstr_a, *idstr_b;
   gt_assert(gn_a && gn_b);
   /* ensure that region nodes come first and sequence nodes come last,
      otherwise we don't get a valid GFF3 stream */
   if ((rval = compare_genome_node_type(gn_a, gn_b)))
     return rval;
 
-  id_a = gt_str_get(gt_genome_node_get_idstr(gn_a));
-  id_b = gt_str_get(gt_genome_node_get_idstr(gn_b));
-  if ((rval = gt_md5_seqid_cmp_seqids(id_a, id_b))) {
+  idstr_a = gt_genome_node_get_idstr(gn_a);
+  idstr_b = gt_genome_node_get_idstr(gn_b);
+  /* identical seqids (e.g., interned ones, see gt_symbol_str()) are equal */
+  if (idstr_a != idstr_b &&
+      (rval = gt_md5_seqid_cmp_seqids(gt_str_get(idstr_a),
+                                      gt_str_get(idstr_b)))) {
     return rval;
   }
   range_a = gt_genome_node_get_range(gn_a),
@@ -165,16 +168,19 @@ static int compare_genome_nodes_with_delta(GtGenomeNode *gn_a,
 {
   GtRange range_a, range_b;
   int rval;
-  const char *id_a, *id_b;
+  GtStr *idstr_a, *idstr_b;
   gt_assert(gn_a && gn_b);
   /* ensure that sequence regions come first, otherwise we don't get a valid
      gff3 stream */
   if ((rval = compare_genome_node_type(gn_a, gn_b)))
     return rval;
 
-  id_a = gt_str_get(gt_genome_node_get_idstr(gn_a));
-  id_b = gt_str_get(gt_genome_node_get_idstr(gn_b));
-  if ((rval = gt_md5_seqid_cmp_seqids(id_a, id_b))) {
+  idstr_a = gt_genome_node_get_idstr(gn_a);
+  idstr_b = gt_genome_node_get_idstr(gn_b);
+  /* identical seqids (e.g., interned ones, see gt_symbol_str()) are equal */
+  if (idstr_a != idstr_b &&
+      (rval = gt_md5_seqid_cmp_seqids(gt_str_get(idstr_a),
+                                      gt_str_get(idstr_b)))) {
     return rval;
   }
   range_a = gt_genome_node_get_range(gn_a);
@@ -23,6 +23,8 @@
 #include "core/queue.h"
 #include "core/progressbar.h"
 #include "core/str_array.h"
+#include "core/symbol.h"
+#include "extended/binary_parser.h"
 #include "extended/genome_node.h"
 #include "extended/gff3_in_stream_plain.h"
 #include "extended/gff3_parser.h"
@@ -32,16 +34,19 @@ struct GtGFF3InStreamPlain {
   const GtNodeStream parent_instance;
   GtUword next_file;
   GtStrArray *files;
-  GtStr *stdinstr;
+  GtStr *stdinstr,
+        *filenamestr;
   bool ensure_sorting,
        stdin_argument,
        stdin_processed,
        file_is_open,
+       binary_input,
        progress_bar;
   GtFile *fpin;
   GtUint64 line_number;
   GtQueue *genome_node_buffer;
   GtGFF3Parser *gff3_parser;
+  GtBinaryParser *binary_parser;
   GtCstrTable *used_types;
 };
 
@@ -121,6 +126,14 @@ static int gff3_in_stream_plain_next(GtNodeStream *ns, GtGenomeNode **gn,
         is->file_is_open = true;
       }
       is->line_number = 0;
+      /* the file name is shared by all nodes created from this file, intern it
+         to allow for nodes being released in other threads */
+      is->filenamestr = gt_str_array_size(is->files)
+                        ? gt_symbol_str(gt_str_array_get(is->files,
+                                                         is->next_file-1))
+                        : is->stdinstr;
+      /* files in the binary node format are read without validation */
+      is->binary_input = gt_binary_parser_detect(is->fpin);
 
       if (!had_err && is->progress_bar) {
         printf("processing file \"%s\"\n", gt_str_array_size(is->files)
@@ -135,25 +148,45 @@ static int gff3_in_stream_plain_next(GtNodeStream *ns, GtGenomeNode **gn,
 
     gt_assert(is->file_is_open);
 
-    filenamestr = gt_str_array_size(is->files)
-                  ? gt_str_array_get_str(is->files, is->next_file-1)
-                  : is->stdinstr;
+    filenamestr = is->filenamestr;
     /* read two nodes */
-    had_err = gt_gff3_parser_parse_genome_nodes(is->gff3_parser, &status_code,
-                                                is->genome_node_buffer,
-                                                is->used_types, filenamestr,
-                                                &is->line_number, is->fpin,
-                                                err);
-    if (had_err)
-      break;
-    if (status_code != EOF) {
-      had_err = gt_gff3_parser_parse_genome_nodes(is->gff3_parser, &status_code,
+    if (is->binary_input) {
+      had_err = gt_binary_parser_parse_genome_nodes(is->binary_parser,
+                                                    &status_code,
+                                                    is->genome_node_buffer,
+                                                    is->used_types,
+                                                    filenamestr, is->fpin, err);
+      if (!had_err && status_code != EOF) {
+        had_err = gt_binary_parser_parse_genome_nodes(is->binary_parser,
+                                                      &status_code,
+                                                      is->genome_node_buffer,
+                                                      is->used_types,
+                                                      filenamestr, is->fpin,
+                                                      err);
+      }
+      if (had_err)
+        break;
+    }
+    else {
+      had_err = gt_gff3_parser_parse_genome_nodes(is->gff3_parser,
+                                                  &status_code,
                                                   is->genome_node_buffer,
                                                   is->used_types, filenamestr,
                                                   &is->line_number, is->fpin,
                                                   err);
       if (had_err)
         break;
+      if (status_code != EOF) {
+        had_err = gt_gff3_parser_parse_genome_nodes(is->gff3_parser,
+                                                    &status_code,
+                                                    is->genome_node_buffer,
+                                                    is->used_types,
+                                                    filenamestr,
+                                                    &is->line_number, is->fpin,
+                                                    err);
+        if (had_err)
+          break;
+      }
     }
 
     if (status_code == EOF) {
@@ -163,6 +196,7 @@ static int gff3_in_stream_plain_next(GtNodeStream *ns, GtGenomeNode **gn,
       is->fpin = NULL;
       is->file_is_open = false;
       gt_gff3_parser_reset(is->gff3_parser);
+      gt_binary_parser_reset(is->binary_parser);
       if (!gt_str_array_size(is->files)) {
         is->stdin_processed = true;
         break;
@@ -202,6 +236,7 @@ static void gff3_in_stream_plain_free(GtNodeStream *ns)
   }
   gt_queue_delete(gff3_in_stream_plain->genome_node_buffer);
   gt_gff3_parser_delete(gff3_in_stream_plain->gff3_parser);
+  gt_binary_parser_delete(gff3_in_stream_plain->binary_parser);
   gt_cstr_table_delete(gff3_in_stream_plain->used_types);
   gt_file_delete(gff3_in_stream_plain->fpin);
 }
@@ -227,10 +262,11 @@ static GtNodeStream* gff3_in_stream_plain_new(GtStrArray *files,
                                            ensure_sorting);
   GtGFF3InStreamPlain *gff3_in_stream_plain = gff3_in_stream_plain_cast(ns);
   gff3_in_stream_plain->files               = files;
-  gff3_in_stream_plain->stdinstr            = gt_str_new_cstr("stdin");
+  gff3_in_stream_plain->stdinstr            = gt_symbol_str("stdin");
   gff3_in_stream_plain->ensure_sorting      = ensure_sorting;
   gff3_in_stream_plain->genome_node_buffer  = gt_queue_new();
   gff3_in_stream_plain->gff3_parser         = gt_gff3_parser_new(NULL);
+  gff3_in_stream_plain->binary_parser       = gt_binary_parser_new();
   gff3_in_stream_plain->used_types          = gt_cstr_table_new();
   return ns;
 }
@@ -29,7 +29,7 @@
 #include "core/parseutils.h"
 #include "core/queue.h"
 #include "core/splitter.h"
-#include "core/symbol_api.h"
+#include "core/symbol.h"
 #include "core/undef_api.h"
 #include "core/unused_api.h"
 #include "core/warning_api.h"
@@ -83,7 +83,7 @@ static SimpleSequenceRegion* simple_sequence_region_new(const char *seqid,
                                                         line_number)
 {
   SimpleSequenceRegion *ssr = gt_calloc(1, sizeof *ssr);
-  ssr->seqid_str = gt_str_new_cstr(seqid);
+  ssr->seqid_str = gt_symbol_str(seqid);
   ssr->range = range;
   ssr->line_number = line_number;
   return ssr;
@@ -1442,7 +1442,7 @@ static void set_source(GtFeatureNode *feature_node, const char *source,
   gt_assert(feature_node && source && source_to_str_mapping);
   source_str = gt_hashmap_get(source_to_str_mapping, source);
   if (!source_str) {
-    source_str = gt_str_new_cstr(source);
+    source_str = gt_symbol_str(source);
     gt_hashmap_add(source_to_str_mapping, gt_str_get(source_str), source_str);
   }
   gt_assert(source_str);
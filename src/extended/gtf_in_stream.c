@@ -32,7 +32,12 @@ struct GtGTFInStream {
   GtTypeChecker *type_checker;
   char *filename;
   bool file_processed,
-       tidy;
+       tidy,
+       streaming;
+  /* used in streaming mode */
+  GtGTFParser *gtf_parser;
+  GtFile *fpin;
+  GtStr *filenamestr;
 };
 
 #define gtf_in_stream_cast(NS)\
@@ -76,6 +81,33 @@ static int gtf_in_stream_process_file(GtGTFInStream *gtf_in_stream,
   return had_err;
 }
 
+static int gtf_in_stream_process_next(GtGTFInStream *is, GtError *err)
+{
+  int had_err = 0;
+  gt_error_check(err);
+  gt_assert(is && is->streaming);
+
+  if (!is->gtf_parser) {
+    /* open input file */
+    if (is->filename && !(is->fpin = gt_file_new(is->filename, "r", err)))
+      return -1;
+    is->filenamestr = gt_str_new_cstr(is->filename ? is->filename : "stdin");
+    is->gtf_parser = gt_gtf_parser_new(is->type_checker);
+    gt_gtf_parser_enable_streaming(is->gtf_parser);
+  }
+
+  /* parse until nodes are available */
+  while (!had_err && !gt_queue_size(is->genome_node_buffer) &&
+         !gt_gtf_parser_is_finished(is->gtf_parser)) {
+    had_err = gt_gtf_parser_parse(is->gtf_parser, is->genome_node_buffer,
+                                  is->filenamestr, is->fpin, is->tidy, err);
+  }
+  if (!had_err && gt_gtf_parser_is_finished(is->gtf_parser))
+    is->file_processed = true;
+
+  return had_err;
+}
+
 static int gtf_in_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
                               GT_UNUSED GtError *err)
 {
@@ -83,7 +115,11 @@ static int gtf_in_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
   int had_err = 0;
   gt_error_check(err);
   is = gtf_in_stream_cast(ns);
-  if (!is->file_processed) {
+  if (is->streaming) {
+    if (!is->file_processed && !gt_queue_size(is->genome_node_buffer))
+      had_err = gtf_in_stream_process_next(is, err);
+  }
+  else if (!is->file_processed) {
     had_err = gtf_in_stream_process_file(is, err);
     is->file_processed = true;
   }
@@ -103,6 +139,9 @@ static int gtf_in_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
 static void gtf_in_stream_free(GtNodeStream *ns)
 {
   GtGTFInStream *gtf_in_stream = gtf_in_stream_cast(ns);
+  gt_gtf_parser_delete(gtf_in_stream->gtf_parser);
+  gt_file_delete(gtf_in_stream->fpin);
+  gt_str_delete(gtf_in_stream->filenamestr);
   gt_free(gtf_in_stream->filename);
   gt_type_checker_delete(gtf_in_stream->type_checker);
   while (gt_queue_size(gtf_in_stream->genome_node_buffer))
@@ -139,3 +178,10 @@ void gt_gtf_in_stream_enable_tidy_mode(GtNodeStream *ns)
   GtGTFInStream *is = gtf_in_stream_cast(ns);
   is->tidy = true;
 }
+
+void gt_gtf_in_stream_enable_streaming_mode(GtNodeStream *ns)
+{
+  GtGTFInStream *is = gtf_in_stream_cast(ns);
+  gt_assert(!is->gtf_parser);
+  is->streaming = true;
+}
@@ -22,5 +22,11 @@
 
 const GtNodeStreamClass* gt_gtf_in_stream_class(void);
 void                     gt_gtf_in_stream_enable_tidy_mode(GtNodeStream*);
+/* Process the input gene by gene instead of reading the whole file first.
+   The input has to be grouped by gene, otherwise the stream fails as soon as
+   a gene_id reappears (the genes returned up to then cannot be taken back).
+   Besides the current gene only the ids of the completed genes are kept in
+   memory. No region nodes are created. */
+void                     gt_gtf_in_stream_enable_streaming_mode(GtNodeStream*);
 
 #endif
@@ -18,6 +18,7 @@
 #include <string.h>
 #include "core/assert_api.h"
 #include "core/cstr_api.h"
+#include "core/cstr_table_api.h"
 #include "core/hashmap.h"
 #include "core/ma.h"
 #include "core/parseutils.h"
@@ -49,6 +50,15 @@ struct GtGTFParser {
             *transcript_id_to_name_mapping;
   GtRegionNodeBuilder *region_node_builder;
   GtTypeChecker *type_checker;
+  /* parsing state, kept between calls in streaming mode */
+  GtStr *line_buffer;
+  GtSplitter *splitter,
+             *attribute_splitter;
+  GtUword line_number;
+  bool streaming,
+       finished;
+  char *current_gene_id;
+  GtCstrTable *flushed_gene_ids; /* to detect input not grouped by gene */
 };
 
 typedef struct {
@@ -109,9 +119,30 @@ GtGTFParser* gt_gtf_parser_new(GtTypeChecker *type_checker)
                                                          gt_free_func);
   parser->region_node_builder = gt_region_node_builder_new();
   parser->type_checker = type_checker;
+  parser->line_buffer = gt_str_new();
+  parser->splitter = gt_splitter_new();
+  parser->attribute_splitter = gt_splitter_new();
+  parser->line_number = 0;
+  parser->streaming = false;
+  parser->finished = false;
+  parser->current_gene_id = NULL;
+  parser->flushed_gene_ids = NULL;
   return parser;
 }
 
+void gt_gtf_parser_enable_streaming(GtGTFParser *parser)
+{
+  gt_assert(parser && !parser->line_number);
+  parser->streaming = true;
+  parser->flushed_gene_ids = gt_cstr_table_new();
+}
+
+bool gt_gtf_parser_is_finished(const GtGTFParser *parser)
+{
+  gt_assert(parser);
+  return parser->finished;
+}
+
 static int construct_mRNAs(GT_UNUSED void *key, void *value, void *data,
                            GtError *err)
 {
@@ -378,6 +409,27 @@ static int delete_genes(GT_UNUSED void *key, void *value, GT_UNUSED void *data,
   return had_err;
 }
 
+/* construct genes from all features collected so far, add them to
+   <genome_nodes> and forget about them */
+static int gtf_parser_flush_genes(GtGTFParser *parser, GtQueue *genome_nodes,
+                                  bool be_tolerant, GtError *err)
+{
+  ConstructionInfo cinfo;
+  int had_err;
+  gt_error_check(err);
+  cinfo.genome_nodes = genome_nodes;
+  cinfo.tidy = be_tolerant;
+  cinfo.gene_id_to_name_mapping = parser->gene_id_to_name_mapping;
+  cinfo.transcript_id_to_name_mapping = parser->transcript_id_to_name_mapping;
+  had_err = gt_hashmap_foreach(parser->gene_id_hash, construct_genes, &cinfo,
+                               err);
+  gt_hashmap_foreach(parser->gene_id_hash, delete_genes, NULL, NULL);
+  gt_hashmap_reset(parser->gene_id_hash);
+  gt_hashmap_reset(parser->gene_id_to_name_mapping);
+  gt_hashmap_reset(parser->transcript_id_to_name_mapping);
+  return had_err;
+}
+
 int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
                         GtStr *filenamestr, GtFile *fpin, bool be_tolerant,
                         GtError *err)
@@ -385,7 +437,7 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
   GtStr *seqid_str, *source_str, *line_buffer;
   char *line;
   size_t line_length;
-  GtUword i, line_number = 0;
+  GtUword i, line_number;
   GtGenomeNode *gn;
   GtRange range;
   GtPhase phase_value;
@@ -410,7 +462,6 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
   GtHashmap *transcript_id_hash; /* map from transcript id to array of genome
                                     nodes */
   GtArray *gt_genome_node_array;
-  ConstructionInfo cinfo;
   GTF_feature_type gtf_feature_type;
   GT_UNUSED bool gff_type_is_valid = false;
   const char *type = NULL;
@@ -422,11 +473,10 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
   gt_error_check(err);
 
   filename = gt_str_get(filenamestr);
-
-  /* alloc */
-  line_buffer = gt_str_new();
-  splitter = gt_splitter_new(),
-  attribute_splitter = gt_splitter_new();
+  line_buffer = parser->line_buffer;
+  splitter = parser->splitter;
+  attribute_splitter = parser->attribute_splitter;
+  line_number = parser->line_number;
 
 #define HANDLE_ERROR                                                   \
         if (had_err) {                                                 \
@@ -443,7 +493,12 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
           }                                                            \
         }
 
-  while (gt_str_read_next_line_generic(line_buffer, fpin) != EOF) {
+  /* in streaming mode return as soon as nodes are available */
+  while (!(parser->streaming && gt_queue_size(genome_nodes))) {
+    if (gt_str_read_next_line_generic(line_buffer, fpin) == EOF) {
+      parser->finished = true;
+      break;
+    }
     line = gt_str_get(line_buffer);
     line_length = gt_str_length(line_buffer);
     line_number++;
@@ -525,8 +580,10 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
       HANDLE_ERROR;
 
       /* process seqname (we have to do it here because we need the range) */
-      gt_region_node_builder_add_region(parser->region_node_builder, seqname,
-                                        range);
+      if (!parser->streaming) {
+        gt_region_node_builder_add_region(parser->region_node_builder,
+                                          seqname, range);
+      }
 
       /* parse the score */
       had_err = gt_parse_score(&score_is_defined, &score_value, score,
@@ -660,6 +717,33 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
       }
       HANDLE_ERROR;
 
+      /* in streaming mode a new gene_id completes the current gene */
+      if (parser->streaming) {
+        if (parser->current_gene_id &&
+            strcmp(parser->current_gene_id, gene_id) != 0) {
+          had_err = gtf_parser_flush_genes(parser, genome_nodes, be_tolerant,
+                                           err);
+          gt_cstr_table_add(parser->flushed_gene_ids, parser->current_gene_id);
+          gt_free(parser->current_gene_id);
+          parser->current_gene_id = NULL;
+        }
+        if (!had_err && gt_cstr_table_get(parser->flushed_gene_ids, gene_id)) {
+          gt_error_set(err, "the feature on line " GT_WU " in file \"%s\" "
+                       "belongs to gene \"%s\" which was completed before, "
+                       "the input is not grouped by %s and cannot be "
+                       "parsed in streaming mode", line_number, filename,
+                       gene_id, GENE_ID_ATTRIBUTE);
+          had_err = -1;
+        }
+        if (had_err) {
+          gt_str_array_delete(attrkeys);
+          gt_str_array_delete(attrvals);
+          break;
+        }
+        if (!parser->current_gene_id)
+          parser->current_gene_id = gt_cstr_dup(gene_id);
+      }
+
       /* process the mandatory attributes */
       if (!(transcript_id_hash = gt_hashmap_get(parser->gene_id_hash,
                                              gene_id))) {
@@ -697,7 +781,7 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
       /* get seqid */
       seqid_str = gt_hashmap_get(parser->seqid_to_str_mapping, seqname);
       if (!seqid_str) {
-        seqid_str = gt_str_new_cstr(seqname);
+        seqid_str = gt_symbol_str(seqname);
         gt_hashmap_add(parser->seqid_to_str_mapping, gt_str_get(seqid_str),
                        seqid_str);
       }
@@ -724,7 +808,7 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
       /* set source */
       source_str = gt_hashmap_get(parser->source_to_str_mapping, source);
       if (!source_str) {
-        source_str = gt_str_new_cstr(source);
+        source_str = gt_symbol_str(source);
         gt_hashmap_add(parser->source_to_str_mapping, gt_str_get(source_str),
                     source_str);
       }
@@ -741,25 +825,18 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
     gt_str_reset(line_buffer);
   }
 
-  /* process all region nodes */
-  if (!had_err)
-    gt_region_node_builder_build(parser->region_node_builder, genome_nodes);
-
-  /* process all feature nodes */
-  cinfo.genome_nodes = genome_nodes;
-  cinfo.tidy = be_tolerant;
-  cinfo.gene_id_to_name_mapping = parser->gene_id_to_name_mapping;
-  cinfo.transcript_id_to_name_mapping = parser->transcript_id_to_name_mapping;
-  if (!had_err) {
-    had_err = gt_hashmap_foreach(parser->gene_id_hash, construct_genes,
-                                 &cinfo, err);
+  parser->line_number = line_number;
+  if (!had_err && parser->finished) {
+    /* process all region nodes (in streaming mode the extent of a sequence
+       is not known before its features have been output, so none are
+       created) */
+    if (!parser->streaming) {
+      gt_region_node_builder_build(parser->region_node_builder,
+                                   genome_nodes);
+    }
+    /* process all (remaining) feature nodes */
+    had_err = gtf_parser_flush_genes(parser, genome_nodes, be_tolerant, err);
   }
-  gt_hashmap_foreach(parser->gene_id_hash, delete_genes, NULL, err);
-
-  /* free */
-  gt_splitter_delete(splitter);
-  gt_splitter_delete(attribute_splitter);
-  gt_str_delete(line_buffer);
 
   return had_err;
 }
@@ -767,6 +844,12 @@ int gt_gtf_parser_parse(GtGTFParser *parser, GtQueue *genome_nodes,
 void gt_gtf_parser_delete(GtGTFParser *parser)
 {
   if (!parser) return;
+  gt_hashmap_foreach(parser->gene_id_hash, delete_genes, NULL, NULL);
+  gt_free(parser->current_gene_id);
+  gt_cstr_table_delete(parser->flushed_gene_ids);
+  gt_splitter_delete(parser->attribute_splitter);
+  gt_splitter_delete(parser->splitter);
+  gt_str_delete(parser->line_buffer);
   gt_region_node_builder_delete(parser->region_node_builder);
   gt_hashmap_delete(parser->gene_id_hash);
   gt_hashmap_delete(parser->seqid_to_str_mapping);
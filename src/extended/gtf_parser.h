@@ -37,9 +37,20 @@
 typedef struct GtGTFParser GtGTFParser;
 
 GtGTFParser* gt_gtf_parser_new(GtTypeChecker*);
+/* Enable streaming mode for input grouped by gene (all lines of a gene are
+   consecutive): <gt_gtf_parser_parse()> then returns as soon as nodes have
+   been added to <genome_nodes>, a gene is added as soon as a line with
+   another gene_id is read. It has to be called again with the same file until
+   <gt_gtf_parser_is_finished()>. If a line belongs to a gene which has already
+   been completed, the input is not grouped by gene and an error is returned.
+   To detect this, the ids of all completed genes are kept. No region nodes
+   are created in this mode. */
+void         gt_gtf_parser_enable_streaming(GtGTFParser*);
 int          gt_gtf_parser_parse(GtGTFParser*, GtQueue *genome_nodes,
                                  GtStr *filenamestr, GtFile*,
                                  bool be_tolerant, GtError*);
+/* Returns true if the whole input has been parsed. */
+bool         gt_gtf_parser_is_finished(const GtGTFParser*);
 void         gt_gtf_parser_delete(GtGTFParser*);
 
 #endif
@@ -15,15 +15,21 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include "core/array_api.h"
 #include "core/complement.h"
 #include "core/disc_distri_api.h"
+#include "core/fa.h"
 #include "core/fastq.h"
 #include "core/hashmap_api.h"
 #include "core/log_api.h"
 #include "core/ma.h"
 #include "core/minmax.h"
+#include "core/multithread_api.h"
+#include "core/thread_api.h"
 #include "core/undef_api.h"
 #include "core/warning_api.h"
+#include "core/xansi_api.h"
+#include "core/xposix.h"
 #include "extended/aligned_segments_pile.h"
 #include "extended/feature_type.h"
 #include "extended/hpol_processor.h"
@@ -48,7 +54,9 @@ struct GtHpolProcessor
   GtUword nfiles;
   GtHashmap *processed_segments;
   GtAlphabet *alpha;
-  bool output_segments, output_stats, output_multihit_stats;
+  bool output_segments, output_stats, output_multihit_stats,
+       check_refregions;
+  GtArray *collected_segments;
 };
 
 GtHpolProcessor *gt_hpol_processor_new(GtEncseq *encseq, GtUword hmin)
@@ -92,6 +100,8 @@ GtHpolProcessor *gt_hpol_processor_new(GtEncseq *encseq, GtUword hmin)
   hpp->reads_iters = NULL;
   hpp->outfiles = NULL;
   hpp->nfiles = 0;
+  hpp->check_refregions = false;
+  hpp->collected_segments = NULL;
   return hpp;
 }
 
@@ -295,6 +305,7 @@ void gt_hpol_processor_enable_aligned_segments_refregionscheck(
   gt_assert(asp != NULL);
   gt_assert(hpp->asp == NULL);
   hpp->asp = asp;
+  hpp->check_refregions = true;
   gt_aligned_segments_pile_register_process_complete(hpp->asp,
       gt_hpol_processor_refregioncheck, hpp);
   gt_aligned_segments_pile_register_process_skipped(hpp->asp,
@@ -931,25 +942,27 @@ static int gt_hpol_processor_output_sorted_segments(GtHpolProcessor *hpp,
   return next_rval;
 }
 
-int gt_hpol_processor_run(GtHpolProcessor *hpp, GtLogger *logger, GtError *err)
+/* scans the positions <from> to <to> of the cognate sequence */
+static int gt_hpol_processor_scan(GtHpolProcessor *hpp, GtUword from,
+    GtUword to, GtError *err)
 {
   int had_err = 0;
-  GtUword i, hlen, tlen;
+  GtUword i, hlen;
   GtUchar prev, c;
   bool coding = false;
   bool end_of_annotation = true;
   GtEncseqReader *esr;
   gt_assert(hpp != NULL);
   gt_assert(hpp->encseq != NULL);
+  gt_assert(from <= to);
   esr = gt_encseq_create_reader_with_readmode(hpp->encseq,
-      GT_READMODE_FORWARD, 0);
-  tlen = gt_encseq_total_length(hpp->encseq);
+      GT_READMODE_FORWARD, from);
   prev = gt_encseq_reader_next_encoded_char(esr);
   hlen = 1UL;
   if (hpp->cds_oracle != NULL)
     had_err = gt_seqpos_classifier_position_is_inside_feature(
-        hpp->cds_oracle, 0, &coding, &end_of_annotation, err);
-  for (i = 1UL; i < tlen && !had_err; i++)
+        hpp->cds_oracle, from, &coding, &end_of_annotation, err);
+  for (i = from + 1UL; i <= to && !had_err; i++)
   {
     if (hpp->cds_oracle != NULL)
     {
@@ -978,10 +991,17 @@ int gt_hpol_processor_run(GtHpolProcessor *hpp, GtLogger *logger, GtError *err)
       gt_hpol_processor_process_hpol_end(hpp, prev, i - 1UL, hlen);
   }
   gt_encseq_reader_delete(esr);
-  gt_aligned_segments_pile_flush(hpp->asp, true);
-  if (!had_err && hpp->processed_segments != NULL)
+  return had_err;
+}
+
+static int gt_hpol_processor_finish(GtHpolProcessor *hpp, GtLogger *logger,
+    GtError *err)
+{
+  int had_err = 0;
+  GtUword i;
+  if (hpp->processed_segments != NULL)
   {
-    for (i = 0; i < hpp->nfiles; i++)
+    for (i = 0; i < hpp->nfiles && !had_err; i++)
       had_err = gt_hpol_processor_output_sorted_segments(hpp,
           hpp->reads_iters[i], hpp->outfiles[i], err);
   }
@@ -990,6 +1010,290 @@ int gt_hpol_processor_run(GtHpolProcessor *hpp, GtLogger *logger, GtError *err)
   return had_err;
 }
 
+int gt_hpol_processor_run(GtHpolProcessor *hpp, GtLogger *logger, GtError *err)
+{
+  int had_err = 0;
+  GtUword tlen;
+  gt_assert(hpp != NULL);
+  tlen = gt_encseq_total_length(hpp->encseq);
+  if (tlen > 0)
+    had_err = gt_hpol_processor_scan(hpp, 0, tlen - 1UL, err);
+  gt_aligned_segments_pile_flush(hpp->asp, true);
+  if (!had_err)
+    had_err = gt_hpol_processor_finish(hpp, logger, err);
+  return had_err;
+}
+
+/* In the parallel run, each reference sequence (and the set of alignments
+   without reference) is a region processed by its own <GtHpolProcessor>.
+   Segments which must be stored for the sorted output are collected per
+   region, together with the function processing them, and passed to the
+   main processor in the order of the regions after all regions are done. */
+
+typedef struct
+{
+  GtAlignedSegment *as;
+  GtAlignedSegmentsPileProcessFunc process;
+} GtHpolProcessorCollectedSegment;
+
+static void gt_hpol_processor_collect_segment(GtHpolProcessor *hpp,
+    GtAlignedSegment *as, GtAlignedSegmentsPileProcessFunc process)
+{
+  GtHpolProcessorCollectedSegment collected;
+  collected.as = as;
+  collected.process = process;
+  gt_array_add(hpp->collected_segments, collected);
+}
+
+static void gt_hpol_processor_collect_complete_segment(GtAlignedSegment *as,
+    void *data)
+{
+  gt_hpol_processor_collect_segment(data, as,
+      gt_hpol_processor_process_complete_segment);
+}
+
+static void gt_hpol_processor_collect_skipped_segment(GtAlignedSegment *as,
+    void *data)
+{
+  gt_hpol_processor_collect_segment(data, as,
+      gt_hpol_processor_process_skipped_segment);
+}
+
+static void gt_hpol_processor_collect_unmapped_segment(GtAlignedSegment *as,
+    void *data)
+{
+  gt_hpol_processor_collect_segment(data, as,
+      gt_hpol_processor_process_unmapped_segment);
+}
+
+typedef struct
+{
+  GtHpolProcessor *hpp;
+  GtSamfileIterator *sfi;
+  GtAlignedSegmentsPile *asp;
+  GtStr *segments_filename;
+  FILE *segments_fp;
+  GtFile *segments_file;
+  int32_t reference_num; /* negative: alignments without reference */
+  GtUword from, to;
+} GtHpolProcessorRegion;
+
+typedef struct
+{
+  GtHpolProcessor *hpp;
+  GtSamfileIterator *sfi;
+  GtSamfileEncseqMapping *sem;
+  GtHpolProcessorRegion *regions;
+  GtUword nof_regions, next_region;
+  GtMutex *mutex;
+  GtError *err;
+  int had_err;
+} GtHpolProcessorParallelInfo;
+
+static int gt_hpol_processor_process_region(GtHpolProcessorParallelInfo *pi,
+    GtHpolProcessorRegion *region, GtError *err)
+{
+  GtHpolProcessor *hpp = pi->hpp, *rhpp;
+  int had_err = 0;
+  region->sfi = gt_samfile_iterator_new_for_reference(pi->sfi,
+      region->reference_num, err);
+  if (region->sfi == NULL)
+    return -1;
+  region->asp = gt_aligned_segments_pile_new(region->sfi, pi->sem);
+  rhpp = region->hpp = gt_hpol_processor_new(hpp->encseq, hpp->hmin);
+  if (hpp->adjust_s_hlen)
+    gt_hpol_processor_enable_segments_hlen_adjustment(rhpp, region->asp,
+        hpp->read_hmin, hpp->qmax, hpp->altmax, hpp->refmin, hpp->mapqmin,
+        hpp->covmin, hpp->allow_partial, hpp->allow_multiple, hpp->clenmax);
+  else if (hpp->check_refregions)
+    gt_hpol_processor_enable_aligned_segments_refregionscheck(rhpp,
+        region->asp);
+  if (hpp->processed_segments != NULL)
+  {
+    rhpp->collected_segments =
+      gt_array_new(sizeof (GtHpolProcessorCollectedSegment));
+    gt_aligned_segments_pile_register_process_complete(region->asp,
+        gt_hpol_processor_collect_complete_segment, rhpp);
+    gt_aligned_segments_pile_register_process_skipped(region->asp,
+        gt_hpol_processor_collect_skipped_segment, rhpp);
+    gt_aligned_segments_pile_register_process_unmapped(region->asp,
+        gt_hpol_processor_collect_unmapped_segment, rhpp);
+    gt_aligned_segments_pile_disable_segment_deletion(region->asp);
+  }
+  else if (hpp->output_segments)
+  {
+    region->segments_filename = gt_str_new();
+    region->segments_fp = gt_xtmpfp(region->segments_filename);
+    region->segments_file = gt_file_new_from_fileptr(region->segments_fp);
+    gt_hpol_processor_enable_direct_segments_output(rhpp,
+        region->segments_file);
+  }
+  if (region->reference_num >= 0 && region->from <= region->to)
+    had_err = gt_hpol_processor_scan(rhpp, region->from, region->to, err);
+  gt_aligned_segments_pile_flush(region->asp, true);
+  return had_err;
+}
+
+static void* gt_hpol_processor_parallel_thread(void *data)
+{
+  GtHpolProcessorParallelInfo *pi = data;
+  GtError *err = gt_error_new();
+  while (true)
+  {
+    GtUword r;
+    gt_mutex_lock(pi->mutex);
+    r = pi->next_region++;
+    if (pi->had_err)
+      r = pi->nof_regions;
+    gt_mutex_unlock(pi->mutex);
+    if (r >= pi->nof_regions)
+      break;
+    if (gt_hpol_processor_process_region(pi, pi->regions + r, err) != 0)
+    {
+      gt_mutex_lock(pi->mutex);
+      if (!pi->had_err)
+      {
+        pi->had_err = -1;
+        gt_error_set(pi->err, "%s", gt_error_get(err));
+      }
+      gt_mutex_unlock(pi->mutex);
+      break;
+    }
+  }
+  gt_error_delete(err);
+  return NULL;
+}
+
+static void gt_hpol_processor_add_distri(GtUword key, GtUint64 value,
+    void *data)
+{
+  gt_disc_distri_add_multi(data, key, value);
+}
+
+/* adds the results of the processor of <region> to <hpp> */
+static void gt_hpol_processor_merge_region(GtHpolProcessor *hpp,
+    GtHpolProcessorRegion *region)
+{
+  GtHpolProcessor *rhpp = region->hpp;
+  gt_disc_distri_foreach(rhpp->hdist, gt_hpol_processor_add_distri,
+      hpp->hdist);
+  gt_disc_distri_foreach(rhpp->hdist_e, gt_hpol_processor_add_distri,
+      hpp->hdist_e);
+  hpp->nof_h += rhpp->nof_h;
+  hpp->nof_h_e += rhpp->nof_h_e;
+  hpp->hlen_max = MAX(hpp->hlen_max, rhpp->hlen_max);
+  hpp->nof_complete_edited += rhpp->nof_complete_edited;
+  hpp->nof_complete_not_edited += rhpp->nof_complete_not_edited;
+  hpp->nof_skipped += rhpp->nof_skipped;
+  hpp->nof_unmapped += rhpp->nof_unmapped;
+  if (rhpp->collected_segments != NULL)
+  {
+    GtUword i;
+    for (i = 0; i < gt_array_size(rhpp->collected_segments); i++)
+    {
+      GtHpolProcessorCollectedSegment *collected =
+        gt_array_get(rhpp->collected_segments, i);
+      collected->process(collected->as, hpp);
+    }
+    gt_array_reset(rhpp->collected_segments);
+  }
+  if (region->segments_file != NULL)
+  {
+    char buffer[BUFSIZ];
+    size_t len;
+    rewind(region->segments_fp);
+    while ((len = gt_xfread(buffer, sizeof (char), sizeof (buffer),
+            region->segments_fp)) > 0)
+      gt_file_xwrite(hpp->outfp_segments, buffer, len);
+  }
+}
+
+static void gt_hpol_processor_delete_region(GtHpolProcessorRegion *region)
+{
+  if (region->hpp != NULL && region->hpp->collected_segments != NULL)
+  {
+    GtUword i;
+    for (i = 0; i < gt_array_size(region->hpp->collected_segments); i++)
+    {
+      GtHpolProcessorCollectedSegment *collected =
+        gt_array_get(region->hpp->collected_segments, i);
+      gt_aligned_segment_delete(collected->as);
+    }
+    gt_array_delete(region->hpp->collected_segments);
+  }
+  gt_aligned_segments_pile_delete(region->asp);
+  gt_samfile_iterator_delete(region->sfi);
+  gt_hpol_processor_delete(region->hpp);
+  if (region->segments_file != NULL)
+  {
+    gt_file_delete(region->segments_file);
+    gt_xremove(gt_str_get(region->segments_filename));
+  }
+  gt_str_delete(region->segments_filename);
+}
+
+int gt_hpol_processor_run_parallel(GtHpolProcessor *hpp,
+    GtSamfileIterator *sfi, GtSamfileEncseqMapping *sem, GtLogger *logger,
+    GtError *err)
+{
+  GtHpolProcessorParallelInfo pi;
+  GtUword i;
+  int32_t nof_references;
+  int had_err;
+  gt_assert(hpp != NULL);
+  gt_assert(hpp->asp != NULL);
+  gt_assert(hpp->cds_oracle == NULL);
+  gt_assert(!hpp->output_stats);
+  had_err = gt_samfile_iterator_load_index(sfi, err);
+  if (had_err)
+    return had_err;
+  nof_references = gt_samfile_iterator_number_of_references(sfi);
+  pi.hpp = hpp;
+  pi.sfi = sfi;
+  pi.sem = sem;
+  pi.nof_regions = (GtUword)nof_references + 1UL;
+  pi.regions = gt_calloc((size_t)pi.nof_regions, sizeof (*pi.regions));
+  /* regions in the order of the sequences in the encseq, followed by the
+     alignments without reference */
+  for (i = 0; i < pi.nof_regions; i++)
+    pi.regions[i].reference_num = -1;
+  for (i = 0; i < (GtUword)nof_references; i++)
+  {
+    GtUword seqnum = gt_samfile_encseq_mapping_seqnum(sem, (int32_t)i);
+    GtHpolProcessorRegion *region = pi.regions + seqnum;
+    region->reference_num = (int32_t)i;
+    region->from = gt_encseq_seqstartpos(hpp->encseq, seqnum);
+    region->to = region->from + gt_encseq_seqlength(hpp->encseq, seqnum);
+    if (region->to > region->from)
+      region->to--;
+    else
+      region->from = 1UL; /* empty sequence, nothing to scan */
+  }
+  pi.next_region = 0;
+  pi.mutex = gt_mutex_new();
+  pi.err = err;
+  pi.had_err = 0;
+  had_err = gt_multithread(gt_hpol_processor_parallel_thread, &pi, err);
+  if (!had_err)
+    had_err = pi.had_err;
+  for (i = 0; i < pi.nof_regions; i++)
+  {
+    if (!had_err)
+      gt_hpol_processor_merge_region(hpp, pi.regions + i);
+    gt_hpol_processor_delete_region(pi.regions + i);
+  }
+  gt_free(pi.regions);
+  gt_mutex_delete(pi.mutex);
+  /* all alignments were processed by the regions, thus they must not be
+     processed again when the pile of <hpp> is flushed */
+  gt_aligned_segments_pile_register_process_complete(hpp->asp, NULL, NULL);
+  gt_aligned_segments_pile_register_process_skipped(hpp->asp, NULL, NULL);
+  gt_aligned_segments_pile_register_process_unmapped(hpp->asp, NULL, NULL);
+  if (!had_err)
+    had_err = gt_hpol_processor_finish(hpp, logger, err);
+  return had_err;
+}
+
 void gt_hpol_processor_delete(GtHpolProcessor *hpp)
 {
   if (hpp != NULL)
@@ -21,6 +21,8 @@
 #include "core/encseq.h"
 #include "extended/seqpos_classifier.h"
 #include "extended/aligned_segments_pile.h"
+#include "extended/samfile_encseq_mapping.h"
+#include "extended/samfile_iterator.h"
 #include "core/seq_iterator_api.h"
 #include "core/logger.h"
 
@@ -41,6 +43,20 @@ GtHpolProcessor* gt_hpol_processor_new(GtEncseq *encseq, GtUword hmin);
 int              gt_hpol_processor_run(GtHpolProcessor *hpp, GtLogger *logger,
                                        GtError *err);
 
+/* Like <gt_hpol_processor_run()>, but processes the sequences of the
+   cognate sequence in parallel, using <gt_jobs> threads. The alignments to
+   each sequence are read from the BAM file of <sfi> using its index, which
+   is built in memory if there is no index file. <sfi> and <sem> must be
+   those from which the <GtAlignedSegmentsPile> given to <hpp> was created.
+   Not supported in combination with
+   <gt_hpol_processor_restrict_to_feature_type()> and
+   <gt_hpol_processor_enable_statistics_output()>. */
+int              gt_hpol_processor_run_parallel(GtHpolProcessor *hpp,
+                                                GtSamfileIterator *sfi,
+                                                GtSamfileEncseqMapping *sem,
+                                                GtLogger *logger,
+                                                GtError *err);
+
 /* Enables the correction of homopolymers errors in the segments (usually
    sequencing reads) provided by <asp>.
    Some thresholds are defined for the correction to take place:
@@ -29,9 +29,7 @@
 #include "extended/md5set_primes_table.h"
 #include "extended/reverse_api.h"
 
-typedef struct {
-  uint64_t l, h;
-} md5_t;
+typedef GtMD5SetHash md5_t;
 
 #define MD5_T_EQUAL(A, B) \
         ((A).l == (B).l && (A).h == (B).h)
@@ -82,27 +80,33 @@ static GtUword md5set_get_size(GtUword n)
 }
 #endif
 
-struct GtMD5Set
+typedef struct
 {
-  /* hash table */
   md5_t    *table;
   GtUword  alloc;
   GtUword  fill;
   GtUword  maxfill;
+} MD5SetShard;
+
+struct GtMD5Set
+{
+  /* hash tables */
+  MD5SetShard  *shards;
+  unsigned int nof_shards;
   /* string temp buffer */
   char           *buffer;
   GtUword  bufsize;
 };
 
-#define GT_MD5SET_PREPARE_INSERTION(SET) \
-  ((SET)->fill)++;\
-  if ((SET)->fill > (SET)->maxfill) \
-    md5set_alloc_table((SET), \
+#define GT_MD5SET_PREPARE_INSERTION(SHARD) \
+  ((SHARD)->fill)++;\
+  if ((SHARD)->fill > (SHARD)->maxfill) \
+    md5set_alloc_table((SHARD), \
         /* using alloc + 1, the next value in the lookup table is returned */ \
-        md5set_get_size((SET)->alloc + 1));\
-  gt_assert((SET)->fill <= (SET)->maxfill)
+        md5set_get_size((SHARD)->alloc + 1));\
+  gt_assert((SHARD)->fill <= (SHARD)->maxfill)
 
-static void md5set_alloc_table(GtMD5Set *set, GtUword newsize);
+static void md5set_alloc_table(MD5SetShard *shard, GtUword newsize);
 
 enum MD5SetSearchResult
 {
@@ -111,20 +115,20 @@ enum MD5SetSearchResult
   GT_MD5SET_COLLISION
 };
 
-static inline enum MD5SetSearchResult md5set_search_pos(GtMD5Set *set,
+static inline enum MD5SetSearchResult md5set_search_pos(MD5SetShard *shard,
                                                         md5_t k,
                                                         bool
                                                         insert_if_not_found,
                                                         GtUword i)
 {
-  if (MD5_T_IS_EMPTY(set->table[i])) {
+  if (MD5_T_IS_EMPTY(shard->table[i])) {
     if (insert_if_not_found) {
-      GT_MD5SET_PREPARE_INSERTION(set);
-      set->table[i] = k;
+      GT_MD5SET_PREPARE_INSERTION(shard);
+      shard->table[i] = k;
     }
     return GT_MD5SET_EMPTY;
   }
-  return (MD5_T_EQUAL(k, set->table[i]))
+  return (MD5_T_EQUAL(k, shard->table[i]))
          ? GT_MD5SET_KEY_FOUND
          : GT_MD5SET_COLLISION;
 }
@@ -137,7 +141,8 @@ static inline enum MD5SetSearchResult md5set_search_pos(GtMD5Set *set,
 #define MD5SET_H2(MD5, TABLE_SIZE) \
         (((MD5).h % ((TABLE_SIZE) - 1)) + 1)
 
-static bool md5set_search(GtMD5Set *set, md5_t k, bool insert_if_not_found)
+static bool md5set_search(MD5SetShard *shard, md5_t k,
+                          bool insert_if_not_found)
 {
   GtUword i, c;
 #ifndef NDEBUG
@@ -145,136 +150,204 @@ static bool md5set_search(GtMD5Set *set, md5_t k, bool insert_if_not_found)
 #endif
   enum MD5SetSearchResult retval;
 
-  i = (GtUword) MD5SET_H1(k, set->alloc);
-  retval = md5set_search_pos(set, k, insert_if_not_found, i);
+  i = (GtUword) MD5SET_H1(k, shard->alloc);
+  retval = md5set_search_pos(shard, k, insert_if_not_found, i);
   if (retval != GT_MD5SET_COLLISION)
     return retval == GT_MD5SET_EMPTY ? false : true;
 
   /* open addressing by double hashing */
-  c = (GtUword) MD5SET_H2(k, set->alloc);
+  c = (GtUword) MD5SET_H2(k, shard->alloc);
   gt_assert(c > 0);
 #ifndef NDEBUG
   first_i = i;
 #endif
   while (1) {
-    i = (i + c) % set->alloc;
+    i = (i + c) % shard->alloc;
     gt_assert(i != first_i);
-    retval = md5set_search_pos(set, k, insert_if_not_found, i);
+    retval = md5set_search_pos(shard, k, insert_if_not_found, i);
     if (retval != GT_MD5SET_COLLISION)
       return retval == GT_MD5SET_EMPTY ? false : true;
   }
 }
 
-static void md5set_rehash(GtMD5Set *set, md5_t *oldtable, GtUword oldsize)
+static void md5set_rehash(MD5SetShard *shard, md5_t *oldtable,
+                          GtUword oldsize)
 {
   GtUword i;
-  set->fill = 0;
+  shard->fill = 0;
   for (i = 0; i < oldsize; i++)
     if (!MD5_T_IS_EMPTY(oldtable[i]))
-      (void) md5set_search(set, oldtable[i], true);
+      (void) md5set_search(shard, oldtable[i], true);
 }
 
 #define MD5SET_MAX_LOAD_FACTOR 0.8
 
-static void md5set_alloc_table(GtMD5Set *set, GtUword newsize)
+static void md5set_alloc_table(MD5SetShard *shard, GtUword newsize)
 {
   md5_t *oldtable;
   GtUword oldsize;
 
-  oldsize = set->alloc;
-  oldtable = set->table;
-  set->alloc = newsize;
-  set->maxfill =
+  oldsize = shard->alloc;
+  oldtable = shard->table;
+  shard->alloc = newsize;
+  shard->maxfill =
     (GtUword)((double)newsize * MD5SET_MAX_LOAD_FACTOR);
-  set->table = gt_calloc((size_t)newsize, sizeof (md5_t));
+  shard->table = gt_calloc((size_t)newsize, sizeof (md5_t));
   if (oldtable != NULL) {
     gt_log_log("rehashing " GT_WU " elements; old size: " GT_WU ", new size: "
-               GT_WU "\n", set->fill, oldsize, newsize);
-    md5set_rehash(set, oldtable, oldsize);
+               GT_WU "\n", shard->fill, oldsize, newsize);
+    md5set_rehash(shard, oldtable, oldsize);
     gt_free(oldtable);
   }
 }
 
-GtMD5Set *gt_md5set_new(GtUword nof_elements)
+GtMD5Set *gt_md5set_new_sharded(GtUword nof_elements, unsigned int nof_shards)
 {
   GtMD5Set *md5set;
+  GtUword shard_elements;
+  unsigned int s;
+
+  gt_assert(nof_shards > 0);
   md5set = gt_malloc(sizeof (GtMD5Set));
-  md5set->fill = 0;
-  md5set->alloc = 0;
-  md5set->table = NULL;
-  md5set_alloc_table(md5set,
-                     md5set_get_size(nof_elements + (nof_elements >> 2)));
-  gt_assert(nof_elements < md5set->maxfill);
+  md5set->nof_shards = nof_shards;
+  md5set->shards = gt_malloc(sizeof (*md5set->shards) * nof_shards);
+  shard_elements = nof_elements / nof_shards +
+                   (nof_elements % nof_shards > 0 ? 1UL : 0);
+  for (s = 0; s < nof_shards; s++) {
+    MD5SetShard *shard = md5set->shards + s;
+    shard->fill = 0;
+    shard->alloc = 0;
+    shard->table = NULL;
+    md5set_alloc_table(shard,
+                       md5set_get_size(shard_elements + (shard_elements >> 2)));
+    gt_assert(shard_elements < shard->maxfill);
+  }
   md5set->buffer = NULL;
   md5set->bufsize = 0;
   return md5set;
 }
 
+GtMD5Set *gt_md5set_new(GtUword nof_elements)
+{
+  return gt_md5set_new_sharded(nof_elements, 1U);
+}
+
+unsigned int gt_md5set_number_of_shards(const GtMD5Set *set)
+{
+  gt_assert(set != NULL);
+  return set->nof_shards;
+}
+
 void gt_md5set_delete(GtMD5Set *set)
 {
   if (set != NULL) {
-    gt_free(set->table);
+    unsigned int s;
+    for (s = 0; s < set->nof_shards; s++)
+      gt_free(set->shards[s].table);
+    gt_free(set->shards);
     gt_free(set->buffer);
     gt_free(set);
   }
 }
 
-static void md5set_prepare_buffer(GtMD5Set *md5set, GtUword bufsize)
+static void md5set_prepare_buffer(char **buffer, GtUword *bufsize,
+                                  GtUword size)
 {
-  gt_assert(md5set != NULL);
+  gt_assert(buffer != NULL && bufsize != NULL);
 
-  if (md5set->buffer == NULL) {
-    md5set->buffer = gt_malloc(sizeof (char) * bufsize);
-    md5set->bufsize = bufsize;
+  if (*buffer == NULL) {
+    *buffer = gt_malloc(sizeof (char) * size);
+    *bufsize = size;
   }
-  else if (md5set->bufsize < bufsize) {
-    md5set->buffer = gt_realloc(md5set->buffer, sizeof (char) * bufsize);
-    md5set->bufsize = bufsize;
+  else if (*bufsize < size) {
+    *buffer = gt_realloc(*buffer, sizeof (char) * size);
+    *bufsize = size;
   }
 }
 
 #define MD5SET_HASH_STRING(BUF, LEN, MD5) \
         md5((BUF), gt_safe_cast2long(LEN), (char*)&(MD5))
 
-GtMD5SetStatus gt_md5set_add_sequence(GtMD5Set *set, const char* seq,
-                                      GtUword seqlen, bool both_strands,
-                                      GtError *err)
+int gt_md5set_hash_sequence(GtMD5SetKeys *keys, const char *seq,
+                            GtUword seqlen, bool both_strands,
+                            char **buffer, GtUword *bufsize, GtError *err)
 {
-  md5_t md5sum, md5sum_rc;
   GtUword i;
-  int retval = 0;
-  bool found;
-
-  gt_assert(set != NULL);
-  gt_assert(set->table != NULL);
+  int retval;
 
-  md5set_prepare_buffer(set, seqlen);
+  gt_assert(keys != NULL);
+  md5set_prepare_buffer(buffer, bufsize, seqlen);
   for (i = 0; i < seqlen; i++)
-    set->buffer[i] = toupper(seq[i]);
-
-  MD5SET_HASH_STRING(set->buffer, seqlen, md5sum);
-  found = md5set_search(set, md5sum, true);
-  if (found)
-    return GT_MD5SET_FOUND;
+    (*buffer)[i] = toupper(seq[i]);
 
+  MD5SET_HASH_STRING(*buffer, seqlen, keys->fwd);
+  keys->both_strands = both_strands;
   if (both_strands) {
-    retval = gt_reverse_complement(set->buffer, seqlen, err);
+    retval = gt_reverse_complement(*buffer, seqlen, err);
     if (retval != 0) {
       gt_assert(retval < 0);
-      return GT_MD5SET_ERROR;
+      return retval;
     }
+    MD5SET_HASH_STRING(*buffer, seqlen, keys->rc);
+  }
+  else
+    keys->rc = keys->fwd;
+  return 0;
+}
+
+/* the smaller of the forward and reverse complement MD5 is the same for a
+   sequence and its reverse complement */
+static inline const md5_t *md5set_canonical_key(const GtMD5SetKeys *keys)
+{
+  if (keys->both_strands &&
+      (keys->rc.h < keys->fwd.h ||
+       (keys->rc.h == keys->fwd.h && keys->rc.l < keys->fwd.l)))
+    return &keys->rc;
+  return &keys->fwd;
+}
+
+/* uses the upper half of h, which is independent of MD5SET_H1 and almost
+   independent of MD5SET_H2 */
+GtUword gt_md5set_keys_partition(const GtMD5SetKeys *keys,
+                                 GtUword nof_partitions)
+{
+  gt_assert(keys != NULL && nof_partitions > 0);
+  return (GtUword) ((md5set_canonical_key(keys)->h >> 32) % nof_partitions);
+}
+
+GtMD5SetStatus gt_md5set_add_keys(GtMD5Set *set, const GtMD5SetKeys *keys)
+{
+  MD5SetShard *shard;
 
-    MD5SET_HASH_STRING(set->buffer, seqlen, md5sum_rc);
+  gt_assert(set != NULL && keys != NULL);
+  shard = set->shards + (set->nof_shards == 1U
+                         ? 0
+                         : gt_md5set_keys_partition(keys, set->nof_shards));
+  if (md5set_search(shard, keys->fwd, true))
+    return GT_MD5SET_FOUND;
+
+  if (keys->both_strands) {
     /* if the MD5 sum of the reverse complement equals the MD5 sum of the
        sequence itself we don't check if the reverse complement is in the set.
        Otherwise such sequences would never be added to the set at all. */
-    if (md5sum_rc.l == md5sum.l && md5sum_rc.h == md5sum.h) {
+    if (MD5_T_EQUAL(keys->rc, keys->fwd))
       return GT_MD5SET_NOT_FOUND;
-    }
-    found = md5set_search(set, md5sum_rc, false);
-    if (found)
+    if (md5set_search(shard, keys->rc, false))
       return GT_MD5SET_RC_FOUND;
   }
 
   return GT_MD5SET_NOT_FOUND;
 }
+
+GtMD5SetStatus gt_md5set_add_sequence(GtMD5Set *set, const char* seq,
+                                      GtUword seqlen, bool both_strands,
+                                      GtError *err)
+{
+  GtMD5SetKeys keys;
+
+  gt_assert(set != NULL);
+  if (gt_md5set_hash_sequence(&keys, seq, seqlen, both_strands, &set->buffer,
+                              &set->bufsize, err) != 0)
+    return GT_MD5SET_ERROR;
+  return gt_md5set_add_keys(set, &keys);
+}
@@ -19,6 +19,7 @@
 #define MD5SET_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "core/types_api.h"
 #include "core/error_api.h"
@@ -36,10 +37,34 @@ typedef enum {
   GT_MD5SET_RC_FOUND
 } GtMD5SetStatus;
 
+/* A 128-bit MD5 hash. */
+typedef struct {
+  uint64_t l, h;
+} GtMD5SetHash;
+
+/* The MD5 hashes of a sequence and, if <both_strands> is set, of its reverse
+   complement, as computed by <gt_md5set_hash_sequence()>. */
+typedef struct {
+  GtMD5SetHash fwd, rc;
+  bool         both_strands;
+} GtMD5SetKeys;
+
 /* Create a new <GtMD5Set> with <nof_elements> sequences. If the number of
    sequences is not known, set <nof_elements> to 0. */
 GtMD5Set*      gt_md5set_new(GtUword nof_elements);
 
+/* Create a new <GtMD5Set> for <nof_elements> sequences split into
+   <nof_shards> independent hash tables. The shard a sequence is stored in is
+   given by <gt_md5set_keys_partition()>, calls of <gt_md5set_add_keys()> for
+   keys of different shards can be made from different threads without
+   locking. All keys added to a sharded set must have been computed with the
+   same <both_strands> value. */
+GtMD5Set*      gt_md5set_new_sharded(GtUword nof_elements,
+                                     unsigned int nof_shards);
+
+/* Returns the number of shards of <set>. */
+unsigned int   gt_md5set_number_of_shards(const GtMD5Set *set);
+
 /* Deletes a <GtMD5Set> and frees all associated memory. */
 void           gt_md5set_delete(GtMD5Set *set);
 
@@ -57,4 +82,28 @@ GtMD5SetStatus gt_md5set_add_sequence(GtMD5Set *set, const char* seq,
                                       GtUword seqlen, bool both_strands,
                                       GtError *err);
 
+/* Calculates the MD5 hash of an upper case copy of <seq> and, if
+   <both_strands> is true, of its reverse complement and stores them in <keys>.
+   <*buffer> of size <*bufsize> is used (and enlarged if necessary) for the
+   copy, it has to be freed by the caller. Does not access any <GtMD5Set>, so
+   it can be called from several threads with different buffers.
+   Returns 0 on success and a negative value on error, <err> is set
+   accordingly. */
+int            gt_md5set_hash_sequence(GtMD5SetKeys *keys, const char *seq,
+                                       GtUword seqlen, bool both_strands,
+                                       char **buffer, GtUword *bufsize,
+                                       GtError *err);
+
+/* Returns a number in the range [0,<nof_partitions>-1] for <keys>, which is
+   the same for all sequences which are identical to the sequence <keys> were
+   computed from or, if <keys> were computed with <both_strands>, to its
+   reverse complement. Thus duplicates can be detected independently for each
+   partition. */
+GtUword        gt_md5set_keys_partition(const GtMD5SetKeys *keys,
+                                        GtUword nof_partitions);
+
+/* Adds the sequence hashed to <keys> to <set>, the meaning of the result is
+   the same as for <gt_md5set_add_sequence()>. */
+GtMD5SetStatus gt_md5set_add_keys(GtMD5Set *set, const GtMD5SetKeys *keys);
+
 #endif
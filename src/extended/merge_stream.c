@@ -177,6 +177,14 @@ static void merge_stream_free(GtNodeStream *ns)
 {
   GtMergeStream *ms = gt_merge_stream_cast(ns);
   GtUword i;
+  /* free the nodes which have not been passed on (if the stream has not been
+     read to the end) */
+  while (!gt_priority_queue_is_empty(ms->pq)) {
+    GtMergeStreamItem *item = gt_priority_queue_extract_min(ms->pq);
+    gt_genome_node_delete(item->gn);
+  }
+  gt_genome_node_delete(ms->first_node);
+  gt_genome_node_delete(ms->second_node);
   for (i = 0; i < gt_array_size(ms->node_streams); i++)
     gt_node_stream_delete(*(GtNodeStream**) gt_array_get(ms->node_streams, i));
   gt_array_delete(ms->node_streams);
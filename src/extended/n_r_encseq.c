@@ -28,6 +28,7 @@
 #include "core/log_api.h"
 #include "core/logger_api.h"
 #include "core/ma.h"
+#include "core/minmax.h"
 #include "core/qsort_r_api.h"
 #include "core/range.h"
 #include "core/readmode_api.h"
@@ -393,6 +394,30 @@ static void gt_n_r_encseq_add_link_to_db(GtNREncseq *nre,
   nre->ldb_nelems++;
 }
 
+const GtEncseq *gt_n_r_encseq_get_unique_encseq(const GtNREncseq *n_r_encseq)
+{
+  return n_r_encseq->unique_es;
+}
+
+GtUword gt_n_r_encseq_get_orig_num_of_seqs(const GtNREncseq *n_r_encseq)
+{
+  return n_r_encseq->orig_num_seq;
+}
+
+GtUword gt_n_r_encseq_get_orig_seqlength(const GtNREncseq *n_r_encseq,
+                                         GtUword seqnum)
+{
+  gt_assert(seqnum < n_r_encseq->orig_num_seq);
+  return gt_n_r_encseq_ssp_seqlength(n_r_encseq, seqnum);
+}
+
+const char *gt_n_r_encseq_get_orig_seqid(const GtNREncseq *n_r_encseq,
+                                         GtUword seqnum,
+                                         GtUword *idlen)
+{
+  return gt_n_r_encseq_sdstab_get_id(n_r_encseq, idlen, seqnum);
+}
+
 void gt_n_r_encseq_delete(GtNREncseq *n_r_encseq)
 {
   if (n_r_encseq != NULL) {
@@ -590,7 +615,7 @@ GtNREncseq *gt_n_r_encseq_new_from_file(const char *basename_nre,
 /* returns index of the link element with the biggest orig_startpos smaller than
    <position>
    if smallest is larger, return that. */
-static GtUword gt_n_r_encseq_links_position_binsearch(GtNREncseq *nre,
+static GtUword gt_n_r_encseq_links_position_binsearch(const GtNREncseq *nre,
                                                       GtUword position)
 {
   GtWord idx, low, high;
@@ -615,8 +640,9 @@ static GtUword gt_n_r_encseq_links_position_binsearch(GtNREncseq *nre,
 /* returns index of the unique element with the biggest orig_startpos smaller
    than <position>.
    if smallest is larger: return first. */
-static GtUword gt_n_r_encseq_uniques_position_binsearch(GtNREncseq *nre,
-                                                        GtUword position)
+static GtUword gt_n_r_encseq_uniques_position_binsearch(
+                                                          const GtNREncseq *nre,
+                                                          GtUword position)
 {
   GtWord idx, low, high;
   gt_assert(nre && nre->udb_nelems > 0);
@@ -638,6 +664,86 @@ static GtUword gt_n_r_encseq_uniques_position_binsearch(GtNREncseq *nre,
   return 0;
 }
 
+void gt_n_r_encseq_unique_orig_seqnums(const GtNREncseq *nre,
+                                       GtUword unique_id,
+                                       GtArrayGtUword *seqnums)
+{
+  GtUword idx;
+  const GtNREncseqUnique *unique;
+  gt_assert(unique_id < nre->udb_nelems);
+  unique = &nre->uniques[unique_id];
+  GT_STOREINARRAY(seqnums, GtUword, 16,
+                  gt_n_r_encseq_ssp_pos2seqnum(nre, unique->orig_startpos));
+  for (idx = 0; idx < unique->links.nextfreeuint32_t; idx++) {
+    const GtNREncseqLink *link = &nre->links[unique->links.spaceuint32_t[idx]];
+    GT_STOREINARRAY(seqnums, GtUword, 16,
+                    gt_n_r_encseq_ssp_pos2seqnum(nre, link->orig_startpos));
+  }
+}
+
+/* uniques and links tile the original sequences without gaps, separators are
+   not part of either */
+void gt_n_r_encseq_extract_orig_seq_encoded(const GtNREncseq *nre,
+                                            GtUword seqnum,
+                                            GtUchar *buffer)
+{
+  GtUchar *linkbuffer = NULL;
+  GtUword linkbuffsize = 0,
+          lidx = nre->ldb_nelems,
+          start = gt_n_r_encseq_ssp_seqstartpos(nre, seqnum),
+          end = start + gt_n_r_encseq_ssp_seqlength(nre, seqnum),
+          pos = start,
+          uidx = nre->udb_nelems;
+
+  if (nre->udb_nelems > 0) {
+    uidx = gt_n_r_encseq_uniques_position_binsearch(nre, start);
+    if (nre->uniques[uidx].orig_startpos + nre->uniques[uidx].len <= start)
+      uidx++;
+  }
+  if (nre->ldb_nelems > 0) {
+    lidx = gt_n_r_encseq_links_position_binsearch(nre, start);
+    if (nre->links[lidx].orig_startpos + nre->links[lidx].len <= start)
+      lidx++;
+  }
+  while (pos < end) {
+    GtUword offset, len;
+    if (uidx < nre->udb_nelems && nre->uniques[uidx].orig_startpos <= pos) {
+      const GtNREncseqUnique *unique = &nre->uniques[uidx];
+      GtUword esstart;
+      offset = pos - unique->orig_startpos;
+      len = MIN(unique->len - offset, end - pos);
+      esstart = gt_encseq_seqstartpos(nre->unique_es, uidx) + offset;
+      gt_encseq_extract_encoded(nre->unique_es, buffer + (pos - start),
+                                esstart, esstart + len - 1);
+      uidx++;
+    }
+    else {
+      const GtNREncseqLink *link;
+      gt_assert(lidx < nre->ldb_nelems &&
+                nre->links[lidx].orig_startpos <= pos);
+      link = &nre->links[lidx];
+      offset = pos - link->orig_startpos;
+      len = MIN(link->len - offset, end - pos);
+      if (linkbuffsize < link->len) {
+        linkbuffsize = link->len;
+        linkbuffer = gt_realloc(linkbuffer,
+                                sizeof (*linkbuffer) * linkbuffsize);
+      }
+      (void) gt_editscript_get_sequence(link->editscript, nre->unique_es,
+                                        gt_encseq_seqstartpos(nre->unique_es,
+                                                              link->unique_id) +
+                                          link->unique_offset,
+                                        GT_READMODE_FORWARD,
+                                        linkbuffer);
+      memcpy(buffer + (pos - start), linkbuffer + offset,
+             sizeof (*buffer) * len);
+      lidx++;
+    }
+    pos += len;
+  }
+  gt_free(linkbuffer);
+}
+
 typedef struct GtNRECXdrop {
   GtXdropresources *left_xdrop_res,
                    *right_xdrop_res,
@@ -19,6 +19,7 @@
 #ifndef N_R_ENCSEQ_H
 #define N_R_ENCSEQ_H
 
+#include "core/arraydef.h"
 #include "core/encseq_api.h"
 #include "core/error_api.h"
 #include "core/logger_api.h"
@@ -59,6 +60,37 @@ GtUword     gt_n_r_encseq_get_orig_length(GtNREncseq *n_r_encseq);
    redundand sequences. */
 GtUword     gt_n_r_encseq_get_unique_length(GtNREncseq *n_r_encseq);
 
+/* Return the <GtEncseq> holding the unique database of <n_r_encseq>, sequence
+   <i> of which is unique entry <i>. */
+const GtEncseq* gt_n_r_encseq_get_unique_encseq(const GtNREncseq *n_r_encseq);
+
+/* Return the number of sequences in the original sequence collection. */
+GtUword     gt_n_r_encseq_get_orig_num_of_seqs(const GtNREncseq *n_r_encseq);
+
+/* Return the length of original sequence <seqnum>. */
+GtUword     gt_n_r_encseq_get_orig_seqlength(const GtNREncseq *n_r_encseq,
+                                             GtUword seqnum);
+
+/* Return the id of original sequence <seqnum>, which is not '\0' terminated,
+   and store its length in <idlen>. */
+const char* gt_n_r_encseq_get_orig_seqid(const GtNREncseq *n_r_encseq,
+                                         GtUword seqnum,
+                                         GtUword *idlen);
+
+/* Append the numbers of all original sequences containing unique entry
+   <unique_id> or a link to it to <seqnums>, which might contain duplicates
+   afterwards. Only valid for <GtNREncseq> objects read from file. */
+void        gt_n_r_encseq_unique_orig_seqnums(const GtNREncseq *n_r_encseq,
+                                              GtUword unique_id,
+                                              GtArrayGtUword *seqnums);
+
+/* Decompress original sequence <seqnum> of <n_r_encseq> to <buffer>, which
+   has to hold at least <gt_n_r_encseq_get_orig_seqlength()> symbols. The
+   sequence is stored encoded, not decoded to characters. */
+void        gt_n_r_encseq_extract_orig_seq_encoded(const GtNREncseq *n_r_encseq,
+                                                   GtUword seqnum,
+                                                   GtUchar *buffer);
+
 /* Free space for <n_r_encseq> */
 void        gt_n_r_encseq_delete(GtNREncseq *n_r_encseq);
 
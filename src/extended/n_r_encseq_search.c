@@ -0,0 +1,1157 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/alphabet_api.h"
+#include "core/array_api.h"
+#include "core/arraydef.h"
+#include "core/chardef.h"
+#include "core/codetype.h"
+#include "core/divmodmul.h"
+#include "core/encseq_api.h"
+#include "core/fa.h"
+#include "core/fileutils_api.h"
+#include "core/hashmap_api.h"
+#include "core/log_api.h"
+#include "core/ma.h"
+#include "core/multithread_api.h"
+#include "core/seq_iterator_sequence_buffer_api.h"
+#include "core/str_array_api.h"
+#include "core/thread_api.h"
+#include "core/undef_api.h"
+#include "core/warning_api.h"
+#include "core/xansi_api.h"
+#include "extended/multieoplist.h"
+#include "extended/n_r_encseq_search.h"
+#include "match/seqabstract.h"
+#include "match/sfx-mappedstr.h"
+
+/* Karlin-Altschul parameter K is not derived from the scoring scheme, these are
+   the values BLAST uses for its default gapped nucleotide and protein
+   searches. */
+#define GT_NRES_KARLIN_K_DNA     0.46
+#define GT_NRES_KARLIN_K_PROTEIN 0.041
+
+typedef struct {
+  GtCodetype code;
+  GtUword    position;
+} GtNRESKmerpos;
+
+/* positions of all k-mers of the unique database without special symbols,
+   grouped by their code, which are stored sorted. */
+typedef struct {
+  GtCodetype *codes;
+  GtUword    *offsets, /* numofcodes + 1 entries */
+             *positions,
+              numofcodes,
+              numofpositions,
+              totallength,
+              kmersize;
+} GtNRESKmerindex;
+
+struct GtNREncseqSearch {
+  GtNREncseq                   *nre;
+  const GtEncseq               *unique_es;
+  const GtXdropArbitraryscores *scores;
+  GtLogger                     *logger;
+  GtNRESKmerindex               kmerindex;
+  GtCodetype                    numofkmercodes;
+  GtWord                        xdropscore;
+  double                        lambda,
+                                karlin_k;
+  unsigned int                  kmersize,
+                                numofchars;
+  bool                          bothstrands;
+};
+
+/* one local alignment, positions are half open intervals on the strand of the
+   query that was searched. */
+typedef struct {
+  GtUword      qstart,
+               qend,
+               sstart,
+               send,
+               subject,
+               alignlen,
+               matches;
+  GtXdropscore score;
+  double       evalue;
+  bool         reverse;
+} GtNRESHsp;
+
+typedef struct {
+  GtXdropresources *left_res,
+                   *right_res;
+  GtSeqabstract    *query_fwd,
+                   *query_bwd,
+                   *subject_fwd,
+                   *subject_bwd;
+  GtHashmap        *diagonals,
+                   *hituniques;
+  GtNRESKmerpos    *querykmers;
+  GtUchar          *rcquery;
+  GtXdropbest       left,
+                    right;
+  GtUword           querykmersallocated,
+                    rcqueryallocated;
+} GtNRESWorkspace;
+
+/* a batch of queries of bounded total length, processed by <gt_jobs> threads
+   each claiming the next unprocessed query. */
+typedef struct {
+  const GtNREncseqSearch *nres;
+  GtUchar                *sequences;
+  GtUword                *seqstartpos, /* numofqueries + 1 entries */
+                          numofqueries,
+                          allocatedqueries,
+                          allocatedchars,
+                          nextquery;
+  GtStrArray             *ids;
+  GtArrayGtUword         *hits; /* unique ids, later original seqnums */
+  GtStr                 **outbufs;
+  GtUword                *numofhits;
+  /* decompressed original sequences selected by the coarse search for the
+     queries of this batch */
+  GtUchar                *origsequences;
+  GtUword                *origseqnums,
+                         *origstartpos, /* numoforigseqs + 1 entries */
+                          numoforigseqs,
+                          fine_dblen; /* over all batches */
+  double                  coarse_eval,
+                          fine_eval;
+  GtMutex                *mutex;
+} GtNRESBatch;
+
+static int gt_n_r_encseq_search_kmerpos_cmp(const void *a, const void *b)
+{
+  const GtNRESKmerpos *ka = a, *kb = b;
+  if (ka->code != kb->code)
+    return ka->code < kb->code ? -1 : 1;
+  if (ka->position != kb->position)
+    return ka->position < kb->position ? -1 : 1;
+  return 0;
+}
+
+static int gt_n_r_encseq_search_uword_cmp(const void *a, const void *b)
+{
+  const GtUword *ua = a, *ub = b;
+  if (*ua != *ub)
+    return *ua < *ub ? -1 : 1;
+  return 0;
+}
+
+/* sort <arr> and remove duplicates */
+static void gt_n_r_encseq_search_sort_unique(GtArrayGtUword *arr)
+{
+  GtUword idx, nextfree = 0;
+  if (arr->nextfreeGtUword == 0)
+    return;
+  qsort(arr->spaceGtUword, (size_t) arr->nextfreeGtUword,
+        sizeof (*arr->spaceGtUword), gt_n_r_encseq_search_uword_cmp);
+  for (idx = 1UL; idx < arr->nextfreeGtUword; idx++) {
+    if (arr->spaceGtUword[idx] != arr->spaceGtUword[nextfree])
+      arr->spaceGtUword[++nextfree] = arr->spaceGtUword[idx];
+  }
+  arr->nextfreeGtUword = nextfree + 1;
+}
+
+static void gt_n_r_encseq_search_kmerindex_build(GtNRESKmerindex *kmerindex,
+                                                 const GtEncseq *unique_es,
+                                                 unsigned int kmersize)
+{
+  GtKmercodeiterator *iter;
+  GtNRESKmerpos *kmers = NULL;
+  GtUword idx, numofkmers = 0;
+
+  kmerindex->totallength = gt_encseq_total_length(unique_es);
+  kmerindex->kmersize = (GtUword) kmersize;
+  if (kmerindex->totallength >= (GtUword) kmersize) {
+    const GtKmercode *kmercode;
+    GtUword pos = 0,
+            lastpos = kmerindex->totallength - kmersize;
+    kmers = gt_malloc(sizeof (*kmers) * (lastpos + 1));
+    iter = gt_kmercodeiterator_encseq_new(unique_es, GT_READMODE_FORWARD,
+                                          kmersize, 0);
+    while (pos <= lastpos &&
+           (kmercode = gt_kmercodeiterator_encseq_next(iter)) != NULL) {
+      if (!kmercode->definedspecialposition) {
+        kmers[numofkmers].code = kmercode->code;
+        kmers[numofkmers].position = pos;
+        numofkmers++;
+      }
+      pos++;
+    }
+    gt_kmercodeiterator_delete(iter);
+    qsort(kmers, (size_t) numofkmers, sizeof (*kmers),
+          gt_n_r_encseq_search_kmerpos_cmp);
+  }
+  kmerindex->numofcodes = 0;
+  for (idx = 0; idx < numofkmers; idx++) {
+    if (idx == 0 || kmers[idx].code != kmers[idx - 1].code)
+      kmerindex->numofcodes++;
+  }
+  kmerindex->numofpositions = numofkmers;
+  kmerindex->codes = gt_malloc(sizeof (*kmerindex->codes) *
+                               (kmerindex->numofcodes + 1));
+  kmerindex->offsets = gt_malloc(sizeof (*kmerindex->offsets) *
+                                 (kmerindex->numofcodes + 1));
+  kmerindex->positions = gt_malloc(sizeof (*kmerindex->positions) *
+                                   (numofkmers + 1));
+  kmerindex->numofcodes = 0;
+  for (idx = 0; idx < numofkmers; idx++) {
+    if (idx == 0 || kmers[idx].code != kmers[idx - 1].code) {
+      kmerindex->codes[kmerindex->numofcodes] = kmers[idx].code;
+      kmerindex->offsets[kmerindex->numofcodes++] = idx;
+    }
+    kmerindex->positions[idx] = kmers[idx].position;
+  }
+  kmerindex->offsets[kmerindex->numofcodes] = numofkmers;
+  gt_free(kmers);
+}
+
+static void gt_n_r_encseq_search_kmerindex_write(
+                                            const GtNRESKmerindex *kmerindex,
+                                            FILE *fp)
+{
+  gt_xfwrite_one(&kmerindex->kmersize, fp);
+  gt_xfwrite_one(&kmerindex->totallength, fp);
+  gt_xfwrite_one(&kmerindex->numofcodes, fp);
+  gt_xfwrite_one(&kmerindex->numofpositions, fp);
+  gt_xfwrite(kmerindex->codes, sizeof (*kmerindex->codes),
+             (size_t) kmerindex->numofcodes, fp);
+  gt_xfwrite(kmerindex->offsets, sizeof (*kmerindex->offsets),
+             (size_t) kmerindex->numofcodes + 1, fp);
+  gt_xfwrite(kmerindex->positions, sizeof (*kmerindex->positions),
+             (size_t) kmerindex->numofpositions, fp);
+}
+
+/* returns false if the stored index does not fit <kmersize> and
+   <totallength>, or is truncated. */
+static bool gt_n_r_encseq_search_kmerindex_read(GtNRESKmerindex *kmerindex,
+                                                GtUword kmersize,
+                                                GtUword totallength,
+                                                FILE *fp)
+{
+  if (gt_xfread_one(&kmerindex->kmersize, fp) != (size_t) 1 ||
+      gt_xfread_one(&kmerindex->totallength, fp) != (size_t) 1 ||
+      gt_xfread_one(&kmerindex->numofcodes, fp) != (size_t) 1 ||
+      gt_xfread_one(&kmerindex->numofpositions, fp) != (size_t) 1 ||
+      kmerindex->kmersize != kmersize ||
+      kmerindex->totallength != totallength ||
+      kmerindex->numofcodes > kmerindex->numofpositions ||
+      kmerindex->numofpositions > totallength)
+    return false;
+  kmerindex->codes = gt_malloc(sizeof (*kmerindex->codes) *
+                               (kmerindex->numofcodes + 1));
+  kmerindex->offsets = gt_malloc(sizeof (*kmerindex->offsets) *
+                                 (kmerindex->numofcodes + 1));
+  kmerindex->positions = gt_malloc(sizeof (*kmerindex->positions) *
+                                   (kmerindex->numofpositions + 1));
+  if (gt_xfread(kmerindex->codes, sizeof (*kmerindex->codes),
+                (size_t) kmerindex->numofcodes, fp) !=
+        (size_t) kmerindex->numofcodes ||
+      gt_xfread(kmerindex->offsets, sizeof (*kmerindex->offsets),
+                (size_t) kmerindex->numofcodes + 1, fp) !=
+        (size_t) kmerindex->numofcodes + 1 ||
+      gt_xfread(kmerindex->positions, sizeof (*kmerindex->positions),
+                (size_t) kmerindex->numofpositions, fp) !=
+        (size_t) kmerindex->numofpositions) {
+    gt_free(kmerindex->codes);
+    gt_free(kmerindex->offsets);
+    gt_free(kmerindex->positions);
+    return false;
+  }
+  return true;
+}
+
+static void gt_n_r_encseq_search_kmerindex_init(GtNREncseqSearch *nres,
+                                                const char *basename_nre,
+                                                GtError *err)
+{
+  bool loaded = false;
+  FILE *fp;
+  GtUword totallength = gt_encseq_total_length(nres->unique_es);
+  GtStr *indexpath = gt_str_new_cstr(basename_nre),
+        *nrepath = gt_str_new_cstr(basename_nre);
+
+  gt_str_append_cstr(indexpath, GT_NRENCSEQ_KMERINDEX_FILE_SUFFIX);
+  gt_str_append_cstr(nrepath, GT_NRENCSEQ_FILE_SUFFIX);
+  /* an index older than the compressed database is rebuilt, as is an index
+     which cannot be read */
+  if (gt_file_exists(gt_str_get(indexpath)) &&
+      !gt_file_is_newer(gt_str_get(nrepath), gt_str_get(indexpath))) {
+    fp = gt_fa_fopen_with_suffix(basename_nre,
+                                 GT_NRENCSEQ_KMERINDEX_FILE_SUFFIX, "rb", NULL);
+    if (fp != NULL) {
+      loaded = gt_n_r_encseq_search_kmerindex_read(&nres->kmerindex,
+                                                   (GtUword) nres->kmersize,
+                                                   totallength, fp);
+      gt_fa_fclose(fp);
+      if (loaded)
+        gt_logger_log(nres->logger, "read k-mer index from %s%s",
+                      basename_nre, GT_NRENCSEQ_KMERINDEX_FILE_SUFFIX);
+    }
+  }
+  if (!loaded) {
+    gt_n_r_encseq_search_kmerindex_build(&nres->kmerindex, nres->unique_es,
+                                         nres->kmersize);
+    /* the index is only a cache, the search works without storing it */
+    fp = gt_fa_fopen_with_suffix(basename_nre,
+                                 GT_NRENCSEQ_KMERINDEX_FILE_SUFFIX, "wb", err);
+    if (fp == NULL) {
+      gt_warning("k-mer index is not stored: %s", gt_error_get(err));
+      gt_error_unset(err);
+    }
+    else {
+      gt_n_r_encseq_search_kmerindex_write(&nres->kmerindex, fp);
+      gt_fa_fclose(fp);
+      gt_logger_log(nres->logger, "stored k-mer index to %s%s",
+                    basename_nre, GT_NRENCSEQ_KMERINDEX_FILE_SUFFIX);
+    }
+  }
+  gt_str_delete(indexpath);
+  gt_str_delete(nrepath);
+  gt_logger_log(nres->logger, "k-mer index: " GT_WU " distinct %u-mers, "
+                GT_WU " positions", nres->kmerindex.numofcodes,
+                nres->kmersize, nres->kmerindex.numofpositions);
+}
+
+/* stores the range of positions for <code> in <first> and <last> (exclusive),
+   returns false if <code> does not occur. */
+static bool gt_n_r_encseq_search_kmerindex_find(
+                                            const GtNRESKmerindex *kmerindex,
+                                            GtCodetype code,
+                                            GtUword *first,
+                                            GtUword *last)
+{
+  GtUword left = 0, right = kmerindex->numofcodes;
+  while (left < right) {
+    GtUword mid = left + GT_DIV2(right - left);
+    if (kmerindex->codes[mid] < code)
+      left = mid + 1;
+    else
+      right = mid;
+  }
+  if (left < kmerindex->numofcodes && kmerindex->codes[left] == code) {
+    *first = kmerindex->offsets[left];
+    *last = kmerindex->offsets[left + 1];
+    return true;
+  }
+  return false;
+}
+
+/* solve sum_{a,b} p_a p_b e^{lambda s(a,b)} = 1 for uniform symbol
+   frequencies */
+static double gt_n_r_encseq_search_lambda(const GtXdropArbitraryscores *scores,
+                                          unsigned int numofchars)
+{
+  const double pmatch = 1.0 / numofchars;
+  double low = 0.0, high = 1.0;
+  int iteration;
+#define GT_NRES_LAMBDA_F(L) (pmatch * exp((L) * scores->mat) + \
+                             (1.0 - pmatch) * exp((L) * scores->mis) - 1.0)
+  while (GT_NRES_LAMBDA_F(high) < 0.0)
+    high *= 2.0;
+  for (iteration = 0; iteration < 100; iteration++) {
+    double mid = (low + high) / 2.0;
+    if (GT_NRES_LAMBDA_F(mid) < 0.0)
+      low = mid;
+    else
+      high = mid;
+  }
+#undef GT_NRES_LAMBDA_F
+  return (low + high) / 2.0;
+}
+
+GtNREncseqSearch *gt_n_r_encseq_search_new(GtNREncseq *nre,
+                                           const char *basename_nre,
+                                           unsigned int kmersize,
+                                           const GtXdropArbitraryscores *scores,
+                                           GtWord xdropscore,
+                                           GtLogger *logger,
+                                           GtError *err)
+{
+  int had_err = 0;
+  GtNREncseqSearch *nres;
+  const GtAlphabet *alphabet;
+  GtCodetype numofkmercodes = 1;
+  unsigned int idx;
+
+  gt_error_check(err);
+  nres = gt_calloc((size_t) 1, sizeof (*nres));
+  nres->nre = nre;
+  nres->unique_es = gt_n_r_encseq_get_unique_encseq(nre);
+  nres->scores = scores;
+  nres->xdropscore = xdropscore;
+  nres->logger = logger;
+  nres->kmersize = kmersize;
+  alphabet = gt_encseq_alphabet(nres->unique_es);
+  nres->numofchars = gt_alphabet_num_of_chars(alphabet);
+  nres->bothstrands = gt_alphabet_is_dna(alphabet);
+  nres->karlin_k = nres->bothstrands ? GT_NRES_KARLIN_K_DNA
+                                     : GT_NRES_KARLIN_K_PROTEIN;
+
+  if (kmersize > (unsigned int) MAXPREFIXLENGTH) {
+    gt_error_set(err, "k-mer size %u too large, maximum is %u", kmersize,
+                 (unsigned int) MAXPREFIXLENGTH);
+    had_err = -1;
+  }
+  /* rolling codes need room for one additional symbol */
+  for (idx = 0; !had_err && idx <= kmersize; idx++) {
+    if (numofkmercodes > GT_UWORD_MAX / nres->numofchars) {
+      gt_error_set(err, "k-mer size %u too large for alphabet of size %u",
+                   kmersize, nres->numofchars);
+      had_err = -1;
+    }
+    else if (idx < kmersize)
+      numofkmercodes *= nres->numofchars;
+  }
+  nres->numofkmercodes = numofkmercodes;
+  if (!had_err && (double) scores->mat / nres->numofchars +
+      (double) scores->mis * (nres->numofchars - 1) / nres->numofchars >= 0.0) {
+    gt_error_set(err, "expected score of scoring scheme has to be negative");
+    had_err = -1;
+  }
+  if (!had_err) {
+    nres->lambda = gt_n_r_encseq_search_lambda(scores, nres->numofchars);
+    gt_logger_log(logger, "Karlin-Altschul parameters: lambda %.4f, K %.3f",
+                  nres->lambda, nres->karlin_k);
+    gt_n_r_encseq_search_kmerindex_init(nres, basename_nre, err);
+  }
+  if (had_err) {
+    gt_free(nres);
+    return NULL;
+  }
+  return nres;
+}
+
+void gt_n_r_encseq_search_delete(GtNREncseqSearch *nres)
+{
+  if (nres != NULL) {
+    gt_free(nres->kmerindex.codes);
+    gt_free(nres->kmerindex.offsets);
+    gt_free(nres->kmerindex.positions);
+    gt_free(nres);
+  }
+}
+
+static double gt_n_r_encseq_search_evalue(const GtNREncseqSearch *nres,
+                                          GtXdropscore score,
+                                          GtUword dblen,
+                                          GtUword querylen)
+{
+  return (double) dblen * querylen * nres->karlin_k *
+         exp(-nres->lambda * score);
+}
+
+static double gt_n_r_encseq_search_bitscore(const GtNREncseqSearch *nres,
+                                            GtXdropscore score)
+{
+  return (nres->lambda * score - log(nres->karlin_k)) / log(2.0);
+}
+
+static void gt_n_r_encseq_search_workspace_init(GtNRESWorkspace *ws,
+                                                const GtNREncseqSearch *nres)
+{
+  ws->left_res = gt_xdrop_resources_new(nres->scores);
+  ws->right_res = gt_xdrop_resources_new(nres->scores);
+  ws->query_fwd = gt_seqabstract_new_empty();
+  ws->query_bwd = gt_seqabstract_new_empty();
+  ws->subject_fwd = gt_seqabstract_new_empty();
+  ws->subject_bwd = gt_seqabstract_new_empty();
+  ws->diagonals = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  ws->hituniques = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  ws->querykmers = NULL;
+  ws->rcquery = NULL;
+  ws->querykmersallocated = ws->rcqueryallocated = 0;
+}
+
+static void gt_n_r_encseq_search_workspace_delete(GtNRESWorkspace *ws)
+{
+  gt_xdrop_resources_delete(ws->left_res);
+  gt_xdrop_resources_delete(ws->right_res);
+  gt_seqabstract_delete(ws->query_fwd);
+  gt_seqabstract_delete(ws->query_bwd);
+  gt_seqabstract_delete(ws->subject_fwd);
+  gt_seqabstract_delete(ws->subject_bwd);
+  gt_hashmap_delete(ws->diagonals);
+  gt_hashmap_delete(ws->hituniques);
+  gt_free(ws->querykmers);
+  gt_free(ws->rcquery);
+}
+
+/* returns the reverse complement of <query>, which is encoded DNA */
+static const GtUchar *gt_n_r_encseq_search_revcompl(GtNRESWorkspace *ws,
+                                                    const GtUchar *query,
+                                                    GtUword querylen)
+{
+  GtUword idx;
+  if (ws->rcqueryallocated < querylen) {
+    ws->rcqueryallocated = querylen;
+    ws->rcquery = gt_realloc(ws->rcquery,
+                             sizeof (*ws->rcquery) * ws->rcqueryallocated);
+  }
+  for (idx = 0; idx < querylen; idx++) {
+    GtUchar cc = query[querylen - 1 - idx];
+    ws->rcquery[idx] = ISSPECIAL(cc) ? cc : (GtUchar) (3 - cc);
+  }
+  return ws->rcquery;
+}
+
+/* Extend seed at <qpos> of <query> and <spos> of the subject in both
+   directions. The subject is either <encseq> or, if that is <NULL>, <subject>,
+   and extensions are limited to positions <sleft> to <sright> (exclusive).
+   Both extensions stay in the resources of <ws> until the next call. */
+static void gt_n_r_encseq_search_extend(GtNRESWorkspace *ws,
+                                        const GtNREncseqSearch *nres,
+                                        const GtUchar *query,
+                                        GtUword querylen,
+                                        GtUword qpos,
+                                        const GtEncseq *encseq,
+                                        const GtUchar *subject,
+                                        GtUword sleft,
+                                        GtUword sright,
+                                        GtUword spos,
+                                        GtNRESHsp *hsp)
+{
+  const bool forward = true;
+  GtXdropbest empty = {0,0,0,0,0};
+
+  ws->left = ws->right = empty;
+  gt_xdrop_resources_reset(ws->left_res);
+  gt_xdrop_resources_reset(ws->right_res);
+  if (sleft < spos && qpos > 0) {
+    if (encseq != NULL)
+      gt_seqabstract_reinit_encseq(ws->subject_bwd, encseq, spos - sleft,
+                                   sleft);
+    else
+      gt_seqabstract_reinit_gtuchar(ws->subject_bwd, subject, spos - sleft,
+                                    sleft);
+    gt_seqabstract_reinit_gtuchar(ws->query_bwd, query, qpos, 0);
+    gt_evalxdroparbitscoresextend(!forward, &ws->left, ws->left_res,
+                                  ws->subject_bwd, ws->query_bwd,
+                                  nres->xdropscore);
+  }
+  if (encseq != NULL)
+    gt_seqabstract_reinit_encseq(ws->subject_fwd, encseq, sright - spos, spos);
+  else
+    gt_seqabstract_reinit_gtuchar(ws->subject_fwd, subject, sright - spos,
+                                  spos);
+  gt_seqabstract_reinit_gtuchar(ws->query_fwd, query, querylen - qpos, qpos);
+  gt_evalxdroparbitscoresextend(forward, &ws->right, ws->right_res,
+                                ws->subject_fwd, ws->query_fwd,
+                                nres->xdropscore);
+  /* ivalue corresponds to subject and jvalue to query */
+  hsp->qstart = qpos - ws->left.jvalue;
+  hsp->qend = qpos + ws->right.jvalue;
+  hsp->sstart = spos - ws->left.ivalue;
+  hsp->send = spos + ws->right.ivalue;
+  hsp->score = ws->left.score + ws->right.score;
+  hsp->alignlen = hsp->matches = 0;
+}
+
+/* count alignment columns and matches of the last extension */
+static void gt_n_r_encseq_search_alignment_stats(GtNRESWorkspace *ws,
+                                                 GtNRESHsp *hsp)
+{
+  GtXdropresources *res[2] = {ws->left_res, ws->right_res};
+  GtXdropbest *best[2] = {&ws->left, &ws->right};
+  int side;
+
+  for (side = 0; side < 2; side++) {
+    if (best[side]->score > 0 && best[side]->ivalue > 0 &&
+        best[side]->jvalue > 0) {
+      GtMultieoplist *meops = gt_xdrop_backtrack(res[side], best[side]);
+      GtUword idx, numofentries = gt_multieoplist_get_num_entries(meops);
+      for (idx = 0; idx < numofentries; idx++) {
+        GtMultieop meop = gt_multieoplist_get_entry(meops, idx);
+        hsp->alignlen += meop.steps;
+        if (meop.type == Match)
+          hsp->matches += meop.steps;
+      }
+      gt_multieoplist_delete(meops);
+    }
+  }
+}
+
+/* Search <query> against the unique database, append ids of unique entries
+   with an alignment of e-value up to <maxevalue> to <uniquehits>. */
+static void gt_n_r_encseq_search_coarse(const GtNREncseqSearch *nres,
+                                        GtNRESWorkspace *ws,
+                                        const GtUchar *query,
+                                        GtUword querylen,
+                                        double maxevalue,
+                                        GtArrayGtUword *uniquehits)
+{
+  const GtNRESKmerindex *kmerindex = &nres->kmerindex;
+  GtUword dblen = gt_encseq_total_length(nres->unique_es),
+          qpos;
+  GtCodetype code = 0;
+  unsigned int defined = 0;
+
+  gt_hashmap_reset(ws->diagonals);
+  for (qpos = 0; qpos < querylen; qpos++) {
+    GtUword first, last, seedpos, idx;
+    GtUchar cc = query[qpos];
+    if (ISSPECIAL(cc) || cc >= (GtUchar) nres->numofchars) {
+      defined = 0;
+      code = 0;
+      continue;
+    }
+    code = (code * nres->numofchars + cc) % nres->numofkmercodes;
+    if (++defined < nres->kmersize ||
+        !gt_n_r_encseq_search_kmerindex_find(kmerindex, code, &first, &last))
+      continue;
+    seedpos = qpos + 1 - nres->kmersize;
+    for (idx = first; idx < last; idx++) {
+      GtUword spos = kmerindex->positions[idx],
+              diagonal = spos + querylen - seedpos,
+              covered, unique_id, ustart;
+      GtNRESHsp hsp;
+      covered = (GtUword) gt_hashmap_get(ws->diagonals, (void *) diagonal);
+      if (covered > seedpos)
+        continue;
+      unique_id = gt_encseq_seqnum(nres->unique_es, spos);
+      if (gt_hashmap_get(ws->hituniques, (void *) (unique_id + 1)) != NULL)
+        continue;
+      ustart = gt_encseq_seqstartpos(nres->unique_es, unique_id);
+      gt_n_r_encseq_search_extend(ws, nres, query, querylen, seedpos,
+                                  nres->unique_es, NULL, ustart,
+                                  ustart + gt_encseq_seqlength(nres->unique_es,
+                                                               unique_id),
+                                  spos, &hsp);
+      gt_hashmap_add(ws->diagonals, (void *) diagonal, (void *) hsp.qend);
+      if (gt_n_r_encseq_search_evalue(nres, hsp.score, dblen, querylen) <=
+          maxevalue) {
+        gt_hashmap_add(ws->hituniques, (void *) (unique_id + 1),
+                       (void *) (unique_id + 1));
+        GT_STOREINARRAY(uniquehits, GtUword, 16, unique_id);
+      }
+    }
+  }
+}
+
+/* Search <query> against the decompressed original sequences listed in
+   <seqnums>, append alignments with e-value up to <batch->fine_eval> to
+   <hsps>. */
+static void gt_n_r_encseq_search_fine(const GtNRESBatch *batch,
+                                      GtNRESWorkspace *ws,
+                                      const GtUchar *query,
+                                      GtUword querylen,
+                                      bool reverse,
+                                      const GtArrayGtUword *seqnums,
+                                      GtArray *hsps)
+{
+  const GtNREncseqSearch *nres = batch->nres;
+  GtUword idx, numofquerykmers = 0,
+          dblen = batch->fine_dblen;
+  GtCodetype code = 0;
+  unsigned int defined = 0;
+
+  if (ws->querykmersallocated < querylen) {
+    ws->querykmersallocated = querylen;
+    ws->querykmers = gt_realloc(ws->querykmers, sizeof (*ws->querykmers) *
+                                ws->querykmersallocated);
+  }
+  for (idx = 0; idx < querylen; idx++) {
+    GtUchar cc = query[idx];
+    if (ISSPECIAL(cc) || cc >= (GtUchar) nres->numofchars) {
+      defined = 0;
+      code = 0;
+      continue;
+    }
+    code = (code * nres->numofchars + cc) % nres->numofkmercodes;
+    if (++defined >= nres->kmersize) {
+      ws->querykmers[numofquerykmers].code = code;
+      ws->querykmers[numofquerykmers++].position = idx + 1 - nres->kmersize;
+    }
+  }
+  qsort(ws->querykmers, (size_t) numofquerykmers, sizeof (*ws->querykmers),
+        gt_n_r_encseq_search_kmerpos_cmp);
+
+  for (idx = 0; idx < seqnums->nextfreeGtUword; idx++) {
+    GtUword slot, slen, spos, firsthsp = gt_array_size(hsps);
+    const GtUchar *subject;
+    GtUword left = 0, right = batch->numoforigseqs;
+    while (left < right) {
+      GtUword mid = left + GT_DIV2(right - left);
+      if (batch->origseqnums[mid] < seqnums->spaceGtUword[idx])
+        left = mid + 1;
+      else
+        right = mid;
+    }
+    slot = left;
+    gt_assert(slot < batch->numoforigseqs &&
+              batch->origseqnums[slot] == seqnums->spaceGtUword[idx]);
+    subject = batch->origsequences + batch->origstartpos[slot];
+    slen = batch->origstartpos[slot + 1] - batch->origstartpos[slot];
+
+    gt_hashmap_reset(ws->diagonals);
+    code = 0;
+    defined = 0;
+    for (spos = 0; spos < slen; spos++) {
+      GtUword kidx, seedpos;
+      GtUchar cc = subject[spos];
+      if (ISSPECIAL(cc) || cc >= (GtUchar) nres->numofchars) {
+        defined = 0;
+        code = 0;
+        continue;
+      }
+      code = (code * nres->numofchars + cc) % nres->numofkmercodes;
+      if (++defined < nres->kmersize)
+        continue;
+      seedpos = spos + 1 - nres->kmersize;
+      left = 0;
+      right = numofquerykmers;
+      while (left < right) {
+        GtUword mid = left + GT_DIV2(right - left);
+        if (ws->querykmers[mid].code < code)
+          left = mid + 1;
+        else
+          right = mid;
+      }
+      for (kidx = left;
+           kidx < numofquerykmers && ws->querykmers[kidx].code == code;
+           kidx++) {
+        GtUword qpos = ws->querykmers[kidx].position,
+                diagonal = seedpos + querylen - qpos,
+                covered, hidx;
+        bool contained = false;
+        GtNRESHsp hsp;
+        covered = (GtUword) gt_hashmap_get(ws->diagonals, (void *) diagonal);
+        if (covered > qpos)
+          continue;
+        for (hidx = firsthsp; !contained && hidx < gt_array_size(hsps);
+             hidx++) {
+          const GtNRESHsp *other = gt_array_get(hsps, hidx);
+          contained = other->reverse == reverse &&
+                      other->qstart <= qpos && qpos < other->qend &&
+                      other->sstart <= seedpos && seedpos < other->send;
+        }
+        if (contained)
+          continue;
+        gt_n_r_encseq_search_extend(ws, nres, query, querylen, qpos, NULL,
+                                    subject, 0, slen, seedpos, &hsp);
+        gt_hashmap_add(ws->diagonals, (void *) diagonal, (void *) hsp.qend);
+        hsp.evalue = gt_n_r_encseq_search_evalue(nres, hsp.score, dblen,
+                                                 querylen);
+        if (hsp.evalue <= batch->fine_eval) {
+          hsp.subject = batch->origseqnums[slot];
+          hsp.reverse = reverse;
+          gt_n_r_encseq_search_alignment_stats(ws, &hsp);
+          gt_array_add(hsps, hsp);
+        }
+      }
+    }
+  }
+}
+
+static int gt_n_r_encseq_search_hsp_cmp(const void *a, const void *b)
+{
+  const GtNRESHsp *ha = a, *hb = b;
+  if (ha->score != hb->score)
+    return ha->score > hb->score ? -1 : 1;
+  if (ha->subject != hb->subject)
+    return ha->subject < hb->subject ? -1 : 1;
+  if (ha->reverse != hb->reverse)
+    return ha->reverse ? 1 : -1;
+  if (ha->qstart != hb->qstart)
+    return ha->qstart < hb->qstart ? -1 : 1;
+  if (ha->sstart != hb->sstart)
+    return ha->sstart < hb->sstart ? -1 : 1;
+  return 0;
+}
+
+static void gt_n_r_encseq_search_show_hsps(const GtNRESBatch *batch,
+                                           GtUword querynum,
+                                           GtUword querylen,
+                                           GtArray *hsps)
+{
+  const GtNREncseqSearch *nres = batch->nres;
+  GtStr *outbuf = batch->outbufs[querynum];
+  const char *queryid = gt_str_array_get(batch->ids, querynum);
+  GtUword idx;
+
+  gt_array_sort(hsps, gt_n_r_encseq_search_hsp_cmp);
+  for (idx = 0; idx < gt_array_size(hsps); idx++) {
+    const GtNRESHsp *hsp = gt_array_get(hsps, idx);
+    GtUword subjectidlen, qstart, qend, sstart, send;
+    const char *subjectid = gt_n_r_encseq_get_orig_seqid(nres->nre,
+                                                         hsp->subject,
+                                                         &subjectidlen);
+    char buffer[BUFSIZ];
+    /* report 1-based positions, alignments with the reverse complement of the
+       query are reported on the minus strand of the subject */
+    if (hsp->reverse) {
+      qstart = querylen - hsp->qend + 1;
+      qend = querylen - hsp->qstart;
+      sstart = hsp->send;
+      send = hsp->sstart + 1;
+    }
+    else {
+      qstart = hsp->qstart + 1;
+      qend = hsp->qend;
+      sstart = hsp->sstart + 1;
+      send = hsp->send;
+    }
+    gt_str_append_cstr(outbuf, queryid);
+    gt_str_append_char(outbuf, '\t');
+    gt_str_append_cstr_nt(outbuf, subjectid, subjectidlen);
+    (void) snprintf(buffer, sizeof (buffer),
+                    "\t%.2f\t" GT_WU "\t" GT_WU "\t" GT_WU "\t" GT_WU "\t"
+                    GT_WU "\t%g\t%.3f\n",
+                    hsp->alignlen == 0
+                      ? 0.0 : 100.0 * hsp->matches / hsp->alignlen,
+                    hsp->alignlen, qstart, qend, sstart, send, hsp->evalue,
+                    gt_n_r_encseq_search_bitscore(nres, hsp->score));
+    gt_str_append_cstr(outbuf, buffer);
+  }
+}
+
+static void *gt_n_r_encseq_search_coarse_thread(void *data)
+{
+  GtNRESBatch *batch = data;
+  GtNRESWorkspace ws;
+
+  gt_n_r_encseq_search_workspace_init(&ws, batch->nres);
+  while (true) {
+    GtUword querynum, querylen;
+    const GtUchar *query;
+
+    gt_mutex_lock(batch->mutex);
+    querynum = batch->nextquery++;
+    gt_mutex_unlock(batch->mutex);
+    if (querynum >= batch->numofqueries)
+      break;
+    query = batch->sequences + batch->seqstartpos[querynum];
+    querylen = batch->seqstartpos[querynum + 1] -
+               batch->seqstartpos[querynum];
+    gt_hashmap_reset(ws.hituniques);
+    gt_n_r_encseq_search_coarse(batch->nres, &ws, query, querylen,
+                                batch->coarse_eval, &batch->hits[querynum]);
+    if (batch->nres->bothstrands)
+      gt_n_r_encseq_search_coarse(batch->nres, &ws,
+                                  gt_n_r_encseq_search_revcompl(&ws, query,
+                                                                querylen),
+                                  querylen, batch->coarse_eval,
+                                  &batch->hits[querynum]);
+  }
+  gt_n_r_encseq_search_workspace_delete(&ws);
+  return NULL;
+}
+
+static void *gt_n_r_encseq_search_fine_thread(void *data)
+{
+  GtNRESBatch *batch = data;
+  GtNRESWorkspace ws;
+  GtArray *hsps = gt_array_new(sizeof (GtNRESHsp));
+
+  gt_n_r_encseq_search_workspace_init(&ws, batch->nres);
+  while (true) {
+    GtUword querynum, querylen;
+    const GtUchar *query;
+
+    gt_mutex_lock(batch->mutex);
+    querynum = batch->nextquery++;
+    gt_mutex_unlock(batch->mutex);
+    if (querynum >= batch->numofqueries)
+      break;
+    if (batch->hits[querynum].nextfreeGtUword == 0)
+      continue;
+    query = batch->sequences + batch->seqstartpos[querynum];
+    querylen = batch->seqstartpos[querynum + 1] -
+               batch->seqstartpos[querynum];
+    gt_array_reset(hsps);
+    gt_n_r_encseq_search_fine(batch, &ws, query, querylen, false,
+                              &batch->hits[querynum], hsps);
+    if (batch->nres->bothstrands)
+      gt_n_r_encseq_search_fine(batch, &ws,
+                                gt_n_r_encseq_search_revcompl(&ws, query,
+                                                              querylen),
+                                querylen, true, &batch->hits[querynum], hsps);
+    gt_n_r_encseq_search_show_hsps(batch, querynum, querylen, hsps);
+    gt_mutex_lock(batch->mutex);
+    *batch->numofhits += gt_array_size(hsps);
+    gt_mutex_unlock(batch->mutex);
+  }
+  gt_array_delete(hsps);
+  gt_n_r_encseq_search_workspace_delete(&ws);
+  return NULL;
+}
+
+static void gt_n_r_encseq_search_batch_add(GtNRESBatch *batch,
+                                           const GtUchar *query,
+                                           GtUword querylen,
+                                           const char *description)
+{
+  GtUword idlen = 0,
+          startpos = batch->seqstartpos[batch->numofqueries];
+
+  if (startpos + querylen > batch->allocatedchars) {
+    batch->allocatedchars = startpos + querylen + GT_DIV2(startpos + querylen);
+    batch->sequences = gt_realloc(batch->sequences, sizeof (*batch->sequences)
+                                  * batch->allocatedchars);
+  }
+  if (batch->numofqueries == batch->allocatedqueries) {
+    batch->allocatedqueries += 64UL + GT_DIV2(batch->allocatedqueries);
+    batch->seqstartpos = gt_realloc(batch->seqstartpos,
+                                    sizeof (*batch->seqstartpos) *
+                                    (batch->allocatedqueries + 1));
+  }
+  memcpy(batch->sequences + startpos, query, sizeof (*query) * querylen);
+  batch->seqstartpos[++batch->numofqueries] = startpos + querylen;
+  /* like BLAST, use the first word of the description as id */
+  while (description[idlen] != '\0' && !isspace((int) description[idlen]))
+    idlen++;
+  gt_str_array_add_cstr_nt(batch->ids, description, idlen);
+}
+
+/* Read queries from <seqit> into <batch> until their total length reaches
+   <batchlength>. Returns 1 if queries were read, 0 at the end of the input and
+   -1 on error. */
+static int gt_n_r_encseq_search_batch_read(GtNRESBatch *batch,
+                                           GtSeqIterator *seqit,
+                                           GtUword batchlength,
+                                           GtError *err)
+{
+  const GtUchar *query;
+  GtUword querylen;
+  char *description;
+  int retval = 1;
+
+  batch->numofqueries = 0;
+  gt_str_array_reset(batch->ids);
+  while (batch->seqstartpos[batch->numofqueries] < batchlength &&
+         (retval = gt_seq_iterator_next(seqit, &query, &querylen, &description,
+                                        err)) == 1)
+    gt_n_r_encseq_search_batch_add(batch, query, querylen, description);
+  if (retval < 0)
+    return -1;
+  return batch->numofqueries > 0 ? 1 : 0;
+}
+
+/* replace the unique ids of the hits of each query in <batch> by the sorted
+   numbers of the original sequences referring to them, append those to
+   <all> */
+static void gt_n_r_encseq_search_hits_to_origs(GtNRESBatch *batch,
+                                               GtArrayGtUword *all)
+{
+  GtArrayGtUword seqnums;
+  GtUword querynum, idx;
+
+  GT_INITARRAY(&seqnums, GtUword);
+  for (querynum = 0; querynum < batch->numofqueries; querynum++) {
+    GtArrayGtUword *hits = &batch->hits[querynum];
+    seqnums.nextfreeGtUword = 0;
+    for (idx = 0; idx < hits->nextfreeGtUword; idx++)
+      gt_n_r_encseq_unique_orig_seqnums(batch->nres->nre,
+                                        hits->spaceGtUword[idx], &seqnums);
+    gt_n_r_encseq_search_sort_unique(&seqnums);
+    hits->nextfreeGtUword = 0;
+    for (idx = 0; idx < seqnums.nextfreeGtUword; idx++) {
+      GT_STOREINARRAY(hits, GtUword, 16, seqnums.spaceGtUword[idx]);
+      GT_STOREINARRAY(all, GtUword, 256, seqnums.spaceGtUword[idx]);
+    }
+  }
+  gt_n_r_encseq_search_sort_unique(all);
+  GT_FREEARRAY(&seqnums, GtUword);
+}
+
+/* decompress the union of the original sequences hit by the queries of
+   <batch> */
+static void gt_n_r_encseq_search_extract_origs(GtNRESBatch *batch)
+{
+  const GtNREncseqSearch *nres = batch->nres;
+  GtArrayGtUword all;
+  GtUword querynum, idx, totallength = 0;
+
+  GT_INITARRAY(&all, GtUword);
+  for (querynum = 0; querynum < batch->numofqueries; querynum++) {
+    const GtArrayGtUword *hits = &batch->hits[querynum];
+    for (idx = 0; idx < hits->nextfreeGtUword; idx++)
+      GT_STOREINARRAY(&all, GtUword, 256, hits->spaceGtUword[idx]);
+  }
+  gt_n_r_encseq_search_sort_unique(&all);
+  batch->numoforigseqs = all.nextfreeGtUword;
+  batch->origseqnums = gt_malloc(sizeof (*batch->origseqnums) *
+                                 (batch->numoforigseqs + 1));
+  batch->origstartpos = gt_malloc(sizeof (*batch->origstartpos) *
+                                  (batch->numoforigseqs + 1));
+  for (idx = 0; idx < batch->numoforigseqs; idx++) {
+    batch->origseqnums[idx] = all.spaceGtUword[idx];
+    batch->origstartpos[idx] = totallength;
+    totallength += gt_n_r_encseq_get_orig_seqlength(nres->nre,
+                                                    all.spaceGtUword[idx]);
+  }
+  batch->origstartpos[batch->numoforigseqs] = totallength;
+  batch->origsequences = gt_malloc(sizeof (*batch->origsequences) *
+                                   (totallength + 1));
+  for (idx = 0; idx < batch->numoforigseqs; idx++)
+    gt_n_r_encseq_extract_orig_seq_encoded(nres->nre, batch->origseqnums[idx],
+                                           batch->origsequences +
+                                             batch->origstartpos[idx]);
+  GT_FREEARRAY(&all, GtUword);
+}
+
+static void gt_n_r_encseq_search_release_origs(GtNRESBatch *batch)
+{
+  gt_free(batch->origsequences);
+  gt_free(batch->origseqnums);
+  gt_free(batch->origstartpos);
+  batch->origsequences = NULL;
+  batch->origseqnums = NULL;
+  batch->origstartpos = NULL;
+  batch->numoforigseqs = 0;
+}
+
+static GtSeqIterator *gt_n_r_encseq_search_query_iterator(
+                                                  const GtNREncseqSearch *nres,
+                                                  const GtStrArray *queryfiles,
+                                                  GtError *err)
+{
+  GtSeqIterator *seqit = gt_seq_iterator_sequence_buffer_new(queryfiles, err);
+  if (seqit != NULL)
+    gt_seq_iterator_set_symbolmap(seqit,
+                       gt_alphabet_symbolmap(gt_encseq_alphabet(
+                                                         nres->unique_es)));
+  return seqit;
+}
+
+int gt_n_r_encseq_search_run(GtNREncseqSearch *nres,
+                             const char *querypath,
+                             double coarse_eval,
+                             double fine_eval,
+                             double raw_eval,
+                             GtUword batchlength,
+                             GtFile *outfp,
+                             GtTimer *timer,
+                             GtUword *numofhits,
+                             GtError *err)
+{
+  int had_err = 0, retval;
+  GtNRESBatch batch;
+  GtStrArray *queryfiles = gt_str_array_new();
+  GtSeqIterator *seqit;
+  GtArrayGtUword all;
+  GtArrayGtUword *hits = NULL; /* of all queries */
+  GtUword idx, numofqueries = 0, firstquery = 0, allocatedhits = 0;
+
+  gt_error_check(err);
+  gt_assert(batchlength > 0);
+  memset(&batch, 0, sizeof (batch));
+  batch.nres = nres;
+  batch.seqstartpos = gt_malloc(sizeof (*batch.seqstartpos));
+  batch.seqstartpos[0] = 0;
+  batch.ids = gt_str_array_new();
+  batch.numofhits = numofhits;
+  batch.coarse_eval = coarse_eval;
+  batch.mutex = gt_mutex_new();
+  GT_INITARRAY(&all, GtUword);
+  *numofhits = 0;
+  gt_str_array_add_cstr(queryfiles, querypath);
+
+  /* The fine e-values depend on the total length of the original sequences
+     selected for all queries, so the coarse search is completed first. Only
+     the ids of the selected original sequences are kept per query, the query
+     file is read again for the fine search. */
+  if (timer != NULL)
+    gt_timer_show_progress(timer, "coarse search", stderr);
+  seqit = gt_n_r_encseq_search_query_iterator(nres, queryfiles, err);
+  if (seqit == NULL)
+    had_err = -1;
+  while (!had_err &&
+         (retval = gt_n_r_encseq_search_batch_read(&batch, seqit, batchlength,
+                                                   err)) != 0) {
+    if (retval < 0) {
+      had_err = -1;
+      break;
+    }
+    if (numofqueries + batch.numofqueries > allocatedhits) {
+      allocatedhits = numofqueries + batch.numofqueries +
+                      GT_DIV2(numofqueries + batch.numofqueries);
+      hits = gt_realloc(hits, sizeof (*hits) * allocatedhits);
+    }
+    for (idx = numofqueries; idx < numofqueries + batch.numofqueries; idx++)
+      GT_INITARRAY(&hits[idx], GtUword);
+    batch.hits = hits + numofqueries;
+    numofqueries += batch.numofqueries;
+    batch.nextquery = 0;
+    had_err = gt_multithread(gt_n_r_encseq_search_coarse_thread, &batch, err);
+    if (!had_err)
+      gt_n_r_encseq_search_hits_to_origs(&batch, &all);
+  }
+  gt_seq_iterator_delete(seqit);
+  seqit = NULL;
+  if (!had_err) {
+    for (idx = 0; idx < all.nextfreeGtUword; idx++)
+      batch.fine_dblen += gt_n_r_encseq_get_orig_seqlength(nres->nre,
+                                                         all.spaceGtUword[idx]);
+    if (fine_eval == GT_UNDEF_DOUBLE)
+      batch.fine_eval = raw_eval * batch.fine_dblen;
+    else
+      batch.fine_eval = fine_eval;
+    gt_logger_log(nres->logger, GT_WU " original sequences of total length "
+                  GT_WU " selected by coarse search", all.nextfreeGtUword,
+                  batch.fine_dblen);
+    gt_logger_log(nres->logger, "Fine E-value set to: %.4e", batch.fine_eval);
+    if (timer != NULL)
+      gt_timer_show_progress(timer, "fine search", stderr);
+    seqit = gt_n_r_encseq_search_query_iterator(nres, queryfiles, err);
+    if (seqit == NULL)
+      had_err = -1;
+  }
+  GT_FREEARRAY(&all, GtUword);
+  while (!had_err &&
+         (retval = gt_n_r_encseq_search_batch_read(&batch, seqit, batchlength,
+                                                   err)) != 0) {
+    if (retval < 0) {
+      had_err = -1;
+      break;
+    }
+    gt_assert(firstquery + batch.numofqueries <= numofqueries);
+    batch.hits = hits + firstquery;
+    firstquery += batch.numofqueries;
+    batch.outbufs = gt_malloc(sizeof (*batch.outbufs) * batch.numofqueries);
+    for (idx = 0; idx < batch.numofqueries; idx++)
+      batch.outbufs[idx] = gt_str_new();
+    gt_n_r_encseq_search_extract_origs(&batch);
+    batch.nextquery = 0;
+    had_err = gt_multithread(gt_n_r_encseq_search_fine_thread, &batch, err);
+    gt_n_r_encseq_search_release_origs(&batch);
+    for (idx = 0; idx < batch.numofqueries; idx++) {
+      if (!had_err)
+        gt_file_xwrite(outfp, gt_str_get(batch.outbufs[idx]),
+                       (size_t) gt_str_length(batch.outbufs[idx]));
+      gt_str_delete(batch.outbufs[idx]);
+    }
+    gt_free(batch.outbufs);
+    batch.outbufs = NULL;
+  }
+  gt_seq_iterator_delete(seqit);
+  for (idx = 0; idx < numofqueries; idx++)
+    GT_FREEARRAY(&hits[idx], GtUword);
+  gt_free(hits);
+  gt_free(batch.sequences);
+  gt_free(batch.seqstartpos);
+  gt_str_array_delete(batch.ids);
+  gt_str_array_delete(queryfiles);
+  gt_mutex_delete(batch.mutex);
+  return had_err;
+}
@@ -0,0 +1,77 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef N_R_ENCSEQ_SEARCH_H
+#define N_R_ENCSEQ_SEARCH_H
+
+#include "core/error_api.h"
+#include "core/file_api.h"
+#include "core/logger_api.h"
+#include "core/str_api.h"
+#include "core/timer_api.h"
+#include "extended/n_r_encseq.h"
+#include "match/xdrop.h"
+
+#define GT_NRENCSEQ_KMERINDEX_FILE_SUFFIX ".kmi"
+
+/* The <GtNREncseqSearch> class performs a compressive seed-and-extend search
+   of query sequences against a <GtNREncseq>. Exact k-mer seeds are looked up
+   in a k-mer index of the unique database and extended with xdrop, the
+   original sequences referring to each unique entry hit are decompressed and
+   searched the same way. */
+typedef struct GtNREncseqSearch GtNREncseqSearch;
+
+/* Return a new <GtNREncseqSearch> object for <nre>, which was read from
+   <basename_nre>. The k-mer index of size <kmersize> is read from
+   <basename_nre> with suffix <GT_NRENCSEQ_KMERINDEX_FILE_SUFFIX>, if it does
+   not exist or was built with a different <kmersize> it is constructed and, if
+   possible, stored there for later runs. Extensions use <scores> and
+   <xdropscore>, which both have to stay valid during the lifetime of the
+   returned object.
+   Returns <NULL> and sets <err> on error. */
+GtNREncseqSearch* gt_n_r_encseq_search_new(GtNREncseq *nre,
+                                           const char *basename_nre,
+                                           unsigned int kmersize,
+                                           const GtXdropArbitraryscores *scores,
+                                           GtWord xdropscore,
+                                           GtLogger *logger,
+                                           GtError *err);
+
+/* Search all sequences in fasta file <querypath>, hits against the unique
+   database with an e-value up to <coarse_eval> select the original sequences
+   to search. Hits against those are reported if their e-value does not exceed
+   <fine_eval>, or <raw_eval> times the total length of the selected original
+   sequences if <fine_eval> is <GT_UNDEF_DOUBLE>.
+   Hits are written to <outfp> in BLAST tabular format, ordered by query.
+   Queries are read in batches of total length at least <batchlength>, which
+   are processed by <gt_jobs> threads. Only the queries of one batch and the
+   original sequences selected for them are kept in memory, <querypath> is
+   read twice. <timer> might be <NULL>. Stores the number of reported hits in
+   <numofhits>. Returns 0 on success. */
+int               gt_n_r_encseq_search_run(GtNREncseqSearch *nres,
+                                           const char *querypath,
+                                           double coarse_eval,
+                                           double fine_eval,
+                                           double raw_eval,
+                                           GtUword batchlength,
+                                           GtFile *outfp,
+                                           GtTimer *timer,
+                                           GtUword *numofhits,
+                                           GtError *err);
+
+void              gt_n_r_encseq_search_delete(GtNREncseqSearch *nres);
+
+#endif
@@ -0,0 +1,232 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "core/assert_api.h"
+#include "core/class_alloc_lock.h"
+#include "core/ensure.h"
+#include "core/ma.h"
+#include "core/minmax.h"
+#include "core/thread_api.h"
+#include "extended/array_in_stream_api.h"
+#include "extended/comment_node_api.h"
+#include "extended/genome_node.h"
+#include "extended/prefetch_stream.h"
+
+typedef struct {
+  GtGenomeNode **nodes;
+  GtUword nof_nodes,
+          nextnode;
+  bool eof;
+  int had_err;
+  GtError *err;
+} GtPrefetchStreamBatch;
+
+struct GtPrefetchStream {
+  const GtNodeStream parent_instance;
+  GtNodeStream *in_stream;
+  GtUword batchsize;
+  GtPrefetchStreamBatch batches[2],
+                        *current_batch,
+                        *next_batch;
+  GtThread *prefetcher;
+  bool started,
+       pending; /* the next batch has yet to be retrieved (without threads) */
+};
+
+#define prefetch_stream_cast(NS)\
+        gt_node_stream_cast(gt_prefetch_stream_class(), NS)
+
+static void* prefetch_stream_fill_batch(void *data)
+{
+  GtPrefetchStream *ps = data;
+  GtPrefetchStreamBatch *batch = ps->next_batch;
+  GtGenomeNode *gn;
+  batch->nof_nodes = batch->nextnode = 0;
+  while (batch->nof_nodes < ps->batchsize) {
+    gn = NULL;
+    batch->had_err = gt_node_stream_next(ps->in_stream, &gn, batch->err);
+    if (batch->had_err)
+      break;
+    if (!gn) {
+      batch->eof = true;
+      break;
+    }
+    batch->nodes[batch->nof_nodes++] = gn;
+  }
+  return NULL;
+}
+
+/* start retrieving the next batch */
+static void prefetch_stream_start(GtPrefetchStream *ps)
+{
+#ifdef GT_THREADS_ENABLED
+  GtError *err = gt_error_new();
+  gt_assert(!ps->prefetcher);
+  ps->prefetcher = gt_thread_new(prefetch_stream_fill_batch, ps, err);
+  if (!ps->prefetcher) /* retrieve the batch in the calling thread instead */
+    (void) prefetch_stream_fill_batch(ps);
+  gt_error_delete(err);
+#else
+  /* no threads, retrieve the batch when it is needed */
+  ps->pending = true;
+#endif
+}
+
+/* wait until the next batch has been retrieved */
+static void prefetch_stream_finish(GtPrefetchStream *ps)
+{
+#ifdef GT_THREADS_ENABLED
+  if (ps->prefetcher) {
+    gt_thread_join(ps->prefetcher);
+    gt_thread_delete(ps->prefetcher);
+    ps->prefetcher = NULL;
+  }
+#else
+  if (ps->pending) {
+    (void) prefetch_stream_fill_batch(ps);
+    ps->pending = false;
+  }
+#endif
+}
+
+static int prefetch_stream_next(GtNodeStream *ns, GtGenomeNode **gn,
+                                GtError *err)
+{
+  GtPrefetchStream *ps;
+  GtPrefetchStreamBatch *batch;
+  gt_error_check(err);
+  ps = prefetch_stream_cast(ns);
+  if (!ps->started) {
+    prefetch_stream_start(ps);
+    ps->started = true;
+  }
+  batch = ps->current_batch;
+  while (batch->nextnode == batch->nof_nodes) {
+    if (batch->had_err) {
+      gt_error_set(err, "%s", gt_error_get(batch->err));
+      return batch->had_err;
+    }
+    if (batch->eof) {
+      *gn = NULL;
+      return 0;
+    }
+    /* switch to the prefetched batch and retrieve the following one */
+    prefetch_stream_finish(ps);
+    ps->current_batch = ps->next_batch;
+    ps->next_batch = batch;
+    batch = ps->current_batch;
+    if (!batch->eof && !batch->had_err)
+      prefetch_stream_start(ps);
+  }
+  *gn = batch->nodes[batch->nextnode++];
+  return 0;
+}
+
+static void prefetch_stream_free(GtNodeStream *ns)
+{
+  GtPrefetchStream *ps = prefetch_stream_cast(ns);
+  GtUword b;
+#ifdef GT_THREADS_ENABLED
+  prefetch_stream_finish(ps);
+#endif
+  for (b = 0; b < 2UL; b++) {
+    GtPrefetchStreamBatch *batch = ps->batches + b;
+    while (batch->nextnode < batch->nof_nodes)
+      gt_genome_node_delete(batch->nodes[batch->nextnode++]);
+    gt_free(batch->nodes);
+    gt_error_delete(batch->err);
+  }
+  gt_node_stream_delete(ps->in_stream);
+}
+
+const GtNodeStreamClass* gt_prefetch_stream_class(void)
+{
+  static const GtNodeStreamClass *nsc = NULL;
+  gt_class_alloc_lock_enter();
+  if (!nsc) {
+    nsc = gt_node_stream_class_new(sizeof (GtPrefetchStream),
+                                   prefetch_stream_free,
+                                   prefetch_stream_next);
+  }
+  gt_class_alloc_lock_leave();
+  return nsc;
+}
+
+GtNodeStream* gt_prefetch_stream_new(GtNodeStream *in_stream,
+                                     GtUword batchsize)
+{
+  GtPrefetchStream *ps;
+  GtNodeStream *ns;
+  GtUword b;
+  gt_assert(in_stream && batchsize);
+  ns = gt_node_stream_create(gt_prefetch_stream_class(),
+                             gt_node_stream_is_sorted(in_stream));
+  ps = prefetch_stream_cast(ns);
+  ps->in_stream = gt_node_stream_ref(in_stream);
+  ps->batchsize = batchsize;
+  for (b = 0; b < 2UL; b++) {
+    ps->batches[b].nodes = gt_malloc(sizeof (GtGenomeNode*) * batchsize);
+    ps->batches[b].nof_nodes = ps->batches[b].nextnode = 0;
+    ps->batches[b].eof = false;
+    ps->batches[b].had_err = 0;
+    ps->batches[b].err = gt_error_new();
+  }
+  ps->current_batch = ps->batches;
+  ps->next_batch = ps->batches + 1;
+  ps->prefetcher = NULL;
+  ps->started = false;
+  ps->pending = false;
+  return ns;
+}
+
+int gt_prefetch_stream_unit_test(GtError *err)
+{
+  GtArray *nodes = gt_array_new(sizeof (GtGenomeNode*));
+  GtNodeStream *array_stream, *ps;
+  GtGenomeNode *gn;
+  GtUword i, progress = 0;
+  const GtUword nof_nodes = 10UL, batchsize = 3UL;
+  int had_err = 0;
+  gt_error_check(err);
+
+  for (i = 0; i < nof_nodes; i++) {
+    gn = gt_comment_node_new("prefetch");
+    gt_array_add(nodes, gn);
+  }
+  array_stream = gt_array_in_stream_new(nodes, &progress, err);
+  ps = gt_prefetch_stream_new(array_stream, batchsize);
+  for (i = 0; !had_err && i <= nof_nodes; i++) {
+    had_err = gt_node_stream_next(ps, &gn, err);
+    if (!had_err && i < nof_nodes) {
+      gt_ensure(gn == *(GtGenomeNode**) gt_array_get(nodes, i));
+#ifndef GT_THREADS_ENABLED
+      /* without threads, a batch is only retrieved when it is needed (both
+         node streams read one node ahead) */
+      gt_ensure(progress == MIN(nof_nodes,
+                                ((i + 1) / batchsize + 1) * batchsize + 1));
+#endif
+    }
+    else if (!had_err)
+      gt_ensure(gn == NULL);
+  }
+  gt_ensure(progress == nof_nodes);
+  gt_node_stream_delete(ps);
+  gt_node_stream_delete(array_stream);
+  for (i = 0; i < gt_array_size(nodes); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(nodes, i));
+  gt_array_delete(nodes);
+  return had_err;
+}
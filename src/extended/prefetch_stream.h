@@ -0,0 +1,42 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#ifndef PREFETCH_STREAM_H
+#define PREFETCH_STREAM_H
+
+#include "core/types_api.h"
+#include "extended/node_stream_api.h"
+
+/* Implements the <GtNodeStream> interface. A <GtPrefetchStream> reads the
+   nodes of its input stream ahead of time in a separate thread: while the
+   nodes of one batch are passed on, the next batch is retrieved in the
+   background. Hence, at most two batches of nodes are held in memory.
+   Errors of the input stream are reported after all nodes retrieved before
+   the error have been passed on, as if the input stream was read directly.
+   The input stream must not be used by other threads or streams, and all
+   objects it shares with the nodes it creates must be thread-safe (e.g.,
+   interned sequence IDs, see <gt_symbol_str()>). */
+typedef struct GtPrefetchStream GtPrefetchStream;
+
+const GtNodeStreamClass* gt_prefetch_stream_class(void);
+/* Create a <GtPrefetchStream*> which retrieves the nodes from <in_stream> in
+   batches of up to <batchsize> nodes. If threads are not available, each batch
+   is retrieved when it is needed. */
+GtNodeStream*            gt_prefetch_stream_new(GtNodeStream *in_stream,
+                                                GtUword batchsize);
+int                      gt_prefetch_stream_unit_test(GtError *err);
+
+#endif
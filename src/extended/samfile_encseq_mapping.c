@@ -112,7 +112,7 @@ GtSamfileEncseqMapping *gt_samfile_encseq_mapping_new(
     return samfile_encseq_mapping;
 }
 
-static GtUword gt_samfile_encseq_mapping_seqnum(
+GtUword gt_samfile_encseq_mapping_seqnum(
     GtSamfileEncseqMapping *samfile_encseq_mapping,
     int32_t reference_num)
 {
@@ -38,6 +38,12 @@ GtSamfileEncseqMapping* gt_samfile_encseq_mapping_new(
                                             const GtEncseq *encseq,
                                             GtError *err);
 
+/* Returns the number of the sequence in the <GtEncseq> corresponding to the
+   reference with number <reference_num> in the SAM file. */
+GtUword           gt_samfile_encseq_mapping_seqnum(
+                                 GtSamfileEncseqMapping *samfile_encseq_mapping,
+                                 int32_t reference_num);
+
 /* Returns the coordinate in the <GtEncseq> corresponding to a given read with
    number <reference_num> in the SAM file and <reference_seqpos> */
 GtUword           gt_samfile_encseq_mapping_seqpos(
@@ -19,13 +19,28 @@
 #include "core/cstr_api.h"
 #include "core/ensure.h"
 #include "core/error_api.h"
+#include "core/fileutils_api.h"
 #include "core/ma_api.h"
+#include "core/str_api.h"
+#include "core/thread_api.h"
 #include "core/unused_api.h"
 #include "core/undef_api.h"
 #include "extended/sam_alignment.h"
 #include "extended/sam_alignment_rep.h"
 #include "extended/samfile_iterator.h"
 
+/* largest coordinate which can be stored in a BAM index */
+#define GT_SAMFILE_ITERATOR_MAXCOORD (1 << 29)
+/* number of records decoded in one go when prefetching */
+#define GT_SAMFILE_ITERATOR_BATCHSIZE 4096UL
+
+typedef struct {
+  bam1_t  **records;
+  GtUword   nof_records,
+            nextrecord;
+  int       retval; /* return value of the last read into this batch */
+} GtSamfileIteratorBatch;
+
 struct GtSamfileIterator {
   GtAlphabet     *alphabet;
   GtSamAlignment *current_alignment;
@@ -33,6 +48,17 @@ struct GtSamfileIterator {
                  *mode;
   samfile_t      *samfile;
   void           *aux;
+  bam_index_t    *index;
+  const bam_index_t *reference_index;
+  bam_iter_t      reference_iter;
+  int32_t         reference_num;
+  GtSamfileIteratorBatch batches[2],
+                 *current_batch,
+                 *next_batch;
+  GtThread       *prefetcher;
+  bool            prefetch,
+                  pending; /* the next batch has yet to be decoded (without
+                              threads) */
   GtUword   ref_count;
 };
 
@@ -50,6 +76,13 @@ GtSamfileIterator* gt_samfile_iterator_new(const char *filename,
   s_iter->aux = aux;
   s_iter->current_alignment = NULL;
   s_iter->alphabet = gt_alphabet_ref(alphabet);
+  s_iter->index = NULL;
+  s_iter->reference_index = NULL;
+  s_iter->reference_iter = NULL;
+  s_iter->reference_num = -1;
+  s_iter->prefetcher = NULL;
+  s_iter->prefetch = s_iter->pending = false;
+  s_iter->current_batch = s_iter->next_batch = NULL;
   s_iter->samfile = samopen(filename, mode, aux);
   if (s_iter->samfile == NULL) {
     gt_error_set(err, "could not open sam/bam file: %s", filename);
@@ -82,13 +115,40 @@ GtSamfileIterator* gt_samfile_iterator_new_sam(const char *filename,
                                  err);
 }
 
+static void gt_samfile_iterator_stop_prefetch(GtSamfileIterator *s_iter)
+{
+#ifdef GT_THREADS_ENABLED
+  if (s_iter->prefetcher != NULL) {
+    gt_thread_join(s_iter->prefetcher);
+    gt_thread_delete(s_iter->prefetcher);
+    s_iter->prefetcher = NULL;
+  }
+#else
+  s_iter->pending = false;
+#endif
+}
+
 void gt_samfile_iterator_delete(GtSamfileIterator *s_iter)
 {
   if (s_iter != NULL) {
     if (s_iter->ref_count != 0)
       s_iter->ref_count--;
     else {
-      samclose(s_iter->samfile);
+      gt_samfile_iterator_stop_prefetch(s_iter);
+      if (s_iter->prefetch) {
+        GtUword b, i;
+        for (b = 0; b < 2UL; b++) {
+          for (i = 0; i < GT_SAMFILE_ITERATOR_BATCHSIZE; i++)
+            bam_destroy1(s_iter->batches[b].records[i]);
+          gt_free(s_iter->batches[b].records);
+        }
+      }
+      if (s_iter->reference_iter != NULL)
+        bam_iter_destroy(s_iter->reference_iter);
+      if (s_iter->index != NULL)
+        bam_index_destroy(s_iter->index);
+      if (s_iter->samfile != NULL)
+        samclose(s_iter->samfile);
       gt_free(s_iter->filename);
       gt_free(s_iter->mode);
       gt_alphabet_delete(s_iter->alphabet);
@@ -98,6 +158,100 @@ void gt_samfile_iterator_delete(GtSamfileIterator *s_iter)
   }
 }
 
+static int gt_samfile_iterator_read(GtSamfileIterator *s_iter, bam1_t *b)
+{
+  int read;
+  if (s_iter->reference_iter != NULL)
+    return bam_iter_read(s_iter->samfile->x.bam, s_iter->reference_iter, b);
+  if (s_iter->reference_index != NULL) {
+    /* only alignments without reference, they are at the end of the file */
+    while ((read = samread(s_iter->samfile, b)) > 0 && b->core.tid >= 0)
+      /* skip alignments with reference */;
+    return read;
+  }
+  return samread(s_iter->samfile, b);
+}
+
+static void* gt_samfile_iterator_fill_batch(void *data)
+{
+  GtSamfileIterator *s_iter = data;
+  GtSamfileIteratorBatch *batch = s_iter->next_batch;
+  batch->nof_records = batch->nextrecord = 0;
+  do {
+    batch->retval = gt_samfile_iterator_read(s_iter,
+                                      batch->records[batch->nof_records]);
+    if (batch->retval > 0)
+      batch->nof_records++;
+  } while (batch->retval > 0 &&
+           batch->nof_records < GT_SAMFILE_ITERATOR_BATCHSIZE);
+  return NULL;
+}
+
+static void gt_samfile_iterator_start_prefetch(GtSamfileIterator *s_iter)
+{
+#ifdef GT_THREADS_ENABLED
+  GtError *err = gt_error_new();
+  gt_assert(s_iter->prefetcher == NULL);
+  s_iter->prefetcher = gt_thread_new(gt_samfile_iterator_fill_batch, s_iter,
+                                     err);
+  if (s_iter->prefetcher == NULL) /* decode in the calling thread instead */
+    (void) gt_samfile_iterator_fill_batch(s_iter);
+  gt_error_delete(err);
+#else
+  s_iter->pending = true; /* no threads, decode the batch when it is needed */
+#endif
+}
+
+static void gt_samfile_iterator_reset_batches(GtSamfileIterator *s_iter)
+{
+  s_iter->current_batch = s_iter->batches;
+  s_iter->next_batch = s_iter->batches + 1;
+  s_iter->current_batch->nof_records = s_iter->current_batch->nextrecord = 0;
+  s_iter->current_batch->retval = 1;
+  gt_samfile_iterator_start_prefetch(s_iter);
+}
+
+void gt_samfile_iterator_enable_prefetch(GtSamfileIterator *s_iter)
+{
+  GtUword b, i;
+  gt_assert(s_iter != NULL);
+  if (s_iter->prefetch)
+    return;
+  s_iter->prefetch = true;
+  for (b = 0; b < 2UL; b++) {
+    s_iter->batches[b].records
+      = gt_malloc(sizeof (*s_iter->batches[b].records) *
+                  GT_SAMFILE_ITERATOR_BATCHSIZE);
+    for (i = 0; i < GT_SAMFILE_ITERATOR_BATCHSIZE; i++)
+      s_iter->batches[b].records[i] = bam_init1();
+  }
+  gt_samfile_iterator_reset_batches(s_iter);
+}
+
+static int gt_samfile_iterator_next_prefetched(GtSamfileIterator *s_iter,
+                                               bam1_t **record)
+{
+  GtSamfileIteratorBatch *batch = s_iter->current_batch;
+  bam1_t *tmp;
+  while (batch->nextrecord == batch->nof_records) {
+    if (batch->retval <= 0)
+      return batch->retval;
+    if (s_iter->pending)
+      (void) gt_samfile_iterator_fill_batch(s_iter);
+    gt_samfile_iterator_stop_prefetch(s_iter);
+    s_iter->current_batch = s_iter->next_batch;
+    s_iter->next_batch = batch;
+    batch = s_iter->current_batch;
+    if (batch->retval > 0)
+      gt_samfile_iterator_start_prefetch(s_iter);
+  }
+  /* exchange the buffers instead of copying the record */
+  tmp = *record;
+  *record = batch->records[batch->nextrecord];
+  batch->records[batch->nextrecord++] = tmp;
+  return 1;
+}
+
 int gt_samfile_iterator_next(GtSamfileIterator *s_iter,
                              GtSamAlignment **s_alignment)
 {
@@ -105,7 +259,12 @@ int gt_samfile_iterator_next(GtSamfileIterator *s_iter,
   if (s_iter->current_alignment == NULL)
     s_iter->current_alignment = gt_sam_alignment_new(s_iter->alphabet);
   s_iter->current_alignment->rightmost = GT_UNDEF_UWORD;
-  read = samread(s_iter->samfile, s_iter->current_alignment->s_alignment);
+  if (s_iter->prefetch)
+    read = gt_samfile_iterator_next_prefetched(s_iter,
+                                     &s_iter->current_alignment->s_alignment);
+  else
+    read = gt_samfile_iterator_read(s_iter,
+                                    s_iter->current_alignment->s_alignment);
   if (read > 0) {
     *s_alignment = s_iter->current_alignment;
   }
@@ -115,19 +274,89 @@ int gt_samfile_iterator_next(GtSamfileIterator *s_iter,
   return read;
 }
 
+static int gt_samfile_iterator_query_reference(GtSamfileIterator *s_iter,
+                                               GtError *err)
+{
+  if (s_iter->reference_iter != NULL) {
+    bam_iter_destroy(s_iter->reference_iter);
+    s_iter->reference_iter = NULL;
+  }
+  if (s_iter->reference_num >= 0) {
+    s_iter->reference_iter = bam_iter_query(s_iter->reference_index,
+                                            s_iter->reference_num, 0,
+                                            GT_SAMFILE_ITERATOR_MAXCOORD);
+    if (s_iter->reference_iter == NULL) {
+      gt_error_set(err, "could not query reference %d of bam file: %s",
+                   s_iter->reference_num, s_iter->filename);
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int gt_samfile_iterator_reset(GtSamfileIterator *s_iter,
                               GtError *err)
 {
   gt_assert(s_iter != NULL);
+  gt_samfile_iterator_stop_prefetch(s_iter);
   samclose(s_iter->samfile);
   s_iter->samfile = samopen(s_iter->filename, s_iter->mode, s_iter->aux);
   if (s_iter->samfile == NULL) {
     gt_error_set(err, "could not reopen sam/bam file: %s", s_iter->filename);
     return -1;
   }
+  if (s_iter->reference_index != NULL &&
+      gt_samfile_iterator_query_reference(s_iter, err) != 0)
+    return -1;
+  if (s_iter->prefetch)
+    gt_samfile_iterator_reset_batches(s_iter);
   return 0;
 }
 
+int gt_samfile_iterator_load_index(GtSamfileIterator *s_iter, GtError *err)
+{
+  GtStr *indexfilename;
+  gt_assert(s_iter != NULL);
+  if (s_iter->index != NULL)
+    return 0;
+  if ((s_iter->samfile->type & 1) == 0 /* TYPE_BAM in sam.c */) {
+    gt_error_set(err, "cannot index sam file %s, a bam file is required",
+                 s_iter->filename);
+    return -1;
+  }
+  indexfilename = gt_str_new_cstr(s_iter->filename);
+  gt_str_append_cstr(indexfilename, ".bai");
+  /* bam_index_build() writes the index next to the bam file */
+  if (gt_file_exists(gt_str_get(indexfilename)) ||
+      bam_index_build(s_iter->filename) == 0)
+    s_iter->index = bam_index_load(s_iter->filename);
+  if (s_iter->index == NULL)
+    gt_error_set(err, "could not load index %s", gt_str_get(indexfilename));
+  gt_str_delete(indexfilename);
+  return s_iter->index == NULL ? -1 : 0;
+}
+
+GtSamfileIterator* gt_samfile_iterator_new_for_reference(
+                                                    GtSamfileIterator *s_iter,
+                                                    int32_t reference_num,
+                                                    GtError *err)
+{
+  GtSamfileIterator *r_iter;
+  gt_assert(s_iter != NULL && s_iter->index != NULL);
+  gt_assert(reference_num < gt_samfile_iterator_number_of_references(s_iter));
+  r_iter = gt_samfile_iterator_new(s_iter->filename, s_iter->mode,
+                                   s_iter->aux, s_iter->alphabet, err);
+  if (r_iter != NULL) {
+    r_iter->reference_index = s_iter->index;
+    r_iter->reference_num = reference_num < 0 ? -1 : reference_num;
+    if (gt_samfile_iterator_query_reference(r_iter, err) != 0) {
+      gt_samfile_iterator_delete(r_iter);
+      r_iter = NULL;
+    }
+  }
+  return r_iter;
+}
+
 const char* gt_samfile_iterator_reference_name(const GtSamfileIterator *s_iter,
                                                int32_t reference_num)
 {
@@ -46,6 +46,28 @@ GtSamfileIterator* gt_samfile_iterator_new_sam(const char *filename,
 int                gt_samfile_iterator_next(GtSamfileIterator *s_iter,
                                             GtSamAlignment **s_alignment);
 
+/* Decode the alignments in a separate thread, in batches ahead of the
+   alignments returned by <gt_samfile_iterator_next()>. */
+void               gt_samfile_iterator_enable_prefetch(
+                                                     GtSamfileIterator *s_iter);
+
+/* Loads the index <filename>.bai of the BAM file processed by <s_iter>, after
+   building it if there is no such file. Returns 0 on success and -1 on error,
+   with <err> set accordingly. */
+int                gt_samfile_iterator_load_index(GtSamfileIterator *s_iter,
+                                                  GtError *err);
+
+/* Returns a new <GtSamfileIterator> for the BAM file processed by <s_iter>
+   which only returns the alignments to the reference sequence with number
+   <reference_num>, or the alignments without reference if <reference_num> is
+   negative. The index of <s_iter> must have been loaded by
+   <gt_samfile_iterator_load_index()>, and <s_iter> must not be deleted
+   before the returned iterator. Returns NULL on error. */
+GtSamfileIterator* gt_samfile_iterator_new_for_reference(
+                                                    GtSamfileIterator *s_iter,
+                                                    int32_t reference_num,
+                                                    GtError *err);
+
 /* Resets the iterator to the beginning of the file */
 int                gt_samfile_iterator_reset(GtSamfileIterator *s_iter,
                                              GtError *err);
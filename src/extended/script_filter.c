@@ -316,6 +316,18 @@ int gt_script_filter_run(GtScriptFilter *sf, GtFeatureNode *gf,
   return had_err;
 }
 
+void gt_script_filter_set_read_only(GtScriptFilter *script_filter)
+{
+  gt_assert(script_filter);
+  gt_lua_genome_node_set_read_only(script_filter->L, true);
+}
+
+void gt_script_filter_collect_garbage(GtScriptFilter *script_filter)
+{
+  gt_assert(script_filter);
+  lua_gc(script_filter->L, LUA_GCCOLLECT, 0);
+}
+
 GtScriptFilter* gt_script_filter_ref(GtScriptFilter *script_filter)
 {
   if (!script_filter) return NULL;
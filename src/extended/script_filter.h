@@ -20,4 +20,13 @@
 
 #include "extended/script_filter_api.h"
 
+/* Makes nodes passed to the filter function of <script_filter> read-only, so
+   that filters in different Lua states can be run on different nodes in
+   parallel. */
+void gt_script_filter_set_read_only(GtScriptFilter *script_filter);
+
+/* Runs a full garbage collection in the Lua state of <script_filter>,
+   releasing the node references collected by previous runs. */
+void gt_script_filter_collect_garbage(GtScriptFilter *script_filter);
+
 #endif
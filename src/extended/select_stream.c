@@ -28,6 +28,7 @@ struct GtSelectStream
   const GtNodeStream parent_instance;
   GtNodeStream *in_stream;
   GtNodeVisitor *select_visitor; /* the actual work is done in the visitor */
+  GtError *flush_err; /* reported after the nodes preceding the failing one */
 };
 
 const GtNodeStreamClass* gt_select_stream_class(void);
@@ -35,6 +36,24 @@ const GtNodeStreamClass* gt_select_stream_class(void);
 #define gt_select_stream_cast(GS)\
         gt_node_stream_cast(gt_select_stream_class(), GS);
 
+/* Evaluate the nodes buffered in the select visitor. If the evaluation of a
+   node failed, the nodes preceding it are returned first and the error is
+   reported afterwards, as in a serial run. */
+static int select_stream_flush(GtSelectStream *fs, GtError *err)
+{
+  int had_err;
+  gt_error_check(err);
+  had_err = gt_select_visitor_flush(fs->select_visitor, err);
+  if (had_err && gt_select_visitor_node_buffer_size(fs->select_visitor)) {
+    gt_assert(!fs->flush_err);
+    fs->flush_err = gt_error_new();
+    gt_error_set(fs->flush_err, "%s", gt_error_get(err));
+    gt_error_unset(err);
+    had_err = 0;
+  }
+  return had_err;
+}
+
 static int select_stream_next(GtNodeStream *ns, GtGenomeNode **gn, GtError *err)
 {
   GtSelectStream *fs;
@@ -49,6 +68,15 @@ static int select_stream_next(GtNodeStream *ns, GtGenomeNode **gn, GtError *err)
     return 0;
   }
 
+  /* report an error deferred by select_stream_flush() */
+  if (fs->flush_err) {
+    gt_error_set(err, "%s", gt_error_get(fs->flush_err));
+    gt_error_delete(fs->flush_err);
+    fs->flush_err = NULL;
+    *gn = NULL;
+    return -1;
+  }
+
   /* no nodes in the buffer -> get new nodes */
   while (!(had_err = gt_node_stream_next(fs->in_stream, gn, err)) && *gn) {
     gt_assert(*gn && !had_err);
@@ -59,12 +87,27 @@ static int select_stream_next(GtNodeStream *ns, GtGenomeNode **gn, GtError *err)
       *gn = NULL;
       break;
     }
+    /* enough nodes buffered for parallel evaluation of Lua rules */
+    if (gt_select_visitor_needs_flush(fs->select_visitor)) {
+      *gn = NULL;
+      if ((had_err = select_stream_flush(fs, err)))
+        break;
+    }
     if (gt_select_visitor_node_buffer_size(fs->select_visitor)) {
       *gn = gt_select_visitor_get_node(fs->select_visitor);
       return 0;
     }
   }
 
+  /* end of input -> evaluate the remaining buffered nodes */
+  if (!had_err) {
+    had_err = select_stream_flush(fs, err);
+    if (!had_err && gt_select_visitor_node_buffer_size(fs->select_visitor)) {
+      *gn = gt_select_visitor_get_node(fs->select_visitor);
+      return 0;
+    }
+  }
+
   /* either we have an error or no new node */
   gt_assert(had_err || !*gn);
   return had_err;
@@ -73,6 +116,7 @@ static int select_stream_next(GtNodeStream *ns, GtGenomeNode **gn, GtError *err)
 static void select_stream_free(GtNodeStream *ns)
 {
   GtSelectStream *fs = gt_select_stream_cast(ns);
+  gt_error_delete(fs->flush_err);
   gt_node_visitor_delete(fs->select_visitor);
   gt_node_stream_delete(fs->in_stream);
 }
@@ -107,6 +151,7 @@ GtNodeStream* gt_select_stream_new(GtNodeStream *in_stream, GtStr *seqid,
   GtSelectStream *select_stream = gt_select_stream_cast(ns);
   gt_assert(in_stream);
   select_stream->in_stream = gt_node_stream_ref(in_stream);
+  select_stream->flush_err = NULL;
   select_stream->select_visitor =
     gt_select_visitor_new(seqid, source, contain_range, overlap_range, strand,
                           targetstrand, has_CDS, max_gene_length, max_gene_num,
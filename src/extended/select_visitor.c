@@ -19,7 +19,9 @@
 #include "core/assert_api.h"
 #include "core/ma.h"
 #include "core/minmax.h"
+#include "core/multithread_api.h"
 #include "core/queue_api.h"
+#include "core/thread_api.h"
 #include "core/undef_api.h"
 #include "core/unused_api.h"
 #include "extended/feature_node.h"
@@ -29,11 +31,26 @@
 #include "extended/script_filter.h"
 #include "extended/select_visitor.h"
 
+/* number of buffered nodes after which Lua rules are evaluated in parallel */
+#define GT_SELECT_VISITOR_BATCH_SIZE  1024
+
 typedef enum {
   GT_SELECT_AND,
   GT_SELECT_OR
 } GtSelectLogic;
 
+typedef enum {
+  GT_SELECT_KEEP,
+  GT_SELECT_DROP,
+  GT_SELECT_EVALUATE
+} GtSelectAction;
+
+typedef struct {
+  GtGenomeNode *gn;
+  GtSelectAction action;
+  bool select_node;
+} GtSelectPending;
+
 struct GtSelectVisitor {
   const GtNodeVisitor parent_instance;
   GtQueue *node_buffer;
@@ -59,6 +76,11 @@ struct GtSelectVisitor {
   GtArray *script_filters;
   GtSelectNodeFunc drophandler;
   void *data;
+  /* parallel evaluation of Lua rules: one set of script filters per thread,
+     nodes are buffered in <pending> in input order */
+  GtArray **thread_filters,
+          *pending;
+  GtUword nof_thread_filters;
 };
 
 #define select_visitor_cast(GV)\
@@ -78,16 +100,69 @@ static void select_visitor_free(GtNodeVisitor *nv)
     }
   }
   gt_array_delete(select_visitor->script_filters);
+  if (select_visitor->thread_filters) {
+    GtUword j;
+    /* the first set is <script_filters> itself */
+    for (j = 1; j < select_visitor->nof_thread_filters; j++) {
+      if (!select_visitor->thread_filters[j])
+        continue;
+      for (i = 0; i < gt_array_size(select_visitor->thread_filters[j]); i++) {
+        gt_script_filter_delete(*(GtScriptFilter**)
+                               gt_array_get(select_visitor->thread_filters[j],
+                                            i));
+      }
+      gt_array_delete(select_visitor->thread_filters[j]);
+    }
+    gt_free(select_visitor->thread_filters);
+  }
+  if (select_visitor->pending) {
+    GtUword j;
+    for (j = 0; j < gt_array_size(select_visitor->pending); j++) {
+      GtSelectPending *p = gt_array_get(select_visitor->pending, j);
+      gt_genome_node_delete(p->gn);
+    }
+    gt_array_delete(select_visitor->pending);
+  }
   gt_queue_delete(select_visitor->node_buffer);
 }
 
+/* Passes <gn> on, after all nodes buffered for parallel evaluation. */
+static void select_visitor_keep(GtSelectVisitor *sv, GtGenomeNode *gn)
+{
+  if (sv->pending) {
+    GtSelectPending p;
+    p.gn = gn;
+    p.action = GT_SELECT_KEEP;
+    gt_array_add(sv->pending, p);
+  }
+  else
+    gt_queue_add(sv->node_buffer, gn);
+}
+
+/* Hands <gn> to the drop handler and deletes it, after all nodes buffered for
+   parallel evaluation. */
+static void select_visitor_drop(GtSelectVisitor *sv, GtGenomeNode *gn,
+                                GtError *err)
+{
+  if (sv->pending) {
+    GtSelectPending p;
+    p.gn = gn;
+    p.action = GT_SELECT_DROP;
+    gt_array_add(sv->pending, p);
+  }
+  else {
+    sv->drophandler(gn, sv->data, err);
+    gt_genome_node_delete(gn);
+  }
+}
+
 static int select_visitor_comment_node(GtNodeVisitor *nv, GtCommentNode *c,
                                        GT_UNUSED GtError *err)
 {
   GtSelectVisitor *select_visitor;
   gt_error_check(err);
   select_visitor = select_visitor_cast(nv);
-  gt_queue_add(select_visitor->node_buffer, c);
+  select_visitor_keep(select_visitor, (GtGenomeNode*) c);
   return 0;
 }
 
@@ -97,7 +172,7 @@ static int select_visitor_meta_node(GtNodeVisitor *nv, GtMetaNode *mn,
   GtSelectVisitor *select_visitor;
   gt_error_check(err);
   select_visitor = select_visitor_cast(nv);
-  gt_queue_add(select_visitor->node_buffer, mn);
+  select_visitor_keep(select_visitor, (GtGenomeNode*) mn);
   return 0;
 }
 
@@ -274,17 +349,25 @@ static int select_visitor_feature_node(GtNodeVisitor *nv,
                                          fv->single_intron_factor);
   }
 
+  if (fv->is_lua && !select_node && fv->pending) {
+    /* evaluated later in parallel, see gt_select_visitor_flush() */
+    GtSelectPending p;
+    p.gn = (GtGenomeNode*) fn;
+    p.action = GT_SELECT_EVALUATE;
+    gt_array_add(fv->pending, p);
+    return 0;
+  }
+
   if (fv->is_lua && !select_node)
     had_err = filter_lua(fv->script_filters, fn, fv->select_logic,
                          &select_node, err);
 
   if (select_node && !had_err)
-    fv->drophandler((GtGenomeNode*) fn, fv->data, err);
-
-  if (select_node)
+    select_visitor_drop(fv, (GtGenomeNode*) fn, err);
+  else if (select_node)
     gt_genome_node_delete((GtGenomeNode*) fn);
   else
-    gt_queue_add(fv->node_buffer, fn);
+    select_visitor_keep(fv, (GtGenomeNode*) fn);
 
   return had_err;
 }
@@ -305,22 +388,18 @@ static int select_visitor_region_node(GtNodeVisitor *nv, GtRegionNode *rn,
         range.start = MAX(range.start, select_visitor->contain_range.start);
         range.end = MIN(range.end, select_visitor->contain_range.end);
         gt_genome_node_set_range((GtGenomeNode*) rn, &range);
-        gt_queue_add(select_visitor->node_buffer, rn);
+        select_visitor_keep(select_visitor, (GtGenomeNode*) rn);
       }
       else {
         /* contain range does not overlap with <rn> range -> handle <rn> */
-        select_visitor->drophandler((GtGenomeNode*) rn, select_visitor->data,
-                                    err);
-        gt_genome_node_delete((GtGenomeNode*) rn);
+        select_visitor_drop(select_visitor, (GtGenomeNode*) rn, err);
       }
     }
     else
-      gt_queue_add(select_visitor->node_buffer, rn);
-  }
-  else {
-    select_visitor->drophandler((GtGenomeNode*) rn, select_visitor->data, err);
-    gt_genome_node_delete((GtGenomeNode*) rn);
+      select_visitor_keep(select_visitor, (GtGenomeNode*) rn);
   }
+  else
+    select_visitor_drop(select_visitor, (GtGenomeNode*) rn, err);
   return 0;
 }
 
@@ -333,12 +412,10 @@ static int select_visitor_sequence_node(GtNodeVisitor *nv, GtSequenceNode *sn,
   if (!gt_str_length(select_visitor->seqid) || /* no seqid was specified */
       !gt_str_cmp(select_visitor->seqid,       /* or seqids are equal */
                   gt_genome_node_get_seqid((GtGenomeNode*) sn))) {
-    gt_queue_add(select_visitor->node_buffer, sn);
-  }
-  else {
-    select_visitor->drophandler((GtGenomeNode*) sn, select_visitor->data, err);
-    gt_genome_node_delete((GtGenomeNode*) sn);
+    select_visitor_keep(select_visitor, (GtGenomeNode*) sn);
   }
+  else
+    select_visitor_drop(select_visitor, (GtGenomeNode*) sn, err);
   return 0;
 }
 
@@ -348,7 +425,7 @@ static int select_visitor_eof_node(GtNodeVisitor *nv, GtEOFNode *eofn,
   GtSelectVisitor *select_visitor;
   gt_error_check(err);
   select_visitor = select_visitor_cast(nv);
-  gt_queue_add(select_visitor->node_buffer, eofn);
+  select_visitor_keep(select_visitor, (GtGenomeNode*) eofn);
   return 0;
 }
 
@@ -434,6 +511,38 @@ GtNodeVisitor* gt_select_visitor_new(GtStr *seqid,
       }
     }
   }
+  if (select_visitor->is_lua && gt_jobs > 1) {
+    /* evaluate rules in parallel, each thread gets its own Lua states */
+    GtUword j;
+    int i;
+    select_visitor->nof_thread_filters = gt_jobs;
+    select_visitor->thread_filters = gt_calloc(gt_jobs, sizeof (GtArray*));
+    select_visitor->thread_filters[0] = select_visitor->script_filters;
+    select_visitor->pending = gt_array_new(sizeof (GtSelectPending));
+    for (j = 1; j < select_visitor->nof_thread_filters; j++) {
+      select_visitor->thread_filters[j] =
+                                         gt_array_new(sizeof (GtScriptFilter*));
+      for (i = 0; i < gt_str_array_size(select_visitor->select_files); i++) {
+        GtScriptFilter *sf;
+        sf = gt_script_filter_new_unsafe(
+                                  gt_str_array_get(select_visitor->select_files,
+                                                   i),
+                                err);
+        if (!sf) {
+          gt_node_visitor_delete(nv);
+          return NULL;
+        }
+        gt_array_add(select_visitor->thread_filters[j], sf);
+      }
+    }
+    for (j = 0; j < select_visitor->nof_thread_filters; j++) {
+      for (i = 0; i < gt_array_size(select_visitor->thread_filters[j]); i++) {
+        gt_script_filter_set_read_only(*(GtScriptFilter**)
+                                 gt_array_get(select_visitor->thread_filters[j],
+                                              i));
+      }
+    }
+  }
   if (strcmp(gt_str_get(select_logic), "AND") == 0) {
     select_visitor->select_logic = GT_SELECT_AND;
   } else {
@@ -442,6 +551,119 @@ GtNodeVisitor* gt_select_visitor_new(GtStr *seqid,
   return nv;
 }
 
+typedef struct {
+  GtSelectVisitor *sv;
+  GtUword next_node,
+          next_filters,
+          *error_pos;
+  GtError **errors;
+  GtMutex *mutex;
+} GtSelectLuaJob;
+
+static void* select_visitor_lua_thread(void *data)
+{
+  GtSelectLuaJob *job = data;
+  GtSelectVisitor *sv = job->sv;
+  GtUword filters, i;
+  gt_assert(job);
+
+  gt_mutex_lock(job->mutex);
+  filters = job->next_filters++;
+  gt_mutex_unlock(job->mutex);
+  gt_assert(filters < sv->nof_thread_filters);
+
+  while (job->error_pos[filters] == GT_UNDEF_UWORD) {
+    GtSelectPending *p;
+    gt_mutex_lock(job->mutex);
+    i = job->next_node++;
+    gt_mutex_unlock(job->mutex);
+    if (i >= gt_array_size(sv->pending))
+      break;
+    p = gt_array_get(sv->pending, i);
+    if (p->action != GT_SELECT_EVALUATE)
+      continue;
+    p->select_node = false;
+    if (filter_lua(sv->thread_filters[filters], (GtFeatureNode*) p->gn,
+                   sv->select_logic, &p->select_node, job->errors[filters])) {
+      job->error_pos[filters] = i;
+    }
+  }
+  /* drop the node references held by Lua before the nodes are passed on */
+  for (i = 0; i < gt_array_size(sv->thread_filters[filters]); i++) {
+    gt_script_filter_collect_garbage(*(GtScriptFilter**)
+                                 gt_array_get(sv->thread_filters[filters], i));
+  }
+  return NULL;
+}
+
+bool gt_select_visitor_needs_flush(GtNodeVisitor *nv)
+{
+  GtSelectVisitor *select_visitor = select_visitor_cast(nv);
+  return select_visitor->pending
+           && gt_array_size(select_visitor->pending)
+                >= GT_SELECT_VISITOR_BATCH_SIZE;
+}
+
+int gt_select_visitor_flush(GtNodeVisitor *nv, GtError *err)
+{
+  GtSelectVisitor *sv = select_visitor_cast(nv);
+  GtSelectLuaJob job;
+  GtUword i, first_error = GT_UNDEF_UWORD, first_error_filters = 0;
+  int had_err = 0;
+  gt_error_check(err);
+
+  if (!sv->pending || !gt_array_size(sv->pending))
+    return 0;
+
+  job.sv = sv;
+  job.next_node = job.next_filters = 0;
+  job.mutex = gt_mutex_new();
+  job.error_pos = gt_malloc(sv->nof_thread_filters * sizeof (GtUword));
+  job.errors = gt_malloc(sv->nof_thread_filters * sizeof (GtError*));
+  for (i = 0; i < sv->nof_thread_filters; i++) {
+    job.error_pos[i] = GT_UNDEF_UWORD;
+    job.errors[i] = gt_error_new();
+  }
+  gt_assert(gt_jobs <= sv->nof_thread_filters);
+  had_err = gt_multithread(select_visitor_lua_thread, &job, err);
+
+  /* report the error of the first failing node, like a serial run would */
+  for (i = 0; i < sv->nof_thread_filters; i++) {
+    if (job.error_pos[i] < first_error) {
+      first_error = job.error_pos[i];
+      first_error_filters = i;
+    }
+  }
+  if (!had_err && first_error != GT_UNDEF_UWORD) {
+    gt_error_set(err, "%s", gt_error_get(job.errors[first_error_filters]));
+    had_err = -1;
+  }
+
+  /* pass on nodes in input order */
+  for (i = 0; i < gt_array_size(sv->pending); i++) {
+    GtSelectPending *p = gt_array_get(sv->pending, i);
+    if (had_err && (first_error == GT_UNDEF_UWORD || i >= first_error)) {
+      gt_genome_node_delete(p->gn);
+      continue;
+    }
+    if (p->action == GT_SELECT_KEEP
+          || (p->action == GT_SELECT_EVALUATE && !p->select_node)) {
+      gt_queue_add(sv->node_buffer, p->gn);
+    } else {
+      sv->drophandler(p->gn, sv->data, err);
+      gt_genome_node_delete(p->gn);
+    }
+  }
+  gt_array_reset(sv->pending);
+
+  for (i = 0; i < sv->nof_thread_filters; i++)
+    gt_error_delete(job.errors[i]);
+  gt_free(job.errors);
+  gt_free(job.error_pos);
+  gt_mutex_delete(job.mutex);
+  return had_err;
+}
+
 void gt_select_visitor_set_single_intron_factor(GtNodeVisitor *nv,
                                                 double single_intron_factor)
 {
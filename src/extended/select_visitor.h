@@ -45,6 +45,15 @@ GtNodeVisitor* gt_select_visitor_new(GtStr *seqid,
                                      GtError *err);
 void           gt_select_visitor_set_single_intron_factor(GtNodeVisitor*,
                                                           double);
+/* Returns true if enough nodes are buffered for parallel evaluation of the Lua
+   rules to call <gt_select_visitor_flush()>. Lua rules are evaluated in
+   parallel by <gt_jobs> independent sets of Lua states, nodes are read-only
+   for them. */
+bool           gt_select_visitor_needs_flush(GtNodeVisitor*);
+/* Evaluates the Lua rules for all buffered nodes in parallel and moves the
+   selected ones to the node buffer, in input order. Has to be called at the
+   end of the input. */
+int            gt_select_visitor_flush(GtNodeVisitor*, GtError*);
 GtUword  gt_select_visitor_node_buffer_size(GtNodeVisitor*);
 GtGenomeNode*  gt_select_visitor_get_node(GtNodeVisitor*);
 void           gt_select_visitor_set_drophandler(GtSelectVisitor *fv,
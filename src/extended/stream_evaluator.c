@@ -15,12 +15,17 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <string.h>
 #include "core/assert_api.h"
 #include "core/bsearch.h"
 #include "core/cstr_api.h"
 #include "core/hashmap.h"
 #include "core/log.h"
 #include "core/ma.h"
+#include "core/md5_seqid.h"
+#include "core/minmax.h"
+#include "core/multithread_api.h"
+#include "core/thread_api.h"
 #include "core/unused_api.h"
 #include "core/warning_api.h"
 #include "core/xansi_api.h"
@@ -35,12 +40,9 @@ typedef struct {
   GtUword TP, FP, FN;
 } NucEval;
 
-struct GtStreamEvaluator {
-  GtNodeStream *reference,
-               *prediction;
-  bool nuceval, evalLTR;
-  GtUword LTRdelta;
-  GtHashmap *slots; /* sequence id -> slot */
+/* the accumulated evaluation values, kept per sequence region during the
+   evaluation and summed up afterwards */
+typedef struct {
   GtEvaluator *mRNA_gene_evaluator,
               *CDS_gene_evaluator,
               *mRNA_mRNA_evaluator,
@@ -58,14 +60,33 @@ struct GtStreamEvaluator {
                 wrong_LTRs;
   NucEval mRNA_nucleotides,
           CDS_nucleotides;
+} EvalValues;
+
+struct GtStreamEvaluator {
+  GtNodeStream *reference,
+               *prediction;
+  bool nuceval, evalLTR;
+  GtUword LTRdelta;
+  GtHashmap *slots; /* sequence id -> slot */
+  EvalValues values;
 };
 
+/* A ``slot'' holds the reference of one sequence region. Exon ranges for the
+   nucleotide level are stored sparsely and merged into runs when the slot is
+   finished, nothing is allocated proportional to the region length. */
 typedef struct {
+  char *seqid;
   GtArray *genes_forward,
           *genes_reverse,
           *mRNAs_forward,
           *mRNAs_reverse,
-          *LTRs;
+          *LTRs,
+          *predictions; /* buffered for evaluation on a worker thread */
+  GtUword *genes_forward_max_ends,
+          *genes_reverse_max_ends,
+          *mRNAs_forward_max_ends,
+          *mRNAs_reverse_max_ends,
+          *LTRs_max_ends;
   GtTranscriptExons *mRNA_exons_forward,
                     *mRNA_exons_reverse,
                     *CDS_exons_forward,
@@ -79,15 +100,15 @@ typedef struct {
                 FP_mRNA_nucleotides_reverse,
                 FP_CDS_nucleotides_forward,
                 FP_CDS_nucleotides_reverse;
-  GtBittab *real_mRNA_nucleotides_forward,
-           *pred_mRNA_nucleotides_forward,
-           *real_mRNA_nucleotides_reverse,
-           *pred_mRNA_nucleotides_reverse,
-           *real_CDS_nucleotides_forward,
-           *pred_CDS_nucleotides_forward,
-           *real_CDS_nucleotides_reverse,
-           *pred_CDS_nucleotides_reverse,
-           *true_mRNA_genes_forward,
+  GtArray *real_mRNA_nucleotides_forward,
+          *pred_mRNA_nucleotides_forward,
+          *real_mRNA_nucleotides_reverse,
+          *pred_mRNA_nucleotides_reverse,
+          *real_CDS_nucleotides_forward,
+          *pred_CDS_nucleotides_forward,
+          *real_CDS_nucleotides_reverse,
+          *pred_CDS_nucleotides_reverse;
+  GtBittab *true_mRNA_genes_forward,
            *true_mRNA_genes_reverse,
            *true_CDS_genes_forward,
            *true_CDS_genes_reverse,
@@ -109,6 +130,8 @@ typedef struct {
                         *used_mRNA_exons_reverse,
                         *used_CDS_exons_forward,
                         *used_CDS_exons_reverse;
+  bool prepared; /* the reference of this slot is complete */
+  EvalValues values;
 } Slot;
 
 typedef struct
@@ -139,35 +162,95 @@ typedef struct {
                 *wrong_LTRs;
 } ProcessPredictedFeatureInfo;
 
-static Slot* slot_new(bool nuceval, GtRange range)
+static void eval_values_init(EvalValues *values)
+{
+  gt_assert(values);
+  memset(values, 0, sizeof *values);
+  values->mRNA_gene_evaluator = gt_evaluator_new();
+  values->CDS_gene_evaluator = gt_evaluator_new();
+  values->mRNA_mRNA_evaluator = gt_evaluator_new();
+  values->CDS_mRNA_evaluator = gt_evaluator_new();
+  values->LTR_evaluator = gt_evaluator_new();
+  values->mRNA_exon_evaluators = gt_transcript_evaluators_new();
+  values->mRNA_exon_evaluators_collapsed = gt_transcript_evaluators_new();
+  values->CDS_exon_evaluators = gt_transcript_evaluators_new();
+  values->CDS_exon_evaluators_collapsed = gt_transcript_evaluators_new();
+}
+
+static void eval_values_add(EvalValues *dest, const EvalValues *src)
+{
+  gt_assert(dest && src);
+  gt_evaluator_add(dest->mRNA_gene_evaluator, src->mRNA_gene_evaluator);
+  gt_evaluator_add(dest->CDS_gene_evaluator, src->CDS_gene_evaluator);
+  gt_evaluator_add(dest->mRNA_mRNA_evaluator, src->mRNA_mRNA_evaluator);
+  gt_evaluator_add(dest->CDS_mRNA_evaluator, src->CDS_mRNA_evaluator);
+  gt_evaluator_add(dest->LTR_evaluator, src->LTR_evaluator);
+  gt_transcript_evaluators_add(dest->mRNA_exon_evaluators,
+                               src->mRNA_exon_evaluators);
+  gt_transcript_evaluators_add(dest->mRNA_exon_evaluators_collapsed,
+                               src->mRNA_exon_evaluators_collapsed);
+  gt_transcript_evaluators_add(dest->CDS_exon_evaluators,
+                               src->CDS_exon_evaluators);
+  gt_transcript_evaluators_add(dest->CDS_exon_evaluators_collapsed,
+                               src->CDS_exon_evaluators_collapsed);
+  dest->missing_genes += src->missing_genes;
+  dest->wrong_genes += src->wrong_genes;
+  dest->missing_mRNAs += src->missing_mRNAs;
+  dest->wrong_mRNAs += src->wrong_mRNAs;
+  dest->missing_LTRs += src->missing_LTRs;
+  dest->wrong_LTRs += src->wrong_LTRs;
+  dest->mRNA_nucleotides.TP += src->mRNA_nucleotides.TP;
+  dest->mRNA_nucleotides.FP += src->mRNA_nucleotides.FP;
+  dest->mRNA_nucleotides.FN += src->mRNA_nucleotides.FN;
+  dest->CDS_nucleotides.TP += src->CDS_nucleotides.TP;
+  dest->CDS_nucleotides.FP += src->CDS_nucleotides.FP;
+  dest->CDS_nucleotides.FN += src->CDS_nucleotides.FN;
+}
+
+static void eval_values_clean(EvalValues *values)
+{
+  gt_assert(values);
+  gt_evaluator_delete(values->mRNA_gene_evaluator);
+  gt_evaluator_delete(values->CDS_gene_evaluator);
+  gt_evaluator_delete(values->mRNA_mRNA_evaluator);
+  gt_evaluator_delete(values->CDS_mRNA_evaluator);
+  gt_evaluator_delete(values->LTR_evaluator);
+  gt_transcript_evaluators_delete(values->mRNA_exon_evaluators);
+  gt_transcript_evaluators_delete(values->mRNA_exon_evaluators_collapsed);
+  gt_transcript_evaluators_delete(values->CDS_exon_evaluators);
+  gt_transcript_evaluators_delete(values->CDS_exon_evaluators_collapsed);
+}
+
+static Slot* slot_new(const char *seqid, bool nuceval, GtRange range)
 {
-  GtUword length;
   Slot *s = gt_calloc(1, sizeof (Slot));
-  length = gt_range_length(&range);
+  s->seqid = gt_cstr_dup(seqid);
   s->genes_forward = gt_array_new(sizeof (GtGenomeNode*));
   s->genes_reverse = gt_array_new(sizeof (GtGenomeNode*));
   s->mRNAs_forward = gt_array_new(sizeof (GtGenomeNode*));
   s->mRNAs_reverse = gt_array_new(sizeof (GtGenomeNode*));
   s->LTRs          = gt_array_new(sizeof (GtGenomeNode*));
+  s->predictions   = gt_array_new(sizeof (GtGenomeNode*));
   s->mRNA_exons_forward = gt_transcript_exons_new();
   s->mRNA_exons_reverse = gt_transcript_exons_new();
   s->CDS_exons_forward = gt_transcript_exons_new();
   s->CDS_exons_reverse = gt_transcript_exons_new();
+  s->real_range = range;
   if (nuceval) {
-    s->real_range = range;
-    s->real_mRNA_nucleotides_forward = gt_bittab_new(length);
-    s->pred_mRNA_nucleotides_forward = gt_bittab_new(length);
-    s->real_mRNA_nucleotides_reverse = gt_bittab_new(length);
-    s->pred_mRNA_nucleotides_reverse = gt_bittab_new(length);
-    s->real_CDS_nucleotides_forward = gt_bittab_new(length);
-    s->pred_CDS_nucleotides_forward = gt_bittab_new(length);
-    s->real_CDS_nucleotides_reverse = gt_bittab_new(length);
-    s->pred_CDS_nucleotides_reverse = gt_bittab_new(length);
+    s->real_mRNA_nucleotides_forward = gt_array_new(sizeof (GtRange));
+    s->pred_mRNA_nucleotides_forward = gt_array_new(sizeof (GtRange));
+    s->real_mRNA_nucleotides_reverse = gt_array_new(sizeof (GtRange));
+    s->pred_mRNA_nucleotides_reverse = gt_array_new(sizeof (GtRange));
+    s->real_CDS_nucleotides_forward = gt_array_new(sizeof (GtRange));
+    s->pred_CDS_nucleotides_forward = gt_array_new(sizeof (GtRange));
+    s->real_CDS_nucleotides_reverse = gt_array_new(sizeof (GtRange));
+    s->pred_CDS_nucleotides_reverse = gt_array_new(sizeof (GtRange));
   }
   s->used_mRNA_exons_forward = gt_transcript_used_exons_new();
   s->used_mRNA_exons_reverse = gt_transcript_used_exons_new();
   s->used_CDS_exons_forward = gt_transcript_used_exons_new();
   s->used_CDS_exons_reverse = gt_transcript_used_exons_new();
+  eval_values_init(&s->values);
   return s;
 }
 
@@ -175,6 +258,7 @@ static void slot_delete(Slot *s)
 {
   GtUword i;
   gt_assert(s);
+  gt_free(s->seqid);
   for (i = 0; i < gt_array_size(s->genes_forward); i++)
     gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(s->genes_forward, i));
   gt_array_delete(s->genes_forward);
@@ -190,6 +274,14 @@ static void slot_delete(Slot *s)
   for (i = 0; i < gt_array_size(s->LTRs); i++)
     gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(s->LTRs, i));
   gt_array_delete(s->LTRs);
+  for (i = 0; i < gt_array_size(s->predictions); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(s->predictions, i));
+  gt_array_delete(s->predictions);
+  gt_free(s->genes_forward_max_ends);
+  gt_free(s->genes_reverse_max_ends);
+  gt_free(s->mRNAs_forward_max_ends);
+  gt_free(s->mRNAs_reverse_max_ends);
+  gt_free(s->LTRs_max_ends);
   gt_transcript_exons_delete(s->mRNA_exons_forward);
   gt_transcript_exons_delete(s->mRNA_exons_reverse);
   gt_transcript_exons_delete(s->CDS_exons_forward);
@@ -198,14 +290,14 @@ static void slot_delete(Slot *s)
   gt_transcript_counts_delete(s->mRNA_counts_reverse);
   gt_transcript_counts_delete(s->CDS_counts_forward);
   gt_transcript_counts_delete(s->CDS_counts_reverse);
-  gt_bittab_delete(s->real_mRNA_nucleotides_forward);
-  gt_bittab_delete(s->pred_mRNA_nucleotides_forward);
-  gt_bittab_delete(s->real_mRNA_nucleotides_reverse);
-  gt_bittab_delete(s->pred_mRNA_nucleotides_reverse);
-  gt_bittab_delete(s->real_CDS_nucleotides_forward);
-  gt_bittab_delete(s->pred_CDS_nucleotides_forward);
-  gt_bittab_delete(s->real_CDS_nucleotides_reverse);
-  gt_bittab_delete(s->pred_CDS_nucleotides_reverse);
+  gt_array_delete(s->real_mRNA_nucleotides_forward);
+  gt_array_delete(s->pred_mRNA_nucleotides_forward);
+  gt_array_delete(s->real_mRNA_nucleotides_reverse);
+  gt_array_delete(s->pred_mRNA_nucleotides_reverse);
+  gt_array_delete(s->real_CDS_nucleotides_forward);
+  gt_array_delete(s->pred_CDS_nucleotides_forward);
+  gt_array_delete(s->real_CDS_nucleotides_reverse);
+  gt_array_delete(s->pred_CDS_nucleotides_reverse);
   gt_bittab_delete(s->true_mRNA_genes_forward);
   gt_bittab_delete(s->true_mRNA_genes_reverse);
   gt_bittab_delete(s->true_CDS_genes_forward);
@@ -228,9 +320,17 @@ static void slot_delete(Slot *s)
   gt_transcript_used_exons_delete(s->used_mRNA_exons_reverse);
   gt_transcript_used_exons_delete(s->used_CDS_exons_forward);
   gt_transcript_used_exons_delete(s->used_CDS_exons_reverse);
+  eval_values_clean(&s->values);
   gt_free(s);
 }
 
+static int slot_delete_func(GT_UNUSED void *key, void *value,
+                            GT_UNUSED void *data, GT_UNUSED GtError *err)
+{
+  slot_delete(value);
+  return 0;
+}
+
 GtStreamEvaluator* gt_stream_evaluator_new(GtNodeStream *reference,
                                            GtNodeStream *prediction,
                                            bool nuceval, bool evalLTR,
@@ -242,60 +342,69 @@ GtStreamEvaluator* gt_stream_evaluator_new(GtNodeStream *reference,
   evaluator->nuceval = nuceval;
   evaluator->evalLTR = evalLTR;
   evaluator->LTRdelta = LTRdelta;
-  evaluator->slots = gt_hashmap_new(GT_HASH_STRING, gt_free_func,
-                                    (GtFree) slot_delete);
-  evaluator->mRNA_gene_evaluator = gt_evaluator_new();
-  evaluator->CDS_gene_evaluator = gt_evaluator_new();
-  evaluator->mRNA_mRNA_evaluator = gt_evaluator_new();
-  evaluator->CDS_mRNA_evaluator = gt_evaluator_new();
-  evaluator->LTR_evaluator = gt_evaluator_new();
-  evaluator->mRNA_exon_evaluators = gt_transcript_evaluators_new();
-  evaluator->mRNA_exon_evaluators_collapsed = gt_transcript_evaluators_new();
-  evaluator->CDS_exon_evaluators = gt_transcript_evaluators_new();
-  evaluator->CDS_exon_evaluators_collapsed = gt_transcript_evaluators_new();
+  /* the keys are owned by the slots */
+  evaluator->slots = gt_hashmap_new(GT_HASH_STRING, NULL, NULL);
+  eval_values_init(&evaluator->values);
   return evaluator;
 }
 
-static int set_actuals_and_sort_them(GT_UNUSED void *key, void *value,
-                                     void *data, GT_UNUSED GtError *err)
+/* Returns an array containing for every position i the maximal end position of
+   the (sorted) <nodes> up to i. */
+static GtUword* nodes_max_ends(GtArray *nodes)
 {
-  GtStreamEvaluator *se = (GtStreamEvaluator*) data;
-  Slot *s = (Slot*) value;
+  GtUword i, *max_ends = NULL;
+  GtRange range;
+  gt_assert(nodes);
+  if (gt_array_size(nodes)) {
+    max_ends = gt_malloc(sizeof (GtUword) * gt_array_size(nodes));
+    for (i = 0; i < gt_array_size(nodes); i++) {
+      range = gt_genome_node_get_range(*(GtGenomeNode**)
+                                       gt_array_get(nodes, i));
+      max_ends[i] = i && max_ends[i-1] > range.end ? max_ends[i-1] : range.end;
+    }
+  }
+  return max_ends;
+}
 
-  gt_error_check(err);
-  gt_assert(key && value && data);
+/* called when the reference of slot <s> is complete */
+static void prepare_slot(Slot *s)
+{
+  EvalValues *values = &s->values;
+
+  gt_assert(s && !s->prepared);
+  s->prepared = true;
 
   /* set actual genes */
-  gt_evaluator_add_actual(se->mRNA_gene_evaluator,
+  gt_evaluator_add_actual(values->mRNA_gene_evaluator,
                           gt_array_size(s->genes_forward));
-  gt_evaluator_add_actual(se->mRNA_gene_evaluator,
+  gt_evaluator_add_actual(values->mRNA_gene_evaluator,
                           gt_array_size(s->genes_reverse));
-  gt_evaluator_add_actual(se->CDS_gene_evaluator,
+  gt_evaluator_add_actual(values->CDS_gene_evaluator,
                           gt_array_size(s->genes_forward));
-  gt_evaluator_add_actual(se->CDS_gene_evaluator,
+  gt_evaluator_add_actual(values->CDS_gene_evaluator,
                           gt_array_size(s->genes_reverse));
 
   /* set actual mRNAs */
-  gt_evaluator_add_actual(se->mRNA_mRNA_evaluator,
+  gt_evaluator_add_actual(values->mRNA_mRNA_evaluator,
                           gt_array_size(s->mRNAs_forward));
-  gt_evaluator_add_actual(se->mRNA_mRNA_evaluator,
+  gt_evaluator_add_actual(values->mRNA_mRNA_evaluator,
                           gt_array_size(s->mRNAs_reverse));
-  gt_evaluator_add_actual(se->CDS_mRNA_evaluator,
+  gt_evaluator_add_actual(values->CDS_mRNA_evaluator,
                           gt_array_size(s->mRNAs_forward));
-  gt_evaluator_add_actual(se->CDS_mRNA_evaluator,
+  gt_evaluator_add_actual(values->CDS_mRNA_evaluator,
                           gt_array_size(s->mRNAs_reverse));
 
   /* set actual LTRs */
-  gt_evaluator_add_actual(se->LTR_evaluator, gt_array_size(s->LTRs));
+  gt_evaluator_add_actual(values->LTR_evaluator, gt_array_size(s->LTRs));
 
   /* set actual exons (before uniq!) */
-  gt_transcript_evaluators_add_actuals(se->mRNA_exon_evaluators,
+  gt_transcript_evaluators_add_actuals(values->mRNA_exon_evaluators,
                                        s->mRNA_exons_forward);
-  gt_transcript_evaluators_add_actuals(se->mRNA_exon_evaluators,
+  gt_transcript_evaluators_add_actuals(values->mRNA_exon_evaluators,
                                        s->mRNA_exons_reverse);
-  gt_transcript_evaluators_add_actuals(se->CDS_exon_evaluators,
+  gt_transcript_evaluators_add_actuals(values->CDS_exon_evaluators,
                                        s->CDS_exons_forward);
-  gt_transcript_evaluators_add_actuals(se->CDS_exon_evaluators,
+  gt_transcript_evaluators_add_actuals(values->CDS_exon_evaluators,
                                        s->CDS_exons_reverse);
 
   /* sort genes */
@@ -326,13 +435,13 @@ static int set_actuals_and_sort_them(GT_UNUSED void *key, void *value,
     gt_transcript_exons_uniq_in_place_count(s->CDS_exons_reverse);
 
   /* set actual exons for the collapsed case (after uniq!) */
-  gt_transcript_evaluators_add_actuals(se->mRNA_exon_evaluators_collapsed,
+  gt_transcript_evaluators_add_actuals(values->mRNA_exon_evaluators_collapsed,
                                        s->mRNA_exons_forward);
-  gt_transcript_evaluators_add_actuals(se->mRNA_exon_evaluators_collapsed,
+  gt_transcript_evaluators_add_actuals(values->mRNA_exon_evaluators_collapsed,
                                        s->mRNA_exons_reverse);
-  gt_transcript_evaluators_add_actuals(se->CDS_exon_evaluators_collapsed,
+  gt_transcript_evaluators_add_actuals(values->CDS_exon_evaluators_collapsed,
                                        s->CDS_exons_forward);
-  gt_transcript_evaluators_add_actuals(se->CDS_exon_evaluators_collapsed,
+  gt_transcript_evaluators_add_actuals(values->CDS_exon_evaluators_collapsed,
                                        s->CDS_exons_reverse);
 
   /* make sure that the genes are sorted */
@@ -408,7 +517,12 @@ static int set_actuals_and_sort_them(GT_UNUSED void *key, void *value,
   s->CDS_exon_bittabs_reverse =
     gt_transcript_exons_create_bittabs(s->CDS_exons_reverse);
 
-  return 0;
+  /* init maximal end positions (for overlap queries) */
+  s->genes_forward_max_ends = nodes_max_ends(s->genes_forward);
+  s->genes_reverse_max_ends = nodes_max_ends(s->genes_reverse);
+  s->mRNAs_forward_max_ends = nodes_max_ends(s->mRNAs_forward);
+  s->mRNAs_reverse_max_ends = nodes_max_ends(s->mRNAs_reverse);
+  s->LTRs_max_ends = nodes_max_ends(s->LTRs);
 }
 
 static void add_real_exon(GtTranscriptExons *te, GtRange range,
@@ -440,20 +554,22 @@ static void add_real_exon(GtTranscriptExons *te, GtRange range,
   }
 }
 
-static void add_nucleotide_exon(GtBittab *nucleotides, GtRange range,
+static void add_nucleotide_exon(GtArray *nucleotides, GtRange range,
                                 GtRange real_range, GtUword *FP)
 {
-  GtUword i;
+  GtRange clipped;
   gt_assert(nucleotides);
-  for (i = range.start; i <= range.end; i++) {
-    if (gt_range_within(&real_range, i)) {
-      gt_assert(i >= real_range.start);
-      gt_bittab_set_bit(nucleotides, i - real_range.start);
-    }
-    else {
-      gt_assert(FP);
-      (*FP)++;
-    }
+  /* nucleotides outside of the sequence region are false positives */
+  if (FP) {
+    if (range.start < real_range.start)
+      *FP += MIN(range.end + 1, real_range.start) - range.start;
+    if (range.end > real_range.end)
+      *FP += range.end - MAX(range.start - 1, real_range.end);
+  }
+  if (gt_range_overlap(&range, &real_range)) {
+    clipped.start = MAX(range.start, real_range.start);
+    clipped.end = MIN(range.end, real_range.end);
+    gt_array_add(nucleotides, clipped);
   }
 }
 
@@ -734,13 +850,30 @@ static void store_predicted_exon(GtTranscriptEvaluators *te, GtFeatureNode *fn)
   }
 }
 
+/* <used_exons> is sorted and predicted exons arrive mostly in sorted order,
+   therefore search backwards from the end */
+static bool used_exons_contain(GtDlist *used_exons, GtRange *predicted_range)
+{
+  GtDlistelem *dlistelem;
+  int rval;
+  for (dlistelem = gt_dlist_last(used_exons); dlistelem != NULL;
+       dlistelem = gt_dlistelem_previous(dlistelem)) {
+    rval = gt_range_compare(gt_dlistelem_get_data(dlistelem), predicted_range);
+    if (!rval)
+      return true;
+    if (rval < 0)
+      break;
+  }
+  return false;
+}
+
 /* adds exon only if necessary */
 static void add_predicted_collapsed(GtDlist *used_exons,
                                     GtRange *predicted_range,
                                     GtEvaluator *exon_evaluator_collapsed)
 {
   GtRange *used_range;
-  if (!gt_dlist_find(used_exons, predicted_range)) {
+  if (!used_exons_contain(used_exons, predicted_range)) {
     used_range = gt_malloc(sizeof (GtRange));
     used_range->start = predicted_range->start;
     used_range->end = predicted_range->end;
@@ -947,6 +1080,40 @@ static void store_true_exon(GtFeatureNode *fn, GtStrand predicted_strand,
   }
 }
 
+/* Marks all <nodes> overlapping <fn> in <b> and returns true if there are
+   any. <nodes> are sorted and <max_ends> contains their maximal end positions
+   (see nodes_max_ends()), so only the candidates are visited. */
+static bool nodes_overlap_mark(GtFeatureNode *fn, GtArray *nodes,
+                               const GtUword *max_ends, GtBittab *b)
+{
+  GtRange fn_range, node_range;
+  GtUword lo = 0, hi, mid, i;
+  bool rval = false;
+  gt_assert(fn && nodes);
+  fn_range = gt_genome_node_get_range((GtGenomeNode*) fn);
+  hi = gt_array_size(nodes);
+  /* determine the first node which starts behind <fn> */
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    node_range = gt_genome_node_get_range(*(GtGenomeNode**)
+                                          gt_array_get(nodes, mid));
+    if (node_range.start > fn_range.end)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  /* all nodes before start in front of the end of <fn> */
+  for (i = lo; i > 0 && max_ends[i-1] >= fn_range.start; i--) {
+    node_range = gt_genome_node_get_range(*(GtGenomeNode**)
+                                          gt_array_get(nodes, i-1));
+    if (node_range.end >= fn_range.start) {
+      rval = true;
+      gt_bittab_set_bit(b, i-1);
+    }
+  }
+  return rval;
+}
+
 typedef bool (*FeaturesAreEqualFunc)(GtGenomeNode *gn_1, GtGenomeNode *gn_2,
                                      const char *feature_type);
 
@@ -1046,11 +1213,14 @@ static int process_predicted_feature(GtFeatureNode *fn, void *data,
         else {
           /* no gene with the same range found -> check if this is a wrong
              gene */
-          if (!gt_feature_node_overlaps_nodes_mark(fn,
+          if (!nodes_overlap_mark(fn,
                                     predicted_strand == GT_STRAND_FORWARD
                                     ? info->slot->genes_forward
                                     : info->slot->genes_reverse,
                                     predicted_strand == GT_STRAND_FORWARD
+                                    ? info->slot->genes_forward_max_ends
+                                    : info->slot->genes_reverse_max_ends,
+                                    predicted_strand == GT_STRAND_FORWARD
                                     ? info->slot->overlapped_genes_forward
                                     : info->slot->overlapped_genes_reverse)) {
             (*info->wrong_genes)++;
@@ -1105,11 +1275,14 @@ static int process_predicted_feature(GtFeatureNode *fn, void *data,
         else {
           /* no mRNA with the same range found -> check if this is a wrong
              mRNA */
-          if (!gt_feature_node_overlaps_nodes_mark(fn,
+          if (!nodes_overlap_mark(fn,
                                     predicted_strand == GT_STRAND_FORWARD
                                     ? info->slot->mRNAs_forward
                                     : info->slot->mRNAs_reverse,
                                     predicted_strand == GT_STRAND_FORWARD
+                                    ? info->slot->mRNAs_forward_max_ends
+                                    : info->slot->mRNAs_reverse_max_ends,
+                                    predicted_strand == GT_STRAND_FORWARD
                                     ? info->slot->overlapped_mRNAs_forward
                                     : info->slot->overlapped_mRNAs_reverse)) {
             (*info->wrong_mRNAs)++;
@@ -1150,8 +1323,8 @@ static int process_predicted_feature(GtFeatureNode *fn, void *data,
     }
     else {
       /* no LTR with the same range found -> check if this is a wrong LTR */
-      if (!gt_feature_node_overlaps_nodes_mark(fn, info->slot->LTRs,
-                                               info->slot->overlapped_LTRs)) {
+      if (!nodes_overlap_mark(fn, info->slot->LTRs, info->slot->LTRs_max_ends,
+                              info->slot->overlapped_LTRs)) {
         (*info->wrong_LTRs)++;
       }
     }
@@ -1248,220 +1421,490 @@ static int process_predicted_feature(GtFeatureNode *fn, void *data,
   return 0;
 }
 
-static int determine_missing_features(GT_UNUSED void *key, void *value,
-                                      void *data, GT_UNUSED GtError *err)
+static void determine_missing_features(Slot *slot)
 {
-  GtStreamEvaluator *se = (GtStreamEvaluator*) data;
-  Slot *slot = (Slot*) value;
-  gt_error_check(err);
-  gt_assert(key && value && data);
+  EvalValues *values = &slot->values;
+  gt_assert(slot);
   if (slot->overlapped_genes_forward) {
-    se->missing_genes +=
+    values->missing_genes +=
       gt_bittab_size(slot->overlapped_genes_forward) -
       gt_bittab_count_set_bits(slot->overlapped_genes_forward);
   }
   if (slot->overlapped_genes_reverse) {
-    se->missing_genes +=
+    values->missing_genes +=
       gt_bittab_size(slot->overlapped_genes_reverse) -
       gt_bittab_count_set_bits(slot->overlapped_genes_reverse);
   }
   if (slot->overlapped_mRNAs_forward) {
-    se->missing_mRNAs +=
+    values->missing_mRNAs +=
       gt_bittab_size(slot->overlapped_mRNAs_forward) -
       gt_bittab_count_set_bits(slot->overlapped_mRNAs_forward);
   }
   if (slot->overlapped_mRNAs_reverse) {
-    se->missing_mRNAs +=
+    values->missing_mRNAs +=
       gt_bittab_size(slot->overlapped_mRNAs_reverse) -
       gt_bittab_count_set_bits(slot->overlapped_mRNAs_reverse);
   }
   if (slot->overlapped_LTRs) {
-    se->missing_LTRs  += gt_bittab_size(slot->overlapped_LTRs) -
-                         gt_bittab_count_set_bits(slot->overlapped_LTRs);
+    values->missing_LTRs  += gt_bittab_size(slot->overlapped_LTRs) -
+                             gt_bittab_count_set_bits(slot->overlapped_LTRs);
   }
-  return 0;
 }
 
-static void add_nucleotide_values(NucEval *nucleotides, GtBittab *real,
-                                  GtBittab *pred, GtBittab *tmp,
-                                  const char *level)
+/* Sorts the exon <ranges> and merges them in place into disjoint runs.
+   Returns the number of covered nucleotides. */
+static GtUword merge_nucleotide_runs(GtArray *ranges)
 {
-  gt_assert(nucleotides && real && pred && tmp);
+  GtRange *runs;
+  GtUword i, nof_runs = 0, length = 0;
+  gt_assert(ranges);
+  if (!gt_array_size(ranges))
+    return 0;
+  gt_ranges_sort(ranges);
+  runs = gt_array_get_space(ranges);
+  for (i = 1; i < gt_array_size(ranges); i++) {
+    if (runs[i].start <= runs[nof_runs].end + 1)
+      runs[nof_runs].end = MAX(runs[nof_runs].end, runs[i].end);
+    else
+      runs[++nof_runs] = runs[i];
+  }
+  gt_array_set_size(ranges, ++nof_runs);
+  for (i = 0; i < nof_runs; i++)
+    length += gt_range_length(runs + i);
+  return length;
+}
+
+/* Returns the number of nucleotides covered by both lists of disjoint, sorted
+   <runs_a> and <runs_b>. */
+static GtUword nucleotide_runs_overlap(const GtArray *runs_a,
+                                       const GtArray *runs_b)
+{
+  const GtRange *a, *b;
+  GtUword i = 0, j = 0, overlap = 0;
+  gt_assert(runs_a && runs_b);
+  while (i < gt_array_size(runs_a) && j < gt_array_size(runs_b)) {
+    a = gt_array_get(runs_a, i);
+    b = gt_array_get(runs_b, j);
+    if (gt_range_overlap(a, b))
+      overlap += MIN(a->end, b->end) - MAX(a->start, b->start) + 1;
+    if (a->end < b->end)
+      i++;
+    else
+      j++;
+  }
+  return overlap;
+}
+
+static void log_nucleotide_runs(const GtArray *runs)
+{
+  GtUword i;
+  const GtRange *run;
+  for (i = 0; i < gt_array_size(runs); i++) {
+    run = gt_array_get(runs, i);
+    fprintf(gt_log_fp(), "[" GT_WU "," GT_WU "]", run->start, run->end);
+  }
+  fputc('\n', gt_log_fp());
+}
+
+static void add_nucleotide_values(NucEval *nucleotides, GtArray *real,
+                                  GtArray *pred, const char *level)
+{
+  GtUword real_length, pred_length, TP;
+  gt_assert(nucleotides && real && pred);
+  real_length = merge_nucleotide_runs(real);
+  pred_length = merge_nucleotide_runs(pred);
   if (gt_log_enabled()) {
     gt_log_log("%s", level);
     gt_log_log("reference:");
-    gt_bittab_show(real, gt_log_fp());
+    log_nucleotide_runs(real);
     gt_log_log("prediction:");
-    gt_bittab_show(pred, gt_log_fp());
+    log_nucleotide_runs(pred);
   }
+  TP = nucleotide_runs_overlap(real, pred);
   /* real & pred = TP */
-  gt_bittab_and(tmp, real, pred);
-  nucleotides->TP += gt_bittab_count_set_bits(tmp);
-  /* ~real & pred = FP */;
-  gt_bittab_complement(tmp, real);
-  gt_bittab_and_equal(tmp, pred);
-  nucleotides->FP += gt_bittab_count_set_bits(tmp);
+  nucleotides->TP += TP;
+  /* ~real & pred = FP */
+  nucleotides->FP += pred_length - TP;
   /* real & ~pred = FN */
-  gt_bittab_complement(tmp, pred);
-  gt_bittab_and_equal(tmp, real);
-  nucleotides->FN += gt_bittab_count_set_bits(tmp);
+  nucleotides->FN += real_length - TP;
 }
 
-static int compute_nucleotides_values(GT_UNUSED void *key, void *value,
-                                      void *data, GT_UNUSED GtError *err)
+static void compute_nucleotides_values(Slot *slot)
 {
-  GtStreamEvaluator *se = (GtStreamEvaluator*) data;
-  Slot *slot = (Slot*) value;
-  GtBittab *tmp;
-  gt_error_check(err);
-  gt_assert(key && value && data);
+  EvalValues *values = &slot->values;
+  gt_assert(slot);
   /* add ``out of range'' FPs */
-  se->mRNA_nucleotides.FP += slot->FP_mRNA_nucleotides_forward;
-  se->mRNA_nucleotides.FP += slot->FP_mRNA_nucleotides_reverse;
-  se->CDS_nucleotides.FP  += slot->FP_CDS_nucleotides_forward;
-  se->CDS_nucleotides.FP  += slot->FP_CDS_nucleotides_reverse;
+  values->mRNA_nucleotides.FP += slot->FP_mRNA_nucleotides_forward;
+  values->mRNA_nucleotides.FP += slot->FP_mRNA_nucleotides_reverse;
+  values->CDS_nucleotides.FP  += slot->FP_CDS_nucleotides_forward;
+  values->CDS_nucleotides.FP  += slot->FP_CDS_nucleotides_reverse;
   /* add other values */
-  tmp = gt_bittab_new(gt_range_length(&slot->real_range));
-  add_nucleotide_values(&se->mRNA_nucleotides,
+  add_nucleotide_values(&values->mRNA_nucleotides,
                         slot->real_mRNA_nucleotides_forward,
-                        slot->pred_mRNA_nucleotides_forward, tmp,
-                        "mRNA forward");
-  add_nucleotide_values(&se->mRNA_nucleotides,
+                        slot->pred_mRNA_nucleotides_forward, "mRNA forward");
+  add_nucleotide_values(&values->mRNA_nucleotides,
                         slot->real_mRNA_nucleotides_reverse,
-                        slot->pred_mRNA_nucleotides_reverse, tmp,
-                        "mRNA reverse");
-  add_nucleotide_values(&se->CDS_nucleotides,
+                        slot->pred_mRNA_nucleotides_reverse, "mRNA reverse");
+  add_nucleotide_values(&values->CDS_nucleotides,
                         slot->real_CDS_nucleotides_forward,
-                        slot->pred_CDS_nucleotides_forward, tmp,
-                        "CDS forward");
-  add_nucleotide_values(&se->CDS_nucleotides,
+                        slot->pred_CDS_nucleotides_forward, "CDS forward");
+  add_nucleotide_values(&values->CDS_nucleotides,
                         slot->real_CDS_nucleotides_reverse,
-                        slot->pred_CDS_nucleotides_reverse, tmp,
-                        "CDS reverse");
-  gt_bittab_delete(tmp);
+                        slot->pred_CDS_nucleotides_reverse, "CDS reverse");
+}
+
+/* let <info> collect the values of <slot> */
+static void set_predicted_info_slot(ProcessPredictedFeatureInfo *info,
+                                    Slot *slot)
+{
+  gt_assert(info && slot);
+  info->slot = slot;
+  info->mRNA_gene_evaluator = slot->values.mRNA_gene_evaluator;
+  info->CDS_gene_evaluator = slot->values.CDS_gene_evaluator;
+  info->mRNA_mRNA_evaluator = slot->values.mRNA_mRNA_evaluator;
+  info->CDS_mRNA_evaluator = slot->values.CDS_mRNA_evaluator;
+  info->LTR_evaluator = slot->values.LTR_evaluator;
+  info->mRNA_exon_evaluators = slot->values.mRNA_exon_evaluators;
+  info->mRNA_exon_evaluators_collapsed =
+    slot->values.mRNA_exon_evaluators_collapsed;
+  info->CDS_exon_evaluators = slot->values.CDS_exon_evaluators;
+  info->CDS_exon_evaluators_collapsed =
+    slot->values.CDS_exon_evaluators_collapsed;
+  info->wrong_genes = &slot->values.wrong_genes;
+  info->wrong_mRNAs = &slot->values.wrong_mRNAs;
+  info->wrong_LTRs = &slot->values.wrong_LTRs;
+}
+
+/* evaluate the buffered predictions of <slot> and compute its final values */
+static void evaluate_slot(Slot *slot, const ProcessPredictedFeatureInfo *info,
+                          bool nuceval)
+{
+  ProcessPredictedFeatureInfo predicted_info = *info;
+  GtUword i;
+  GT_UNUSED int had_err;
+  gt_assert(slot && slot->prepared);
+  set_predicted_info_slot(&predicted_info, slot);
+  for (i = 0; i < gt_array_size(slot->predictions); i++) {
+    GtFeatureNode *fn = *(GtFeatureNode**) gt_array_get(slot->predictions, i);
+    had_err = gt_feature_node_traverse_children(fn, &predicted_info,
+                                                process_predicted_feature,
+                                                false, NULL);
+    gt_assert(!had_err); /* cannot happen, process_predicted_feature() is
+                            sane */
+  }
+  determine_missing_features(slot);
+  if (nuceval)
+    compute_nucleotides_values(slot);
+}
+
+/* The reference and the prediction stream are sorted, therefore they are
+   processed in lockstep: the reference stream is read just far enough to
+   complete the slot of the current prediction sequence region, and slots which
+   both streams have passed are evaluated and freed. */
+typedef struct {
+  GtStreamEvaluator *se;
+  GtNodeVisitor *nv;
+  ProcessRealFeatureInfo real_info;
+  ProcessPredictedFeatureInfo predicted_info;
+  GtStr *reference_seqid,
+        *prediction_seqid;
+  Slot *reference_slot, /* the slot currently collecting the reference */
+       *prediction_slot;
+  GtArray *prepared_slots, /* reference complete, predictions pending */
+          *finished_slots; /* ready for evaluation */
+  bool reference_done,
+       parallel;
+} EvaluationState;
+
+typedef struct {
+  EvaluationState *state;
+  GtUword next_slot;
+  GtMutex *mutex;
+} EvaluateSlotsJob;
+
+static void* evaluate_slots_thread(void *data)
+{
+  EvaluateSlotsJob *job = data;
+  EvaluationState *state;
+  GtUword i;
+  gt_assert(job);
+  state = job->state;
+  for (;;) {
+    gt_mutex_lock(job->mutex);
+    i = job->next_slot++;
+    gt_mutex_unlock(job->mutex);
+    if (i >= gt_array_size(state->finished_slots))
+      break;
+    evaluate_slot(*(Slot**) gt_array_get(state->finished_slots, i),
+                  &state->predicted_info, state->se->nuceval);
+  }
+  return NULL;
+}
+
+/* evaluate the finished slots (in parallel, if possible), add their values to
+   the total ones and free them */
+static int evaluate_finished_slots(EvaluationState *state, GtError *err)
+{
+  GtUword i;
+  Slot *slot;
+  int had_err = 0;
+  gt_error_check(err);
+  if (state->parallel && gt_array_size(state->finished_slots) > 1) {
+    EvaluateSlotsJob job;
+    job.state = state;
+    job.next_slot = 0;
+    job.mutex = gt_mutex_new();
+    had_err = gt_multithread(evaluate_slots_thread, &job, err);
+    gt_mutex_delete(job.mutex);
+  }
+  else {
+    for (i = 0; i < gt_array_size(state->finished_slots); i++) {
+      evaluate_slot(*(Slot**) gt_array_get(state->finished_slots, i),
+                    &state->predicted_info, state->se->nuceval);
+    }
+  }
+  for (i = 0; i < gt_array_size(state->finished_slots); i++) {
+    slot = *(Slot**) gt_array_get(state->finished_slots, i);
+    if (!had_err)
+      eval_values_add(&state->se->values, &slot->values);
+    slot_delete(slot);
+  }
+  gt_array_reset(state->finished_slots);
+  return had_err;
+}
+
+/* finish all prepared slots in front of <seqid> (all, if <seqid> is NULL) */
+static int finish_slots(EvaluationState *state, const char *seqid,
+                        GtError *err)
+{
+  GtUword i, nof_prepared = 0;
+  Slot *slot;
+  gt_error_check(err);
+  for (i = 0; i < gt_array_size(state->prepared_slots); i++) {
+    slot = *(Slot**) gt_array_get(state->prepared_slots, i);
+    if (!seqid || gt_md5_seqid_cmp_seqids(slot->seqid, seqid) < 0) {
+      gt_hashmap_remove(state->se->slots, slot->seqid);
+      gt_array_add(state->finished_slots, slot);
+    }
+    else {
+      *(Slot**) gt_array_get(state->prepared_slots, nof_prepared++) = slot;
+    }
+  }
+  gt_array_set_size(state->prepared_slots, nof_prepared);
+  if (!seqid || !state->parallel ||
+      gt_array_size(state->finished_slots) >= gt_jobs) {
+    return evaluate_finished_slots(state, err);
+  }
   return 0;
 }
 
-int gt_stream_evaluator_evaluate(GtStreamEvaluator *se, bool verbose,
-                                 bool exondiff, bool exondiffcollapsed,
-                                 GtNodeVisitor *nv, GtError *err)
+static int check_seqid_order(GtStr *last_seqid, GtGenomeNode *gn,
+                             GtError *err)
 {
+  const char *seqid = gt_str_get(gt_genome_node_get_seqid(gn));
+  gt_error_check(err);
+  if (gt_str_length(last_seqid) &&
+      gt_md5_seqid_cmp_seqids(gt_str_get(last_seqid), seqid) > 0) {
+    gt_error_set(err, "the file %s is not sorted by sequence id (example: "
+                 "line %u)", gt_genome_node_get_filename(gn),
+                 gt_genome_node_get_line_number(gn));
+    return -1;
+  }
+  gt_str_set(last_seqid, seqid);
+  return 0;
+}
+
+/* Read the reference stream until a feature behind <seqid> has been read (the
+   complete stream, if <seqid> is NULL). */
+static int read_reference(EvaluationState *state, const char *seqid,
+                          GtError *err)
+{
+  GtStreamEvaluator *se = state->se;
   GtGenomeNode *gn;
   GtFeatureNode *fn;
   Slot *slot;
-  ProcessRealFeatureInfo real_info;
-  ProcessPredictedFeatureInfo predicted_info;
-  int had_err;
-
+  int had_err = 0;
   gt_error_check(err);
-  gt_assert(se);
 
-  /* init */
-  real_info.nuceval = se->nuceval;
-  real_info.verbose = verbose;
-  predicted_info.nuceval = se->nuceval;
-  predicted_info.verbose = verbose;
-  predicted_info.exondiff = exondiff;
-  predicted_info.exondiffcollapsed = exondiffcollapsed;
-  predicted_info.LTRdelta = se->LTRdelta;
-  predicted_info.mRNA_gene_evaluator = se->mRNA_gene_evaluator;
-  predicted_info.CDS_gene_evaluator = se->CDS_gene_evaluator;
-  predicted_info.mRNA_mRNA_evaluator = se->mRNA_mRNA_evaluator;
-  predicted_info.CDS_mRNA_evaluator = se->CDS_mRNA_evaluator;
-  predicted_info.LTR_evaluator  = se->LTR_evaluator;
-  predicted_info.mRNA_exon_evaluators = se->mRNA_exon_evaluators;
-  predicted_info.mRNA_exon_evaluators_collapsed =
-    se->mRNA_exon_evaluators_collapsed;
-  predicted_info.CDS_exon_evaluators = se->CDS_exon_evaluators;
-  predicted_info.CDS_exon_evaluators_collapsed =
-    se->CDS_exon_evaluators_collapsed;
-  predicted_info.wrong_genes = &se->wrong_genes;
-  predicted_info.wrong_mRNAs = &se->wrong_mRNAs;
-  predicted_info.wrong_LTRs  = &se->wrong_LTRs;
-
-  /* process the reference stream completely */
-  while (!(had_err = gt_node_stream_next(se->reference, &gn, err)) && gn) {
+  while (!had_err && !state->reference_done) {
+    if (seqid && gt_str_length(state->reference_seqid) &&
+        gt_md5_seqid_cmp_seqids(gt_str_get(state->reference_seqid),
+                                seqid) > 0) {
+      break;
+    }
+    if ((had_err = gt_node_stream_next(se->reference, &gn, err)))
+      break;
+    if (!gn) {
+      state->reference_done = true;
+      if (state->reference_slot) {
+        prepare_slot(state->reference_slot);
+        gt_array_add(state->prepared_slots, state->reference_slot);
+        state->reference_slot = NULL;
+      }
+      break;
+    }
     if (gt_region_node_try_cast(gn)) {
       /* each sequence region gets its own ``slot'' */
-      if (!(slot = gt_hashmap_get(se->slots,
-                                  gt_str_get(gt_genome_node_get_seqid(gn))))) {
-        slot = slot_new(se->nuceval, gt_genome_node_get_range(gn));
-        gt_hashmap_add(se->slots,
-                       gt_cstr_dup(gt_str_get(gt_genome_node_get_seqid(gn))),
-                       slot);
+      if (!gt_hashmap_get(se->slots,
+                          gt_str_get(gt_genome_node_get_seqid(gn)))) {
+        slot = slot_new(gt_str_get(gt_genome_node_get_seqid(gn)), se->nuceval,
+                        gt_genome_node_get_range(gn));
+        gt_hashmap_add(se->slots, slot->seqid, slot);
       }
-      gt_assert(slot);
     }
     /* we consider only genome features */
     if ((fn = gt_feature_node_try_cast(gn))) {
-      /* each sequence must have its own ``slot'' at this point */
-      slot = gt_hashmap_get(se->slots,
-                            gt_str_get(gt_genome_node_get_seqid(gn)));
-      gt_assert(slot);
-      /* store the exons */
-      real_info.slot = slot;
-      gt_feature_node_determine_transcripttypes(fn);
-      had_err = gt_feature_node_traverse_children(fn, &real_info,
-                                                  process_real_feature, false,
-                                                  NULL);
-      gt_assert(!had_err); /* cannot happen, process_real_feature() is sane */
+      if (!state->reference_slot ||
+          strcmp(state->reference_slot->seqid,
+                 gt_str_get(gt_genome_node_get_seqid(gn)))) {
+        /* the reference of the last slot is complete */
+        had_err = check_seqid_order(state->reference_seqid, gn, err);
+        if (!had_err && state->reference_slot) {
+          prepare_slot(state->reference_slot);
+          gt_array_add(state->prepared_slots, state->reference_slot);
+        }
+        if (!had_err) {
+          /* each sequence must have its own ``slot'' at this point */
+          state->reference_slot =
+            gt_hashmap_get(se->slots, gt_str_get(gt_genome_node_get_seqid(gn)));
+          gt_assert(state->reference_slot);
+          gt_assert(!state->reference_slot->prepared);
+        }
+      }
+      if (!had_err) {
+        /* store the exons */
+        state->real_info.slot = state->reference_slot;
+        gt_feature_node_determine_transcripttypes(fn);
+        had_err = gt_feature_node_traverse_children(fn, &state->real_info,
+                                                    process_real_feature,
+                                                    false, NULL);
+        gt_assert(!had_err); /* cannot happen, process_real_feature() is
+                                sane */
+      }
     }
-    if (nv)
-      gt_genome_node_accept(gn, nv, err);
+    if (!had_err && state->nv)
+      gt_genome_node_accept(gn, state->nv, err);
     gt_genome_node_delete(gn);
   }
+  return had_err;
+}
 
-  /* set the actuals and sort them */
+/* a new sequence region starts in the prediction stream */
+static int enter_prediction_region(EvaluationState *state, GtGenomeNode *gn,
+                                   GtError *err)
+{
+  const char *seqid = gt_str_get(gt_genome_node_get_seqid(gn));
+  Slot *slot;
+  int had_err;
+  gt_error_check(err);
+  had_err = check_seqid_order(state->prediction_seqid, gn, err);
+  if (!had_err)
+    had_err = read_reference(state, seqid, err);
+  if (!had_err)
+    had_err = finish_slots(state, seqid, err);
   if (!had_err) {
-    had_err = gt_hashmap_foreach(se->slots, set_actuals_and_sort_them, se,
-                                 NULL);
-    gt_assert(!had_err); /* set_actuals_and_sort_them() is sane */
+    /* get (real) slot */
+    slot = gt_hashmap_get(state->se->slots, seqid);
+    if (slot && !slot->prepared) {
+      /* the reference contains no features for this region */
+      prepare_slot(slot);
+      gt_array_add(state->prepared_slots, slot);
+    }
+    state->prediction_slot = slot;
   }
+  return had_err;
+}
+
+int gt_stream_evaluator_evaluate(GtStreamEvaluator *se, bool verbose,
+                                 bool exondiff, bool exondiffcollapsed,
+                                 GtNodeVisitor *nv, GtError *err)
+{
+  EvaluationState state;
+  GtGenomeNode *gn;
+  GtFeatureNode *fn;
+  int had_err = 0;
+
+  gt_error_check(err);
+  gt_assert(se);
+
+  /* init */
+  memset(&state, 0, sizeof state);
+  state.se = se;
+  state.nv = nv;
+  state.real_info.nuceval = se->nuceval;
+  state.real_info.verbose = verbose;
+  state.predicted_info.nuceval = se->nuceval;
+  state.predicted_info.verbose = verbose;
+  state.predicted_info.exondiff = exondiff;
+  state.predicted_info.exondiffcollapsed = exondiffcollapsed;
+  state.predicted_info.LTRdelta = se->LTRdelta;
+  state.reference_seqid = gt_str_new();
+  state.prediction_seqid = gt_str_new();
+  state.prepared_slots = gt_array_new(sizeof (Slot*));
+  state.finished_slots = gt_array_new(sizeof (Slot*));
+  /* sequence regions are evaluated on worker threads, unless output has to
+     appear in input order */
+  state.parallel = gt_jobs > 1 && !nv && !exondiff && !exondiffcollapsed &&
+                   !gt_log_enabled();
+
+  /* the visitor sees all reference nodes before the prediction nodes */
+  if (nv)
+    had_err = read_reference(&state, NULL, err);
 
   /* process the prediction stream */
-  if (!had_err) {
-    while (!had_err &&
-             !(had_err = gt_node_stream_next(se->prediction, &gn, err)) &&
-                gn) {
-      /* we consider only genome features */
-      if ((fn = gt_feature_node_try_cast(gn))) {
-        /* get (real) slot */
-        slot = gt_hashmap_get(se->slots,
-                              gt_str_get(gt_genome_node_get_seqid(gn)));
-        if (slot) {
-          predicted_info.slot = slot;
-          gt_feature_node_determine_transcripttypes(fn);
-          had_err = gt_feature_node_traverse_children(fn, &predicted_info,
+  while (!had_err &&
+         !(had_err = gt_node_stream_next(se->prediction, &gn, err)) && gn) {
+    /* we consider only genome features */
+    if ((fn = gt_feature_node_try_cast(gn))) {
+      if (!gt_str_length(state.prediction_seqid) ||
+          strcmp(gt_str_get(state.prediction_seqid),
+                 gt_str_get(gt_genome_node_get_seqid(gn)))) {
+        had_err = enter_prediction_region(&state, gn, err);
+      }
+      if (!had_err && state.prediction_slot) {
+        gt_feature_node_determine_transcripttypes(fn);
+        if (state.parallel) {
+          GtGenomeNode *gn_ref = gt_genome_node_ref(gn);
+          gt_array_add(state.prediction_slot->predictions, gn_ref);
+        }
+        else {
+          set_predicted_info_slot(&state.predicted_info,
+                                  state.prediction_slot);
+          had_err = gt_feature_node_traverse_children(fn,
+                                                      &state.predicted_info,
                                                       process_predicted_feature,
                                                       false, NULL);
           gt_assert(!had_err); /* cannot happen, process_predicted_feature() is
-                               sane */
-        }
-        else {
-          /* we got no (real) slot */
-          gt_warning("sequence id \"%s\" (with predictions) not given in "
-                     "reference", gt_str_get(gt_genome_node_get_seqid(gn)));
+                                  sane */
         }
       }
-      if (nv)
-        had_err = gt_genome_node_accept(gn, nv, err);
-      gt_genome_node_delete(gn);
+      else if (!had_err) {
+        /* we got no (real) slot */
+        gt_warning("sequence id \"%s\" (with predictions) not given in "
+                   "reference", gt_str_get(gt_genome_node_get_seqid(gn)));
+      }
     }
+    if (!had_err && nv)
+      had_err = gt_genome_node_accept(gn, nv, err);
+    gt_genome_node_delete(gn);
   }
 
-  /* determine the missing mRNAs */
-  if (!had_err) {
-    had_err = gt_hashmap_foreach(se->slots, determine_missing_features, se,
-                                 NULL);
-    gt_assert(!had_err); /* determine_missing_features() is sane */
-  }
+  /* process the rest of the reference and evaluate the remaining slots */
+  if (!had_err)
+    had_err = read_reference(&state, NULL, err);
+  if (!had_err)
+    had_err = finish_slots(&state, NULL, err);
 
-  /* compute the nucleotides values */
-  if (!had_err && se->nuceval) {
-    had_err = gt_hashmap_foreach(se->slots, compute_nucleotides_values, se,
-                                 NULL);
-    gt_assert(!had_err); /* compute_nucleotides_values() is sane */
+  /* free */
+  while (gt_array_size(state.prepared_slots)) {
+    Slot *slot = *(Slot**) gt_array_pop(state.prepared_slots);
+    gt_hashmap_remove(se->slots, slot->seqid);
+    slot_delete(slot);
   }
+  gt_array_delete(state.prepared_slots);
+  gt_array_delete(state.finished_slots);
+  gt_str_delete(state.prediction_seqid);
+  gt_str_delete(state.reference_seqid);
 
   return had_err;
 }
@@ -1529,7 +1972,8 @@ static void show_transcript_values(GtTranscriptEvaluators *te,
   gt_file_xfputc('\n', outfp);
 }
 
-static void show_nucleotide_values(NucEval *nucleotides, const char *level,
+static void show_nucleotide_values(const NucEval *nucleotides,
+                                   const char *level,
                                    GtFile *outfp)
 {
   double sensitivity = 1.0, specificity = 1.0;
@@ -1554,86 +1998,88 @@ static void show_nucleotide_values(NucEval *nucleotides, const char *level,
 
 void gt_stream_evaluator_show(GtStreamEvaluator *se, GtFile *outfp)
 {
+  const EvalValues *values;
   gt_assert(se);
+  values = &se->values;
 
   if (!se->evalLTR) {
     /* gene level */
     gt_file_xprintf(outfp, "gene sensitivity (mRNA level): ");
-    gt_evaluator_show_sensitivity(se->mRNA_gene_evaluator, outfp);
-    gt_file_xprintf(outfp, " (missing genes: " GT_WU ")\n", se->missing_genes);
+    gt_evaluator_show_sensitivity(values->mRNA_gene_evaluator, outfp);
+    gt_file_xprintf(outfp, " (missing genes: " GT_WU ")\n",
+                    values->missing_genes);
 
     gt_file_xprintf(outfp, "gene specificity (mRNA level): ");
-    gt_evaluator_show_specificity(se->mRNA_gene_evaluator, outfp);
-    gt_file_xprintf(outfp, " (wrong genes: " GT_WU ")\n", se->wrong_genes);
+    gt_evaluator_show_specificity(values->mRNA_gene_evaluator, outfp);
+    gt_file_xprintf(outfp, " (wrong genes: " GT_WU ")\n", values->wrong_genes);
 
     gt_file_xprintf(outfp, "gene sensitivity (CDS level): ");
-    gt_evaluator_show_sensitivity(se->CDS_gene_evaluator, outfp);
-    gt_file_xprintf(outfp, " (missing genes: " GT_WU ")\n", se->missing_genes);
+    gt_evaluator_show_sensitivity(values->CDS_gene_evaluator, outfp);
+    gt_file_xprintf(outfp, " (missing genes: " GT_WU ")\n",
+                    values->missing_genes);
 
     gt_file_xprintf(outfp, "gene specificity (CDS level): ");
-    gt_evaluator_show_specificity(se->CDS_gene_evaluator, outfp);
-    gt_file_xprintf(outfp, " (wrong genes: " GT_WU ")\n", se->wrong_genes);
+    gt_evaluator_show_specificity(values->CDS_gene_evaluator, outfp);
+    gt_file_xprintf(outfp, " (wrong genes: " GT_WU ")\n", values->wrong_genes);
 
     /* mRNA level */
     gt_file_xprintf(outfp, "mRNA sensitivity (mRNA level): ");
-    gt_evaluator_show_sensitivity(se->mRNA_mRNA_evaluator, outfp);
-    gt_file_xprintf(outfp, " (missing mRNAs: " GT_WU ")\n", se->missing_mRNAs);
+    gt_evaluator_show_sensitivity(values->mRNA_mRNA_evaluator, outfp);
+    gt_file_xprintf(outfp, " (missing mRNAs: " GT_WU ")\n",
+                    values->missing_mRNAs);
 
     gt_file_xprintf(outfp, "mRNA specificity (mRNA level): ");
-    gt_evaluator_show_specificity(se->mRNA_mRNA_evaluator, outfp);
-    gt_file_xprintf(outfp, " (wrong mRNAs: " GT_WU ")\n", se->wrong_mRNAs);
+    gt_evaluator_show_specificity(values->mRNA_mRNA_evaluator, outfp);
+    gt_file_xprintf(outfp, " (wrong mRNAs: " GT_WU ")\n", values->wrong_mRNAs);
 
     gt_file_xprintf(outfp, "mRNA sensitivity (CDS level): ");
-    gt_evaluator_show_sensitivity(se->CDS_mRNA_evaluator, outfp);
-    gt_file_xprintf(outfp, " (missing mRNAs: " GT_WU ")\n", se->missing_mRNAs);
+    gt_evaluator_show_sensitivity(values->CDS_mRNA_evaluator, outfp);
+    gt_file_xprintf(outfp, " (missing mRNAs: " GT_WU ")\n",
+                    values->missing_mRNAs);
 
     gt_file_xprintf(outfp, "mRNA specificity (CDS level): ");
-    gt_evaluator_show_specificity(se->CDS_mRNA_evaluator, outfp);
-    gt_file_xprintf(outfp, " (wrong mRNAs: " GT_WU ")\n", se->wrong_mRNAs);
+    gt_evaluator_show_specificity(values->CDS_mRNA_evaluator, outfp);
+    gt_file_xprintf(outfp, " (wrong mRNAs: " GT_WU ")\n", values->wrong_mRNAs);
 
     /* mRNA exon level */
-    show_transcript_values(se->mRNA_exon_evaluators, "mRNA", "", outfp);
-    show_transcript_values(se->mRNA_exon_evaluators_collapsed, "mRNA",
+    show_transcript_values(values->mRNA_exon_evaluators, "mRNA", "", outfp);
+    show_transcript_values(values->mRNA_exon_evaluators_collapsed, "mRNA",
                            ", collapsed", outfp);
 
     /* CDS exon level */
-    show_transcript_values(se->CDS_exon_evaluators, "CDS", "", outfp);
-    show_transcript_values(se->CDS_exon_evaluators_collapsed, "CDS",
+    show_transcript_values(values->CDS_exon_evaluators, "CDS", "", outfp);
+    show_transcript_values(values->CDS_exon_evaluators_collapsed, "CDS",
                            ", collapsed", outfp);
 
     if (se->nuceval) {
       /* mRNA nucleotide level */
-      show_nucleotide_values(&se->mRNA_nucleotides, "mRNA", outfp);
+      show_nucleotide_values(&values->mRNA_nucleotides, "mRNA", outfp);
       /* CDS nucleotide level */
-      show_nucleotide_values(&se->CDS_nucleotides, "CDS", outfp);
+      show_nucleotide_values(&values->CDS_nucleotides, "CDS", outfp);
     }
   }
   else {
     /* LTR_retrotransposon prediction */
     gt_file_xprintf(outfp, "LTR_retrotransposon sensitivity: ");
-    gt_evaluator_show_sensitivity(se->LTR_evaluator, outfp);
-    gt_file_xprintf(outfp, " (missing LTRs: " GT_WU ")\n", se->missing_LTRs);
+    gt_evaluator_show_sensitivity(values->LTR_evaluator, outfp);
+    gt_file_xprintf(outfp, " (missing LTRs: " GT_WU ")\n",
+                    values->missing_LTRs);
 
     gt_file_xprintf(outfp, "LTR_retrotransposon specificity: ");
-    gt_evaluator_show_specificity(se->LTR_evaluator, outfp);
-    gt_file_xprintf(outfp, " (wrong LTRs: " GT_WU ")\n", se->wrong_LTRs);
+    gt_evaluator_show_specificity(values->LTR_evaluator, outfp);
+    gt_file_xprintf(outfp, " (wrong LTRs: " GT_WU ")\n", values->wrong_LTRs);
   }
 }
 
 void gt_stream_evaluator_delete(GtStreamEvaluator *se)
 {
+  GT_UNUSED int had_err;
   if (!se) return;
   gt_node_stream_delete(se->reference);
   gt_node_stream_delete(se->prediction);
+  had_err = gt_hashmap_foreach(se->slots, slot_delete_func, NULL, NULL);
+  gt_assert(!had_err); /* slot_delete_func() is sane */
   gt_hashmap_delete(se->slots);
-  gt_evaluator_delete(se->mRNA_gene_evaluator);
-  gt_evaluator_delete(se->CDS_gene_evaluator);
-  gt_evaluator_delete(se->mRNA_mRNA_evaluator);
-  gt_evaluator_delete(se->CDS_mRNA_evaluator);
-  gt_evaluator_delete(se->LTR_evaluator);
-  gt_transcript_evaluators_delete(se->mRNA_exon_evaluators);
-  gt_transcript_evaluators_delete(se->mRNA_exon_evaluators_collapsed);
-  gt_transcript_evaluators_delete(se->CDS_exon_evaluators);
-  gt_transcript_evaluators_delete(se->CDS_exon_evaluators_collapsed);
+  eval_values_clean(&se->values);
   gt_free(se);
 }
@@ -27,7 +27,10 @@ GtStreamEvaluator* gt_stream_evaluator_new(GtNodeStream *reference,
                                            GtNodeStream *prediction,
                                            bool nuceval, bool evalLTR,
                                            GtUword LTRdelta);
-/* if <nv> is not NULL, it visits all nodes from reference and the prediction */
+/* Both streams have to be sorted, they are processed in lockstep one sequence
+   region at a time. Sequence regions are evaluated on <gt_jobs> threads, unless
+   <nv> is given or an exon diff is shown.
+   if <nv> is not NULL, it visits all nodes from reference and the prediction */
 int                gt_stream_evaluator_evaluate(GtStreamEvaluator*,
                                                 bool verbose, bool exondiff,
                                                 bool exondiffcollapsed,
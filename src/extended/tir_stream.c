@@ -21,13 +21,17 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include "core/arraydef.h"
+#include "core/chunk_dispenser.h"
 #include "core/encseq.h"
 #include "core/log_api.h"
 #include "core/mathsupport.h"
 #include "core/md5_seqid.h"
 #include "core/minmax.h"
+#include "core/multithread_api.h"
 #include "core/str_api.h"
+#include "core/thread_api.h"
 #include "core/undef_api.h"
 #include "extended/feature_type.h"
 #include "extended/genome_node.h"
@@ -79,6 +83,8 @@ typedef struct
                                     of right tir */
   GtUword right_transformed_start,
                 right_transformed_end;
+  GtUword seednum;         /* index of the seed this pair was extended from,
+                                    makes the order independent of threads */
 } TIRPair;
 
 GT_DECLAREARRAYSTRUCT(TIRPair);
@@ -214,7 +220,9 @@ static int gt_tir_compare_TIRs(const void *a, const void *b)
         return -1;
       } else if (pair1->right_transformed_start
                                             == pair2->right_transformed_start) {
-        return 0;
+        if (pair1->seednum < pair2->seednum)
+          return -1;
+        return pair1->seednum == pair2->seednum ? 0 : 1;
       }
     }
   }
@@ -453,11 +461,23 @@ static int gt_tir_search_for_TSDs(GtTIRStream *tir_stream, TIRPair *tir_pair,
   return had_err;
 }
 
-static int gt_tir_searchforTIRs(GtTIRStream *tir_stream,
-                                const GtEncseq *encseq, GtError *err)
+typedef struct {
+  GtTIRStream *tir_stream;
+  const GtEncseq *encseq;
+  GtChunkDispenser *seeds;
+  GtMutex *wmutex;
+  GtError *err;
+  int had_err;
+} GtTIRThreadInfo;
+
+/* Extends the seeds claimed by the calling thread to TIR candidates, which
+   are stored in the thread-local array <pairs>. */
+static int gt_tir_extend_seeds(GtTIRThreadInfo *info, GtArrayTIRPair *pairs,
+                               GtError *err)
 {
-  GtUword seedcounter = 0;
-  GtArrayTIRPair new;             /* need to remove overlaps */
+  GtTIRStream *tir_stream = info->tir_stream;
+  const GtEncseq *encseq = info->encseq;
+  GtUword seedcounter = 0, chunkend = 0;
   GtXdropresources *xdropresources;
   GtUword total_length = 0;
   GtUword alilen,
@@ -474,13 +494,17 @@ static int gt_tir_searchforTIRs(GtTIRStream *tir_stream,
   gt_error_check(err);
 
   xdropresources = gt_xdrop_resources_new(&tir_stream->arbit_scores);
+  total_length = gt_encseq_total_length(encseq);
 
   /* Iterating over seeds */
-  for (seedcounter = 0; seedcounter < tir_stream->seedinfo.seed.nextfreeSeed;
-       seedcounter++) {
-
-    total_length = gt_encseq_total_length(encseq);
-    seedptr = &(tir_stream->seedinfo.seed.spaceSeed[seedcounter]);
+  while (!had_err) {
+    if (seedcounter == chunkend) {
+      GtUword chunk = gt_chunk_dispenser_next(info->seeds, &seedcounter);
+      if (chunk == 0)
+        break;
+      chunkend = seedcounter + chunk;
+    }
+    seedptr = &(tir_stream->seedinfo.seed.spaceSeed[seedcounter++]);
     gt_assert(tir_stream->seedinfo.max_tir_length >= seedptr->len);
     alilen = tir_stream->seedinfo.max_tir_length - seedptr->len;
     seqstart1 = gt_encseq_seqstartpos(tir_stream->encseq,
@@ -565,8 +589,9 @@ static int gt_tir_searchforTIRs(GtTIRStream *tir_stream,
         seedptr->pos2 - xdropbest_left.jvalue + 1 < tir_stream->min_TIR_length)
       continue;
 
-    GT_GETNEXTFREEINARRAY(pair, &tir_stream->first_pairs, TIRPair, 256);
+    GT_GETNEXTFREEINARRAY(pair, pairs, TIRPair, 256);
     /* Store positions for the found TIR */
+    pair->seednum = seedcounter - 1;
     pair->contignumber = seedptr->contignumber;
     pair->tsd_length = 0;
     pair->left_tir_start = seedptr->pos1 - xdropbest_left.ivalue;
@@ -581,10 +606,12 @@ static int gt_tir_searchforTIRs(GtTIRStream *tir_stream,
                                                 pair->right_tir_start);
     pair->similarity = 0.0;
     pair->skip = false;
-    tir_stream->num_of_tirs++;
 
     /* TSDs */
-    gt_tir_search_for_TSDs(tir_stream, pair, encseq, err);
+    if (gt_tir_search_for_TSDs(tir_stream, pair, encseq, err) != 0) {
+      had_err = -1;
+      break;
+    }
 
     /* determine and filter by similarity */
     ulen = pair->left_tir_end - pair->left_tir_start + 1;
@@ -599,29 +626,83 @@ static int gt_tir_searchforTIRs(GtTIRStream *tir_stream,
     }
   }
 
-  /* sort results after seed extension */
+  gt_xdrop_resources_delete(xdropresources);
+  gt_seqabstract_delete(sa_useq);
+  gt_seqabstract_delete(sa_vseq);
+  gt_frontresource_delete(frontresource);
+  return had_err;
+}
+
+static void* gt_tir_extend_seeds_threadfunc(void *data)
+{
+  GtTIRThreadInfo *info = (GtTIRThreadInfo*) data;
+  GtArrayTIRPair *first_pairs = &info->tir_stream->first_pairs;
+  GtArrayTIRPair pairs;
+  GtError *err;
+  int rval;
+  gt_assert(info);
+  GT_INITARRAY(&pairs, TIRPair);
+  err = gt_error_new();
+  rval = gt_tir_extend_seeds(info, &pairs, err);
+
+  /* merge thread-local results, report only the first error */
+  gt_mutex_lock(info->wmutex);
+  if (rval != 0) {
+    if (!info->had_err) {
+      gt_error_set(info->err, "%s", gt_error_get(err));
+      info->had_err = -1;
+    }
+  } else if (pairs.nextfreeTIRPair > 0) {
+    GT_CHECKARRAYSPACEMULTI(first_pairs, TIRPair, pairs.nextfreeTIRPair);
+    memcpy(first_pairs->spaceTIRPair + first_pairs->nextfreeTIRPair,
+           pairs.spaceTIRPair, sizeof (TIRPair) * pairs.nextfreeTIRPair);
+    first_pairs->nextfreeTIRPair += pairs.nextfreeTIRPair;
+  }
+  gt_mutex_unlock(info->wmutex);
+  GT_FREEARRAY(&pairs, TIRPair);
+  gt_error_delete(err);
+  return NULL;
+}
+
+static int gt_tir_searchforTIRs(GtTIRStream *tir_stream,
+                                const GtEncseq *encseq, GtError *err)
+{
+  GtTIRThreadInfo info;
+  int had_err = 0;
+  gt_error_check(err);
+
+  /* extend seeds to TIR candidates in parallel */
+  info.tir_stream = tir_stream;
+  info.encseq = encseq;
+  info.seeds = gt_chunk_dispenser_new(tir_stream->seedinfo.seed.nextfreeSeed);
+  info.err = err;
+  info.had_err = 0;
+  info.wmutex = gt_mutex_new();
+  if (gt_multithread(gt_tir_extend_seeds_threadfunc, &info, err) != 0
+        || info.had_err != 0) {
+    had_err = -1;
+  }
+  gt_chunk_dispenser_delete(info.seeds);
+  gt_mutex_delete(info.wmutex);
+
+  /* sort results after seed extension, the seed number breaks ties so that
+     the result does not depend on the number of threads */
   if (!had_err && tir_stream->first_pairs.spaceTIRPair) {
     qsort(tir_stream->first_pairs.spaceTIRPair,
           (size_t) tir_stream->first_pairs.nextfreeTIRPair,
            sizeof (TIRPair), gt_tir_compare_TIRs);
   }
 
-  /* initialize array for removing overlaps */
-  GT_INITARRAY(&new, TIRPair);
-
  /* remove overlaps if wanted */
-  if (tir_stream->best_overlaps || tir_stream->no_overlaps) {
+  if (!had_err && (tir_stream->best_overlaps || tir_stream->no_overlaps)) {
     gt_tir_remove_overlaps(&tir_stream->first_pairs, tir_stream->no_overlaps);
   }
 
   /* remove skipped candidates */
-  tir_stream->tir_pairs = tir_compactboundaries(&tir_stream->num_of_tirs,
-                                                &tir_stream->first_pairs);
-
-  gt_xdrop_resources_delete(xdropresources);
-  gt_seqabstract_delete(sa_useq);
-  gt_seqabstract_delete(sa_vseq);
-  gt_frontresource_delete(frontresource);
+  if (!had_err) {
+    tir_stream->tir_pairs = tir_compactboundaries(&tir_stream->num_of_tirs,
+                                                  &tir_stream->first_pairs);
+  }
   return had_err;
 }
 
@@ -50,6 +50,12 @@ void                  gt_transcript_evaluators_add_actuals(const
                                                         GtTranscriptEvaluators*,
                                                       const GtTranscriptExons*);
 
+/* add the counts of all evaluators in <src> to the ones in <dest> */
+void                  gt_transcript_evaluators_add(GtTranscriptEvaluators
+                                                                         *dest,
+                                                   const GtTranscriptEvaluators
+                                                                         *src);
+
 void                  gt_transcript_evaluators_delete(GtTranscriptEvaluators*);
 
 #endif
@@ -16,9 +16,9 @@
 
 #include <string.h>
 #include "core/array_api.h"
-#include "core/bool_matrix.h"
 #include "core/cstr_api.h"
 #include "core/hashmap_api.h"
+#include "core/intbits.h"
 #include "core/ma_api.h"
 #include "core/symbol_api.h"
 #include "extended/type_graph.h"
@@ -28,23 +28,31 @@
 #define MEMBER_OF         "member_of"
 #define INTEGRAL_PART_OF  "integral_part_of"
 
+/* When the first query is made, the transitive closures of the is_a and the
+   part_of relation are computed once and stored as bit matrices with one row
+   of <words> words per node, so that a query is a hash lookup of both types
+   followed by a single bit test. */
 struct GtTypeGraph {
-  GtHashmap *name2id, /* maps from name to SO ID */
-            *nodemap; /* maps SO ID to actual node */
+  GtHashmap *type2node, /* maps names and SO IDs (symbols) to nodes */
+            *cstr2node, /* maps names and SO IDs (strings) to nodes */
+            *nodemap;   /* maps SO ID to actual node */
   GtArray *nodes;
-  GtBoolMatrix *part_of_out_edges,
-               *part_of_in_edges;
+  GtBitsequence *is_a_closure,
+                *part_of_closure;
+  GtUword words;
   bool ready;
 };
 
 GtTypeGraph* gt_type_graph_new(void)
 {
   GtTypeGraph *type_graph = gt_malloc(sizeof (GtTypeGraph));
-  type_graph->name2id = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  type_graph->type2node = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
+  type_graph->cstr2node = gt_hashmap_new(GT_HASH_STRING, NULL, NULL);
   type_graph->nodemap = gt_hashmap_new(GT_HASH_DIRECT, NULL, NULL);
   type_graph->nodes = gt_array_new(sizeof (GtTypeNode*));
-  type_graph->part_of_out_edges = gt_bool_matrix_new();
-  type_graph->part_of_in_edges = gt_bool_matrix_new();
+  type_graph->is_a_closure = NULL;
+  type_graph->part_of_closure = NULL;
+  type_graph->words = 0;
   type_graph->ready = false;
   return type_graph;
 }
@@ -53,13 +61,14 @@ void gt_type_graph_delete(GtTypeGraph *type_graph)
 {
   GtUword i;
   if (!type_graph) return;
-  gt_bool_matrix_delete(type_graph->part_of_in_edges);
-  gt_bool_matrix_delete(type_graph->part_of_out_edges);
+  gt_free(type_graph->part_of_closure);
+  gt_free(type_graph->is_a_closure);
   for (i = 0; i < gt_array_size(type_graph->nodes); i++)
     gt_type_node_delete(*(GtTypeNode**) gt_array_get(type_graph->nodes, i));
   gt_array_delete(type_graph->nodes);
   gt_hashmap_delete(type_graph->nodemap);
-  gt_hashmap_delete(type_graph->name2id);
+  gt_hashmap_delete(type_graph->cstr2node);
+  gt_hashmap_delete(type_graph->type2node);
   gt_free(type_graph);
 }
 
@@ -79,7 +88,13 @@ void gt_type_graph_add_stanza(GtTypeGraph *type_graph,
   gt_assert(name_value);
   gt_assert(!gt_hashmap_get(type_graph->nodemap, id_value));
   node = gt_type_node_new(gt_array_size(type_graph->nodes), id_value);
-  gt_hashmap_add(type_graph->name2id, (char*) name_value, (char*) id_value);
+  /* names take precedence over IDs */
+  if (!gt_hashmap_get(type_graph->type2node, id_value)) {
+    gt_hashmap_add(type_graph->type2node, (char*) id_value, node);
+    gt_hashmap_add(type_graph->cstr2node, (char*) id_value, node);
+  }
+  gt_hashmap_add(type_graph->type2node, (char*) name_value, node);
+  gt_hashmap_add(type_graph->cstr2node, (char*) name_value, node);
   gt_hashmap_add(type_graph->nodemap, (char*) id_value, node);
   gt_array_add(type_graph->nodes, node);
   buf = gt_str_new();
@@ -123,82 +138,137 @@ void gt_type_graph_add_stanza(GtTypeGraph *type_graph,
   gt_str_delete(buf);
 }
 
-static void create_vertices(GtTypeGraph *type_graph)
+#define TYPE_GRAPH_ROW(TAB, WORDS, NUM) \
+        ((TAB) + (NUM) * (WORDS))
+
+/* Extends each row of <closure> by the rows of its successors given by the
+   <numofedges> edges from <edges>[2*i] to <edges>[2*i+1] until a fixpoint is
+   reached. Cycles are allowed. */
+static void type_graph_close(GtBitsequence *closure, GtUword words,
+                             const GtUword *edges, GtUword numofedges)
 {
-  GtUword i, j;
-  GtTypeNode *parent;
-  const char *id;
+  bool changed = true;
+  while (changed) {
+    GtUword e, w;
+    changed = false;
+    for (e = 0; e < numofedges; e++) {
+      GtBitsequence *src = TYPE_GRAPH_ROW(closure, words, edges[2 * e]);
+      const GtBitsequence *dst = TYPE_GRAPH_ROW(closure, words,
+                                                edges[2 * e + 1]);
+      for (w = 0; w < words; w++) {
+        if ((src[w] | dst[w]) != src[w]) {
+          src[w] |= dst[w];
+          changed = true;
+        }
+      }
+    }
+  }
+}
+
+static GtUword type_graph_id2num(GtTypeGraph *type_graph, const char *id)
+{
+  GtTypeNode *node = gt_hashmap_get(type_graph->nodemap, id);
+  gt_assert(node);
+  return gt_type_node_num(node);
+}
+
+static void create_closures(GtTypeGraph *type_graph)
+{
+  GtUword i, j, k, numofnodes, words, numofedges, allocatededges;
+  GtUword *edges;
   gt_assert(type_graph && !type_graph->ready);
-  /* iterate over nodes */
-  for (i = 0; i < gt_array_size(type_graph->nodes); i++) {
+  numofnodes = gt_array_size(type_graph->nodes);
+  words = type_graph->words = (GtUword) GT_NUMOFINTSFORBITS(numofnodes);
+  type_graph->is_a_closure = gt_calloc((size_t) (numofnodes * words),
+                                       sizeof (GtBitsequence));
+  type_graph->part_of_closure = gt_calloc((size_t) (numofnodes * words),
+                                          sizeof (GtBitsequence));
+  allocatededges = numofnodes + 1;
+  edges = gt_malloc(sizeof (*edges) * 2 * allocatededges);
+#define TYPE_GRAPH_ADD_EDGE(SRC, DST) \
+        if (numofedges == allocatededges) { \
+          allocatededges += allocatededges / 2; \
+          edges = gt_realloc(edges, sizeof (*edges) * 2 * allocatededges); \
+        } \
+        edges[2 * numofedges] = SRC; \
+        edges[2 * numofedges + 1] = DST; \
+        numofedges++
+
+  /* every type is_a and is part_of itself */
+  for (i = 0; i < numofnodes; i++) {
+    GT_SETIBIT(TYPE_GRAPH_ROW(type_graph->is_a_closure, words, i), i);
+    GT_SETIBIT(TYPE_GRAPH_ROW(type_graph->part_of_closure, words, i), i);
+  }
+  /* is_a edges */
+  numofedges = 0;
+  for (i = 0; i < numofnodes; i++) {
     GtTypeNode *node = *(GtTypeNode**) gt_array_get(type_graph->nodes, i);
-    /* process is_a parents */
     for (j = 0; j < gt_type_node_is_a_size(node); j++) {
-      id = gt_type_node_is_a_get(node, j);
-      parent = gt_hashmap_get(type_graph->nodemap, id);
-      gt_assert(parent);
-      gt_type_node_add_is_a_vertex(node, parent);
+      TYPE_GRAPH_ADD_EDGE(i, type_graph_id2num(type_graph,
+                                               gt_type_node_is_a_get(node, j)));
     }
-    /* process part_of parents */
+  }
+  type_graph_close(type_graph->is_a_closure, words, edges, numofedges);
+  /* a child can be part_of its is_a parents and of all types which are a
+     parent type it is declared to be part_of, that is, if an exon is part_of
+     a transcript, it is also part_of an mRNA because mRNA is_a transcript */
+  for (i = 0; i < numofnodes; i++) {
+    GtTypeNode *node = *(GtTypeNode**) gt_array_get(type_graph->nodes, i);
     for (j = 0; j < gt_type_node_part_of_size(node); j++) {
-      id = gt_type_node_part_of_get(node, j);
-      parent = gt_hashmap_get(type_graph->nodemap, id);
-      gt_assert(parent);
-      gt_bool_matrix_set(type_graph->part_of_out_edges, gt_type_node_num(node),
-                         gt_type_node_num(parent), true);
-      gt_bool_matrix_set(type_graph->part_of_in_edges, gt_type_node_num(parent),
-                         gt_type_node_num(node), true);
+      GtUword parent = type_graph_id2num(type_graph,
+                                         gt_type_node_part_of_get(node, j));
+      for (k = 0; k < numofnodes; k++) {
+        if (GT_ISIBITSET(TYPE_GRAPH_ROW(type_graph->is_a_closure, words, k),
+                         parent)) {
+          TYPE_GRAPH_ADD_EDGE(i, k);
+        }
+      }
     }
   }
+  type_graph_close(type_graph->part_of_closure, words, edges, numofedges);
+  gt_free(edges);
 }
 
-bool gt_type_graph_is_partof(GtTypeGraph *type_graph, const char *parent_type,
-                             const char *child_type)
+static GtTypeNode* type_graph_get_node(GtTypeGraph *type_graph,
+                                       const char *type)
+{
+  GtTypeNode *node;
+  /* feature types are symbols, so the lookup by address should succeed */
+  if (!(node = gt_hashmap_get(type_graph->type2node, type)))
+    node = gt_hashmap_get(type_graph->cstr2node, type);
+  return node;
+}
+
+static bool type_graph_query(GtTypeGraph *type_graph, bool part_of,
+                             const char *parent_type, const char *child_type)
 {
-  const char *parent_id, *child_id;
-  GtTypeNode *child_node;
+  GtTypeNode *parent_node, *child_node;
   gt_assert(type_graph && parent_type && child_type);
   /* make sure graph is built */
   if (!type_graph->ready) {
-    create_vertices(type_graph);
+    create_closures(type_graph);
     type_graph->ready = true;
   }
-  /* get parent ID, if the type is not mappable to an ID, assume it is the ID */
-  if (!(parent_id = gt_hashmap_get(type_graph->name2id, parent_type)))
-    parent_id = parent_type;
-  /* get child ID, if the type is not mappable to an ID, assmue it is the ID */
-  if (!(child_id = gt_hashmap_get(type_graph->name2id, child_type)))
-    child_id = child_type;
-  /* get child node */
-  child_node = gt_hashmap_get(type_graph->nodemap, child_id);
+  child_node = type_graph_get_node(type_graph, child_type);
   gt_assert(child_node);
-  /* check for parent */
-  return gt_type_node_has_parent(child_node, parent_id,
-                                 type_graph->part_of_out_edges,
-                                 type_graph->part_of_in_edges,
-                                 type_graph->nodes);
+  if (!(parent_node = type_graph_get_node(type_graph, parent_type)))
+    return false;
+  return GT_ISIBITSET(TYPE_GRAPH_ROW(part_of
+                                     ? type_graph->part_of_closure
+                                     : type_graph->is_a_closure,
+                                     type_graph->words,
+                                     gt_type_node_num(child_node)),
+                      gt_type_node_num(parent_node)) ? true : false;
+}
+
+bool gt_type_graph_is_partof(GtTypeGraph *type_graph, const char *parent_type,
+                             const char *child_type)
+{
+  return type_graph_query(type_graph, true, parent_type, child_type);
 }
 
 bool gt_type_graph_is_a(GtTypeGraph *type_graph, const char *parent_type,
                         const char *child_type)
 {
-  const char *parent_id, *child_id;
-  GtTypeNode *child_node;
-  gt_assert(type_graph && parent_type && child_type);
-  /* make sure graph is built */
-  if (!type_graph->ready) {
-    create_vertices(type_graph);
-    type_graph->ready = true;
-  }
-  /* get parent ID, if the type is not mappable to an ID, assume it is the ID */
-  if (!(parent_id = gt_hashmap_get(type_graph->name2id, parent_type)))
-    parent_id = parent_type;
-  /* get child ID, if the type is not mappable to an ID, assume it is the ID */
-  if (!(child_id = gt_hashmap_get(type_graph->name2id, child_type)))
-    child_id = child_type;
-  /* get child node */
-  child_node = gt_hashmap_get(type_graph->nodemap, child_id);
-  gt_assert(child_node);
-  /* check for parent */
-  return gt_type_node_is_a(child_node, parent_id);
+  return type_graph_query(type_graph, false, parent_type, child_type);
 }
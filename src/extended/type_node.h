@@ -17,7 +17,7 @@
 #ifndef TYPE_NODE_H
 #define TYPE_NODE_H
 
-#include "core/bool_matrix.h"
+#include "core/types_api.h"
 
 typedef struct GtTypeNode GtTypeNode;
 
@@ -30,13 +30,5 @@ GtUword       gt_type_node_is_a_size(const GtTypeNode*);
 void          gt_type_node_part_of_add(GtTypeNode*, const char*);
 const char*   gt_type_node_part_of_get(const GtTypeNode*, GtUword);
 GtUword       gt_type_node_part_of_size(const GtTypeNode*);
-void          gt_type_node_add_is_a_vertex(GtTypeNode *src,
-                                           const GtTypeNode *dst);
-bool          gt_type_node_has_parent(GtTypeNode*, const char *id,
-                                      GtBoolMatrix *part_of_out_edges,
-                                      GtBoolMatrix *part_of_in_edges,
-                                      GtArray *node_list);
-bool          gt_type_node_is_a(GtTypeNode *child_node,
-                                const char *parent_id);
 
 #endif
@@ -168,6 +168,7 @@ extern "C" {
 #include "annotationsketch/canvas_cairo_file_api.h"
 #include "annotationsketch/color_api.h"
 #include "annotationsketch/custom_track_api.h"
+#include "annotationsketch/custom_track_feature_density_api.h"
 #include "annotationsketch/custom_track_gc_content_api.h"
 #include "annotationsketch/custom_track_script_wrapper_api.h"
 #include "annotationsketch/diagram_api.h"
@@ -40,6 +40,21 @@
 #include "gtlua/range_lua.h"
 #include "gtlua/region_mapping_lua.h"
 
+#define GENOME_NODE_READ_ONLY "GenomeTools.genome_node_read_only"
+
+/* Like check_genome_node(), but raises an error if nodes may not be modified
+   in <L>. */
+static GtGenomeNode** check_writable_genome_node(lua_State *L, int pos)
+{
+  bool read_only;
+  lua_getfield(L, LUA_REGISTRYINDEX, GENOME_NODE_READ_ONLY);
+  read_only = lua_toboolean(L, -1);
+  lua_pop(L, 1);
+  if (read_only)
+    luaL_error(L, "genome nodes are read-only in this context");
+  return check_genome_node(L, pos);
+}
+
 static int feature_node_lua_new(lua_State *L)
 {
   GtGenomeNode **gf;
@@ -279,7 +294,7 @@ static int feature_node_lua_set_source(lua_State *L)
 {
   const char *source;
   GtStr *source_str;
-  GtGenomeNode **gn = check_genome_node(L, 1);
+  GtGenomeNode **gn = check_writable_genome_node(L, 1);
   GtFeatureNode *fn;
   /* make sure we get a feature node */
   fn = gt_feature_node_try_cast(*gn);
@@ -295,7 +310,7 @@ static int genome_node_lua_change_seqid(lua_State *L)
 {
   const char *seqid;
   GtStr *seqid_str;
-  GtGenomeNode **gn = check_genome_node(L, 1);
+  GtGenomeNode **gn = check_writable_genome_node(L, 1);
   seqid = luaL_checkstring(L, 2);
   seqid_str = gt_str_new_cstr(seqid);
   gt_genome_node_change_seqid(*gn, seqid_str);
@@ -306,7 +321,7 @@ static int genome_node_lua_change_seqid(lua_State *L)
 static int genome_node_lua_set_range(lua_State *L)
 {
   GtRange *rng;
-  GtGenomeNode **gn = check_genome_node(L, 1);
+  GtGenomeNode **gn = check_writable_genome_node(L, 1);
   rng = check_range(L, 2);
   gt_genome_node_set_range(*gn, rng);
   return 0;
@@ -315,7 +330,7 @@ static int genome_node_lua_set_range(lua_State *L)
 static int feature_node_lua_set_strand(lua_State *L)
 {
   const char *str;
-  GtGenomeNode **gn = check_genome_node(L, 1);
+  GtGenomeNode **gn = check_writable_genome_node(L, 1);
   GtFeatureNode *fn;
   /* make sure we get a feature node */
   fn = gt_feature_node_try_cast(*gn);
@@ -330,7 +345,7 @@ static int feature_node_lua_set_strand(lua_State *L)
 static int feature_node_lua_set_score(lua_State *L)
 {
   float sc;
-  GtGenomeNode **gn = check_genome_node(L, 1);
+  GtGenomeNode **gn = check_writable_genome_node(L, 1);
   GtFeatureNode *fn;
   /* make sure we get a feature node */
   fn = gt_feature_node_try_cast(*gn);
@@ -343,7 +358,7 @@ static int feature_node_lua_set_score(lua_State *L)
 static int feature_node_lua_set_phase(lua_State *L)
 {
   const char *p;
-  GtGenomeNode **gn = check_genome_node(L, 1);
+  GtGenomeNode **gn = check_writable_genome_node(L, 1);
   GtFeatureNode *fn;
   /* make sure we get a feature node */
   fn = gt_feature_node_try_cast(*gn);
@@ -360,7 +375,7 @@ static int genome_node_lua_accept(lua_State *L)
   GtGenomeNode **gn;
   GtNodeVisitor **gv;
   GtError *err;
-  gn = check_genome_node(L, 1);
+  gn = check_writable_genome_node(L, 1);
   gv = check_genome_visitor(L, 2);
   err = gt_error_new();
   if (gt_genome_node_accept(*gn, *gv, err))
@@ -373,7 +388,7 @@ static int genome_node_lua_add_child(lua_State *L)
 {
   GtGenomeNode **parent, **child;
   GtFeatureNode *pf, *cf;
-  parent = check_genome_node(L, 1);
+  parent = check_writable_genome_node(L, 1);
   child  = check_genome_node(L, 2);
   pf = gt_feature_node_try_cast(*parent);
   luaL_argcheck(L, pf, 1, "not a feature node");
@@ -389,7 +404,7 @@ static int genome_node_lua_add_attribute(lua_State *L)
   GtGenomeNode **node;
   const char *key, *val;
   GtFeatureNode *f;
-  node = check_genome_node(L, 1);
+  node = check_writable_genome_node(L, 1);
   f = gt_feature_node_try_cast(*node);
   luaL_argcheck(L, f, 1, "not a feature node");
   key = luaL_checkstring(L, 2);
@@ -405,7 +420,7 @@ static int genome_node_lua_remove_attribute(lua_State *L)
   GtGenomeNode **node;
   const char *key;
   GtFeatureNode *f;
-  node = check_genome_node(L, 1);
+  node = check_writable_genome_node(L, 1);
   f = gt_feature_node_try_cast(*node);
   luaL_argcheck(L, f, 1, "not a feature node");
   key = luaL_checkstring(L, 2);
@@ -420,7 +435,7 @@ static int genome_node_lua_set_attribute(lua_State *L)
   GtGenomeNode **node;
   const char *key, *val;
   GtFeatureNode *f;
-  node = check_genome_node(L, 1);
+  node = check_writable_genome_node(L, 1);
   f = gt_feature_node_try_cast(*node);
   luaL_argcheck(L, f, 1, "not a feature node");
   key = luaL_checkstring(L, 2);
@@ -492,7 +507,7 @@ static int feature_node_lua_each_attribute(lua_State *L) {
 
 static int genome_node_lua_mark(lua_State *L)
 {
-  GtGenomeNode **gn = check_genome_node(L, 1);
+  GtGenomeNode **gn = check_writable_genome_node(L, 1);
   gt_feature_node_mark(gt_feature_node_cast(*gn));
   return 0;
 }
@@ -672,7 +687,7 @@ static int feature_node_lua_remove_leaf(lua_State *L)
 {
   GtGenomeNode **parent, **leaf;
   GtFeatureNode *pf, *lf;
-  parent = check_genome_node(L, 1);
+  parent = check_writable_genome_node(L, 1);
   leaf  = check_genome_node(L, 2);
   pf = gt_feature_node_try_cast(*parent);
   luaL_argcheck(L, pf, 1, "not a feature node");
@@ -899,6 +914,13 @@ int gt_lua_open_genome_node(lua_State *L)
   return 1;
 }
 
+void gt_lua_genome_node_set_read_only(lua_State *L, bool read_only)
+{
+  gt_assert(L);
+  lua_pushboolean(L, read_only);
+  lua_setfield(L, LUA_REGISTRYINDEX, GENOME_NODE_READ_ONLY);
+}
+
 void gt_lua_genome_node_push(lua_State *L, GtGenomeNode *gn)
 {
   GtGenomeNode **gn_lua;
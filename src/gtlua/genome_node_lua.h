@@ -197,6 +197,10 @@ int gt_lua_open_genome_node(lua_State*);
 /* Push a <GtGenomeNode*> to Lua, takes ownership! */
 void gt_lua_genome_node_push(lua_State*, GtGenomeNode*);
 
+/* If <read_only> is true, all methods modifying genome nodes raise an error
+   in <L>. */
+void gt_lua_genome_node_set_read_only(lua_State *L, bool read_only);
+
 #define GENOME_NODE_METATABLE  "GenomeTools.genome_node"
 #define check_genome_node(L, POS) \
                 (GtGenomeNode**) luaL_checkudata(L, POS, GENOME_NODE_METATABLE)
@@ -48,6 +48,7 @@
 #include "core/quality.h"
 #include "core/queue.h"
 #include "core/sequence_buffer.h"
+#include "core/sequence_buffer_memory.h"
 #include "core/splitter.h"
 #include "core/symbol.h"
 #include "core/tokenizer.h"
@@ -74,6 +75,7 @@
 #include "extended/luaserialize.h"
 #include "extended/n_r_encseq.h"
 #include "extended/popcount_tab.h"
+#include "extended/prefetch_stream.h"
 #include "extended/priority_queue.h"
 #include "extended/ranked_list.h"
 #include "extended/rbtree.h"
@@ -344,6 +346,8 @@ GtHashmap* gtt_unit_tests(void)
   gt_hashmap_add(unit_tests, "PBS finder module",
                                             gt_ltrdigest_pbs_visitor_unit_test);
   gt_hashmap_add(unit_tests, "popcount sorted tab", gt_popcount_tab_unit_test);
+  gt_hashmap_add(unit_tests, "prefetch stream class",
+                                                gt_prefetch_stream_unit_test);
   gt_hashmap_add(unit_tests, "quality module", gt_quality_unit_test);
   gt_hashmap_add(unit_tests, "queue class", gt_queue_unit_test);
   gt_hashmap_add(unit_tests, "range class", gt_range_unit_test);
@@ -357,6 +361,8 @@ GtHashmap* gtt_unit_tests(void)
   gt_hashmap_add(unit_tests, "safearith module", gt_safearith_unit_test);
   gt_hashmap_add(unit_tests, "sequence buffer class",
                                                   gt_sequence_buffer_unit_test);
+  gt_hashmap_add(unit_tests, "sequence buffer class (memory)",
+                                           gt_sequence_buffer_memory_unit_test);
   gt_hashmap_add(unit_tests, "splicedseq class", gt_splicedseq_unit_test);
   gt_hashmap_add(unit_tests, "splitter class", gt_splitter_unit_test);
   gt_hashmap_add(unit_tests, "string class", gt_str_unit_test);
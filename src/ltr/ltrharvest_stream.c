@@ -19,9 +19,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include "core/array_api.h"
 #include "core/arraydef.h"
 #include "core/assert_api.h"
+#include "core/chunk_dispenser.h"
 #include "core/class_alloc_lock.h"
 #include "core/encseq_api.h"
 #include "core/error_api.h"
@@ -902,16 +904,25 @@ static void adjustboundariesfromXdropextension(GtXdropbest xdropbest_left,
   boundaries->rightLTR_3 = seed2_endpos + xdropbest_right.jvalue;
 }
 
+typedef struct {
+  GtLTRharvestStream *lo;
+  GtArrayLTRboundaries *arrayLTRboundaries;
+  const GtEncseq *encseq;
+  GtError *err;
+  GtChunkDispenser *seeds;
+  GtMutex *wmutex;
+  int had_err;
+} GtLTRharvestThreadInfo;
+
 /* The following function applies the filter algorithms one after another
-   to all candidate pairs */
-static int gt_searchforLTRs(GtLTRharvestStream *lo,
+   to all candidate pairs, storing the accepted ones in <arrayLTRboundaries>
+   which is local to the calling thread. */
+static int gt_searchforLTRs(GtLTRharvestThreadInfo *info,
                             GtArrayLTRboundaries *arrayLTRboundaries,
-                            GT_UNUSED GtMutex *rmutex,
-                            GT_UNUSED GtMutex *wmutex,
-                            GtUword *cur_seed,
                             GtError *err)
 {
-  GtUword my_seed;
+  GtLTRharvestStream *lo = info->lo;
+  GtUword my_seed = 0, chunkend = 0;
   GtXdropresources *xdropresources;
   GtXdropbest xdropbest_left, xdropbest_right;
 #undef GT_GREEDY_BUFFER
@@ -932,21 +943,18 @@ static int gt_searchforLTRs(GtLTRharvestStream *lo,
   gt_error_check(err);
   xdropresources = gt_xdrop_resources_new(&lo->arbitscores);
 
-  /* XXX: do thread-synchronized error checking */
   while (true) {
     GtUword ulen,
                   vlen,
                   seqend,
                   seqstart;
-    gt_mutex_lock(rmutex);
-    if (*cur_seed < lo->repeatinfo.repeats.nextfreeRepeat)
-      my_seed = (*cur_seed)++;
-    else {
-      gt_mutex_unlock(rmutex);
-      break;
+    if (my_seed == chunkend) {
+      GtUword chunk = gt_chunk_dispenser_next(info->seeds, &my_seed);
+      if (chunk == 0)
+        break;
+      chunkend = my_seed + chunk;
     }
-    gt_mutex_unlock(rmutex);
-    repeatptr = &(lo->repeatinfo.repeats.spaceRepeat[my_seed]);
+    repeatptr = &(lo->repeatinfo.repeats.spaceRepeat[my_seed++]);
 
     /* check whether max LTR length is exceeded by seed alone */
     if (lo->repeatinfo.lmax < repeatptr->len)
@@ -1131,10 +1139,9 @@ static int gt_searchforLTRs(GtLTRharvestStream *lo,
     if (!gt_double_smaller_double(boundaries.similarity,
                                   lo->similaritythreshold))
     {
-      gt_mutex_lock(wmutex);
-      GT_GETNEXTFREEINARRAY(boundaries_ptr,arrayLTRboundaries,LTRboundaries,5);
+      GT_GETNEXTFREEINARRAY(boundaries_ptr,arrayLTRboundaries,LTRboundaries,
+                            32);
       *boundaries_ptr = boundaries;
-      gt_mutex_unlock(wmutex);
     }
   }
 #ifdef GT_GREEDY_BUFFER
@@ -1148,22 +1155,36 @@ static int gt_searchforLTRs(GtLTRharvestStream *lo,
   return haserr ? -1 : 0;
 }
 
-typedef struct {
-  GtLTRharvestStream *lo;
-  GtArrayLTRboundaries *arrayLTRboundaries;
-  const GtEncseq *encseq;
-  GtError *err;
-  GtMutex *rmutex, *wmutex;
-  GtUword cur_seed;
-} GtLTRharvestThreadInfo;
-
 static void* gt_searchforLTRs_threadfunc(void *data) {
   GtLTRharvestThreadInfo *info = (GtLTRharvestThreadInfo*) data;
-  GT_UNUSED int rval;
+  GtArrayLTRboundaries localboundaries;
+  GtError *localerr;
+  int rval;
   gt_assert(info);
-  rval = gt_searchforLTRs(info->lo, info->arrayLTRboundaries, info->rmutex,
-                          info->wmutex, &info->cur_seed, info->err);
-  gt_assert(rval == 0);
+  GT_INITARRAY(&localboundaries, LTRboundaries);
+  localerr = gt_error_new();
+  rval = gt_searchforLTRs(info, &localboundaries, localerr);
+
+  /* merge thread-local results, report only the first error */
+  gt_mutex_lock(info->wmutex);
+  if (rval != 0) {
+    if (!info->had_err) {
+      gt_error_set(info->err, "%s", gt_error_get(localerr));
+      info->had_err = -1;
+    }
+  } else if (localboundaries.nextfreeLTRboundaries > 0) {
+    GT_CHECKARRAYSPACEMULTI(info->arrayLTRboundaries, LTRboundaries,
+                            localboundaries.nextfreeLTRboundaries);
+    memcpy(info->arrayLTRboundaries->spaceLTRboundaries
+             + info->arrayLTRboundaries->nextfreeLTRboundaries,
+           localboundaries.spaceLTRboundaries,
+           sizeof (LTRboundaries) * localboundaries.nextfreeLTRboundaries);
+    info->arrayLTRboundaries->nextfreeLTRboundaries
+      += localboundaries.nextfreeLTRboundaries;
+  }
+  gt_mutex_unlock(info->wmutex);
+  GT_FREEARRAY(&localboundaries, LTRboundaries);
+  gt_error_delete(localerr);
   return NULL;
 }
 
@@ -1272,16 +1293,18 @@ static int gt_ltrharvest_stream_next(GtNodeStream *ns,
     threadinfo.encseq = ltrh_stream->encseq;
     threadinfo.arrayLTRboundaries = &ltrh_stream->arrayLTRboundaries;
     threadinfo.err = err;
-    threadinfo.cur_seed = 0;
-    threadinfo.rmutex = gt_mutex_new();
+    threadinfo.seeds = gt_chunk_dispenser_new(
+                                ltrh_stream->repeatinfo.repeats.nextfreeRepeat);
+    threadinfo.had_err = 0;
     threadinfo.wmutex = gt_mutex_new();
     /* apply the seed extension and filter algorithms */
-    if (!had_err && gt_multithread(gt_searchforLTRs_threadfunc,
-                                   &threadinfo, err) != 0)
+    if (!had_err && (gt_multithread(gt_searchforLTRs_threadfunc,
+                                    &threadinfo, err) != 0
+                       || threadinfo.had_err != 0))
     {
       had_err = -1;
     }
-    gt_mutex_delete(threadinfo.rmutex);
+    gt_chunk_dispenser_delete(threadinfo.seeds);
     gt_mutex_delete(threadinfo.wmutex);
 
     /* not needed any longer */
@@ -22,6 +22,7 @@
 #include "core/mathsupport.h" /* for gt_double_equals_double */
 #include "core/unused_api.h"
 #include "core/ma.h"
+#include "core/qsort_r_api.h"
 #include "core/arraydef.h"
 #include "core/logger.h"
 #include "extended/rbtree.h"
@@ -113,6 +114,7 @@ struct GtChain2Dimmode
                                   chainkind = LOCALCHAININGBEST */
                 percentawayfrombest;  /* only defined if
                                          chainkind = LOCALCHAININGPERCENTAWAY */
+  bool sparse; /* use range maximum tree instead of dictionary */
 };
 
 typedef GtUword GtChain2Dimref;
@@ -134,8 +136,10 @@ struct GtChain2Dim
 GtChain2Dimmatchtable *gt_chain_matchtable_new(GtUword numberofmatches)
 {
   GtChain2Dimmatchtable *matchtable = gt_malloc(sizeof (*matchtable));
-  matchtable->matches = gt_malloc(sizeof (*matchtable->matches) *
-                                  numberofmatches);
+  matchtable->matches = numberofmatches == 0
+                          ? NULL
+                          : gt_malloc(sizeof (*matchtable->matches) *
+                                      numberofmatches);
   matchtable->nextfree = 0;
   matchtable->allocated = numberofmatches;
   matchtable->largestdim0 = matchtable->largestdim1 = 0;
@@ -170,7 +174,15 @@ void gt_chain_matchtable_add(GtChain2Dimmatchtable *matchtable,
 {
   Matchchaininfo *matchchaininfo;
 
-  gt_assert(matchtable->nextfree < matchtable->allocated);
+  if (matchtable->nextfree >= matchtable->allocated)
+  {
+    /* matches delivered by an enumeration, as from an index, are not
+       counted in advance, so let the table grow */
+    matchtable->allocated = matchtable->allocated * 1.2 + 1024UL;
+    matchtable->matches = gt_realloc(matchtable->matches,
+                                     sizeof (*matchtable->matches) *
+                                     matchtable->allocated);
+  }
   gt_assert(inmatch->startpos[0] <= inmatch->endpos[0]);
   gt_assert(inmatch->startpos[1] <= inmatch->endpos[1]);
   matchchaininfo = matchtable->matches + matchtable->nextfree++;
@@ -246,9 +258,32 @@ typedef struct
   GtChain2Dimpostype fpposition;
 } GtChain2DimMatchpoint;
 
+/*
+  The sparse chaining engine replaces the dictionary of activated end points
+  by a range maximum tree over the ranks of all end points. As the end points
+  are known in advance, they are sorted once by their position in the
+  second dimension and stored as a struct of arrays. The search for the best
+  predecessor of a match then reduces to a maximum query over a prefix of
+  these ranks, which is answered by the tree in logarithmic time, without
+  any memory allocation per match.
+*/
+
+typedef struct
+{
+  GtUword numofkeys,
+          *keyident,    /* matches ordered by end point in 2nd dimension */
+          *keyrank,     /* rank of the end point of each match */
+          *activation,  /* time at which the end point of a match is
+                           activated */
+          *maxident;    /* match of maximum priority for each node */
+  GtChain2Dimpostype *keyposition; /* the ordered end points */
+  GtChain2Dimscoretype *maxpriority; /* maximum priority for each node */
+} GtChain2DimRangemaxtree;
+
 typedef struct
 {
   GtRBTree *dictroot;
+  GtChain2DimRangemaxtree *rmt; /* not NULL only for the sparse engine */
   GtUword *endpointperm;
 } GtChain2DimMatchstore;
 
@@ -901,76 +936,75 @@ static void gt_chain2dim_activatematchpoint(bool addterminal,
   }
 }
 
-static void gt_chain2dim_evalmatchscore(const GtChain2Dimmode *chainmode,
-                                        GtChain2Dimmatchtable *matchtable,
+static GtUword gt_chain2dim_dictprevious(
+                                        const GtChain2Dimmatchtable *matchtable,
                                         GtChain2DimMatchstore *matchstore,
-                                        bool gapsL1,
                                         GtUword matchpointident,
                                         unsigned int presortdim)
 {
-  GtUword previous;
   GtChain2Dimpostype startpos2;
-  GtChain2DimMatchpoint *qmatch2;
-  GtChain2Dimscoretype score;
+  GtChain2DimMatchpoint keymatch2, *qmatch2;
 
   startpos2 = GT_CHAIN2DIM_GETSTOREDSTARTPOINT(1-presortdim,matchpointident);
   if (startpos2 == 0)
   {
-    qmatch2 = NULL;
-  } else
+    return GT_CHAIN2DIM_UNDEFPREVIOUS;
+  }
+  keymatch2.fpposition = startpos2 - 1;  /* it is a start position */
+  keymatch2.fpident = MAKEENDPOINT(matchpointident);
+                     /* but considered as endpoint */
+  qmatch2 = (GtChain2DimMatchpoint *) gt_rbtree_previous_equal_key(
+                                               matchstore->dictroot,
+                                               &keymatch2,
+                                               gt_chain2dim_cmpendMatchpoint2,
+                                               NULL);
+  return qmatch2 == NULL ? GT_CHAIN2DIM_UNDEFPREVIOUS : FRAGIDENT(qmatch2);
+}
+
+static void gt_chain2dim_evalmatchscore(const GtChain2Dimmode *chainmode,
+                                        GtChain2Dimmatchtable *matchtable,
+                                        bool gapsL1,
+                                        GtUword matchpointident,
+                                        GtUword previous)
+{
+  GtChain2Dimscoretype score;
+
+  if (previous != GT_CHAIN2DIM_UNDEFPREVIOUS &&
+      chainmode->maxgapwidth != 0 &&
+      !gt_chain2dim_checkmaxgapwidth(matchtable,
+                                     chainmode->maxgapwidth,
+                                     previous,
+                                     matchpointident))
   {
-    GtChain2DimMatchpoint keymatch2;
-
-    keymatch2.fpposition = startpos2 - 1;  /* it is a start position */
-    keymatch2.fpident = MAKEENDPOINT(matchpointident);
-                       /* but considered as endpoint */
-    qmatch2 = (GtChain2DimMatchpoint *) gt_rbtree_previous_equal_key(
-                                                 matchstore->dictroot,
-                                                 &keymatch2,
-                                                 gt_chain2dim_cmpendMatchpoint2,
-                                                 NULL);
-    if (qmatch2 != NULL)
-    {
-      if (chainmode->maxgapwidth != 0 &&
-          !gt_chain2dim_checkmaxgapwidth(matchtable,
-                                         chainmode->maxgapwidth,
-                                         FRAGIDENT(qmatch2),
-                                         matchpointident))
-      {
-        qmatch2 = NULL;
-      }
-    }
+    previous = GT_CHAIN2DIM_UNDEFPREVIOUS;
   }
-  if (qmatch2 == NULL)
+  if (previous == GT_CHAIN2DIM_UNDEFPREVIOUS)
   {
     score = matchtable->matches[matchpointident].weight;
     if (chainmode->chainkind == GLOBALCHAININGWITHGAPCOST)
     {
       score -= GT_CHAIN2DIM_INITIALGAP(matchpointident);
     }
-    previous = GT_CHAIN2DIM_UNDEFPREVIOUS;
   } else
   {
-    score = matchtable->matches[FRAGIDENT(qmatch2)].score;
+    score = matchtable->matches[previous].score;
     if (chainmode->chainkind == GLOBALCHAINING)
     {
       score += matchtable->matches[matchpointident].weight;
-      previous = FRAGIDENT(qmatch2);
     } else
     {
       GtChain2Dimscoretype tmpgc;
 
       if (gapsL1)
       {
-        tmpgc = gapcostL1(matchtable,FRAGIDENT(qmatch2),matchpointident);
+        tmpgc = gapcostL1(matchtable,previous,matchpointident);
       } else
       {
-        tmpgc = gapcostCc(matchtable,FRAGIDENT(qmatch2),matchpointident);
+        tmpgc = gapcostCc(matchtable,previous,matchpointident);
       }
       if (chainmode->chainkind == GLOBALCHAININGWITHGAPCOST || score > tmpgc)
       {
         score += (matchtable->matches[matchpointident].weight - tmpgc);
-        previous = FRAGIDENT(qmatch2);
       } else
       {
         score = matchtable->matches[matchpointident].weight;
@@ -1235,66 +1269,258 @@ static GtChain2DimMatchpoint *makeactivationpoint(
   return fpptr;
 }
 
+typedef struct
+{
+  const GtChain2Dimmatchtable *matchtable;
+  unsigned int dim;
+} GtChain2DimEndpointorder;
+
+/* order the matches by their end point in the given dimension. Ties are
+   broken by the match number, so that the order is the same as the one
+   obtained by a stable sort of the matches. */
+
+static int gt_chain2dim_cmpendpoint(const void *keya,const void *keyb,
+                                    void *data)
+{
+  const GtChain2DimEndpointorder *order
+    = (const GtChain2DimEndpointorder *) data;
+  const GtChain2Dimmatchtable *matchtable = order->matchtable;
+  GtUword ida = *(const GtUword *) keya, idb = *(const GtUword *) keyb;
+
+  if (GT_CHAIN2DIM_GETSTOREDENDPOINT(order->dim,ida) <
+      GT_CHAIN2DIM_GETSTOREDENDPOINT(order->dim,idb))
+  {
+    return -1;
+  }
+  if (GT_CHAIN2DIM_GETSTOREDENDPOINT(order->dim,ida) >
+      GT_CHAIN2DIM_GETSTOREDENDPOINT(order->dim,idb))
+  {
+    return 1;
+  }
+  return ida < idb ? -1 : (ida > idb ? 1 : 0);
+}
+
+static void gt_chain2dim_sortbyendpoint(GtUword *perm,
+                                        const GtChain2Dimmatchtable *matchtable,
+                                        unsigned int dim)
+{
+  GtUword idx;
+  GtChain2DimEndpointorder order;
+
+  for (idx = 0; idx < matchtable->nextfree; idx++)
+  {
+    perm[idx] = idx;
+  }
+  order.matchtable = matchtable;
+  order.dim = dim;
+  gt_qsort_r(perm,(size_t) matchtable->nextfree,sizeof (*perm),&order,
+             gt_chain2dim_cmpendpoint);
+}
+
+static GtChain2DimRangemaxtree *gt_chain2dim_rmt_new(
+                                       const GtChain2Dimmatchtable *matchtable,
+                                       const GtUword *endpointperm,
+                                       unsigned int postsortdim)
+{
+  GtUword idx;
+  GtChain2DimRangemaxtree *rmt = gt_malloc(sizeof (*rmt));
+
+  rmt->numofkeys = matchtable->nextfree;
+  rmt->keyident = gt_malloc(sizeof (*rmt->keyident) * rmt->numofkeys);
+  gt_chain2dim_sortbyendpoint(rmt->keyident,matchtable,postsortdim);
+  rmt->keyposition = gt_malloc(sizeof (*rmt->keyposition) * rmt->numofkeys);
+  rmt->keyrank = gt_malloc(sizeof (*rmt->keyrank) * rmt->numofkeys);
+  rmt->activation = gt_malloc(sizeof (*rmt->activation) * rmt->numofkeys);
+  for (idx = 0; idx < rmt->numofkeys; idx++)
+  {
+    rmt->keyposition[idx]
+      = GT_CHAIN2DIM_GETSTOREDENDPOINT(postsortdim,rmt->keyident[idx]);
+    rmt->keyrank[rmt->keyident[idx]] = idx;
+    rmt->activation[endpointperm[idx]] = idx;
+  }
+  /* the nodes are numbered from 1 to numofkeys */
+  rmt->maxpriority = gt_malloc(sizeof (*rmt->maxpriority) *
+                               (rmt->numofkeys + 1));
+  rmt->maxident = gt_malloc(sizeof (*rmt->maxident) * (rmt->numofkeys + 1));
+  for (idx = 0; idx <= rmt->numofkeys; idx++)
+  {
+    rmt->maxident[idx] = GT_CHAIN2DIM_UNDEFPREVIOUS;
+  }
+  return rmt;
+}
+
+static void gt_chain2dim_rmt_delete(GtChain2DimRangemaxtree *rmt)
+{
+  if (rmt != NULL)
+  {
+    gt_free(rmt->keyident);
+    gt_free(rmt->keyposition);
+    gt_free(rmt->keyrank);
+    gt_free(rmt->activation);
+    gt_free(rmt->maxpriority);
+    gt_free(rmt->maxident);
+    gt_free(rmt);
+  }
+}
+
+/*
+  The dictionary delivers, among all activated end points of maximum
+  priority, the one activated first. So, if priorities are equal, the
+  activation time decides.
+*/
+
+static bool gt_chain2dim_rmt_precedes(const GtChain2DimRangemaxtree *rmt,
+                                      GtChain2Dimscoretype priority_a,
+                                      GtUword matchnum_a,
+                                      GtChain2Dimscoretype priority_b,
+                                      GtUword matchnum_b)
+{
+  return (priority_a > priority_b ||
+          (priority_a == priority_b &&
+           rmt->activation[matchnum_a] < rmt->activation[matchnum_b]))
+         ? true : false;
+}
+
+static void gt_chain2dim_rmt_activate(bool addterminal,
+                                      const GtChain2Dimmatchtable *matchtable,
+                                      GtChain2DimRangemaxtree *rmt,
+                                      GtUword matchnum)
+{
+  GtUword node;
+  GtChain2Dimscoretype priority
+    = gt_chain2dim_evalpriority(addterminal,matchtable,matchnum);
+
+  for (node = rmt->keyrank[matchnum] + 1; node <= rmt->numofkeys;
+       node += node & -node)
+  {
+    if (rmt->maxident[node] != GT_CHAIN2DIM_UNDEFPREVIOUS &&
+        !gt_chain2dim_rmt_precedes(rmt,priority,matchnum,
+                                   rmt->maxpriority[node],
+                                   rmt->maxident[node]))
+    {
+      /* the range of each node is contained in the range of the next node,
+         so the following nodes already store a better match */
+      break;
+    }
+    rmt->maxpriority[node] = priority;
+    rmt->maxident[node] = matchnum;
+  }
+}
+
+/* return the match of maximum priority among the end points with
+   rank smaller than <prefix> */
+
+static GtUword gt_chain2dim_rmt_prefixmax(
+                                       const GtChain2Dimmatchtable *matchtable,
+                                       const GtChain2DimRangemaxtree *rmt,
+                                       GtUword prefix)
+{
+  GtUword node, best = GT_CHAIN2DIM_UNDEFPREVIOUS;
+  GtChain2Dimscoretype bestpriority = 0;
+
+  for (node = prefix; node > 0; node -= node & -node)
+  {
+    if (rmt->maxident[node] != GT_CHAIN2DIM_UNDEFPREVIOUS &&
+        (best == GT_CHAIN2DIM_UNDEFPREVIOUS ||
+         gt_chain2dim_rmt_precedes(rmt,rmt->maxpriority[node],
+                                   rmt->maxident[node],bestpriority,best)))
+    {
+      best = rmt->maxident[node];
+      bestpriority = rmt->maxpriority[node];
+    }
+  }
+  return best;
+}
+
+/* the analogue of gt_chain2dim_dictprevious for the sparse engine: the
+   end points preceding the start point of the match are those with
+   a rank smaller than the number of keys not larger than the start point */
+
+static GtUword gt_chain2dim_rmtprevious(const GtChain2Dimmatchtable *matchtable,
+                                        const GtChain2DimRangemaxtree *rmt,
+                                        GtUword matchpointident,
+                                        unsigned int presortdim)
+{
+  GtChain2Dimpostype startpos2;
+  GtUword left = 0, right = rmt->numofkeys;
+
+  startpos2 = GT_CHAIN2DIM_GETSTOREDSTARTPOINT(1-presortdim,matchpointident);
+  if (startpos2 == 0)
+  {
+    return GT_CHAIN2DIM_UNDEFPREVIOUS;
+  }
+  /* binary search for the number of keys smaller than or equal to
+     (startpos2 - 1, matchpointident) */
+  while (left < right)
+  {
+    GtUword mid = left + (right - left)/2;
+
+    if (rmt->keyposition[mid] < startpos2 - 1 ||
+        (rmt->keyposition[mid] == startpos2 - 1 &&
+         rmt->keyident[mid] <= matchpointident))
+    {
+      left = mid + 1;
+    } else
+    {
+      right = mid;
+    }
+  }
+  return gt_chain2dim_rmt_prefixmax(matchtable,rmt,left);
+}
+
 static void mergestartandendpoints(const GtChain2Dimmode *chainmode,
                                    GtChain2Dimmatchtable *matchtable,
                                    GtChain2DimMatchstore *matchstore,
                                    bool gapsL1,
                                    unsigned int presortdim)
 {
-  GtUword xidx, startcount, endcount;
+  GtUword startcount, endcount;
   const unsigned int postsortdim = 1U - presortdim;
   bool addterminal = (chainmode->chainkind == GLOBALCHAINING) ? false : true;
 
-  matchstore->dictroot = gt_rbtree_new(gt_chain2dim_cmpendMatchpoint2,
-                                       gt_free_func, NULL);
-  for (xidx = 0, startcount = 0, endcount = 0;
-       startcount < matchtable->nextfree &&
-       endcount < matchtable->nextfree;
-       xidx++)
-  {
-    if (comparestartandend(matchtable->matches + startcount,
-                           matchtable->matches +
-                           matchstore->endpointperm[endcount],
-                           presortdim) < 0)
+  if (matchstore->rmt == NULL)
+  {
+    matchstore->dictroot = gt_rbtree_new(gt_chain2dim_cmpendMatchpoint2,
+                                         gt_free_func, NULL);
+  }
+  for (startcount = 0, endcount = 0;
+       startcount < matchtable->nextfree || endcount < matchtable->nextfree;
+       /* Nothing */)
+  {
+    if (startcount < matchtable->nextfree &&
+        (endcount == matchtable->nextfree ||
+         comparestartandend(matchtable->matches + startcount,
+                            matchtable->matches +
+                            matchstore->endpointperm[endcount],
+                            presortdim) < 0))
     {
       gt_chain2dim_evalmatchscore(chainmode,
                      matchtable,
-                     matchstore,
                      gapsL1,
                      startcount,
-                     presortdim);
+                     matchstore->rmt == NULL
+                       ? gt_chain2dim_dictprevious(matchtable,matchstore,
+                                                   startcount,presortdim)
+                       : gt_chain2dim_rmtprevious(matchtable,matchstore->rmt,
+                                                  startcount,presortdim));
       startcount++;
     } else
     {
-      gt_chain2dim_activatematchpoint(addterminal,matchtable,matchstore,
-                        makeactivationpoint(matchtable,
-                                            matchstore->
-                                            endpointperm[endcount],
-                                            postsortdim));
+      if (matchstore->rmt == NULL)
+      {
+        gt_chain2dim_activatematchpoint(addterminal,matchtable,matchstore,
+                          makeactivationpoint(matchtable,
+                                              matchstore->
+                                              endpointperm[endcount],
+                                              postsortdim));
+      } else
+      {
+        gt_chain2dim_rmt_activate(addterminal,matchtable,matchstore->rmt,
+                                  matchstore->endpointperm[endcount]);
+      }
       endcount++;
     }
   }
-  while (startcount < matchtable->nextfree)
-  {
-    gt_chain2dim_evalmatchscore(chainmode,
-                   matchtable,
-                   matchstore,
-                   gapsL1,
-                   startcount,
-                   presortdim);
-    startcount++;
-    xidx++;
-  }
-  while (endcount < matchtable->nextfree)
-  {
-    gt_chain2dim_activatematchpoint(addterminal,matchtable,matchstore,
-                      makeactivationpoint(matchtable,
-                                          matchstore->
-                                          endpointperm[endcount],
-                                          postsortdim));
-    endcount++;
-    xidx++;
-  }
 }
 
 static unsigned int gt_chain2dim_findmaximalscores(
@@ -1326,9 +1552,17 @@ static unsigned int gt_chain2dim_findmaximalscores(
   switch (chainmode->chainkind)
   {
     case GLOBALCHAINING:
-      maxpoint = gt_rbtree_maximum_key(matchstore->dictroot);
-      gt_assert(maxpoint != NULL);
-      matchnum = FRAGIDENT(maxpoint);
+      if (matchstore->rmt != NULL)
+      {
+        matchnum = gt_chain2dim_rmt_prefixmax(matchtable,matchstore->rmt,
+                                              matchstore->rmt->numofkeys);
+        gt_assert(matchnum != GT_CHAIN2DIM_UNDEFPREVIOUS);
+      } else
+      {
+        maxpoint = gt_rbtree_maximum_key(matchstore->dictroot);
+        gt_assert(maxpoint != NULL);
+        matchnum = FRAGIDENT(maxpoint);
+      }
       minscore = matchtable->matches[matchnum].score;
       minscoredefined = true;
       break;
@@ -1391,33 +1625,6 @@ static unsigned int gt_chain2dim_findmaximalscores(
   return retval;
 }
 
-static void makesortedendpointpermutation(GtUword *perm,
-                                          GtChain2Dimmatchtable *matchtable,
-                                          unsigned int presortdim)
-{
-  GtUword temp, *iptr, *jptr, i, moves = 0;
-
-  for (i = 0; i < matchtable->nextfree; i++)
-  {
-    perm[i] = i;
-  }
-  for (iptr = perm + 1UL; iptr < perm + matchtable->nextfree; iptr++)
-  {
-    for (jptr = iptr; jptr > perm; jptr--)
-    {
-      if (GT_CHAIN2DIM_GETSTOREDENDPOINT(presortdim,*(jptr-1)) <=
-          GT_CHAIN2DIM_GETSTOREDENDPOINT(presortdim,*jptr))
-      {
-        break;
-      }
-      temp = *(jptr-1);
-      *(jptr-1) = *jptr;
-      *jptr = temp;
-      moves++;
-    }
-  }
-}
-
 static void fastchainingscores(const GtChain2Dimmode *chainmode,
                                GtChain2Dimmatchtable *matchtable,
                                GtChain2DimMatchstore *matchstore,
@@ -1427,9 +1634,15 @@ static void fastchainingscores(const GtChain2Dimmode *chainmode,
   matchstore->endpointperm
     = gt_malloc(sizeof (*matchstore->endpointperm) *
                 matchtable->nextfree);
-  makesortedendpointpermutation(matchstore->endpointperm,
-                                matchtable,
-                                presortdim);
+  gt_chain2dim_sortbyendpoint(matchstore->endpointperm,
+                              matchtable,
+                              presortdim);
+  if (chainmode->sparse)
+  {
+    matchstore->rmt = gt_chain2dim_rmt_new(matchtable,
+                                           matchstore->endpointperm,
+                                           1U - presortdim);
+  }
   mergestartandendpoints(chainmode,
                          matchtable,
                          matchstore,
@@ -1498,6 +1711,7 @@ void gt_chain_fastchaining(const GtChain2Dimmode *chainmode,
 
     gt_logger_log(logger,"compute chain scores");
     matchstore.dictroot = NULL;
+    matchstore.rmt = NULL;
     if (chainmode->chainkind == GLOBALCHAININGWITHOVERLAPS)
     {
       gt_chain2dim_bruteforcechainingscores(chainmode,matchtable,
@@ -1525,11 +1739,11 @@ void gt_chain_fastchaining(const GtChain2Dimmode *chainmode,
                                withequivclasses,
                                cpinfo,
                                logger);
-    if (chainmode->chainkind != GLOBALCHAININGWITHOVERLAPS
-        && chainmode->chainkind != GLOBALCHAININGALLCHAINS)
+    if (matchstore.dictroot != NULL)
     {
       gt_rbtree_delete(matchstore.dictroot);
     }
+    gt_chain2dim_rmt_delete(matchstore.rmt);
   } else
   {
     gt_chain2dim_chainingboundarycases(chainmode, chain, matchtable);
@@ -1689,6 +1903,7 @@ GtChain2Dimmode *gt_chain_chainmode_new(GtUword maxgap,
   chainmode = gt_malloc(sizeof (*chainmode));
   chainmode->chainkind = GLOBALCHAINING;
   chainmode->maxgapwidth = (GtChain2Dimpostype) maxgap;
+  chainmode->sparse = false;
   if (localset)
   {
     if (localargs == NULL)
@@ -1724,6 +1939,12 @@ GtChain2Dimmode *gt_chain_chainmode_new(GtUword maxgap,
   return chainmode;
 }
 
+void gt_chain_chainmode_set_sparse(GtChain2Dimmode *chainmode, bool sparse)
+{
+  gt_assert(chainmode != NULL);
+  chainmode->sparse = sparse;
+}
+
 void gt_chain_chainmode_delete(GtChain2Dimmode *chainmode)
 {
   if (chainmode != NULL)
@@ -78,7 +78,8 @@ typedef void (*GtChain2Dimprocessor)(void *,
 
 typedef struct GtChain2Dimmode GtChain2Dimmode;
 
-/* the constructor for tables of matches */
+/* the constructor for tables of matches, with space for <numberofmatches>
+   matches. The table grows if more matches are added. */
 
 GtChain2Dimmatchtable *gt_chain_matchtable_new(GtUword numberofmatches);
 
@@ -127,6 +128,14 @@ GtChain2Dimmode *gt_chain_chainmode_new(GtUword maxgap,
                                         const char *localargs,
                                         GtError *err);
 
+/* use the sparse chaining engine, which determines the best predecessor
+   of each match by a range maximum tree over the sorted end points instead
+   of a dictionary of the activated end points. This is faster for large
+   sets of matches and delivers the same chains. Only relevant for
+   chainmodes not allowing overlaps and not computing all chains. */
+
+void gt_chain_chainmode_set_sparse(GtChain2Dimmode *chainmode, bool sparse);
+
 /* the destructor for chainmode objects */
 
 void gt_chain_chainmode_delete(GtChain2Dimmode *chainmode);
@@ -681,6 +681,12 @@ seqIdxUsesMMap(const struct blockCompositionSeq *seqIdx)
   return seqIdx->externalData.idxMMap != NULL;
 }
 
+static int
+blockCompSeqUsesMMap(const EISeq *seq)
+{
+  return seqIdxUsesMMap(constEncIdxSeq2blockCompositionSeq(seq));
+}
+
 /**
  * Since the sequence represented in the form of blocks is incomplete
  * without the information in corresponding regions, a superBlock
@@ -2748,4 +2754,5 @@ static const struct encIdxSeqClass blockCompositionSeqClass =
   .seekToHeader = seekToHeader,
   .printPosDiags = printBlockEncPosDiags,
   .printExtPosDiags = displayBlockEncBlock,
+  .usesMMap = blockCompSeqUsesMMap,
 };
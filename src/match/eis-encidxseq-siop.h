@@ -152,6 +152,13 @@ EISSeekToHeader(const EISeq *seqIdx, uint16_t headerID,
   return seqIdx->classInfo->seekToHeader(seqIdx, headerID, lenRet);
 }
 
+static inline int
+EISUsesMMap(const EISeq *seqIdx)
+{
+  gt_assert(seqIdx);
+  return seqIdx->classInfo->usesMMap(seqIdx);
+}
+
 static inline EISHint
 newEISHint(const EISeq *seq)
 {
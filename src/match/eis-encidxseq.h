@@ -430,6 +430,16 @@ static inline FILE *
 EISSeekToHeader(const EISeq *seqIdx, uint16_t headerID,
                 uint32_t *lenRet);
 
+/**
+ * @brief Query whether the index data is accessed via a memory map.
+ * Otherwise it is read from a file pointer shared by all hints, so
+ * hints of the same index must not be used concurrently.
+ * @param seqIdx sequence index to query
+ * @return 0 if the index is read from file
+ */
+static inline int
+EISUsesMMap(const EISeq *seqIdx);
+
 /**
  * Given a position write debugging output for surrounding sequence.
  * @param seqIdx sequence index to query
@@ -413,6 +413,32 @@ void gt_deletevoidBWTSeq(FMindex *fmindex)
   gt_deleteBWTSeq(bwtseq);
 }
 
+bool gt_threadviewvoidBWTSeq_supported(const FMindex *fmindex)
+{
+  return EISUsesMMap(((const BWTSeq *) fmindex)->seqIdx) ? true : false;
+}
+
+FMindex *gt_threadviewvoidBWTSeq_new(const FMindex *fmindex)
+{
+  BWTSeq *view = gt_malloc(sizeof (*view));
+
+  gt_assert(gt_threadviewvoidBWTSeq_supported(fmindex));
+  *view = *(const BWTSeq *) fmindex;
+  view->hint = newEISHint(view->seqIdx);
+  return (FMindex *) view;
+}
+
+void gt_threadviewvoidBWTSeq_delete(FMindex *view)
+{
+  if (view != NULL)
+  {
+    BWTSeq *bwtseq = (BWTSeq *) view;
+
+    deleteEISHint(bwtseq->seqIdx, bwtseq->hint);
+    gt_free(bwtseq);
+  }
+}
+
 GtUword gt_voidpackedindexuniqueforward(const void *fmindex,
                                               GT_UNUSED GtUword offset,
                                               GT_UNUSED GtUword left,
@@ -83,6 +83,23 @@ FMindex *gt_loadvoidBWTSeqForSA(const char *indexname,
 
 void gt_deletevoidBWTSeq(FMindex *packedindex);
 
+/* return true if threads can query <fmindex> in parallel, each using a view
+   of its own. This requires the index to be memory mapped, otherwise all
+   views read from the same file pointer. */
+
+bool gt_threadviewvoidBWTSeq_supported(const FMindex *fmindex);
+
+/* return a view of <fmindex> which shares all index data with <fmindex>,
+   but has its own cache for queries. So each thread querying the same
+   index in parallel must use a view of its own. Only supported if
+   <gt_threadviewvoidBWTSeq_supported> returns true. */
+
+FMindex *gt_threadviewvoidBWTSeq_new(const FMindex *fmindex);
+
+/* delete a view returned by <gt_threadviewvoidBWTSeq_new> */
+
+void gt_threadviewvoidBWTSeq_delete(FMindex *view);
+
 /* the parameter is const void *, as this is required by the other
    indexed based methods */
 
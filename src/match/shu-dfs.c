@@ -17,15 +17,20 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "core/array2dim_api.h"
+#include "core/arraydef.h"
 #include "core/chardef.h"
 #include "core/divmodmul.h"
 #include "core/format64.h"
 #include "core/log_api.h"
 #include "core/logger.h"
+#include "core/ma.h"
+#include "core/multithread_api.h"
 #include "core/safearith.h"
 #include "core/stack-inlined.h"
+#include "core/thread_api.h"
 #include "core/unused_api.h"
 
 #include "match/eis-voiditf.h"
@@ -149,6 +154,43 @@ static inline GtUword get_start_idx_binary_search(ShuNode *parent,
   return start_idx;
 }
 
+static ShuNode *shu_push_node(GtStackShuNode *stack,
+                              GtUword lower,
+                              GtUword upper,
+                              GtUword depth,
+                              GtUword numofchars,
+                              GtUword num_of_genomes)
+{
+  ShuNode *node = NULL;
+
+  GT_STACK_NEXT_FREE(stack,node);
+  if (node->countTermSubtree == NULL)
+  {
+    gt_array2dim_calloc(node->countTermSubtree,
+                        numofchars+1UL,
+                        num_of_genomes);
+  }
+  else
+  {
+    GtUword y_idx, file_idx;
+    for (y_idx = 0; y_idx < numofchars+1UL; y_idx++)
+    {
+      for (file_idx = 0;
+           file_idx < num_of_genomes;
+           file_idx++)
+      {
+        node->countTermSubtree[y_idx][file_idx] = 0;
+      }
+    }
+  }
+  node->process = false;
+  node->lower = lower;
+  node->upper = upper;
+  node->parentOffset = 0;
+  node->depth = depth;
+  return node;
+}
+
 static int visit_shu_children(const FMindex *index,
                               ShuNode *parent,
                               GtStackShuNode *stack,
@@ -210,33 +252,13 @@ static int visit_shu_children(const FMindex *index,
         }
         else
         { /* tmpmbtab[idx] is a branch of parent node */
-          ShuNode *child = NULL;
-
-          GT_STACK_NEXT_FREE(stack,child);
-          if (child->countTermSubtree == NULL)
-          {
-            gt_array2dim_calloc(child->countTermSubtree,
-                                numofchars+1UL,
-                                unit_info->num_of_genomes);
-          }
-          else
-          {
-            GtUword y_idx, file_idx;
-            for (y_idx = 0; y_idx < numofchars+1UL; y_idx++)
-            {
-              for (file_idx = 0;
-                   file_idx < unit_info->num_of_genomes;
-                   file_idx++)
-              {
-                child->countTermSubtree[y_idx][file_idx] = 0;
-              }
-            }
-          }
-          child->process = false;
-          child->lower = tmpmbtab[idx].lowerbound;
-          child->upper = tmpmbtab[idx].upperbound;
+          ShuNode *child = shu_push_node(stack,
+                                         tmpmbtab[idx].lowerbound,
+                                         tmpmbtab[idx].upperbound,
+                                         parent->depth + 1,
+                                         numofchars,
+                                         unit_info->num_of_genomes);
           child->parentOffset = offset;
-          child->depth = parent->depth + 1;
           offset++;
         }
       }
@@ -384,6 +406,52 @@ static int process_shu_node(ShuNode *node,
   return had_err;
 }
 
+/* The nodes of the virtual suffix tree in depth <splitdepth> are the roots
+   of the subtrees, which are traversed in parallel. Each such subtree root
+   is a task. The part of the tree above the tasks is traversed twice by
+   one thread: once to collect the tasks and once, after all tasks are done,
+   to process the nodes above the tasks with the counts of the tasks. */
+
+#define SHU_TASKSPERTHREAD 16UL
+
+typedef struct
+{
+  GtUword lower,
+          upper,
+          depth,
+          *counts; /* number of leaves of each genome in the subtree */
+} ShuTask;
+
+GT_DECLAREARRAYSTRUCT(ShuTask);
+
+typedef enum
+{
+  SHU_TRAVERSE_ALL,
+  SHU_TRAVERSE_COLLECT,
+  SHU_TRAVERSE_REPLAY
+} ShuTraversemode;
+
+typedef struct
+{
+  const FMindex *index;
+  const GtShuUnitFileInfo *unit_info;
+  GtUword **special_pos,
+          numofchars,
+          total_length,
+          max_idx;
+} ShuTraverseinfo;
+
+typedef struct
+{
+  const ShuTraverseinfo *tinfo;
+  GtArrayShuTask *tasks;
+  GtUword nexttask;
+  uint64_t **shulen;
+  GtMutex *mutex;
+  bool had_err;
+  GtError *err;
+} ShuParallelinfo;
+
 static int initialise_node(void *node)
 {
   int had_err = 0;
@@ -393,6 +461,303 @@ static int initialise_node(void *node)
   return had_err;
 }
 
+static void shu_free_stack(GtStackShuNode *stack)
+{
+  GtUword depth_idx;
+
+  for (depth_idx = 0; depth_idx < GT_STACK_MAXSIZE(stack); depth_idx++)
+  {
+    gt_array2dim_delete(stack->space[depth_idx].countTermSubtree);
+  }
+  GT_STACK_DELETE(stack);
+}
+
+/* add the counts of a task to the parent of the task node, which was just
+   removed from the stack, as <process_shu_node> would do */
+static void shu_replay_task(ShuNode *node,
+                            GtStackShuNode *stack,
+                            const GtUword *counts,
+                            GtUword num_of_genomes)
+{
+  GtUword idx_i;
+  ShuNode *parent;
+
+  gt_assert(node->parentOffset > 0);
+  parent = stack->space + stack->nextfree - node->parentOffset;
+  for (idx_i = 0; idx_i < num_of_genomes; idx_i++)
+  {
+    if (counts[idx_i] > 0)
+    {
+      parent->countTermSubtree[0][idx_i] += counts[idx_i];
+      parent->countTermSubtree[node->parentOffset][idx_i] = counts[idx_i];
+    }
+  }
+}
+
+/* traverse the subtree whose root is on top of <stack>. In mode
+   <SHU_TRAVERSE_COLLECT> the nodes in depth at least <splitdepth> are not
+   traversed but appended to <tasks>, and no node is processed. In mode
+   <SHU_TRAVERSE_REPLAY> these nodes are replaced by the counts stored in
+   the corresponding tasks. */
+static int shu_traverse(const ShuTraverseinfo *tinfo,
+                        GtStackShuNode *stack,
+                        uint64_t **shulen,
+                        Mbtab *tmpmbtab,
+                        GtUword *rangeOccs,
+                        BwtSeqpositionextractor *pos_extractor,
+                        ShuTraversemode mode,
+                        GtUword splitdepth,
+                        GtArrayShuTask *tasks,
+                        GtUword *processed_nodes,
+                        GtLogger *logger,
+                        GtError *err)
+{
+  int had_err = 0;
+  GtUword nexttask = 0;
+
+  while (!had_err && !GT_STACK_ISEMPTY(stack))
+  {
+    ShuNode *current;
+
+    gt_assert(stack->nextfree > 0);
+    current = stack->space + stack->nextfree -1;
+    if (mode != SHU_TRAVERSE_ALL && !current->process &&
+        stack->nextfree > 1UL && current->depth >= splitdepth)
+    {
+      GT_STACK_DECREMENTTOP(stack);
+      if (mode == SHU_TRAVERSE_COLLECT)
+      {
+        ShuTask *task;
+
+        GT_GETNEXTFREEINARRAY(task,tasks,ShuTask,64UL);
+        task->lower = current->lower;
+        task->upper = current->upper;
+        task->depth = current->depth;
+        task->counts = NULL;
+      }
+      else
+      {
+        gt_assert(nexttask < tasks->nextfreeShuTask);
+        shu_replay_task(current,
+                        stack,
+                        tasks->spaceShuTask[nexttask++].counts,
+                        tinfo->unit_info->num_of_genomes);
+      }
+    }
+    else if (current->process)
+    {
+      GT_STACK_DECREMENTTOP(stack);
+      if (mode != SHU_TRAVERSE_COLLECT)
+      {
+        had_err = process_shu_node(current,
+                                   stack,
+                                   shulen,
+                                   tinfo->unit_info->num_of_genomes,
+                                   tinfo->numofchars,
+                                   logger,
+                                   err);
+        (*processed_nodes)++;
+      }
+    }
+    else
+    {
+      had_err = visit_shu_children(tinfo->index,
+                                   current,
+                                   stack,
+                                   tinfo->unit_info->encseq,
+                                   tmpmbtab,
+                                   pos_extractor,
+                                   rangeOccs,
+                                   tinfo->special_pos,
+                                   tinfo->numofchars,
+                                   tinfo->unit_info,
+                                   tinfo->total_length,
+                                   tinfo->max_idx,
+                                   logger,
+                                   err);
+    }
+  }
+  gt_assert(had_err || mode != SHU_TRAVERSE_REPLAY ||
+            nexttask == tasks->nextfreeShuTask);
+  return had_err;
+}
+
+static int shu_add_shulen(uint64_t **shulen,
+                          uint64_t **localshulen,
+                          GtUword num_of_genomes,
+                          GtError *err)
+{
+  GtUword idx_i, idx_j;
+
+  for (idx_i = 0; idx_i < num_of_genomes; idx_i++)
+  {
+    for (idx_j = 0; idx_j < num_of_genomes; idx_j++)
+    {
+      uint64_t old = shulen[idx_i][idx_j];
+
+      shulen[idx_i][idx_j] += localshulen[idx_i][idx_j];
+      if (shulen[idx_i][idx_j] < old)
+      {
+        gt_error_set(err, "overflow in addition of shuSums! "
+                          Formatuint64_t "+ " Formatuint64_t " ="
+                          Formatuint64_t "\n",
+                     PRINTuint64_tcast(old),
+                     PRINTuint64_tcast(localshulen[idx_i][idx_j]),
+                     PRINTuint64_tcast(shulen[idx_i][idx_j]));
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+static void *shu_traverse_thread(void *data)
+{
+  ShuParallelinfo *pinfo = data;
+  const ShuTraverseinfo *tinfo = pinfo->tinfo;
+  const GtUword num_of_genomes = tinfo->unit_info->num_of_genomes;
+  ShuTraverseinfo threadinfo = *tinfo;
+  GtStackShuNode stack;
+  FMindex *view;
+  Mbtab *tmpmbtab;
+  GtUword *rangeOccs, processed_nodes = 0;
+  BwtSeqpositionextractor *pos_extractor;
+  uint64_t **localshulen;
+  GtError *err = gt_error_new();
+  int had_err = 0;
+
+  view = gt_threadviewvoidBWTSeq_new(tinfo->index);
+  threadinfo.index = view;
+  rangeOccs = gt_calloc((size_t) GT_MULT2(tinfo->numofchars),
+                        sizeof (*rangeOccs));
+  tmpmbtab = gt_calloc((size_t) (tinfo->numofchars + 3), sizeof (*tmpmbtab));
+  pos_extractor = gt_newBwtSeqpositionextractor(view,
+                                                tinfo->total_length + 1);
+  gt_array2dim_calloc(localshulen, num_of_genomes, num_of_genomes);
+  GT_STACK_INIT_WITH_INITFUNC(&stack, 64UL, initialise_node);
+  while (!had_err)
+  {
+    ShuTask *task;
+
+    gt_mutex_lock(pinfo->mutex);
+    if (pinfo->had_err || pinfo->nexttask >= pinfo->tasks->nextfreeShuTask)
+    {
+      gt_mutex_unlock(pinfo->mutex);
+      break;
+    }
+    task = pinfo->tasks->spaceShuTask + pinfo->nexttask++;
+    gt_mutex_unlock(pinfo->mutex);
+    (void) shu_push_node(&stack, task->lower, task->upper, task->depth,
+                         tinfo->numofchars, num_of_genomes);
+    had_err = shu_traverse(&threadinfo, &stack, localshulen, tmpmbtab,
+                           rangeOccs, pos_extractor, SHU_TRAVERSE_ALL, 0,
+                           NULL, &processed_nodes, NULL, err);
+    if (!had_err)
+    {
+      /* the root of the subtree stays in the first stack element */
+      memcpy(task->counts, stack.space[0].countTermSubtree[0],
+             sizeof (*task->counts) * num_of_genomes);
+    }
+  }
+  gt_mutex_lock(pinfo->mutex);
+  if (!had_err && !pinfo->had_err)
+  {
+    had_err = shu_add_shulen(pinfo->shulen, localshulen, num_of_genomes, err);
+  }
+  if (had_err && !pinfo->had_err)
+  {
+    pinfo->had_err = true;
+    gt_error_set(pinfo->err, "%s", gt_error_get(err));
+  }
+  gt_mutex_unlock(pinfo->mutex);
+  gt_log_log("processed nodes in thread= "GT_WU"", processed_nodes);
+  shu_free_stack(&stack);
+  gt_array2dim_delete(localshulen);
+  gt_freeBwtSeqpositionextractor(pos_extractor);
+  gt_free(tmpmbtab);
+  gt_free(rangeOccs);
+  gt_threadviewvoidBWTSeq_delete(view);
+  gt_error_delete(err);
+  return NULL;
+}
+
+static GtUword shu_splitdepth(GtUword numofchars)
+{
+  GtUword splitdepth = 1UL, numofsubtrees = numofchars;
+
+  while (numofsubtrees < (GtUword) gt_jobs * SHU_TASKSPERTHREAD)
+  {
+    numofsubtrees *= numofchars;
+    splitdepth++;
+  }
+  return splitdepth;
+}
+
+static int shu_traverse_parallel(const ShuTraverseinfo *tinfo,
+                                 GtStackShuNode *stack,
+                                 uint64_t **shulen,
+                                 Mbtab *tmpmbtab,
+                                 GtUword *rangeOccs,
+                                 BwtSeqpositionextractor *pos_extractor,
+                                 GtUword *processed_nodes,
+                                 GtLogger *logger,
+                                 GtError *err)
+{
+  int had_err = 0;
+  const GtUword splitdepth = shu_splitdepth(tinfo->numofchars),
+                num_of_genomes = tinfo->unit_info->num_of_genomes;
+  GtArrayShuTask tasks;
+  GtUword task_idx;
+  ShuNode root;
+
+  gt_assert(stack->nextfree == 1UL);
+  root = stack->space[0];
+  GT_INITARRAY(&tasks, ShuTask);
+  had_err = shu_traverse(tinfo, stack, shulen, tmpmbtab, rangeOccs,
+                         pos_extractor, SHU_TRAVERSE_COLLECT, splitdepth,
+                         &tasks, processed_nodes, logger, err);
+  if (!had_err)
+  {
+    ShuParallelinfo pinfo;
+
+    gt_logger_log(logger, "traverse "GT_WU" subtrees of depth "GT_WU
+                  " in parallel", tasks.nextfreeShuTask, splitdepth);
+    for (task_idx = 0; task_idx < tasks.nextfreeShuTask; task_idx++)
+    {
+      tasks.spaceShuTask[task_idx].counts
+        = gt_malloc(sizeof (*tasks.spaceShuTask[task_idx].counts) *
+                    num_of_genomes);
+    }
+    pinfo.tinfo = tinfo;
+    pinfo.tasks = &tasks;
+    pinfo.nexttask = 0;
+    pinfo.shulen = shulen;
+    pinfo.mutex = gt_mutex_new();
+    pinfo.had_err = false;
+    pinfo.err = err;
+    had_err = gt_multithread(shu_traverse_thread, &pinfo, err);
+    gt_mutex_delete(pinfo.mutex);
+    if (!had_err && pinfo.had_err)
+    {
+      had_err = -1;
+    }
+  }
+  if (!had_err)
+  {
+    (void) shu_push_node(stack, root.lower, root.upper, root.depth,
+                         tinfo->numofchars, num_of_genomes);
+    had_err = shu_traverse(tinfo, stack, shulen, tmpmbtab, rangeOccs,
+                           pos_extractor, SHU_TRAVERSE_REPLAY, splitdepth,
+                           &tasks, processed_nodes, logger, err);
+  }
+  for (task_idx = 0; task_idx < tasks.nextfreeShuTask; task_idx++)
+  {
+    gt_free(tasks.spaceShuTask[task_idx].counts);
+  }
+  GT_FREEARRAY(&tasks, ShuTask);
+  return had_err;
+}
+
 int gt_pck_calculate_shulen(const FMindex *index,
                             const GtShuUnitFileInfo *unit_info,
                             uint64_t **shulen,
@@ -404,18 +769,19 @@ int gt_pck_calculate_shulen(const FMindex *index,
 {
   int had_err = 0;
   GtStackShuNode stack;
-  ShuNode *root;
   Mbtab *tmpmbtab;
   const GtUword resize = 64UL;
   GtUword *rangeOccs,
-                **special_char_rows_and_pos,
-                depth_idx,
-                processed_nodes,
-                max_idx = gt_pck_special_occ_in_nonspecial_intervals(index) - 1;
+          processed_nodes;
   BwtSeqpositionextractor *pos_extractor;
-  const GtEncseq *encseq = unit_info->encseq;
-
-  gt_assert(max_idx < total_length);
+  ShuTraverseinfo tinfo;
+
+  tinfo.index = index;
+  tinfo.unit_info = unit_info;
+  tinfo.numofchars = numofchars;
+  tinfo.total_length = total_length;
+  tinfo.max_idx = gt_pck_special_occ_in_nonspecial_intervals(index) - 1;
+  gt_assert(tinfo.max_idx < total_length);
   rangeOccs = gt_calloc((size_t) GT_MULT2(numofchars), sizeof (*rangeOccs));
   tmpmbtab = gt_calloc((size_t) (numofchars + 3), sizeof (*tmpmbtab ));
   GT_STACK_INIT_WITH_INITFUNC(&stack, resize, initialise_node);
@@ -424,70 +790,42 @@ int gt_pck_calculate_shulen(const FMindex *index,
   {
     gt_timer_show_progress(timer, "obtain special pos", stdout);
   }
-  special_char_rows_and_pos = get_special_pos(index,
-                                              pos_extractor,
-                                              max_idx + 1);
-  GT_STACK_NEXT_FREE(&stack,root);
-  gt_array2dim_calloc(root->countTermSubtree,
-                      numofchars+1UL,
-                      unit_info->num_of_genomes);
-  root->process = false;
-  root->parentOffset = 0;
-  root->depth = 0;
-  root->lower = 0;
-  root->upper = total_length + 1;
+  tinfo.special_pos = get_special_pos(index,
+                                      pos_extractor,
+                                      tinfo.max_idx + 1);
+  (void) shu_push_node(&stack, 0, total_length + 1, 0, numofchars,
+                       unit_info->num_of_genomes);
 
   if (timer != NULL)
   {
     gt_timer_show_progress(timer, "traverse virtual tree", stdout);
   }
   processed_nodes = 0;
-  while (!had_err && !GT_STACK_ISEMPTY(&stack))
+  /* without a memory mapped index, the threads would share its file
+     pointer */
+  if (gt_jobs > 1U && gt_threadviewvoidBWTSeq_supported(index))
   {
-    ShuNode *current;
-
-    gt_assert(stack.nextfree > 0);
-    current = stack.space + stack.nextfree -1;
-    if (current->process)
-    {
-      GT_STACK_DECREMENTTOP(&stack);
-        had_err = process_shu_node(current,
-                                   &stack,
-                                   shulen,
-                                   unit_info->num_of_genomes,
-                                   numofchars,
-                                   logger,
-                                   err);
-      processed_nodes++;
-    }
-    else
+    had_err = shu_traverse_parallel(&tinfo, &stack, shulen, tmpmbtab,
+                                    rangeOccs, pos_extractor,
+                                    &processed_nodes, logger, err);
+  }
+  else
+  {
+    if (gt_jobs > 1U)
     {
-      had_err = visit_shu_children(index,
-                                   current,
-                                   &stack,
-                                   encseq,
-                                   tmpmbtab,
-                                   pos_extractor,
-                                   rangeOccs,
-                                   special_char_rows_and_pos,
-                                   numofchars,
-                                   unit_info,
-                                   total_length,
-                                   max_idx,
-                                   logger,
-                                   err);
+      gt_logger_log(logger, "index is not memory mapped, traverse "
+                    "sequentially");
     }
+    had_err = shu_traverse(&tinfo, &stack, shulen, tmpmbtab, rangeOccs,
+                           pos_extractor, SHU_TRAVERSE_ALL, 0, NULL,
+                           &processed_nodes, logger, err);
   }
   gt_logger_log(logger, "max stack depth = "GT_WU"", GT_STACK_MAXSIZE(&stack));
   gt_log_log("processed nodes= "GT_WU"", processed_nodes);
-  for (depth_idx = 0; depth_idx < GT_STACK_MAXSIZE(&stack); depth_idx++)
-  {
-    gt_array2dim_delete(stack.space[depth_idx].countTermSubtree);
-  }
-  GT_STACK_DELETE(&stack);
+  shu_free_stack(&stack);
   gt_free(rangeOccs);
   gt_free(tmpmbtab);
   gt_freeBwtSeqpositionextractor(pos_extractor);
-  gt_array2dim_delete(special_char_rows_and_pos);
+  gt_array2dim_delete(tinfo.special_pos);
   return had_err;
 }
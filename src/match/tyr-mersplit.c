@@ -20,6 +20,7 @@
 #include "core/defined-types.h"
 #include "core/divmodmul.h"
 #include "core/fa.h"
+#include "core/fileutils_api.h"
 #include "core/intbits.h"
 #include "core/mathsupport.h"
 #include "core/minmax.h"
@@ -397,6 +398,11 @@ int gt_constructmerbuckets(const char *inputindex,
   return haserr ? -1 : 0;
 }
 
+bool gt_tyrbckinfo_exists(const char *tyrindexname)
+{
+  return gt_file_exists_with_suffix(tyrindexname,BUCKETSUFFIX);
+}
+
 Tyrbckinfo *gt_tyrbckinfo_new(const char *tyrindexname,unsigned int alphasize,
                               GtError *err)
 {
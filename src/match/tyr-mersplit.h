@@ -29,6 +29,8 @@ int gt_constructmerbuckets(const char *inputindex,
                            const Definedunsignedint *callprefixlength,
                            GtError *err);
 
+bool gt_tyrbckinfo_exists(const char *tyrindexname);
+
 Tyrbckinfo *gt_tyrbckinfo_new(const char *tyrindexname,unsigned int alphasize,
                               GtError *err);
 
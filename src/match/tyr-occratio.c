@@ -19,7 +19,11 @@
 #include "core/unused_api.h"
 #include "core/logger.h"
 #include "core/ma_api.h"
+#include "core/minmax.h"
+#include "core/multithread_api.h"
+#include "core/thread_api.h"
 #include "esa-seqread.h"
+#include "sarr-def.h"
 #include "tyr-occratio.h"
 
 typedef struct /* information stored for each node of the lcp interval tree */
@@ -234,6 +238,228 @@ static int computeoccurrenceratio(Sequentialsuffixarrayreader *ssar,
   return haserr ? -1 : 0;
 }
 
+/* The parallel computation splits the suffix array into chunks whose
+   boundaries are positions with an lcp value smaller than the minimum mer
+   size. Each lcp-interval of depth at least minmersize lies completely
+   inside one chunk, and intervals of smaller depth do not contribute to any
+   distribution. Hence the chunks can be processed independently, each by a
+   bottom-up traversal of its lcp-intervals into thread local
+   distributions, which are summed up at the end. */
+
+#define OCC_CHUNKSPERTHREAD 64UL
+
+typedef struct
+{
+  GtUword depth,
+          lb;
+} OccLcpitv;
+
+GT_DECLAREARRAYSTRUCT(OccLcpitv);
+
+typedef struct
+{
+  const Suffixarray *suffixarray;
+  GtUword totallength,
+          nonspecials,
+          minmersize,
+          maxmersize,
+          chunksize,
+          numofchunks,
+          nextchunk;
+  GtMutex *mutex;
+  GtArrayuint64_t *uniquedistribution,
+                  *nonuniquedistribution,
+                  *nonuniquemultidistribution;
+} OccParallelinfo;
+
+static void occ_addcompletenode(OccDfsstate *state,
+                                GtUword depth,
+                                GtUword fatherdepth,
+                                GtUword occcount)
+{
+  GtUword lenval, startlength, endlength;
+
+  startlength = MAX(fatherdepth + 1, state->minmersize);
+  endlength = MIN(depth, state->maxmersize);
+  for (lenval = startlength; lenval <= endlength; lenval++)
+  {
+    adddistributionuint64_t(state->nonuniquemultidistribution,lenval,
+                            occcount);
+    adddistributionuint64_t(state->nonuniquedistribution,lenval,1UL);
+  }
+}
+
+/* the lcp value of the suffixes at position <pos>-1 and <pos> of the
+   suffix array, where the position after the last non-special suffix
+   counts as a boundary */
+static GtUword occ_lcpvalue(const OccParallelinfo *info,GtUword pos)
+{
+  if (pos == 0 || pos >= info->nonspecials)
+  {
+    return 0;
+  }
+  return lcptable_get(info->suffixarray,pos);
+}
+
+static GtUword occ_nextboundary(const OccParallelinfo *info,GtUword pos)
+{
+  while (pos < info->nonspecials &&
+         occ_lcpvalue(info,pos) >= info->minmersize)
+  {
+    pos++;
+  }
+  return pos;
+}
+
+static void occ_processchunk(OccDfsstate *state,
+                             GtArrayOccLcpitv *stack,
+                             const OccParallelinfo *info,
+                             GtUword firstpos,
+                             GtUword lastpos)
+{
+  GtUword pos, previouslcp = occ_lcpvalue(info,firstpos);
+
+  stack->nextfreeOccLcpitv = 0;
+  for (pos = firstpos; pos <= lastpos; pos++)
+  {
+    GtUword lcpvalue = occ_lcpvalue(info,pos+1),
+            lb = pos;
+
+    iteritvdistribution(state->uniquedistribution,
+                        state->encseq,
+                        state->readmode,
+                        state->totallength,
+                        state->minmersize,
+                        state->maxmersize,
+                        MAX(previouslcp,lcpvalue) + 1,
+                        ESASUFFIXPTRGET(info->suffixarray->suftab,pos));
+    while (stack->nextfreeOccLcpitv > 0 &&
+           (lcpvalue < info->minmersize ||
+            lcpvalue < stack->spaceOccLcpitv[stack->nextfreeOccLcpitv-1]
+                                            .depth))
+    {
+      OccLcpitv *top = stack->spaceOccLcpitv + stack->nextfreeOccLcpitv - 1;
+      /* the interval at the bottom of the stack starts at a chunk
+         boundary, so its father is the larger of the two boundaries */
+      GtUword fatherdepth
+        = MAX(lcpvalue,stack->nextfreeOccLcpitv > 1
+                         ? (top-1)->depth
+                         : occ_lcpvalue(info,top->lb));
+
+      occ_addcompletenode(state,top->depth,fatherdepth,pos - top->lb + 1);
+      lb = top->lb;
+      stack->nextfreeOccLcpitv--;
+    }
+    if (lcpvalue >= info->minmersize &&
+        (stack->nextfreeOccLcpitv == 0 ||
+         lcpvalue > stack->spaceOccLcpitv[stack->nextfreeOccLcpitv-1].depth))
+    {
+      OccLcpitv *itv;
+
+      GT_GETNEXTFREEINARRAY(itv,stack,OccLcpitv,32);
+      itv->depth = lcpvalue;
+      itv->lb = lb;
+    }
+    previouslcp = lcpvalue;
+  }
+  gt_assert(stack->nextfreeOccLcpitv == 0);
+}
+
+static void *occ_parallelthread(void *data)
+{
+  OccParallelinfo *info = data;
+  OccDfsstate state;
+  GtArrayuint64_t distributions[3];
+  GtArrayOccLcpitv stack;
+  int idx;
+
+  for (idx = 0; idx < 3; idx++)
+  {
+    GT_INITARRAY(distributions + idx,uint64_t);
+  }
+  GT_INITARRAY(&stack,OccLcpitv);
+  state.encseq = info->suffixarray->encseq;
+  state.readmode = info->suffixarray->readmode;
+  state.totallength = info->totallength;
+  state.minmersize = info->minmersize;
+  state.maxmersize = info->maxmersize;
+  state.uniquedistribution = distributions;
+  state.nonuniquedistribution = distributions + 1;
+  state.nonuniquemultidistribution = distributions + 2;
+  while (true)
+  {
+    GtUword chunk, firstpos, endpos;
+
+    gt_mutex_lock(info->mutex);
+    chunk = info->nextchunk++;
+    gt_mutex_unlock(info->mutex);
+    if (chunk >= info->numofchunks)
+    {
+      break;
+    }
+    firstpos = occ_nextboundary(info,chunk * info->chunksize);
+    endpos = occ_nextboundary(info,MIN((chunk + 1) * info->chunksize,
+                                       info->nonspecials));
+    if (firstpos < endpos)
+    {
+      occ_processchunk(&state,&stack,info,firstpos,endpos - 1);
+    }
+  }
+  gt_mutex_lock(info->mutex);
+  for (idx = 0; idx < 3; idx++)
+  {
+    GtArrayuint64_t *dest = idx == 0 ? info->uniquedistribution
+                                     : (idx == 1
+                                        ? info->nonuniquedistribution
+                                        : info->nonuniquemultidistribution);
+    GtUword countocc;
+
+    for (countocc = 0; countocc < distributions[idx].nextfreeuint64_t;
+         countocc++)
+    {
+      if (distributions[idx].spaceuint64_t[countocc] > 0)
+      {
+        adddistributionuint64_t(dest,countocc,
+                                distributions[idx].spaceuint64_t[countocc]);
+      }
+    }
+    GT_FREEARRAY(distributions + idx,uint64_t);
+  }
+  gt_mutex_unlock(info->mutex);
+  GT_FREEARRAY(&stack,OccLcpitv);
+  return NULL;
+}
+
+static int computeoccurrenceratio_parallel(
+                                  const Sequentialsuffixarrayreader *ssar,
+                                  GtUword minmersize,
+                                  GtUword maxmersize,
+                                  GtArrayuint64_t *uniquedistribution,
+                                  GtArrayuint64_t *nonuniquedistribution,
+                                  GtArrayuint64_t *nonuniquemultidistribution,
+                                  GtError *err)
+{
+  OccParallelinfo info;
+  int had_err;
+
+  gt_error_check(err);
+  info.suffixarray = gt_suffixarraySequentialsuffixarrayreader(ssar);
+  info.totallength = gt_encseq_total_length(info.suffixarray->encseq);
+  info.nonspecials = gt_Sequentialsuffixarrayreader_nonspecials(ssar);
+  info.minmersize = minmersize;
+  info.maxmersize = maxmersize;
+  info.numofchunks = (GtUword) gt_jobs * OCC_CHUNKSPERTHREAD;
+  info.chunksize = info.nonspecials / info.numofchunks + 1;
+  info.nextchunk = 0;
+  info.uniquedistribution = uniquedistribution;
+  info.nonuniquedistribution = nonuniquedistribution;
+  info.nonuniquemultidistribution = nonuniquemultidistribution;
+  info.mutex = gt_mutex_new();
+  had_err = gt_multithread(occ_parallelthread,&info,err);
+  gt_mutex_delete(info.mutex);
+  return had_err;
+}
+
 int gt_tyr_occratio_func(const char *inputindex,
                          bool scanfile,
                          GtUword minmersize,
@@ -261,16 +487,33 @@ int gt_tyr_occratio_func(const char *inputindex,
   }
   if (!haserr)
   {
-    if (computeoccurrenceratio(ssar,
-                               minmersize,
-                               maxmersize,
-                               uniquedistribution,
-                               nonuniquedistribution,
-                               nonuniquemultidistribution,
-                               logger,
-                               err) != 0)
+    /* a mapped index allows random access and thus a parallel traversal,
+       a scanned index is traversed sequentially */
+    if (scanfile)
     {
-      haserr = true;
+      if (computeoccurrenceratio(ssar,
+                                 minmersize,
+                                 maxmersize,
+                                 uniquedistribution,
+                                 nonuniquedistribution,
+                                 nonuniquemultidistribution,
+                                 logger,
+                                 err) != 0)
+      {
+        haserr = true;
+      }
+    } else
+    {
+      if (computeoccurrenceratio_parallel(ssar,
+                                          minmersize,
+                                          maxmersize,
+                                          uniquedistribution,
+                                          nonuniquedistribution,
+                                          nonuniquemultidistribution,
+                                          err) != 0)
+      {
+        haserr = true;
+      }
     }
   }
   if (ssar != NULL)
@@ -15,9 +15,13 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <string.h>
 #include "core/alphabet.h"
 #include "core/fa.h"
+#include "core/multithread_api.h"
+#include "core/thread_api.h"
 #include "core/unused_api.h"
+#include "core/xansi_api.h"
 #include "core/seq_iterator_sequence_buffer_api.h"
 #include "core/chardef.h"
 #include "core/format64.h"
@@ -70,7 +74,7 @@ static void gt_tyrsearchinfo_delete(Tyrsearchinfo *tyrsearchinfo)
   }
 }
 
-/*@null@*/ const GtUchar *gt_searchsinglemer(const GtUchar *qptr,
+/*@null@*/ static const GtUchar *gt_searchsinglemer(const GtUchar *qptr,
                                         const Tyrindex *tyrindex,
                                         const Tyrsearchinfo *tyrsearchinfo,
                                         const Tyrbckinfo *tyrbckinfo)
@@ -97,10 +101,11 @@ static void gt_tyrsearchinfo_delete(Tyrsearchinfo *tyrsearchinfo)
           firstitem = false;\
         } else\
         {\
-          (void) putchar('\t');\
+          gt_str_append_char(outbuf,'\t');\
         }
 
-static void mermatchoutput(const Tyrindex *tyrindex,
+static void mermatchoutput(GtStr *outbuf,
+                           const Tyrindex *tyrindex,
                            const Tyrcountinfo *tyrcountinfo,
                            const Tyrsearchinfo *tyrsearchinfo,
                            const GtUchar *result,
@@ -115,42 +120,51 @@ static void mermatchoutput(const Tyrindex *tyrindex,
   queryposition = (GtUword) (qptr-query);
   if (tyrsearchinfo->showmode & SHOWQSEQNUM)
   {
-    printf(Formatuint64_t,PRINTuint64_tcast(unitnum));
+    char buf[32];
+
+    (void) snprintf(buf,sizeof (buf),Formatuint64_t,
+                    PRINTuint64_tcast(unitnum));
+    gt_str_append_cstr(outbuf,buf);
     firstitem = false;
   }
   if (tyrsearchinfo->showmode & SHOWQPOS)
   {
     ADDTABULATOR;
-    printf("%c"GT_WU"",forward ? '+' : '-',queryposition);
+    gt_str_append_char(outbuf,forward ? '+' : '-');
+    gt_str_append_ulong(outbuf,queryposition);
   }
   if (tyrsearchinfo->showmode & SHOWCOUNTS)
   {
     GtUword mernumber = gt_tyrindex_ptr2number(tyrindex,result);
     ADDTABULATOR;
-    printf(""GT_WU"",gt_tyrcountinfo_get(tyrcountinfo,mernumber));
+    gt_str_append_ulong(outbuf,gt_tyrcountinfo_get(tyrcountinfo,mernumber));
   }
   if (tyrsearchinfo->showmode & SHOWSEQUENCE)
   {
+    const GtUchar *characters
+      = gt_alphabet_characters(tyrsearchinfo->dnaalpha);
+    GtUword idx;
+
     ADDTABULATOR;
-    gt_alphabet_decode_seq_to_fp(tyrsearchinfo->dnaalpha,
-                                 stdout,
-                                 qptr,
-                                 tyrsearchinfo->mersize);
+    for (idx = 0; idx < tyrsearchinfo->mersize; idx++)
+    {
+      gt_str_append_char(outbuf,(char) characters[qptr[idx]]);
+    }
   }
   if (tyrsearchinfo->showmode & (SHOWSEQUENCE | SHOWQPOS | SHOWCOUNTS))
   {
-    (void) putchar('\n');
+    gt_str_append_char(outbuf,'\n');
   }
 }
 
-static void singleseqtyrsearch(const Tyrindex *tyrindex,
+static void singleseqtyrsearch(GtStr *outbuf,
+                               const Tyrindex *tyrindex,
                                const Tyrcountinfo *tyrcountinfo,
                                const Tyrsearchinfo *tyrsearchinfo,
                                const Tyrbckinfo *tyrbckinfo,
                                uint64_t unitnum,
                                const GtUchar *query,
-                               GtUword querylen,
-                               GT_UNUSED const char *desc)
+                               GtUword querylen)
 {
   const GtUchar *qptr, *result;
   GtUword offset, skipvalue;
@@ -172,7 +186,8 @@ static void singleseqtyrsearch(const Tyrindex *tyrindex,
         result = gt_searchsinglemer(qptr,tyrindex,tyrsearchinfo,tyrbckinfo);
         if (result != NULL)
         {
-          mermatchoutput(tyrindex,
+          mermatchoutput(outbuf,
+                         tyrindex,
                          tyrcountinfo,
                          tyrsearchinfo,
                          result,
@@ -191,7 +206,8 @@ static void singleseqtyrsearch(const Tyrindex *tyrindex,
                                     tyrsearchinfo,tyrbckinfo);
         if (result != NULL)
         {
-          mermatchoutput(tyrindex,
+          mermatchoutput(outbuf,
+                         tyrindex,
                          tyrcountinfo,
                          tyrsearchinfo,
                          result,
@@ -210,6 +226,116 @@ static void singleseqtyrsearch(const Tyrindex *tyrindex,
   }
 }
 
+/* The query sequences are read in batches of at most this many sequences
+   or characters. The sequences of a batch are searched in parallel, each
+   writing to its own output buffer, and the buffers are shown in the order
+   of the sequences. */
+#define TYRSEARCH_BATCHSEQUENCES  4096UL
+#define TYRSEARCH_BATCHCHARACTERS (1UL << 22)
+
+typedef struct
+{
+  const Tyrindex *tyrindex;
+  const Tyrcountinfo *tyrcountinfo;
+  const Tyrbckinfo *tyrbckinfo;
+  unsigned int showmode,
+               searchstrand;
+  GtUchar *sequences;
+  GtUword *seqstartpos, /* numofsequences + 1 entries */
+          numofsequences,
+          allocatedsequences,
+          allocatedcharacters,
+          nextsequence;
+  uint64_t firstunitnum;
+  GtStr **outbufs;
+  GtMutex *mutex;
+} Tyrsearchbatch;
+
+static void tyrsearchbatch_add(Tyrsearchbatch *batch,
+                               const GtUchar *query,
+                               GtUword querylen)
+{
+  GtUword startpos = batch->seqstartpos[batch->numofsequences];
+
+  if (startpos + querylen > batch->allocatedcharacters)
+  {
+    batch->allocatedcharacters = startpos + querylen;
+    batch->sequences = gt_realloc(batch->sequences,
+                                  sizeof *batch->sequences
+                                  * batch->allocatedcharacters);
+  }
+  if (batch->numofsequences == batch->allocatedsequences)
+  {
+    GtUword idx;
+
+    batch->allocatedsequences += TYRSEARCH_BATCHSEQUENCES;
+    batch->seqstartpos = gt_realloc(batch->seqstartpos,
+                                    sizeof *batch->seqstartpos
+                                    * (batch->allocatedsequences + 1));
+    batch->outbufs = gt_realloc(batch->outbufs,
+                                sizeof *batch->outbufs
+                                * batch->allocatedsequences);
+    for (idx = batch->numofsequences; idx < batch->allocatedsequences; idx++)
+    {
+      batch->outbufs[idx] = gt_str_new();
+    }
+  }
+  memcpy(batch->sequences + startpos,query,sizeof *query * querylen);
+  batch->seqstartpos[++batch->numofsequences] = startpos + querylen;
+}
+
+static void *tyrsearchbatch_thread(void *data)
+{
+  Tyrsearchbatch *batch = data;
+  Tyrsearchinfo tyrsearchinfo;
+
+  gt_tyrsearchinfo_init(&tyrsearchinfo,batch->tyrindex,batch->showmode,
+                        batch->searchstrand);
+  while (true)
+  {
+    GtUword seqnum;
+
+    gt_mutex_lock(batch->mutex);
+    seqnum = batch->nextsequence++;
+    gt_mutex_unlock(batch->mutex);
+    if (seqnum >= batch->numofsequences)
+    {
+      break;
+    }
+    singleseqtyrsearch(batch->outbufs[seqnum],
+                       batch->tyrindex,
+                       batch->tyrcountinfo,
+                       &tyrsearchinfo,
+                       batch->tyrbckinfo,
+                       batch->firstunitnum + seqnum,
+                       batch->sequences + batch->seqstartpos[seqnum],
+                       batch->seqstartpos[seqnum+1] -
+                       batch->seqstartpos[seqnum]);
+  }
+  gt_tyrsearchinfo_delete(&tyrsearchinfo);
+  return NULL;
+}
+
+static int tyrsearchbatch_process(Tyrsearchbatch *batch,GtError *err)
+{
+  GtUword idx;
+
+  batch->nextsequence = 0;
+  if (gt_multithread(tyrsearchbatch_thread,batch,err) != 0)
+  {
+    return -1;
+  }
+  for (idx = 0; idx < batch->numofsequences; idx++)
+  {
+    gt_xfwrite(gt_str_get(batch->outbufs[idx]),sizeof (char),
+               (size_t) gt_str_length(batch->outbufs[idx]),stdout);
+    gt_str_reset(batch->outbufs[idx]);
+  }
+  batch->firstunitnum += batch->numofsequences;
+  batch->numofsequences = 0;
+  return 0;
+}
+
 int gt_tyrsearch(const char *tyrindexname,
                  const GtStrArray *queryfilenames,
                  unsigned int showmode,
@@ -254,7 +380,9 @@ int gt_tyrsearch(const char *tyrindexname,
   if (!haserr)
   {
     gt_assert(tyrindex != NULL);
-    if (!gt_tyrindex_isempty(tyrindex))
+    /* without bucket boundaries (option -pl of mkindex), binary search
+       over the whole mer table */
+    if (!gt_tyrindex_isempty(tyrindex) && gt_tyrbckinfo_exists(tyrindexname))
     {
       tyrbckinfo = gt_tyrbckinfo_new(tyrindexname,
                                      gt_tyrindex_alphasize(tyrindex),
@@ -270,21 +398,33 @@ int gt_tyrsearch(const char *tyrindexname,
     const GtUchar *query;
     GtUword querylen;
     char *desc = NULL;
-    uint64_t unitnum;
     int retval;
-    Tyrsearchinfo tyrsearchinfo;
+    GtAlphabet *dnaalpha;
     GtSeqIterator *seqit;
+    Tyrsearchbatch batch;
 
     gt_assert(tyrindex != NULL);
-    gt_tyrsearchinfo_init(&tyrsearchinfo,tyrindex,showmode,searchstrand);
+    batch.tyrindex = tyrindex;
+    batch.tyrcountinfo = tyrcountinfo;
+    batch.tyrbckinfo = tyrbckinfo;
+    batch.showmode = showmode;
+    batch.searchstrand = searchstrand;
+    batch.sequences = NULL;
+    batch.seqstartpos = gt_malloc(sizeof *batch.seqstartpos);
+    batch.seqstartpos[0] = 0;
+    batch.outbufs = NULL;
+    batch.numofsequences = batch.allocatedsequences = 0;
+    batch.allocatedcharacters = 0;
+    batch.firstunitnum = 0;
+    batch.mutex = gt_mutex_new();
+    dnaalpha = gt_alphabet_new_dna();
     seqit = gt_seq_iterator_sequence_buffer_new(queryfilenames, err);
     if (!seqit)
       haserr = true;
     if (!haserr)
     {
-      gt_seq_iterator_set_symbolmap(seqit,
-                                 gt_alphabet_symbolmap(tyrsearchinfo.dnaalpha));
-      for (unitnum = 0; /* Nothing */; unitnum++)
+      gt_seq_iterator_set_symbolmap(seqit,gt_alphabet_symbolmap(dnaalpha));
+      while (true)
       {
         retval = gt_seq_iterator_next(seqit,
                                      &query,
@@ -300,18 +440,37 @@ int gt_tyrsearch(const char *tyrindexname,
         {
           break;
         }
-        singleseqtyrsearch(tyrindex,
-                           tyrcountinfo,
-                           &tyrsearchinfo,
-                           tyrbckinfo,
-                           unitnum,
-                           query,
-                           querylen,
-                           desc);
+        tyrsearchbatch_add(&batch,query,querylen);
+        if ((batch.numofsequences == TYRSEARCH_BATCHSEQUENCES ||
+             batch.seqstartpos[batch.numofsequences] >=
+             TYRSEARCH_BATCHCHARACTERS) &&
+            tyrsearchbatch_process(&batch,err) != 0)
+        {
+          haserr = true;
+          break;
+        }
+      }
+      if (!haserr && batch.numofsequences > 0 &&
+          tyrsearchbatch_process(&batch,err) != 0)
+      {
+        haserr = true;
       }
       gt_seq_iterator_delete(seqit);
     }
-    gt_tyrsearchinfo_delete(&tyrsearchinfo);
+    if (batch.outbufs != NULL)
+    {
+      GtUword idx;
+
+      for (idx = 0; idx < batch.allocatedsequences; idx++)
+      {
+        gt_str_delete(batch.outbufs[idx]);
+      }
+      gt_free(batch.outbufs);
+    }
+    gt_free(batch.sequences);
+    gt_free(batch.seqstartpos);
+    gt_mutex_delete(batch.mutex);
+    gt_alphabet_delete(dnaalpha);
   }
   if (tyrbckinfo != NULL)
   {
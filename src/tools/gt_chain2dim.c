@@ -19,6 +19,7 @@
 #include "core/ma.h"
 #include "core/unused_api.h"
 #include "core/tool_api.h"
+#include "match/esa-maxpairs.h"
 #include "gt_chain2dim.h"
 
 static void *gt_chain2dim_arguments_new (void)
@@ -35,6 +36,7 @@ static void gt_chain2dim_arguments_delete (void *tool_arguments)
     return;
   }
   gt_str_delete (arguments->matchfile);
+  gt_str_delete (arguments->indexname);
   gt_str_array_delete (arguments->globalargs);
   gt_str_array_delete (arguments->localargs);
   gt_option_delete (arguments->refoptionmaxgap);
@@ -48,22 +50,38 @@ static GtOptionParser *gt_chain2dim_option_parser_new (void *tool_arguments)
 {
   GtChain2dimoptions *arguments = tool_arguments;
   GtOptionParser *op;
-  GtOption *option, *optionglobal, *optionlocal;
+  GtOption *option, *optionglobal, *optionlocal, *optionmatchfile, *optionii;
 
   gt_assert (arguments != NULL);
   arguments->matchfile = gt_str_new ();
+  arguments->indexname = gt_str_new ();
   arguments->globalargs = gt_str_array_new();
   arguments->localargs = gt_str_array_new();
 
-  op = gt_option_parser_new("[options] -m matchfile",
+  op = gt_option_parser_new("[options] -m matchfile | -ii indexname",
                             "Chain pairwise matches.");
 
   gt_option_parser_set_mail_address(op, "<kurtz@zbh.uni-hamburg.de>");
-  option = gt_option_new_filename("m","Specify file containing the matches\n"
-                                  "mandatory option",
+  optionmatchfile = gt_option_new_filename("m",
+                                  "Specify file containing the matches",
                                   arguments->matchfile);
+  gt_option_parser_add_option(op, optionmatchfile);
+
+  optionii = gt_option_new_string("ii",
+                                  "Specify index from which the maximal "
+                                  "forward repeats\nto be chained are "
+                                  "computed, as by gt repfind",
+                                  arguments->indexname, NULL);
+  gt_option_parser_add_option(op, optionii);
+  gt_option_exclude(optionmatchfile, optionii);
+  gt_option_is_mandatory_either(optionmatchfile, optionii);
+
+  option = gt_option_new_uint_min("l","Specify minimum length of repeats "
+                                  "computed from the index",
+                                  &arguments->userdefinedleastlength,
+                                  20U,1U);
   gt_option_parser_add_option(op, option);
-  gt_option_is_mandatory(option);
+  gt_option_imply(option, optionii);
 
   optionglobal = gt_option_new_string_array("global",
                    "perform global chaining\n"
@@ -109,6 +127,11 @@ static GtOptionParser *gt_chain2dim_option_parser_new (void *tool_arguments)
                                          &arguments->maxgap,0);
   arguments->refoptionmaxgap = gt_option_ref(option);
   gt_option_parser_add_option(op, option);
+  option = gt_option_new_bool("sparse","use range maximum tree instead of "
+                                       "dictionary to compute the chains\n"
+                                       "(faster for large sets of matches)",
+                                       &arguments->sparse,false);
+  gt_option_parser_add_option(op, option);
   option = gt_option_new_bool("silent","do not output the chains but only "
                                        "report their lengths and scores",
                                        &arguments->silent,false);
@@ -188,7 +211,12 @@ static int gt_chain2dim_arguments_check (GT_UNUSED int rest_argc,
                              gt_option_is_set(arguments->refoptionlocal),
                              localargs,
                              err);
-  return (arguments->gtchainmode == NULL) ? -1 : 0;
+  if (arguments->gtchainmode == NULL)
+  {
+    return -1;
+  }
+  gt_chain_chainmode_set_sparse(arguments->gtchainmode, arguments->sparse);
+  return 0;
 }
 
 typedef struct
@@ -245,6 +273,65 @@ void gt_outputformatchain(void *data,
   gt_outputformatchaingeneric(false,data,matchtable,chain);
 }
 
+typedef struct
+{
+  double weightfactor;
+  GtChain2Dimmatchtable *matchtable;
+} GtChain2dimmaxpairsinfo;
+
+/* add a maximal repeat to the table of matches, so that the repeats
+   need not be output and parsed again */
+
+static int gt_chain2dim_addmaxpair(void *info,
+                                   GT_UNUSED const GtGenericEncseq *encseq,
+                                   GtUword len,
+                                   GtUword pos1,
+                                   GtUword pos2,
+                                   GT_UNUSED GtError *err)
+{
+  GtChain2dimmaxpairsinfo *maxpairsinfo = (GtChain2dimmaxpairsinfo *) info;
+  GtChain2Dimmatchvalues fragment;
+
+  if (pos1 > pos2)
+  {
+    GtUword tmp = pos1;
+    pos1 = pos2;
+    pos2 = tmp;
+  }
+  fragment.startpos[0] = (GtChain2Dimpostype) pos1;
+  fragment.endpos[0] = (GtChain2Dimpostype) (pos1 + len - 1);
+  fragment.startpos[1] = (GtChain2Dimpostype) pos2;
+  fragment.endpos[1] = (GtChain2Dimpostype) (pos2 + len - 1);
+  fragment.weight
+    = (GtChain2Dimscoretype) (maxpairsinfo->weightfactor * (double) len);
+  gt_chain_matchtable_add(maxpairsinfo->matchtable,&fragment);
+  return 0;
+}
+
+static GtChain2Dimmatchtable *gt_chain2dim_maxpairs(
+                                        const GtChain2dimoptions *arguments,
+                                        GtLogger *logger,
+                                        GtError *err)
+{
+  GtChain2dimmaxpairsinfo maxpairsinfo;
+
+  maxpairsinfo.weightfactor = arguments->weightfactor;
+  maxpairsinfo.matchtable = gt_chain_matchtable_new(0);
+  if (gt_callenummaxpairs(gt_str_get(arguments->indexname),
+                          arguments->userdefinedleastlength,
+                          false,
+                          gt_chain2dim_addmaxpair,
+                          &maxpairsinfo,
+                          logger,
+                          err) != 0)
+  {
+    gt_chain_matchtable_delete(maxpairsinfo.matchtable);
+    return NULL;
+  }
+  gt_chain_fillthegapvalues(maxpairsinfo.matchtable);
+  return maxpairsinfo.matchtable;
+}
+
 static int gt_chain2dim_runner (GT_UNUSED int argc,
                                 GT_UNUSED const char **argv,
                                 GT_UNUSED int parsed_args,
@@ -260,10 +347,17 @@ static int gt_chain2dim_runner (GT_UNUSED int argc,
   gt_assert (arguments != NULL);
   gt_assert (parsed_args == argc);
 
-  matchtable = gt_chain_analyzeopenformatfile(arguments->weightfactor,
-                                              gt_str_get(arguments->
-                                                         matchfile),
-                                              err);
+  logger = gt_logger_new(arguments->verbose, GT_LOGGER_DEFLT_PREFIX, stdout);
+  if (gt_str_length(arguments->indexname) > 0)
+  {
+    matchtable = gt_chain2dim_maxpairs(arguments,logger,err);
+  } else
+  {
+    matchtable = gt_chain_analyzeopenformatfile(arguments->weightfactor,
+                                                gt_str_get(arguments->
+                                                           matchfile),
+                                                err);
+  }
   if (matchtable == NULL)
   {
     haserr = true;
@@ -274,7 +368,6 @@ static int gt_chain2dim_runner (GT_UNUSED int argc,
     GtChain2Dim *chain;
     Counter counter;
 
-    logger = gt_logger_new(arguments->verbose, GT_LOGGER_DEFLT_PREFIX, stdout);
     gt_chain_possiblysortmatches(logger, matchtable, presortdim);
     chain = gt_chain_chain_new();
     counter.chaincounter = 0;
@@ -292,10 +385,7 @@ static int gt_chain2dim_runner (GT_UNUSED int argc,
   }
   gt_chain_chainmode_delete(arguments->gtchainmode);
   gt_chain_matchtable_delete(matchtable);
-  if (logger != NULL)
-  {
-    gt_logger_delete(logger);
-  }
+  gt_logger_delete(logger);
   return haserr ? -1 : 0;
 }
 
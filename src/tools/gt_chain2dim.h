@@ -29,10 +29,13 @@
 typedef struct
 {
   bool silent,
-       verbose;
+       verbose,
+       sparse;
   double weightfactor;
   GtUword maxgap;
-  GtStr *matchfile;
+  unsigned int userdefinedleastlength;
+  GtStr *matchfile,
+        *indexname;
   GtStrArray *globalargs,
              *localargs;
   GtOption *refoptionmaxgap,
@@ -40,6 +40,7 @@
 #include "extended/match_blast_api.h"
 #include "extended/match_iterator_blast.h"
 #include "extended/n_r_encseq.h"
+#include "extended/n_r_encseq_search.h"
 #include "core/output_file_api.h"
 
 #include "tools/gt_condenser_search.h"
@@ -49,12 +50,17 @@ typedef struct {
   GtOutputFileInfo *ofi;
   GtStr            *dbpath,
                    *querypath;
-  GtUword bitscore;
+  GtUword bitscore,
+          batchlength;
+  GtWord  xdrop;
+  GtXdropArbitraryscores scores;
   double  ceval,
           feval;
   int     blthreads;
+  unsigned int kmersize;
   bool    blastp,
           blastn,
+          native,
           verbose;
 } GtCondenserSearchArguments;
 
@@ -86,13 +92,13 @@ static GtOptionParser* gt_condenser_search_option_parser_new
   GtCondenserSearchArguments *arguments = tool_arguments;
   GtOptionParser *op;
   GtOption *option, *score_opt, *ceval_opt, *feval_opt, *blastp_opt,
-           *blastn_opt;
+           *blastn_opt, *native_opt;
   gt_assert(arguments);
 
   /* init */
   op = gt_option_parser_new("[option ...]",
-                            "Perform a BLAST or "
-                            "HMMSEARCH on the given compressed database.");
+                            "Perform a BLAST or native seed-and-extend search "
+                            "on the given compressed database.");
 
   /* -blastn */
   blastn_opt = gt_option_new_bool("blastn", "perform blastn search",
@@ -100,9 +106,17 @@ static GtOptionParser* gt_condenser_search_option_parser_new
   /* -blastp */
   blastp_opt = gt_option_new_bool("blastp", "perform blastp search",
                                   &arguments->blastp, false);
+  /* -native */
+  native_opt = gt_option_new_bool("native", "perform seed-and-extend search "
+                                  "without calling BLAST, protein or DNA "
+                                  "depending on the database",
+                                  &arguments->native, false);
   gt_option_exclude(blastn_opt, blastp_opt);
+  gt_option_exclude(blastn_opt, native_opt);
+  gt_option_exclude(blastp_opt, native_opt);
   gt_option_parser_add_option(op, blastn_opt);
   gt_option_parser_add_option(op, blastp_opt);
+  gt_option_parser_add_option(op, native_opt);
 
   /* -score */
   score_opt = gt_option_new_uword("score", "bitscore threshold for BLAST(p) "
@@ -150,6 +164,55 @@ static GtOptionParser* gt_condenser_search_option_parser_new
   gt_option_is_development_option(option);
   gt_option_parser_add_option(op, option);
 
+  /* -kmersize */
+  option = gt_option_new_uint_min("kmersize", "length of exact seeds for "
+                                  "native search, defaults to 14 for DNA and "
+                                  "3 for protein",
+                                  &arguments->kmersize, GT_UNDEF_UINT, 2U);
+  gt_option_hide_default(option);
+  gt_option_imply(option, native_opt);
+  gt_option_parser_add_option(op, option);
+
+  /* -mat */
+  option = gt_option_new_int("mat", "matchscore for native extension, "
+                             "requirements: mat > 0 and mat even",
+                             &arguments->scores.mat, 2);
+  gt_option_imply(option, native_opt);
+  gt_option_parser_add_option(op, option);
+
+  /* -mis */
+  option = gt_option_new_int("mis", "mismatchscore for native extension",
+                             &arguments->scores.mis, -4);
+  gt_option_imply(option, native_opt);
+  gt_option_parser_add_option(op, option);
+
+  /* -ins */
+  option = gt_option_new_int("ins", "insertionscore for native extension",
+                             &arguments->scores.ins, -5);
+  gt_option_imply(option, native_opt);
+  gt_option_parser_add_option(op, option);
+
+  /* -del */
+  option = gt_option_new_int("del", "deletionscore for native extension",
+                             &arguments->scores.del, -5);
+  gt_option_imply(option, native_opt);
+  gt_option_parser_add_option(op, option);
+
+  /* -xdrop */
+  option = gt_option_new_word("xdrop", "xdrop score for native extension",
+                              &arguments->xdrop, (GtWord) 20);
+  gt_option_imply(option, native_opt);
+  gt_option_parser_add_option(op, option);
+
+  /* -batchlength */
+  option = gt_option_new_uword_min("batchlength", "minimal total length of "
+                                   "the queries searched at once by the native "
+                                   "search",
+                                   &arguments->batchlength, 1000000UL, 1UL);
+  gt_option_imply(option, native_opt);
+  gt_option_is_development_option(option);
+  gt_option_parser_add_option(op, option);
+
   gt_output_file_info_register_options(arguments->ofi, op, &arguments->outfp);
 
  return op;
@@ -161,9 +224,17 @@ static int gt_condenser_search_arguments_check(GT_UNUSED int rest_argc,
 {
   GtCondenserSearchArguments *arguments = tool_arguments;
   int had_err = 0;
-  if (!(arguments->blastn || arguments->blastp)) {
-    gt_error_set(err, "no other searches then blast implemented yet, please "
-                 "provide either -blastn or -blastp");
+  if (!(arguments->blastn || arguments->blastp || arguments->native)) {
+    gt_error_set(err, "please provide either -blastn, -blastp or -native");
+    had_err = -1;
+  }
+  if (!had_err && arguments->native &&
+      (arguments->scores.mat <= 0 || arguments->scores.mat % 2 != 0 ||
+       arguments->scores.mis >= arguments->scores.mat ||
+       arguments->scores.ins >= arguments->scores.mat / 2 ||
+       arguments->scores.del >= arguments->scores.mat / 2)) {
+    gt_error_set(err, "invalid scores, requirements: mat > 0, mat even, "
+                 "mat > mis, mat > 2ins, mat > 2del");
     had_err = -1;
   }
   gt_error_check(err);
@@ -247,10 +318,101 @@ static inline int gt_condenser_search_cum_moving_avg(GtUword current_len,
                                                      GT_UNUSED GtError *err)
 {
   GtCondenserSearchAvg *avg = (GtCondenserSearchAvg *) data;
-  avg->avg = avg->avg + (current_len - avg->avg) / ++avg->count;
+  GtWord diff = (GtWord) current_len - (GtWord) avg->avg;
+  avg->avg = (GtUword) ((GtWord) avg->avg + diff / (GtWord) ++avg->count);
   return 0;
 }
 
+static int gt_condenser_search_raw_evalue(
+                                    const GtCondenserSearchArguments *arguments,
+                                        GtLogger *logger,
+                                        double *raw_eval,
+                                        GtError *err)
+{
+  int had_err = 0;
+  if (arguments->ceval == GT_UNDEF_DOUBLE ||
+      arguments->feval == GT_UNDEF_DOUBLE) {
+    /* from NCBI BLAST tutorial:
+       E = Kmne^{-lambdaS}
+       calculates E-value for score S with natural scale parameters K for
+       search space size and lambda for the scoring system
+       E = mn2^-S'
+       m being the subject (total) length, n the length of ONE query
+       calculates E-value for bit-score S'
+     */
+    GtFastaReader *reader;
+    GtCondenserSearchAvg avg = {0,0};
+    reader = gt_fasta_reader_rec_new(arguments->querypath);
+    had_err = gt_fasta_reader_run(reader, NULL, NULL,
+                                  gt_condenser_search_cum_moving_avg,
+                                  &avg,
+                                  err);
+    if (!had_err) {
+      GtUword S = arguments->bitscore;
+      gt_log_log(GT_WU " queries, avg query size: " GT_WU,
+                 avg.count, avg.avg);
+      *raw_eval = 1/pow(2.0, (double) S) * avg.avg;
+      gt_logger_log(logger, "Raw E-value set to %.4e", *raw_eval);
+      gt_assert(avg.avg != 0);
+    }
+    gt_fasta_reader_delete(reader);
+  }
+  return had_err;
+}
+
+static int gt_condenser_search_native(GtCondenserSearchArguments *arguments,
+                                      GtLogger *logger,
+                                      GtError *err)
+{
+  int had_err = 0;
+  double raw_eval = 0.0;
+  GtNREncseq *nrencseq;
+  GtNREncseqSearch *nres = NULL;
+  GtTimer *timer = NULL;
+
+  if (gt_showtime_enabled()) {
+    timer = gt_timer_new_with_progress_description("initialization");
+    gt_timer_start(timer);
+  }
+  nrencseq = gt_n_r_encseq_new_from_file(gt_str_get(arguments->dbpath),
+                                         logger, err);
+  if (nrencseq == NULL)
+    had_err = -1;
+  if (!had_err)
+    had_err = gt_condenser_search_raw_evalue(arguments, logger, &raw_eval,
+                                             err);
+  if (!had_err) {
+    if (arguments->kmersize == GT_UNDEF_UINT) {
+      const GtEncseq *unique_es = gt_n_r_encseq_get_unique_encseq(nrencseq);
+      arguments->kmersize =
+        gt_alphabet_is_dna(gt_encseq_alphabet(unique_es)) ? 14U : 3U;
+    }
+    if (timer != NULL)
+      gt_timer_show_progress(timer, "load k-mer index", stderr);
+    nres = gt_n_r_encseq_search_new(nrencseq, gt_str_get(arguments->dbpath),
+                                    arguments->kmersize, &arguments->scores,
+                                    arguments->xdrop, logger, err);
+    if (nres == NULL)
+      had_err = -1;
+  }
+  if (!had_err) {
+    GtUword numofhits = 0;
+    had_err = gt_n_r_encseq_search_run(nres, gt_str_get(arguments->querypath),
+                                       arguments->ceval, arguments->feval,
+                                       raw_eval, arguments->batchlength,
+                                       arguments->outfp, timer,
+                                       &numofhits, err);
+    if (!had_err)
+      gt_log_log(GT_WU " hits found\n", numofhits);
+  }
+  if (!had_err && timer != NULL)
+    gt_timer_show_progress_final(timer, stderr);
+  gt_timer_delete(timer);
+  gt_n_r_encseq_search_delete(nres);
+  gt_n_r_encseq_delete(nrencseq);
+  return had_err;
+}
+
 static int gt_condenser_search_runner(GT_UNUSED int argc,
                                       GT_UNUSED const char **argv,
                                       GT_UNUSED int parsed_args,
@@ -317,35 +479,9 @@ static int gt_condenser_search_runner(GT_UNUSED int argc,
       if (nrencseq == NULL)
         had_err = -1;
     }
-    if (!had_err) {
-      if (arguments->ceval == GT_UNDEF_DOUBLE ||
-          arguments->feval == GT_UNDEF_DOUBLE) {
-        /* from NCBI BLAST tutorial:
-           E = Kmne^{-lambdaS}
-           calculates E-value for score S with natural scale parameters K for
-           search space size and lambda for the scoring system
-           E = mn2^-S'
-           m being the subject (total) length, n the length of ONE query
-           calculates E-value for bit-score S'
-         */
-        GtFastaReader *reader;
-        GtCondenserSearchAvg avg = {0,0};
-        reader = gt_fasta_reader_rec_new(arguments->querypath);
-        had_err = gt_fasta_reader_run(reader, NULL, NULL,
-                                      gt_condenser_search_cum_moving_avg,
-                                      &avg,
-                                      err);
-        if (!had_err) {
-          GtUword S = arguments->bitscore;
-          gt_log_log(GT_WU " queries, avg query size: " GT_WU,
-                     avg.count, avg.avg);
-          raw_eval = 1/pow(2.0, (double) S) * avg.avg;
-          gt_logger_log(logger, "Raw E-value set to %.4e", raw_eval);
-          gt_assert(avg.avg != 0);
-        }
-        gt_fasta_reader_delete(reader);
-      }
-    }
+    if (!had_err)
+      had_err = gt_condenser_search_raw_evalue(arguments, logger, &raw_eval,
+                                               err);
 
     /*create BLAST database from compressed database fasta file*/
     if (!had_err) {
@@ -532,6 +668,8 @@ static int gt_condenser_search_runner(GT_UNUSED int argc,
     gt_free(hits);
     gt_str_delete(fastaname);
   }
+  else
+    had_err = gt_condenser_search_native(arguments, logger, err);
   gt_str_delete(coarse_fname);
   gt_logger_delete(logger);
   return had_err;
@@ -32,6 +32,7 @@
 #include "tools/gt_extracttarget.h"
 #include "tools/gt_gdiffcalc.h"
 #include "tools/gt_guessprot.h"
+#include "tools/gt_hashbench.h"
 #include "tools/gt_idxlocali.h"
 #include "tools/gt_magicmatch.h"
 #include "tools/gt_mergeesa.h"
@@ -70,6 +71,7 @@ static void* gt_dev_arguments_new(void)
   gt_toolbox_add_tool(dev_toolbox, "gdiffcalc", gt_gdiffcalc());
   gt_toolbox_add_tool(dev_toolbox, "gthbssmrmsd", gt_gthbssmrmsd());
   gt_toolbox_add_tool(dev_toolbox, "gthbssmtrain", gt_gthbssmtrain());
+  gt_toolbox_add_tool(dev_toolbox, "hashbench", gt_hashbench());
   gt_toolbox_add_tool(dev_toolbox, "idxlocali", gt_idxlocali());
   gt_toolbox_add_tool(dev_toolbox, "magicmatch", gt_magicmatch());
   gt_toolbox_add_tool(dev_toolbox, "parsexrf", gt_parsexrf());
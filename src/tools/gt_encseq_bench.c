@@ -19,16 +19,24 @@
 #include "core/ma.h"
 #include "core/unused_api.h"
 #include "core/encseq.h"
+#include "core/encseq_access_type.h"
 #include "core/encseq_metadata.h"
 #include "core/mathsupport.h"
+#include "core/minmax.h"
+#include "core/multithread_api.h"
+#include "core/readmode_api.h"
 #include "core/showtime.h"
 #include "core/logger.h"
+#include "core/thread_api.h"
+#include "core/timer_api.h"
+#include "match/initbasepower.h"
 #include "tools/gt_encseq_bench.h"
 
 typedef struct
 {
-  GtUword ccext;
-  bool sortlenprepare, verbose;
+  GtUword ccext, trials, rangelength;
+  unsigned int prefixlength;
+  bool sortlenprepare, suite, verbose;
 } GtEncseqBenchArguments;
 
 static void* gt_encseq_bench_arguments_new(void)
@@ -69,6 +77,27 @@ static GtOptionParser* gt_encseq_bench_option_parser_new(void *tool_arguments)
                                &arguments->sortlenprepare, false);
   gt_option_parser_add_option(op, option);
 
+  option = gt_option_new_bool("suite", "run all access benchmarks with "
+                                       "-j threads and report the results "
+                                       "as tab separated lines",
+                               &arguments->suite, false);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_uword("trials", "specify number of random accesses "
+                                         "per benchmark in -suite",
+                               &arguments->trials, 1000000UL);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_uword_min("rangelength", "specify length of the "
+                                   "ranges extracted in -suite",
+                                   &arguments->rangelength, 1000UL, 1UL);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_uint_min("prefixlength", "specify length of the "
+                                  "prefix codes extracted in -suite",
+                                  &arguments->prefixlength, 10U, 1U);
+  gt_option_parser_add_option(op, option);
+
   option = gt_option_new_verbose(&arguments->verbose);
   gt_option_parser_add_option(op, option);
 
@@ -263,6 +292,256 @@ GtUword gt_sortedlengthinfo_seqstart(const GtEncseq *encseq,
   }
 }
 
+typedef enum
+{
+  GT_ENCSEQ_BENCH_RANDOMCHAR,
+  GT_ENCSEQ_BENCH_SCAN,
+  GT_ENCSEQ_BENCH_EXTRACT,
+  GT_ENCSEQ_BENCH_DESCRIPTION,
+  GT_ENCSEQ_BENCH_SEQNUM,
+  GT_ENCSEQ_BENCH_PREFIXCODE
+} GtEncseqBenchKind;
+
+static const char *gt_encseq_bench_kind_names[] = {
+  "randomchar",
+  "scan",
+  "extract",
+  "description",
+  "seqnum",
+  "prefixcode"
+};
+
+typedef struct
+{
+  const GtEncseq *encseq;
+  GtEncseqBenchKind kind;
+  GtReadmode readmode;
+  GtUword trials, rangelength, totallength, numofsequences, nextthread,
+          operations, characters, checksum;
+  unsigned int prefixlength;
+  const GtCodetype *filltable, **multimappower;
+  GtMutex *mutex;
+} GtEncseqBenchJob;
+
+/* xorshift generator, one state per thread so that the threads do not
+   contend for the lock of random() */
+static GtUword gt_encseq_bench_random(uint64_t *state, GtUword maxvalue)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return (GtUword) (*state % ((uint64_t) maxvalue + 1));
+}
+
+static void* gt_encseq_bench_thread(void *data)
+{
+  GtEncseqBenchJob *job = data;
+  GtUword threadnum, idx, operations, characters = 0, checksum = 0;
+  uint64_t state;
+
+  gt_mutex_lock(job->mutex);
+  threadnum = job->nextthread++;
+  gt_mutex_unlock(job->mutex);
+  state = (uint64_t) 88172645463325252ULL + (uint64_t) threadnum;
+  operations = job->trials / gt_jobs;
+  if (threadnum < job->trials % gt_jobs)
+    operations++;
+
+  switch (job->kind) {
+    case GT_ENCSEQ_BENCH_RANDOMCHAR:
+      for (idx = 0; idx < operations; idx++) {
+        GtUword pos = gt_encseq_bench_random(&state, job->totallength - 1);
+        checksum += (GtUword) gt_encseq_get_encoded_char(job->encseq, pos,
+                                                         job->readmode);
+      }
+      characters = operations;
+      break;
+    case GT_ENCSEQ_BENCH_SCAN:
+      {
+        /* every thread scans its own slice of the sequence */
+        GtUword start = job->totallength / gt_jobs * threadnum,
+                end = (threadnum + 1 == (GtUword) gt_jobs)
+                        ? job->totallength
+                        : job->totallength / gt_jobs * (threadnum + 1);
+        GtEncseqReader *esr
+          = gt_encseq_create_reader_with_readmode(job->encseq, job->readmode,
+                                                  start);
+
+        for (idx = start; idx < end; idx++) {
+          checksum += (GtUword) gt_encseq_reader_next_encoded_char(esr);
+        }
+        gt_encseq_reader_delete(esr);
+        operations = 1UL;
+        characters = end - start;
+      }
+      break;
+    case GT_ENCSEQ_BENCH_EXTRACT:
+      {
+        GtUchar *buffer = gt_malloc(sizeof (*buffer) * job->rangelength);
+
+        for (idx = 0; idx < operations; idx++) {
+          GtUword frompos
+            = gt_encseq_bench_random(&state,
+                                     job->totallength - job->rangelength);
+          gt_encseq_extract_encoded_with_readmode(job->encseq, buffer,
+                                                  frompos,
+                                                  frompos + job->rangelength
+                                                    - 1,
+                                                  job->readmode);
+          checksum += (GtUword) buffer[0] + buffer[job->rangelength - 1];
+        }
+        gt_free(buffer);
+        characters = operations * job->rangelength;
+      }
+      break;
+    case GT_ENCSEQ_BENCH_DESCRIPTION:
+      for (idx = 0; idx < operations; idx++) {
+        GtUword desclen,
+                seqnum = gt_encseq_bench_random(&state,
+                                                job->numofsequences - 1);
+        (void) gt_encseq_description(job->encseq, &desclen, seqnum);
+        checksum += desclen;
+        characters += desclen;
+      }
+      break;
+    case GT_ENCSEQ_BENCH_SEQNUM:
+      for (idx = 0; idx < operations; idx++) {
+        GtUword pos = gt_encseq_bench_random(&state, job->totallength - 1);
+        checksum += gt_encseq_seqnum(job->encseq, pos);
+      }
+      characters = operations;
+      break;
+    case GT_ENCSEQ_BENCH_PREFIXCODE:
+      {
+        GtEncseqReader *esr
+          = gt_encseq_create_reader_with_readmode(job->encseq, job->readmode,
+                                                  0);
+
+        for (idx = 0; idx < operations; idx++) {
+          unsigned int unitsnotspecial;
+          GtUword frompos
+            = gt_encseq_bench_random(&state,
+                                     job->totallength - job->prefixlength);
+          checksum += (GtUword) gt_encseq_extractprefixcode(&unitsnotspecial,
+                                                            job->encseq,
+                                                            job->filltable,
+                                                            job->readmode,
+                                                            esr,
+                                                            job->multimappower,
+                                                            frompos,
+                                                            job->prefixlength);
+        }
+        gt_encseq_reader_delete(esr);
+        characters = operations * job->prefixlength;
+      }
+      break;
+  }
+  gt_mutex_lock(job->mutex);
+  job->operations += operations;
+  job->characters += characters;
+  job->checksum += checksum;
+  gt_mutex_unlock(job->mutex);
+  return NULL;
+}
+
+static int gt_encseq_bench_run_job(GtEncseqBenchJob *job, GtError *err)
+{
+  GtTimer *timer = gt_timer_new();
+  double seconds;
+  int had_err;
+
+  job->nextthread = job->operations = job->characters = job->checksum = 0;
+  gt_timer_start(timer);
+  had_err = gt_multithread(gt_encseq_bench_thread, job, err);
+  seconds = gt_timer_get_elapsed_seconds(timer);
+  gt_timer_delete(timer);
+  if (!had_err) {
+    printf("%s\t%s\t%s\t%u\t"GT_WU"\t"GT_WU"\t%.6f\t%.0f\t%.0f\t%.2f\t"GT_WU
+           "\n",
+           gt_encseq_bench_kind_names[job->kind],
+           gt_encseq_access_type_str(gt_encseq_accesstype_get(job->encseq)),
+           gt_readmode_show(job->readmode),
+           gt_jobs,
+           job->operations,
+           job->characters,
+           seconds,
+           seconds > 0.0 ? (double) job->operations / seconds : 0.0,
+           seconds > 0.0 ? (double) job->characters / seconds : 0.0,
+           job->operations > 0 ? seconds * 1.0e9 / (double) job->operations
+                               : 0.0,
+           job->checksum);
+  }
+  return had_err;
+}
+
+/* Runs all benchmarks on <encseq> and shows one line per benchmark, with the
+   columns named in the header line. Random accesses are spread over the
+   whole sequence, so that for large sequences the time per operation is
+   dominated by cache misses, while the scans show the sequential
+   throughput. */
+static int gt_encseq_bench_suite(const GtEncseq *encseq,
+                                 const GtEncseqBenchArguments *arguments,
+                                 GtError *err)
+{
+  GtEncseqBenchJob job;
+  GtCodetype *filltable = NULL, **multimappower = NULL;
+  unsigned int numofchars, readmode;
+  const unsigned int numofreadmodes
+    = gt_alphabet_is_dna(gt_encseq_alphabet(encseq)) ? 4U : 2U;
+  int had_err = 0;
+
+  job.encseq = encseq;
+  job.trials = arguments->trials;
+  job.totallength = gt_encseq_total_length(encseq);
+  job.numofsequences = gt_encseq_num_of_sequences(encseq);
+  job.rangelength = MIN(arguments->rangelength, job.totallength);
+  numofchars = gt_alphabet_num_of_chars(gt_encseq_alphabet(encseq));
+  job.prefixlength = MIN(arguments->prefixlength,
+                         MIN(gt_maxbasepower(numofchars),
+                             (unsigned int) job.totallength));
+  job.mutex = gt_mutex_new();
+  printf("# benchmark\taccesstype\treadmode\tthreads\toperations\t"
+         "characters\tseconds\toperations/s\tcharacters/s\tns/operation\t"
+         "checksum\n");
+
+  for (readmode = 0; !had_err && readmode < numofreadmodes; readmode++) {
+    job.readmode = (GtReadmode) readmode;
+    job.kind = GT_ENCSEQ_BENCH_RANDOMCHAR;
+    had_err = gt_encseq_bench_run_job(&job, err);
+  }
+  for (readmode = 0; !had_err && readmode < numofreadmodes; readmode++) {
+    job.readmode = (GtReadmode) readmode;
+    job.kind = GT_ENCSEQ_BENCH_SCAN;
+    had_err = gt_encseq_bench_run_job(&job, err);
+  }
+  for (readmode = 0; !had_err && readmode < numofreadmodes; readmode++) {
+    job.readmode = (GtReadmode) readmode;
+    job.kind = GT_ENCSEQ_BENCH_EXTRACT;
+    had_err = gt_encseq_bench_run_job(&job, err);
+  }
+  job.readmode = GT_READMODE_FORWARD;
+  if (!had_err && gt_encseq_has_description_support(encseq)) {
+    job.kind = GT_ENCSEQ_BENCH_DESCRIPTION;
+    had_err = gt_encseq_bench_run_job(&job, err);
+  }
+  if (!had_err && gt_encseq_has_multiseq_support(encseq)) {
+    job.kind = GT_ENCSEQ_BENCH_SEQNUM;
+    had_err = gt_encseq_bench_run_job(&job, err);
+  }
+  if (!had_err) {
+    filltable = gt_initfilltable(numofchars, job.prefixlength);
+    multimappower = gt_initmultimappower(numofchars, job.prefixlength);
+    job.filltable = filltable;
+    job.multimappower = (const GtCodetype **) multimappower;
+    job.kind = GT_ENCSEQ_BENCH_PREFIXCODE;
+    had_err = gt_encseq_bench_run_job(&job, err);
+  }
+  gt_free(filltable);
+  gt_multimappower_delete(multimappower);
+  gt_mutex_delete(job.mutex);
+  return had_err;
+}
+
 static int gt_encseq_bench_runner(GT_UNUSED int argc, const char **argv,
                                   int parsed_args, void *tool_arguments,
                                   GtError *err)
@@ -327,6 +606,9 @@ static int gt_encseq_bench_runner(GT_UNUSED int argc, const char **argv,
       gt_logger_log(logger,"perform character extractions");
       gt_bench_character_extractions(encseq,arguments->ccext);
     }
+    if (!had_err && arguments->suite) {
+      had_err = gt_encseq_bench_suite(encseq, arguments, err);
+    }
   }
   gt_encseq_delete(encseq);
   gt_encseq_loader_delete(encseq_loader);
@@ -23,6 +23,7 @@
 #include "core/encseq_options.h"
 #include "core/fasta_separator.h"
 #include "core/log_api.h"
+#include "core/minmax.h"
 #include "core/readmode.h"
 #include "core/undef_api.h"
 #include "core/unused_api.h"
@@ -176,13 +177,50 @@ int gt_encseq_decode_arguments_check(GT_UNUSED int rest_argc,
   return had_err;
 }
 
+#define GT_ENCSEQ_DECODE_BUFSIZE 8192UL
+
+/* Shows the characters from the forward positions <frompos> to <topos> of
+   <encseq> in <readmode>, extracting them in chunks of
+   GT_ENCSEQ_DECODE_BUFSIZE characters into <buffer>. If <sepchar> is not 0,
+   separators are shown as <sepchar>. */
+static void encseq_decode_show_range(const GtEncseq *encseq,
+                                     GtReadmode readmode,
+                                     GtUword frompos,
+                                     GtUword topos,
+                                     char sepchar,
+                                     char *buffer)
+{
+  GtUword remaining = topos - frompos + 1;
+
+  while (remaining > 0) {
+    GtUword idx, start,
+            len = MIN(remaining, GT_ENCSEQ_DECODE_BUFSIZE);
+
+    /* in reverse readmodes, the chunks are taken from the end */
+    if (GT_ISDIRREVERSE(readmode))
+      start = frompos + remaining - len;
+    else
+      start = topos + 1 - remaining;
+    gt_encseq_extract_decoded_with_readmode(encseq, buffer, start,
+                                            start + len - 1, readmode);
+    if (sepchar != 0) {
+      for (idx = 0; idx < len; idx++) {
+        if (buffer[idx] == (char) SEPARATOR)
+          buffer[idx] = sepchar;
+      }
+    }
+    gt_xfwrite(buffer, sizeof (char), (size_t) len, stdout);
+    remaining -= len;
+  }
+}
+
 static int output_sequence(GtEncseq *encseq, GtEncseqDecodeArguments *args,
                            const char *filename, GtError *err)
 {
   GtUword i, j, sfrom, sto;
   int had_err = 0;
   bool has_desc;
-  GtEncseqReader *esr;
+  char buffer[GT_ENCSEQ_DECODE_BUFSIZE];
   gt_assert(encseq);
 
   if (!(has_desc = gt_encseq_has_description_support(encseq)))
@@ -258,8 +296,6 @@ static int output_sequence(GtEncseq *encseq, GtEncseqDecodeArguments *args,
       gt_xfputc(GT_FASTA_SEPARATOR, stdout);
       gt_xfwrite(desc, 1, desclen, stdout);
       gt_xfputc('\n', stdout);
-      /* XXX: make this more efficient by writing in a buffer first and then
-         showing the result */
       if (args->singlechars) {
         for (j = 0; j < len; j++) {
            gt_xfputc(gt_encseq_get_decoded_char(encseq,
@@ -267,12 +303,12 @@ static int output_sequence(GtEncseq *encseq, GtEncseqDecodeArguments *args,
                                                 args->rm),
                      stdout);
         }
-      } else {
-        esr = gt_encseq_create_reader_with_readmode(encseq, args->rm, startpos);
-        for (j = 0; j < len; j++) {
-           gt_xfputc(gt_encseq_reader_next_decoded_char(esr), stdout);
-        }
-        gt_encseq_reader_delete(esr);
+      } else if (len > 0) {
+        /* the range extraction expects forward positions */
+        if (GT_ISDIRREVERSE(args->rm))
+          startpos = gt_encseq_total_length(encseq) - startpos - len;
+        encseq_decode_show_range(encseq, args->rm, startpos,
+                                 startpos + len - 1, 0, buffer);
       }
       gt_xfputc('\n', stdout);
     }
@@ -302,16 +338,17 @@ static int output_sequence(GtEncseq *encseq, GtEncseqDecodeArguments *args,
           gt_xfputc(cc, stdout);
         }
       } else {
-        esr = gt_encseq_create_reader_with_readmode(encseq, args->rm, from);
-        if (esr) {
-          for (j = from; j <= to; j++) {
-            char cc = gt_encseq_reader_next_decoded_char(esr);
-            if (cc == (char) SEPARATOR)
-              cc = gt_str_get(args->sepchar)[0];
-            gt_xfputc(cc, stdout);
-          }
-          gt_encseq_reader_delete(esr);
-        }
+        GtUword totallength = gt_encseq_total_length(encseq);
+
+        /* the range extraction expects forward positions */
+        if (GT_ISDIRREVERSE(args->rm))
+          encseq_decode_show_range(encseq, args->rm,
+                                   totallength - 1 - to,
+                                   totallength - 1 - from,
+                                   gt_str_get(args->sepchar)[0], buffer);
+        else
+          encseq_decode_show_range(encseq, args->rm, from, to,
+                                   gt_str_get(args->sepchar)[0], buffer);
       }
       gt_xfputc('\n', stdout);
     }
@@ -342,6 +379,12 @@ static int decode_sequence_file(const char *seqfile,
     if (!had_err)
       had_err = gt_encseq_mirror(encseq, err);
   }
+  if (!had_err && GT_ISDIRCOMPLEMENT(args->rm) &&
+      !gt_alphabet_is_dna(gt_encseq_alphabet(encseq))) {
+    gt_error_set(err, "complementing readmodes are only defined on DNA "
+                      "sequences");
+    had_err = -1;
+  }
   if (!had_err)
     had_err = output_sequence(encseq, args, seqfile, err);
   gt_encseq_delete(encseq);
@@ -22,6 +22,7 @@
 #include "core/undef_api.h"
 #include "core/versionfunc.h"
 #include "extended/add_introns_stream_api.h"
+#include "extended/binary_out_stream.h"
 #include "extended/genome_node.h"
 #include "extended/gff3_defines.h"
 #include "extended/gff3_in_stream.h"
@@ -51,6 +52,7 @@ typedef struct {
        strict,
        tidy,
        show,
+       binary,
        fixboundaries;
   GtWord offset;
   GtStr *offsetfile, *newsource;
@@ -91,7 +93,8 @@ static GtOptionParser* gt_gff3_option_parser_new(void *tool_arguments)
   GtOptionParser *op;
   GtOption *sort_option, *load_option, *strict_option, *tidy_option,
            *mergefeat_option, *addintrons_option, *offset_option,
-           *offsetfile_option, *setsource_option, *sortlines_option, *option;
+           *offsetfile_option, *setsource_option, *sortlines_option,
+           *binary_option, *option;
   gt_assert(arguments);
 
   /* init */
@@ -211,6 +214,15 @@ static GtOptionParser* gt_gff3_option_parser_new(void *tool_arguments)
                               true);
   gt_option_parser_add_option(op, option);
 
+  /* -binary */
+  binary_option = gt_option_new_bool("binary", "show output in the binary node "
+                                     "format instead of GFF3 (for intermediate "
+                                     "files, which are read much faster by "
+                                     "all tools reading GFF3 files)",
+                                     &arguments->binary, false);
+  gt_option_exclude(binary_option, sortlines_option);
+  gt_option_parser_add_option(op, binary_option);
+
   /* -v */
   option = gt_option_new_verbose(&arguments->verbose);
   gt_option_parser_add_option(op, option);
@@ -333,7 +345,9 @@ static int gt_gff3_runner(int argc, const char **argv, int parsed_args,
 
   /* create gff3 output stream */
   if (!had_err && arguments->show) {
-    if (arguments->sortlines) {
+    if (arguments->binary)
+      gff3_out_stream = gt_binary_out_stream_new(last_stream, arguments->outfp);
+    else if (arguments->sortlines) {
       gff3_out_stream = gt_gff3_linesorted_out_stream_new(last_stream,
                                                           arguments->outfp);
       gt_gff3_linesorted_out_stream_set_fasta_width(
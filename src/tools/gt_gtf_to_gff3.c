@@ -26,7 +26,8 @@
 #include "tools/gt_gtf_to_gff3.h"
 
 typedef struct {
-  bool tidy;
+  bool tidy,
+       stream;
   GtOutputFileInfo *ofi;
   GtFile *outfp;
 } GTFToGFF3Arguments;
@@ -62,6 +63,15 @@ static GtOptionParser* gt_gtf_to_gff3_option_parser_new(void *tool_arguments)
                               "parsing", &arguments->tidy, false);
   gt_option_parser_add_option(op, option);
 
+  /* -stream */
+  option = gt_option_new_bool("stream", "output each gene as soon as it is "
+                              "complete instead of reading the whole file "
+                              "first; requires the lines of each gene_id to "
+                              "be consecutive (fails otherwise) and creates "
+                              "no sequence-region lines",
+                              &arguments->stream, false);
+  gt_option_parser_add_option(op, option);
+
   /* output file options */
   gt_output_file_info_register_options(arguments->ofi, op, &arguments->outfp);
 
@@ -85,6 +95,8 @@ static int gt_gtf_to_gff3_runner(GT_UNUSED int argc, const char **argv,
   gtf_in_stream = gt_gtf_in_stream_new(argv[parsed_args]);
   if (arguments->tidy)
     gt_gtf_in_stream_enable_tidy_mode(gtf_in_stream);
+  if (arguments->stream)
+    gt_gtf_in_stream_enable_streaming_mode(gtf_in_stream);
 
   /* create a GFF3 output stream */
   gff3_out_stream = gt_gff3_out_stream_new(gtf_in_stream, arguments->outfp);
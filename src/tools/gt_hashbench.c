@@ -0,0 +1,399 @@
+/*
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <string.h>
+#include "core/cstr_api.h"
+#include "core/hashtable.h"
+#include "core/hashtable_chained.h"
+#include "core/ma.h"
+#include "core/mathsupport.h"
+#include "core/str_api.h"
+#include "core/timer_api.h"
+#include "core/unused_api.h"
+#include "tools/gt_hashbench.h"
+
+typedef struct {
+  GtStr *impl,
+        *workload;
+  GtUword num_of_ids,
+          num_of_seqids,
+          num_of_lookups,
+          runs;
+  bool verbose;
+} HashbenchArguments;
+
+/* the elements stored by both implementations, laid out like the entries of
+   a <GtHashmap> */
+typedef struct {
+  void *key,
+       *value;
+} HashbenchEntry;
+
+typedef void* (*HashbenchNewFunc)(HashElemInfo);
+typedef int   (*HashbenchAddFunc)(void*, const void*);
+typedef void* (*HashbenchGetFunc)(void*, const void*);
+typedef int   (*HashbenchRemoveFunc)(void*, const void*);
+typedef void  (*HashbenchDeleteFunc)(void*);
+
+typedef struct {
+  const char *name;
+  HashbenchNewFunc new;
+  HashbenchAddFunc add;
+  HashbenchGetFunc get;
+  HashbenchRemoveFunc remove;
+  HashbenchDeleteFunc delete;
+} HashbenchImpl;
+
+static const HashbenchImpl gt_hashbench_impls[] = {
+  { "swiss",
+    (HashbenchNewFunc) gt_hashtable_new,
+    (HashbenchAddFunc) gt_hashtable_add,
+    (HashbenchGetFunc) gt_hashtable_get,
+    (HashbenchRemoveFunc) gt_hashtable_remove,
+    (HashbenchDeleteFunc) gt_hashtable_delete },
+  { "chained",
+    (HashbenchNewFunc) gt_hashtable_chained_new,
+    (HashbenchAddFunc) gt_hashtable_chained_add,
+    (HashbenchGetFunc) gt_hashtable_chained_get,
+    (HashbenchRemoveFunc) gt_hashtable_chained_remove,
+    (HashbenchDeleteFunc) gt_hashtable_chained_delete }
+};
+
+static const char *gt_hashbench_impl_names[] = { "all", "swiss", "chained",
+                                                 NULL };
+
+static const char *gt_hashbench_workload_names[] = { "all", "id", "seqid",
+                                                     "direct", NULL };
+
+static void* gt_hashbench_arguments_new(void)
+{
+  HashbenchArguments *arguments = gt_calloc((size_t) 1, sizeof *arguments);
+  arguments->impl = gt_str_new();
+  arguments->workload = gt_str_new();
+  return arguments;
+}
+
+static void gt_hashbench_arguments_delete(void *tool_arguments)
+{
+  HashbenchArguments *arguments = tool_arguments;
+  if (!arguments) return;
+  gt_str_delete(arguments->impl);
+  gt_str_delete(arguments->workload);
+  gt_free(arguments);
+}
+
+static GtOptionParser* gt_hashbench_option_parser_new(void *tool_arguments)
+{
+  HashbenchArguments *arguments = tool_arguments;
+  GtOptionParser *op;
+  GtOption *option;
+
+  gt_assert(arguments);
+
+  op = gt_option_parser_new("[option ...]",
+                            "Benchmark the GtHashtable implementation against "
+                            "the former chained hash table.");
+
+  option = gt_option_new_choice("impl", "implementation\n"
+                                "choose from all|swiss|chained",
+                                arguments->impl,
+                                gt_hashbench_impl_names[0],
+                                gt_hashbench_impl_names);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_choice("workload", "workload to run\n"
+                                "id: add, look up, miss and remove unique "
+                                "feature IDs\n"
+                                "seqid: look up few sequence IDs very often\n"
+                                "direct: add, look up and remove pointer "
+                                "keys\n"
+                                "choose from all|id|seqid|direct",
+                                arguments->workload,
+                                gt_hashbench_workload_names[0],
+                                gt_hashbench_workload_names);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_uword_min("ids", "number of distinct IDs (and "
+                                   "pointers) to use",
+                                   &arguments->num_of_ids, 1000000UL, 1UL);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_uword_min("seqids", "number of distinct sequence IDs "
+                                   "to use",
+                                   &arguments->num_of_seqids, 100UL, 1UL);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_uword("lookups", "number of sequence ID lookups",
+                               &arguments->num_of_lookups, 10000000UL);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_uword_min("runs", "number of times to run each "
+                                   "workload", &arguments->runs, 1UL, 1UL);
+  gt_option_parser_add_option(op, option);
+
+  option = gt_option_new_verbose(&arguments->verbose);
+  gt_option_parser_add_option(op, option);
+
+  return op;
+}
+
+static char** gt_hashbench_keys_new(const char *fmt, GtUword num_of_keys)
+{
+  char **keys = gt_malloc(sizeof (*keys) * num_of_keys), buf[BUFSIZ];
+  GtUword i;
+  for (i = 0; i < num_of_keys; i++) {
+    (void) snprintf(buf, sizeof (buf), fmt, i);
+    keys[i] = gt_cstr_dup(buf);
+  }
+  return keys;
+}
+
+static void gt_hashbench_keys_delete(char **keys, GtUword num_of_keys)
+{
+  GtUword i;
+  for (i = 0; i < num_of_keys; i++)
+    gt_free(keys[i]);
+  gt_free(keys);
+}
+
+static void gt_hashbench_show_time(GtTimer *timer, const HashbenchImpl *impl,
+                                   const char *workload, const char *phase,
+                                   GtUword run)
+{
+  printf("# TIME %s-%s-%s-r" GT_WU " ", impl->name, workload, phase, run);
+  gt_timer_show_formatted(timer, GT_WD ".%06ld\n", stdout);
+}
+
+static int gt_hashbench_wrong_result(const HashbenchImpl *impl,
+                                     const char *workload, GtError *err)
+{
+  gt_error_set(err, "implementation %s returned a wrong result for "
+               "workload %s", impl->name, workload);
+  return -1;
+}
+
+/* unique feature IDs as stored by the GFF3 parser: every ID is checked for
+   being new and added, then looked up (as Parent), IDs which are not defined
+   (yet) are looked up in vain and all IDs are removed at the end */
+static int gt_hashbench_id(const HashbenchImpl *impl,
+                           const HashbenchArguments *arguments, GtUword run,
+                           GtError *err)
+{
+  static const HashElemInfo info = { gt_ht_cstr_elem_hash, { NULL },
+                                     sizeof (HashbenchEntry),
+                                     gt_ht_cstr_elem_cmp, NULL, NULL };
+  char **ids, **missing_ids;
+  GtUword i, n = arguments->num_of_ids;
+  GtTimer *timer;
+  void *ht;
+  int had_err = 0;
+
+  ids = gt_hashbench_keys_new("gene" GT_WU ".mRNA1", n);
+  missing_ids = gt_hashbench_keys_new("gene" GT_WU ".mRNA1.exon1", n);
+  timer = gt_timer_new();
+  ht = impl->new(info);
+
+  gt_timer_start(timer);
+  for (i = 0; !had_err && i < n; i++) {
+    HashbenchEntry entry;
+    entry.key = ids[i];
+    entry.value = ids[i];
+    if (impl->get(ht, &entry) || !impl->add(ht, &entry))
+      had_err = gt_hashbench_wrong_result(impl, "id", err);
+  }
+  gt_hashbench_show_time(timer, impl, "id", "add", run);
+
+  gt_timer_start(timer);
+  for (i = 0; !had_err && i < n; i++) {
+    HashbenchEntry *entry = impl->get(ht, ids + i);
+    if (!entry || entry->value != ids[i])
+      had_err = gt_hashbench_wrong_result(impl, "id", err);
+  }
+  gt_hashbench_show_time(timer, impl, "id", "get", run);
+
+  gt_timer_start(timer);
+  for (i = 0; !had_err && i < n; i++) {
+    if (impl->get(ht, missing_ids + i))
+      had_err = gt_hashbench_wrong_result(impl, "id", err);
+  }
+  gt_hashbench_show_time(timer, impl, "id", "miss", run);
+
+  gt_timer_start(timer);
+  for (i = 0; !had_err && i < n; i++) {
+    if (!impl->remove(ht, ids + i))
+      had_err = gt_hashbench_wrong_result(impl, "id", err);
+  }
+  gt_hashbench_show_time(timer, impl, "id", "remove", run);
+
+  impl->delete(ht);
+  gt_timer_delete(timer);
+  gt_hashbench_keys_delete(ids, n);
+  gt_hashbench_keys_delete(missing_ids, n);
+  return had_err;
+}
+
+/* few sequence IDs, each of which is looked up for every feature (as done
+   when mapping seqids to sequence regions or caching sequence data) */
+static int gt_hashbench_seqid(const HashbenchImpl *impl,
+                              const HashbenchArguments *arguments, GtUword run,
+                              GtError *err)
+{
+  static const HashElemInfo info = { gt_ht_cstr_elem_hash, { NULL },
+                                     sizeof (HashbenchEntry),
+                                     gt_ht_cstr_elem_cmp, NULL, NULL };
+  char **seqids, **queries;
+  GtUword i, n = arguments->num_of_seqids;
+  GtTimer *timer;
+  void *ht;
+  int had_err = 0;
+
+  seqids = gt_hashbench_keys_new("scaffold_" GT_WU, n);
+  /* query with copies of the keys, as parsed from the input */
+  queries = gt_hashbench_keys_new("scaffold_" GT_WU, n);
+  timer = gt_timer_new();
+  ht = impl->new(info);
+
+  gt_timer_start(timer);
+  for (i = 0; !had_err && i < n; i++) {
+    HashbenchEntry entry;
+    entry.key = seqids[i];
+    entry.value = seqids[i];
+    if (!impl->add(ht, &entry))
+      had_err = gt_hashbench_wrong_result(impl, "seqid", err);
+  }
+  gt_hashbench_show_time(timer, impl, "seqid", "add", run);
+
+  gt_timer_start(timer);
+  for (i = 0; !had_err && i < arguments->num_of_lookups; i++) {
+    /* features are sorted by sequence, so the same seqid is looked up
+       repeatedly */
+    GtUword idx = (i / 64) % n;
+    HashbenchEntry *entry = impl->get(ht, queries + idx);
+    if (!entry || entry->value != seqids[idx])
+      had_err = gt_hashbench_wrong_result(impl, "seqid", err);
+  }
+  gt_hashbench_show_time(timer, impl, "seqid", "get", run);
+
+  impl->delete(ht);
+  gt_timer_delete(timer);
+  gt_hashbench_keys_delete(seqids, n);
+  gt_hashbench_keys_delete(queries, n);
+  return had_err;
+}
+
+/* pointer keys in random order, as used to map genome nodes to data */
+static int gt_hashbench_direct(const HashbenchImpl *impl,
+                               const HashbenchArguments *arguments,
+                               GtUword run, GtError *err)
+{
+  static const HashElemInfo info = { gt_ht_ptr_elem_hash, { NULL },
+                                     sizeof (HashbenchEntry),
+                                     gt_ht_ptr_elem_cmp, NULL, NULL };
+  GtUword i, n = arguments->num_of_ids, *order;
+  HashbenchEntry *nodes;
+  GtTimer *timer;
+  void *ht;
+  int had_err = 0;
+
+  nodes = gt_malloc(sizeof (*nodes) * n);
+  order = gt_malloc(sizeof (*order) * n);
+  for (i = 0; i < n; i++) {
+    nodes[i].key = nodes + i;
+    nodes[i].value = nodes + i;
+    order[i] = i;
+  }
+  for (i = n - 1; i > 0; i--) {
+    GtUword j = gt_rand_max(i), tmp = order[i];
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+  timer = gt_timer_new();
+  ht = impl->new(info);
+
+  gt_timer_start(timer);
+  for (i = 0; !had_err && i < n; i++) {
+    if (!impl->add(ht, nodes + order[i]))
+      had_err = gt_hashbench_wrong_result(impl, "direct", err);
+  }
+  gt_hashbench_show_time(timer, impl, "direct", "add", run);
+
+  gt_timer_start(timer);
+  for (i = 0; !had_err && i < n; i++) {
+    HashbenchEntry *entry = impl->get(ht, nodes + i);
+    if (!entry || entry->value != nodes + i)
+      had_err = gt_hashbench_wrong_result(impl, "direct", err);
+  }
+  gt_hashbench_show_time(timer, impl, "direct", "get", run);
+
+  gt_timer_start(timer);
+  for (i = 0; !had_err && i < n; i++) {
+    if (!impl->remove(ht, nodes + order[i]))
+      had_err = gt_hashbench_wrong_result(impl, "direct", err);
+  }
+  gt_hashbench_show_time(timer, impl, "direct", "remove", run);
+
+  impl->delete(ht);
+  gt_timer_delete(timer);
+  gt_free(order);
+  gt_free(nodes);
+  return had_err;
+}
+
+static int gt_hashbench_runner(GT_UNUSED int argc, GT_UNUSED const char **argv,
+                               GT_UNUSED int parsed_args, void *tool_arguments,
+                               GtError *err)
+{
+  HashbenchArguments *arguments = tool_arguments;
+  const char *impl_name = gt_str_get(arguments->impl),
+             *workload = gt_str_get(arguments->workload);
+  bool all_workloads = strcmp(workload, "all") == 0;
+  GtUword run;
+  size_t i;
+  int had_err = 0;
+
+  gt_error_check(err);
+  gt_assert(arguments);
+  if (arguments->verbose) {
+    printf("# number of IDs = " GT_WU "\n", arguments->num_of_ids);
+    printf("# number of seqids = " GT_WU "\n", arguments->num_of_seqids);
+    printf("# number of seqid lookups = " GT_WU "\n",
+           arguments->num_of_lookups);
+  }
+  for (run = 0; !had_err && run < arguments->runs; run++) {
+    for (i = 0; !had_err && i < sizeof (gt_hashbench_impls)
+                                / sizeof (gt_hashbench_impls[0]); i++) {
+      const HashbenchImpl *impl = gt_hashbench_impls + i;
+      if (strcmp(impl_name, "all") != 0 && strcmp(impl_name, impl->name) != 0)
+        continue;
+      if (all_workloads || strcmp(workload, "id") == 0)
+        had_err = gt_hashbench_id(impl, arguments, run, err);
+      if (!had_err && (all_workloads || strcmp(workload, "seqid") == 0))
+        had_err = gt_hashbench_seqid(impl, arguments, run, err);
+      if (!had_err && (all_workloads || strcmp(workload, "direct") == 0))
+        had_err = gt_hashbench_direct(impl, arguments, run, err);
+    }
+  }
+  return had_err;
+}
+
+GtTool* gt_hashbench(void)
+{
+  return gt_tool_new(gt_hashbench_arguments_new,
+                     gt_hashbench_arguments_delete,
+                     gt_hashbench_option_parser_new,
+                     NULL,
+                     gt_hashbench_runner);
+}
@@ -17,6 +17,7 @@
 
 #include "core/basename_api.h"
 #include "core/ma.h"
+#include "core/multithread_api.h"
 #include "core/undef_api.h"
 #include "core/seq_iterator_fastq_api.h"
 #include "core/unused_api.h"
@@ -88,7 +89,10 @@ static GtOptionParser* gt_hop_option_parser_new(void *tool_arguments)
   option = gt_option_new_string("map",
       "mapping of reads to the cognate sequence\n"
       "it must be in SAM/BAM format, and sorted by coordinate\n"
-      "(can be prepared e.g. using: samtools sort)",
+      "(can be prepared e.g. using: samtools sort)\n"
+      "if more than one thread is used (option -j of gt), the "
+      "sequences of a BAM file are processed in parallel, using the "
+      "BAM index (.bai), which is created if it does not exist",
       arguments->map, NULL);
   gt_option_is_mandatory(option);
   gt_option_hide_default(option);
@@ -509,7 +513,21 @@ static int gt_hop_runner(GT_UNUSED int argc, GT_UNUSED const char **argv,
       gt_hpol_processor_restrict_to_feature_type(hpp, spc);
     }
     if (!had_err)
-      had_err = gt_hpol_processor_run(hpp, v_logger, err);
+    {
+      /* with several threads, process the sequences of a BAM file in
+         parallel, or at least decode the alignments in a separate thread */
+      if (gt_jobs > 1U && !arguments->map_is_sam &&
+          gt_encseq_num_of_sequences(encseq) > 1UL && spc == NULL &&
+          !arguments->stats && !arguments->state_of_truth)
+        had_err = gt_hpol_processor_run_parallel(hpp, sfi, sem, v_logger,
+            err);
+      else
+      {
+        if (gt_jobs > 1U)
+          gt_samfile_iterator_enable_prefetch(sfi);
+        had_err = gt_hpol_processor_run(hpp, v_logger, err);
+      }
+    }
     gt_aligned_segments_pile_delete(asp);
     gt_samfile_iterator_delete(sfi);
     gt_samfile_encseq_mapping_delete(sem);
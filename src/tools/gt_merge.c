@@ -15,19 +15,37 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <string.h>
+#include "core/compat.h"
+#include "core/cstr_table.h"
+#include "core/hashmap.h"
 #include "core/ma_api.h"
+#include "core/minmax.h"
 #include "core/option_api.h"
 #include "core/output_file_api.h"
+#include "core/thread_api.h"
+#include "core/unused_api.h"
 #include "core/versionfunc.h"
 #include "extended/genome_node.h"
 #include "extended/gff3_in_stream.h"
 #include "extended/gff3_out_stream_api.h"
+#include "extended/gff3_visitor_api.h"
 #include "extended/merge_stream_api.h"
+#include "extended/meta_node_api.h"
+#include "extended/prefetch_stream.h"
+#include "extended/region_node_api.h"
+#include "extended/sequence_node_api.h"
 #include "tools/gt_merge.h"
 
+/* number of nodes read ahead from each input file with -j > 1 */
+#define GT_MERGE_PREFETCH_BATCHSIZE  1024
+/* number of nodes handed to the writer thread at once with -splitseqids */
+#define GT_MERGE_WRITER_BATCHSIZE    1024
+
 typedef struct {
   GtOutputFileInfo *ofi;
   GtFile *outfp;
+  GtStr *splitseqids;
   bool retainids,
        tidy;
 } MergeArguments;
@@ -36,6 +54,7 @@ static void* gt_merge_arguments_new(void)
 {
   MergeArguments *arguments = gt_calloc(1, sizeof *arguments);
   arguments->ofi = gt_output_file_info_new();
+  arguments->splitseqids = gt_str_new();
   return arguments;
 }
 
@@ -45,6 +64,7 @@ static void gt_merge_arguments_delete(void *tool_arguments)
   if (!arguments) return;
   gt_file_delete(arguments->outfp);
   gt_output_file_info_delete(arguments->ofi);
+  gt_str_delete(arguments->splitseqids);
   gt_free(arguments);
 }
 
@@ -71,10 +91,353 @@ static GtOptionParser* gt_merge_option_parser_new(void *tool_arguments)
                               "during parsing", &arguments->tidy, false);
   gt_option_parser_add_option(op, option);
 
+  /* -splitseqids */
+  option = gt_option_new_string("splitseqids", "write the output for each "
+                                "sequence ID to a separate GFF3 file named "
+                                "<seqid>.gff3 in the given directory, while "
+                                "merging (instead of to a single output)",
+                                arguments->splitseqids, NULL);
+  gt_option_parser_add_option(op, option);
+
   gt_output_file_info_register_options(arguments->ofi, op, &arguments->outfp);
   return op;
 }
 
+static int gt_merge_arguments_check(GT_UNUSED int rest_argc,
+                                    void *tool_arguments, GtError *err)
+{
+  MergeArguments *arguments = tool_arguments;
+  gt_error_check(err);
+  gt_assert(arguments);
+  if (gt_str_length(arguments->splitseqids) && arguments->outfp) {
+    gt_error_set(err, "option \"-splitseqids\" cannot be combined with an "
+                 "output file");
+    return -1;
+  }
+  return 0;
+}
+
+/* With -splitseqids, the merged nodes are written to one file per sequence ID.
+   Each file is an independent GFF3 output with its own visitor. The writing
+   is done by a writer thread (if <gt_jobs> > 1), which processes one batch of
+   nodes while the next batch is merged. As the merged stream is sorted, the
+   features of each sequence ID follow each other and at most one file is open
+   at a time. */
+
+typedef struct {
+  GtFile *outfp;
+  GtNodeVisitor *gff3_visitor;
+} MergePartition;
+
+typedef struct {
+  GtGenomeNode *gn; /* NULL closes <partition> */
+  MergePartition *partition;
+} MergeOutputItem;
+
+typedef struct {
+  MergeOutputItem *items;
+  GtUword nof_items;
+} MergeOutputBatch;
+
+typedef struct {
+  MergeOutputBatch batches[2],
+                   *filling,
+                   *writing;
+  GtThread *writer;
+  int had_err;
+  GtError *err;
+} MergeSplitWriter;
+
+static void merge_partition_close(MergePartition *partition)
+{
+  gt_node_visitor_delete(partition->gff3_visitor);
+  gt_file_delete(partition->outfp);
+  gt_free(partition);
+}
+
+static void* merge_split_writer_write(void *data)
+{
+  MergeSplitWriter *sw = data;
+  MergeOutputBatch *batch = sw->writing;
+  GtUword i;
+  for (i = 0; i < batch->nof_items; i++) {
+    MergeOutputItem *item = batch->items + i;
+    if (item->gn) {
+      if (!sw->had_err) {
+        sw->had_err = gt_genome_node_accept(item->gn,
+                                            item->partition->gff3_visitor,
+                                            sw->err);
+      }
+      gt_genome_node_delete(item->gn);
+    }
+    else
+      merge_partition_close(item->partition);
+  }
+  batch->nof_items = 0;
+  return NULL;
+}
+
+static void merge_split_writer_wait(GT_UNUSED MergeSplitWriter *sw)
+{
+#ifdef GT_THREADS_ENABLED
+  if (sw->writer) {
+    gt_thread_join(sw->writer);
+    gt_thread_delete(sw->writer);
+    sw->writer = NULL;
+  }
+#endif
+}
+
+/* hand the filled batch to the writer thread, or write it directly */
+static void merge_split_writer_flush(MergeSplitWriter *sw)
+{
+  merge_split_writer_wait(sw);
+  sw->writing = sw->filling;
+  sw->filling = sw->batches + (sw->filling == sw->batches ? 1 : 0);
+#ifdef GT_THREADS_ENABLED
+  if (gt_jobs > 1U) {
+    GtError *err = gt_error_new();
+    if (!(sw->writer = gt_thread_new(merge_split_writer_write, sw, err)))
+      (void) merge_split_writer_write(sw); /* write in the calling thread */
+    gt_error_delete(err);
+    return;
+  }
+#endif
+  (void) merge_split_writer_write(sw);
+}
+
+static void merge_split_writer_add(MergeSplitWriter *sw, GtGenomeNode *gn,
+                                   MergePartition *partition)
+{
+  MergeOutputItem *item;
+  gt_assert(partition);
+  if (sw->filling->nof_items == GT_MERGE_WRITER_BATCHSIZE)
+    merge_split_writer_flush(sw);
+  item = sw->filling->items + sw->filling->nof_items++;
+  item->gn = gn;
+  item->partition = partition;
+}
+
+typedef struct {
+  MergeSplitWriter writer;
+  GtStr *dirname,
+        *path;
+  bool retainids;
+  MergePartition *current;
+  GtStr *current_seqid;
+  GtCstrTable *completed_seqids;
+  GtArray *meta_nodes,      /* written to the top of every file */
+          *pending_nodes,   /* comments, written to the next file opened */
+          *region_seqids;   /* in the order of the region nodes */
+  GtHashmap *pending_regions;
+} MergeSplitter;
+
+static void merge_splitter_init(MergeSplitter *ms, GtStr *dirname,
+                                bool retainids)
+{
+  GtUword b;
+  for (b = 0; b < 2UL; b++) {
+    ms->writer.batches[b].items = gt_malloc(sizeof (MergeOutputItem) *
+                                            GT_MERGE_WRITER_BATCHSIZE);
+    ms->writer.batches[b].nof_items = 0;
+  }
+  ms->writer.filling = ms->writer.batches;
+  ms->writer.writing = ms->writer.batches + 1;
+  ms->writer.writer = NULL;
+  ms->writer.had_err = 0;
+  ms->writer.err = gt_error_new();
+  ms->dirname = dirname;
+  ms->path = gt_str_new();
+  ms->retainids = retainids;
+  ms->current = NULL;
+  ms->current_seqid = NULL;
+  ms->completed_seqids = gt_cstr_table_new();
+  ms->meta_nodes = gt_array_new(sizeof (GtGenomeNode*));
+  ms->pending_nodes = gt_array_new(sizeof (GtGenomeNode*));
+  ms->region_seqids = gt_array_new(sizeof (GtStr*));
+  ms->pending_regions = gt_hashmap_new(GT_HASH_STRING, NULL,
+                                       (GtFree) gt_genome_node_delete);
+}
+
+static int merge_splitter_open(MergeSplitter *ms, GtStr *seqid, GtError *err)
+{
+  GtGenomeNode *region;
+  GtFile *outfp;
+  GtUword i;
+  gt_error_check(err);
+  gt_assert(!ms->current);
+  if (strchr(gt_str_get(seqid), '/') || strchr(gt_str_get(seqid), '\\') ||
+      strstr(gt_str_get(seqid), "..")) {
+    gt_error_set(err, "sequence ID \"%s\" cannot be used as a file name "
+                 "(option -splitseqids does not support sequence IDs "
+                 "containing '/', '\\' or \"..\")", gt_str_get(seqid));
+    return -1;
+  }
+  if (gt_cstr_table_get(ms->completed_seqids, gt_str_get(seqid))) {
+    gt_error_set(err, "the output file for sequence ID \"%s\" has already "
+                 "been written", gt_str_get(seqid));
+    return -1;
+  }
+  gt_str_reset(ms->path);
+  gt_str_append_str(ms->path, ms->dirname);
+  gt_str_append_char(ms->path, GT_PATH_SEPARATOR);
+  gt_str_append_str(ms->path, seqid);
+  gt_str_append_cstr(ms->path, ".gff3");
+  if (!(outfp = gt_file_new(gt_str_get(ms->path), "w", err)))
+    return -1;
+  ms->current = gt_malloc(sizeof *ms->current);
+  ms->current->outfp = outfp;
+  ms->current->gff3_visitor = gt_gff3_visitor_new(outfp);
+  if (ms->retainids) {
+    gt_gff3_visitor_retain_id_attributes((GtGFF3Visitor*)
+                                         ms->current->gff3_visitor);
+  }
+  ms->current_seqid = gt_str_ref(seqid);
+  gt_cstr_table_add(ms->completed_seqids, gt_str_get(seqid));
+  for (i = 0; i < gt_array_size(ms->meta_nodes); i++) {
+    GtGenomeNode *meta = *(GtGenomeNode**) gt_array_get(ms->meta_nodes, i);
+    merge_split_writer_add(&ms->writer, gt_genome_node_ref(meta), ms->current);
+  }
+  for (i = 0; i < gt_array_size(ms->pending_nodes); i++) {
+    merge_split_writer_add(&ms->writer,
+                           *(GtGenomeNode**) gt_array_get(ms->pending_nodes, i),
+                           ms->current);
+  }
+  gt_array_reset(ms->pending_nodes);
+  if ((region = gt_hashmap_get(ms->pending_regions, gt_str_get(seqid)))) {
+    gt_genome_node_ref(region);
+    gt_hashmap_remove(ms->pending_regions, gt_str_get(seqid));
+    merge_split_writer_add(&ms->writer, region, ms->current);
+  }
+  return 0;
+}
+
+static void merge_splitter_close(MergeSplitter *ms)
+{
+  if (ms->current) {
+    merge_split_writer_add(&ms->writer, NULL, ms->current);
+    ms->current = NULL;
+    gt_str_delete(ms->current_seqid);
+    ms->current_seqid = NULL;
+  }
+}
+
+/* takes ownership of <gn> */
+static int merge_splitter_add(MergeSplitter *ms, GtGenomeNode *gn,
+                              GtError *err)
+{
+  GtStr *seqid;
+  int had_err = 0;
+  gt_error_check(err);
+  if (gt_meta_node_try_cast(gn)) {
+    gt_array_add(ms->meta_nodes, gn);
+    return 0;
+  }
+  if (gt_sequence_node_try_cast(gn)) {
+    gt_error_set(err, "option -splitseqids does not support FASTA sequences "
+                 "in GFF3 files (sequence \"%s\")",
+                 gt_sequence_node_get_description((GtSequenceNode*) gn));
+    gt_genome_node_delete(gn);
+    return -1;
+  }
+  if (!(seqid = gt_genome_node_get_seqid(gn))) {
+    /* comment nodes are written to the current file */
+    if (ms->current)
+      merge_split_writer_add(&ms->writer, gn, ms->current);
+    else
+      gt_array_add(ms->pending_nodes, gn);
+    return 0;
+  }
+  if (gt_region_node_try_cast(gn) &&
+      (!ms->current || gt_str_cmp(seqid, ms->current_seqid))) {
+    /* region nodes come first, keep them until their file is opened */
+    if (!gt_hashmap_get(ms->pending_regions, gt_str_get(seqid))) {
+      gt_array_add(ms->region_seqids, seqid);
+      gt_str_ref(seqid);
+      gt_hashmap_add(ms->pending_regions, gt_str_get(seqid), gn);
+      return 0;
+    }
+  }
+  if (!ms->current || gt_str_cmp(seqid, ms->current_seqid)) {
+    merge_splitter_close(ms);
+    had_err = merge_splitter_open(ms, seqid, err);
+  }
+  if (!had_err)
+    merge_split_writer_add(&ms->writer, gn, ms->current);
+  else
+    gt_genome_node_delete(gn);
+  return had_err;
+}
+
+/* write the regions without features and wait for the writer thread */
+static int merge_splitter_finish(MergeSplitter *ms, GtError *err)
+{
+  GtUword i;
+  int had_err = 0;
+  gt_error_check(err);
+  for (i = 0; !had_err && i < gt_array_size(ms->region_seqids); i++) {
+    GtStr *seqid = *(GtStr**) gt_array_get(ms->region_seqids, i);
+    if (gt_hashmap_get(ms->pending_regions, gt_str_get(seqid))) {
+      merge_splitter_close(ms);
+      had_err = merge_splitter_open(ms, seqid, err);
+    }
+  }
+  merge_splitter_close(ms);
+  merge_split_writer_flush(&ms->writer);
+  merge_split_writer_wait(&ms->writer);
+  if (!had_err && ms->writer.had_err) {
+    gt_error_set(err, "%s", gt_error_get(ms->writer.err));
+    had_err = ms->writer.had_err;
+  }
+  return had_err;
+}
+
+static void merge_splitter_clean(MergeSplitter *ms)
+{
+  GtUword i, b;
+  merge_splitter_close(ms);
+  /* discard the nodes which have not been written */
+  merge_split_writer_wait(&ms->writer);
+  ms->writer.had_err = -1;
+  merge_split_writer_flush(&ms->writer);
+  merge_split_writer_wait(&ms->writer);
+  for (b = 0; b < 2UL; b++)
+    gt_free(ms->writer.batches[b].items);
+  gt_error_delete(ms->writer.err);
+  for (i = 0; i < gt_array_size(ms->meta_nodes); i++)
+    gt_genome_node_delete(*(GtGenomeNode**) gt_array_get(ms->meta_nodes, i));
+  gt_array_delete(ms->meta_nodes);
+  for (i = 0; i < gt_array_size(ms->pending_nodes); i++) {
+    gt_genome_node_delete(*(GtGenomeNode**)
+                          gt_array_get(ms->pending_nodes, i));
+  }
+  gt_array_delete(ms->pending_nodes);
+  gt_hashmap_delete(ms->pending_regions);
+  for (i = 0; i < gt_array_size(ms->region_seqids); i++)
+    gt_str_delete(*(GtStr**) gt_array_get(ms->region_seqids, i));
+  gt_array_delete(ms->region_seqids);
+  gt_cstr_table_delete(ms->completed_seqids);
+  gt_str_delete(ms->path);
+}
+
+static int merge_split_seqids(GtNodeStream *merge_stream, GtStr *dirname,
+                              bool retainids, GtError *err)
+{
+  MergeSplitter ms;
+  GtGenomeNode *gn;
+  int had_err;
+  gt_error_check(err);
+  merge_splitter_init(&ms, dirname, retainids);
+  while (!(had_err = gt_node_stream_next(merge_stream, &gn, err)) && gn) {
+    if ((had_err = merge_splitter_add(&ms, gn, err)))
+      break;
+  }
+  if (!had_err)
+    had_err = merge_splitter_finish(&ms, err);
+  merge_splitter_clean(&ms);
+  return had_err;
+}
+
 static int gt_merge_runner(int argc, const char **argv, int parsed_args,
                            void *tool_arguments, GtError *err)
 {
@@ -110,20 +473,46 @@ static int gt_merge_runner(int argc, const char **argv, int parsed_args,
      gt_array_add(genome_streams, gff3_in_stream);
    }
 
+  /* parse input files in threads of their own, using at most <gt_jobs> - 1
+     threads besides the merging one (one less with -splitseqids, which needs
+     one for writing) */
+  if (gt_jobs > 1U) {
+    GtUword nof_prefetch = gt_jobs - 1;
+    if (gt_str_length(arguments->splitseqids))
+      nof_prefetch--;
+    nof_prefetch = MIN(nof_prefetch, gt_array_size(genome_streams));
+    for (i = 0; i < nof_prefetch; i++) {
+      GtNodeStream **in_stream = gt_array_get(genome_streams, i),
+                   *prefetch_stream;
+      prefetch_stream = gt_prefetch_stream_new(*in_stream,
+                                               GT_MERGE_PREFETCH_BATCHSIZE);
+      gt_node_stream_delete(*in_stream);
+      *in_stream = prefetch_stream;
+    }
+  }
+
   /* create a merge stream */
   merge_stream = gt_merge_stream_new(genome_streams);
   gt_assert(merge_stream);
 
-  /* create a gff3 output stream */
-  gff3_out_stream = gt_gff3_out_stream_new(merge_stream, arguments->outfp);
-  if (arguments->retainids)
-    gt_gff3_out_stream_retain_id_attributes((GtGFF3OutStream*) gff3_out_stream);
+  if (gt_str_length(arguments->splitseqids)) {
+    had_err = merge_split_seqids(merge_stream, arguments->splitseqids,
+                                 arguments->retainids, err);
+  }
+  else {
+    /* create a gff3 output stream */
+    gff3_out_stream = gt_gff3_out_stream_new(merge_stream, arguments->outfp);
+    if (arguments->retainids) {
+      gt_gff3_out_stream_retain_id_attributes((GtGFF3OutStream*)
+                                              gff3_out_stream);
+    }
 
-  /* pull the features through the stream and free them afterwards */
-  had_err = gt_node_stream_pull(gff3_out_stream, err);
+    /* pull the features through the stream and free them afterwards */
+    had_err = gt_node_stream_pull(gff3_out_stream, err);
+    gt_node_stream_delete(gff3_out_stream);
+  }
 
   /* free */
-  gt_node_stream_delete(gff3_out_stream);
   gt_node_stream_delete(merge_stream);
   for (i = 0; i < gt_array_size(genome_streams); i++)
     gt_node_stream_delete(*(GtNodeStream**) gt_array_get(genome_streams, i));
@@ -137,6 +526,6 @@ GtTool* gt_merge(void)
   return gt_tool_new(gt_merge_arguments_new,
                      gt_merge_arguments_delete,
                      gt_merge_option_parser_new,
-                     NULL,
+                     gt_merge_arguments_check,
                      gt_merge_runner);
 }
@@ -19,6 +19,7 @@
 #include "core/fileutils_api.h"
 #include "core/ma.h"
 #include "core/str_array_api.h"
+#include "core/timer_api.h"
 #include "core/unused_api.h"
 #include "core/xposix.h"
 #include "extended/anno_db_gfflike_api.h"
@@ -47,8 +48,10 @@ typedef struct {
         *database,
         *input;
   int port;
+  GtUword batchsize;
   bool verbose,
-       force;
+       force,
+       bulk;
 } GtMkfeatureindexArguments;
 
 static void* gt_mkfeatureindex_arguments_new(void)
@@ -160,6 +163,18 @@ static GtOptionParser* gt_mkfeatureindex_option_parser_new(void *tool_arguments)
   gt_option_is_mandatory(filenameoption);
 #endif
 
+  /* -bulk */
+  option = gt_option_new_bool("bulk", "load in bulk: commit in batches of "
+                              "rows and create the indexes after loading",
+                              &arguments->bulk, true);
+  gt_option_parser_add_option(op, option);
+
+  /* -batchsize */
+  option = gt_option_new_uword_min("batchsize", "number of rows to insert per "
+                                   "transaction when loading in bulk",
+                                   &arguments->batchsize, 100000, 1);
+  gt_option_parser_add_option(op, option);
+
   option = gt_option_new_verbose(&arguments->verbose);
   gt_option_parser_add_option(op, option);
 
@@ -190,6 +205,8 @@ static int gt_mkfeatureindex_runner(int argc,
   GtRDB *rdb = NULL;
   GtAnnoDBSchema *adb = NULL;
   GtFeatureIndex *fis = NULL;
+  GtTimer *timer = NULL;
+  GtUword nof_rows = 0;
   int had_err = 0;
 
   gt_error_check(err);
@@ -239,6 +256,16 @@ static int gt_mkfeatureindex_runner(int argc,
       had_err = -1;
   }
 
+  if (!had_err && arguments->bulk && arguments->verbose) {
+    timer = gt_timer_new();
+    gt_timer_start(timer);
+  }
+  if (!had_err && arguments->bulk) {
+    had_err = gt_feature_index_gfflike_start_bulk_load(fis,
+                                                       arguments->batchsize,
+                                                       err);
+  }
+
   if (!had_err) {
     if (strcmp(gt_str_get(arguments->input), "gff") == 0)
     {
@@ -264,6 +291,15 @@ static int gt_mkfeatureindex_runner(int argc,
     feature_stream = gt_feature_stream_new(in_stream, fis);
     had_err = gt_node_stream_pull(feature_stream, err);
   }
+  if (!had_err && arguments->bulk) {
+    had_err = gt_feature_index_gfflike_finish_bulk_load(fis, &nof_rows, err);
+    if (!had_err && timer) {
+      double secs = gt_timer_get_elapsed_seconds(timer);
+      printf("# loaded " GT_WU " rows in %.2f seconds (%.0f rows/second)\n",
+             nof_rows, secs, secs > 0 ? nof_rows / secs : 0.0);
+    }
+  }
+  gt_timer_delete(timer);
   gt_node_stream_delete(feature_stream);
   gt_node_stream_delete(in_stream);
   gt_feature_index_delete(fis);
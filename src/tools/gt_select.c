@@ -21,6 +21,7 @@
 #include "core/output_file_api.h"
 #include "core/undef_api.h"
 #include "core/unused_api.h"
+#include "extended/binary_out_stream.h"
 #include "extended/genome_node.h"
 #include "extended/gff3_defines.h"
 #include "extended/gff3_in_stream.h"
@@ -40,7 +41,8 @@ typedef struct {
   bool verbose,
        has_CDS,
        targetbest,
-       retainids;
+       retainids,
+       binary;
   GtStr *seqid,
         *source,
         *gt_strand_char,
@@ -238,7 +240,12 @@ static GtOptionParser* gt_select_option_parser_new(void *tool_arguments)
   option = gt_option_new_filename_array("rule_files",
                                         "specify Lua filter rule files "
                                         "to be used for selection "
-                                        "(terminate list with '--') ",
+                                        "(terminate list with '--')\n"
+                                        "if more than one thread is used "
+                                        "(-j), the rules are evaluated in "
+                                        "parallel in independent Lua states: "
+                                        "nodes are read-only and rules must "
+                                        "not keep state between calls",
                                         arguments->filter_files);
   gt_option_parser_add_option(op, option);
 
@@ -256,6 +263,12 @@ static GtOptionParser* gt_select_option_parser_new(void *tool_arguments)
                                              arguments->dropped_file);
   gt_option_parser_add_option(op, optiondroppedfile);
 
+  /* -binary */
+  option = gt_option_new_bool("binary", "show the selected features in the "
+                              "binary node format instead of GFF3",
+                              &arguments->binary, false);
+  gt_option_parser_add_option(op, option);
+
   /* -v */
   option = gt_option_new_verbose(&arguments->verbose);
   gt_option_parser_add_option(op, option);
@@ -381,13 +394,21 @@ static int gt_select_runner(int argc, const char **argv, int parsed_args,
     if (arguments->targetbest)
       targetbest_select_stream = gt_targetbest_select_stream_new(select_stream);
 
-    /* create a gff3 output stream */
-    gff3_out_stream = gt_gff3_out_stream_new(arguments->targetbest
-                                             ? targetbest_select_stream
-                                             : select_stream,
-                                             arguments->outfp);
+    /* create a gff3 (or binary) output stream */
+    if (arguments->binary) {
+      gff3_out_stream = gt_binary_out_stream_new(arguments->targetbest
+                                                 ? targetbest_select_stream
+                                                 : select_stream,
+                                                 arguments->outfp);
+    }
+    else {
+      gff3_out_stream = gt_gff3_out_stream_new(arguments->targetbest
+                                               ? targetbest_select_stream
+                                               : select_stream,
+                                               arguments->outfp);
+    }
 
-    if (arguments->retainids)
+    if (arguments->retainids && !arguments->binary)
       gt_gff3_out_stream_retain_id_attributes((GtGFF3OutStream*)
                                                                gff3_out_stream);
 
@@ -16,23 +16,34 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <string.h>
+#include "core/arraydef.h"
 #include "core/bioseq.h"
+#include "core/fa.h"
 #include "core/fasta.h"
 #include "core/fileutils_api.h"
+#include "core/intbits.h"
 #include "core/ma.h"
+#include "core/minmax.h"
+#include "core/multithread_api.h"
 #include "core/output_file_api.h"
 #include "core/option_api.h"
 #include "core/progressbar.h"
 #include "core/seq_iterator_sequence_buffer_api.h"
 #include "core/string_distri.h"
+#include "core/thread_api.h"
 #include "core/unused_api.h"
+#include "core/xansi_api.h"
 #include "extended/gtdatahelp.h"
 #include "extended/md5set.h"
 #include "tools/gt_sequniq.h"
 
+#define GT_SEQUNIQ_MAXPARTITIONS      256UL
+#define GT_SEQUNIQ_MAXPARTITIONS_STR  "256"
+
 typedef struct {
   bool seqit, verbose, rev;
-  GtUword width, nofseqs;
+  GtUword width, nofseqs, partitions;
   GtOutputFileInfo *ofi;
   GtFile *outfp;
 } GtSequniqArguments;
@@ -58,7 +69,7 @@ static GtOptionParser* gt_sequniq_option_parser_new(void *tool_arguments)
   GtSequniqArguments *arguments = tool_arguments;
   GtOptionParser *op;
   GtOption *seqit_option, *verbose_option, *width_option, *rev_option,
-           *nofseqs_option;
+           *nofseqs_option, *partitions_option;
   gt_assert(arguments);
 
   op = gt_option_parser_new("[option ...] sequence_file [...] ",
@@ -85,6 +96,18 @@ static GtOptionParser* gt_sequniq_option_parser_new(void *tool_arguments)
       &arguments->rev, false);
   gt_option_parser_add_option(op, rev_option);
 
+  /* -partitions */
+  partitions_option = gt_option_new_uword_min_max("partitions", "split the "
+      "MD5 hashes into the given number of partitions stored in temporary "
+      "files and remove duplicates for each partition separately; this reads "
+      "the input twice but bounds the memory needed for the hashes; at most "
+      GT_SEQUNIQ_MAXPARTITIONS_STR " partitions are allowed, as each keeps a "
+      "temporary file open\n"
+      "default: keep all hashes in memory",
+      &arguments->partitions, 0, 1UL, GT_SEQUNIQ_MAXPARTITIONS);
+  gt_option_hide_default(partitions_option);
+  gt_option_parser_add_option(op, partitions_option);
+
   /* -v */
   verbose_option = gt_option_new_verbose(&arguments->verbose);
   gt_option_parser_add_option(op, verbose_option);
@@ -97,24 +120,511 @@ static GtOptionParser* gt_sequniq_option_parser_new(void *tool_arguments)
 
   /* option implications */
   gt_option_imply(verbose_option, seqit_option);
+  gt_option_exclude(partitions_option, nofseqs_option);
 
   gt_option_parser_set_comment_func(op, gt_gtdata_show_help, NULL);
   gt_option_parser_set_min_args(op, 1U);
   return op;
 }
 
+/* Sequences are read in batches by the main thread. The MD5 hashes of a batch
+   are computed by <gt_jobs> threads, then each thread inserts the hashes
+   belonging to its shards of the <GtMD5Set> in input order, so that the first
+   occurrence of each sequence is kept as in a sequential run. */
+
+#define GT_SEQUNIQ_BATCHSEQUENCES   16384UL
+#define GT_SEQUNIQ_BATCHCHARACTERS  (1UL << 24)
+#define GT_SEQUNIQ_HASHCHUNK        256UL
+
+typedef struct {
+  bool rev;
+  char *sequences,
+       *descriptions;
+  GtUword *seqstartpos,  /* numofsequences + 1 entries */
+          *descstartpos, /* numofsequences + 1 entries */
+          numofsequences,
+          allocatedsequences,
+          allocatedseqchars,
+          allocateddescchars,
+          nextsequence,
+          firsterror;
+  GtMD5SetKeys *keys;
+  GtMD5SetStatus *status;
+  unsigned int *shard,
+               nextshard;
+  GtMD5Set *md5set;
+  GtError *err;
+  GtMutex *mutex;
+} GtSequniqBatch;
+
+static GtSequniqBatch* gt_sequniq_batch_new(GtMD5Set *md5set, bool rev)
+{
+  GtSequniqBatch *batch = gt_calloc((size_t) 1, sizeof *batch);
+
+  batch->rev = rev;
+  batch->md5set = md5set;
+  batch->seqstartpos = gt_calloc((size_t) 1, sizeof *batch->seqstartpos);
+  batch->descstartpos = gt_calloc((size_t) 1, sizeof *batch->descstartpos);
+  batch->err = gt_error_new();
+  batch->mutex = gt_mutex_new();
+  return batch;
+}
+
+static void gt_sequniq_batch_delete(GtSequniqBatch *batch)
+{
+  if (batch == NULL)
+    return;
+  gt_free(batch->sequences);
+  gt_free(batch->descriptions);
+  gt_free(batch->seqstartpos);
+  gt_free(batch->descstartpos);
+  gt_free(batch->keys);
+  gt_free(batch->status);
+  gt_free(batch->shard);
+  gt_error_delete(batch->err);
+  gt_mutex_delete(batch->mutex);
+  gt_free(batch);
+}
+
+static void gt_sequniq_batch_add(GtSequniqBatch *batch, const char *desc,
+                                 const char *seq, GtUword seqlen)
+{
+  GtUword seqstart = batch->seqstartpos[batch->numofsequences],
+          descstart = batch->descstartpos[batch->numofsequences],
+          desclen = desc == NULL ? 0 : (GtUword) strlen(desc);
+
+  if (seqstart + seqlen > batch->allocatedseqchars) {
+    batch->allocatedseqchars = MAX(seqstart + seqlen,
+                                   GT_SEQUNIQ_BATCHCHARACTERS);
+    batch->sequences = gt_realloc(batch->sequences,
+                                  sizeof *batch->sequences
+                                  * batch->allocatedseqchars);
+  }
+  if (descstart + desclen + 1 > batch->allocateddescchars) {
+    batch->allocateddescchars = descstart + desclen + 1 +
+                                batch->allocateddescchars / 2;
+    batch->descriptions = gt_realloc(batch->descriptions,
+                                     sizeof *batch->descriptions
+                                     * batch->allocateddescchars);
+  }
+  if (batch->numofsequences == batch->allocatedsequences) {
+    batch->allocatedsequences += GT_SEQUNIQ_BATCHSEQUENCES;
+    batch->seqstartpos = gt_realloc(batch->seqstartpos,
+                                    sizeof *batch->seqstartpos
+                                    * (batch->allocatedsequences + 1));
+    batch->descstartpos = gt_realloc(batch->descstartpos,
+                                     sizeof *batch->descstartpos
+                                     * (batch->allocatedsequences + 1));
+    batch->keys = gt_realloc(batch->keys, sizeof *batch->keys
+                                          * batch->allocatedsequences);
+    batch->status = gt_realloc(batch->status, sizeof *batch->status
+                                              * batch->allocatedsequences);
+    batch->shard = gt_realloc(batch->shard, sizeof *batch->shard
+                                            * batch->allocatedsequences);
+  }
+  memcpy(batch->sequences + seqstart, seq, sizeof *seq * seqlen);
+  if (desclen > 0)
+    memcpy(batch->descriptions + descstart, desc, sizeof *desc * desclen);
+  batch->descriptions[descstart + desclen] = '\0';
+  batch->numofsequences++;
+  batch->seqstartpos[batch->numofsequences] = seqstart + seqlen;
+  batch->descstartpos[batch->numofsequences] = descstart + desclen + 1;
+}
+
+static bool gt_sequniq_batch_is_full(const GtSequniqBatch *batch)
+{
+  return batch->numofsequences >= GT_SEQUNIQ_BATCHSEQUENCES ||
+         batch->seqstartpos[batch->numofsequences] >=
+           GT_SEQUNIQ_BATCHCHARACTERS;
+}
+
+#define GT_SEQUNIQ_BATCH_SEQ(BATCH, IDX) \
+        ((BATCH)->sequences + (BATCH)->seqstartpos[IDX])
+
+#define GT_SEQUNIQ_BATCH_SEQLEN(BATCH, IDX) \
+        ((BATCH)->seqstartpos[(IDX) + 1] - (BATCH)->seqstartpos[IDX])
+
+#define GT_SEQUNIQ_BATCH_DESC(BATCH, IDX) \
+        ((BATCH)->descriptions + (BATCH)->descstartpos[IDX])
+
+static void *gt_sequniq_batch_hash_thread(void *data)
+{
+  GtSequniqBatch *batch = data;
+  GtError *err = gt_error_new();
+  char *buffer = NULL;
+  GtUword bufsize = 0;
+  unsigned int nof_shards = batch->md5set == NULL
+                            ? 1U
+                            : gt_md5set_number_of_shards(batch->md5set);
+  bool stop = false;
+
+  while (!stop) {
+    GtUword idx, first, last;
+
+    gt_mutex_lock(batch->mutex);
+    first = batch->nextsequence;
+    batch->nextsequence = MIN(first + GT_SEQUNIQ_HASHCHUNK,
+                              batch->numofsequences);
+    last = batch->nextsequence;
+    stop = first >= batch->firsterror;
+    gt_mutex_unlock(batch->mutex);
+    if (stop || first >= last)
+      break;
+    for (idx = first; idx < last; idx++) {
+      if (gt_md5set_hash_sequence(batch->keys + idx,
+                                  GT_SEQUNIQ_BATCH_SEQ(batch, idx),
+                                  GT_SEQUNIQ_BATCH_SEQLEN(batch, idx),
+                                  batch->rev, &buffer, &bufsize, err) != 0) {
+        gt_mutex_lock(batch->mutex);
+        if (idx < batch->firsterror) {
+          batch->firsterror = idx;
+          gt_error_set(batch->err, "%s", gt_error_get(err));
+        }
+        gt_mutex_unlock(batch->mutex);
+        gt_error_unset(err);
+        stop = true;
+        break;
+      }
+      batch->shard[idx] = nof_shards == 1U
+                          ? 0
+                          : (unsigned int)
+                            gt_md5set_keys_partition(batch->keys + idx,
+                                                     nof_shards);
+    }
+  }
+  gt_free(buffer);
+  gt_error_delete(err);
+  return NULL;
+}
+
+static void *gt_sequniq_batch_insert_thread(void *data)
+{
+  GtSequniqBatch *batch = data;
+  unsigned int nof_shards = gt_md5set_number_of_shards(batch->md5set);
+
+  while (true) {
+    GtUword idx;
+    unsigned int shard;
+
+    gt_mutex_lock(batch->mutex);
+    shard = batch->nextshard++;
+    gt_mutex_unlock(batch->mutex);
+    if (shard >= nof_shards)
+      break;
+    for (idx = 0; idx < batch->firsterror; idx++) {
+      if (batch->shard[idx] == shard)
+        batch->status[idx] = gt_md5set_add_keys(batch->md5set,
+                                                batch->keys + idx);
+    }
+  }
+  return NULL;
+}
+
+/* Computes the hashes of all sequences of <batch> and, if it has a
+   <GtMD5Set>, adds them to it. Returns the number of sequences hashed before
+   the first error. */
+static GtUword gt_sequniq_batch_hash(GtSequniqBatch *batch, GtError *err)
+{
+  batch->nextsequence = 0;
+  batch->firsterror = batch->numofsequences;
+  if (gt_multithread(gt_sequniq_batch_hash_thread, batch, err) != 0)
+    return 0;
+  if (batch->md5set != NULL) {
+    batch->nextshard = 0;
+    if (gt_multithread(gt_sequniq_batch_insert_thread, batch, err) != 0)
+      return 0;
+  }
+  return batch->firsterror;
+}
+
+static void gt_sequniq_batch_reset(GtSequniqBatch *batch)
+{
+  batch->numofsequences = 0;
+}
+
+static int gt_sequniq_batch_process(GtSequniqBatch *batch,
+                                    GtSequniqArguments *arguments,
+                                    GtUint64 *duplicates,
+                                    GtUint64 *num_of_sequences,
+                                    GtError *err)
+{
+  GtUword idx, numofhashed;
+
+  gt_error_check(err);
+  numofhashed = gt_sequniq_batch_hash(batch, err);
+  if (gt_error_is_set(err))
+    return -1;
+  for (idx = 0; idx < numofhashed; idx++) {
+    if (batch->status[idx] == GT_MD5SET_NOT_FOUND)
+      gt_fasta_show_entry(GT_SEQUNIQ_BATCH_DESC(batch, idx),
+                          GT_SEQUNIQ_BATCH_SEQ(batch, idx),
+                          GT_SEQUNIQ_BATCH_SEQLEN(batch, idx),
+                          arguments->width, arguments->outfp);
+    else
+      (*duplicates)++;
+    (*num_of_sequences)++;
+  }
+  if (numofhashed < batch->numofsequences) {
+    gt_error_set(err, "%s", gt_error_get(batch->err));
+    return -1;
+  }
+  gt_sequniq_batch_reset(batch);
+  return 0;
+}
+
+/* In the partitioned mode the first pass over the input writes, for each
+   sequence, its number and MD5 hashes to the temporary file of its partition.
+   The partitions are then processed independently by <gt_jobs> threads, each
+   with its own <GtMD5Set> sized for the partition, marking the duplicates in a
+   bit table. The second pass over the input outputs the unmarked sequences. */
+
+typedef struct {
+  GtUword seqnum;
+  GtMD5SetKeys keys;
+} GtSequniqRecord;
+
+#define GT_SEQUNIQ_RECORDBUFSIZE 4096UL
+
+typedef struct {
+  GtUword nof_partitions,
+          nextpartition,
+          *counts,
+          numofduplicates;
+  FILE **fps;
+  GtStr **filenames;
+  GtBitsequence *duplicates;
+  GtMutex *mutex;
+  GtError *err;
+} GtSequniqPartitions;
+
+static GtSequniqPartitions* gt_sequniq_partitions_new(GtUword nof_partitions)
+{
+  GtUword p;
+  GtSequniqPartitions *parts = gt_calloc((size_t) 1, sizeof *parts);
+
+  parts->nof_partitions = nof_partitions;
+  parts->counts = gt_calloc((size_t) nof_partitions, sizeof *parts->counts);
+  parts->fps = gt_malloc(sizeof *parts->fps * nof_partitions);
+  parts->filenames = gt_malloc(sizeof *parts->filenames * nof_partitions);
+  for (p = 0; p < nof_partitions; p++) {
+    parts->filenames[p] = gt_str_new();
+    parts->fps[p] = gt_xtmpfp(parts->filenames[p]);
+  }
+  parts->mutex = gt_mutex_new();
+  parts->err = gt_error_new();
+  return parts;
+}
+
+static void gt_sequniq_partitions_delete(GtSequniqPartitions *parts)
+{
+  GtUword p;
+
+  if (parts == NULL)
+    return;
+  for (p = 0; p < parts->nof_partitions; p++) {
+    gt_fa_xfclose(parts->fps[p]);
+    gt_xremove(gt_str_get(parts->filenames[p]));
+    gt_str_delete(parts->filenames[p]);
+  }
+  gt_free(parts->fps);
+  gt_free(parts->filenames);
+  gt_free(parts->counts);
+  gt_free(parts->duplicates);
+  gt_mutex_delete(parts->mutex);
+  gt_error_delete(parts->err);
+  gt_free(parts);
+}
+
+static void gt_sequniq_partitions_store(GtSequniqPartitions *parts,
+                                        const GtSequniqBatch *batch,
+                                        GtUword numofhashed,
+                                        GtUword firstseqnum)
+{
+  GtUword idx;
+
+  for (idx = 0; idx < numofhashed; idx++) {
+    GtSequniqRecord record;
+    GtUword p = gt_md5set_keys_partition(batch->keys + idx,
+                                         parts->nof_partitions);
+
+    record.seqnum = firstseqnum + idx;
+    record.keys = batch->keys[idx];
+    gt_xfwrite_one(&record, parts->fps[p]);
+    parts->counts[p]++;
+  }
+}
+
+static void *gt_sequniq_partitions_thread(void *data)
+{
+  GtSequniqPartitions *parts = data;
+  GtSequniqRecord *records = gt_malloc(sizeof *records *
+                                       GT_SEQUNIQ_RECORDBUFSIZE);
+  GtArrayGtUword duplicates;
+
+  GT_INITARRAY(&duplicates, GtUword);
+  while (true) {
+    GtUword p, idx, remaining;
+    GtMD5Set *md5set;
+
+    gt_mutex_lock(parts->mutex);
+    p = gt_error_is_set(parts->err) ? parts->nof_partitions
+                                    : parts->nextpartition++;
+    gt_mutex_unlock(parts->mutex);
+    if (p >= parts->nof_partitions)
+      break;
+    md5set = gt_md5set_new(parts->counts[p]);
+    gt_xfseek(parts->fps[p], 0, SEEK_SET);
+    for (remaining = parts->counts[p]; remaining > 0; /* Nothing */) {
+      GtUword toread = MIN(remaining, GT_SEQUNIQ_RECORDBUFSIZE);
+
+      if (gt_xfread(records, sizeof *records, (size_t) toread,
+                    parts->fps[p]) != (size_t) toread) {
+        gt_mutex_lock(parts->mutex);
+        if (!gt_error_is_set(parts->err))
+          gt_error_set(parts->err, "unexpected end of temporary file %s",
+                       gt_str_get(parts->filenames[p]));
+        gt_mutex_unlock(parts->mutex);
+        break;
+      }
+      for (idx = 0; idx < toread; idx++) {
+        if (gt_md5set_add_keys(md5set, &records[idx].keys)
+              != GT_MD5SET_NOT_FOUND)
+          GT_STOREINARRAY(&duplicates, GtUword, 1024, records[idx].seqnum);
+      }
+      remaining -= toread;
+    }
+    gt_md5set_delete(md5set);
+    if (remaining > 0)
+      break;
+    gt_mutex_lock(parts->mutex);
+    for (idx = 0; idx < duplicates.nextfreeGtUword; idx++)
+      GT_SETIBIT(parts->duplicates, duplicates.spaceGtUword[idx]);
+    parts->numofduplicates += duplicates.nextfreeGtUword;
+    gt_mutex_unlock(parts->mutex);
+    duplicates.nextfreeGtUword = 0;
+  }
+  GT_FREEARRAY(&duplicates, GtUword);
+  gt_free(records);
+  return NULL;
+}
+
+static int gt_sequniq_partitioned(GtStrArray *files,
+                                  GtSequniqArguments *arguments,
+                                  GtUint64 *duplicates,
+                                  GtUint64 *num_of_sequences,
+                                  GtError *err)
+{
+  GtSequniqPartitions *parts;
+  GtSequniqBatch *batch;
+  GtSeqIterator *seqit;
+  const GtUchar *sequence;
+  char *desc;
+  GtUword idx, len, numofseqs = 0;
+  int had_err = 0, rval;
+
+  gt_error_check(err);
+  for (idx = 0; idx < gt_str_array_size(files); idx++) {
+    if (strcmp(gt_str_array_get(files, idx), "-") == 0) {
+      gt_error_set(err, "option -partitions reads the input twice and cannot "
+                        "be used with standard input");
+      return -1;
+    }
+  }
+  if (!(seqit = gt_seq_iterator_sequence_buffer_new(files, err)))
+    return -1;
+  parts = gt_sequniq_partitions_new(arguments->partitions);
+  batch = gt_sequniq_batch_new(NULL, arguments->rev);
+
+  /* first pass: hash and partition */
+  while (!had_err) {
+    rval = gt_seq_iterator_next(seqit, &sequence, &len, &desc, err);
+    if (rval == 1)
+      gt_sequniq_batch_add(batch, NULL, (const char*) sequence, len);
+    else if (rval < 0)
+      had_err = -1;
+    if (!had_err && batch->numofsequences > 0 &&
+        (rval != 1 || gt_sequniq_batch_is_full(batch))) {
+      GtUword numofhashed = gt_sequniq_batch_hash(batch, err);
+      if (gt_error_is_set(err))
+        had_err = -1;
+      else {
+        gt_sequniq_partitions_store(parts, batch, numofhashed, numofseqs);
+        numofseqs += numofhashed;
+        if (numofhashed < batch->numofsequences) {
+          gt_error_set(err, "%s", gt_error_get(batch->err));
+          had_err = -1;
+        }
+      }
+      gt_sequniq_batch_reset(batch);
+    }
+    if (rval != 1)
+      break;
+  }
+  gt_sequniq_batch_delete(batch);
+  gt_seq_iterator_delete(seqit);
+
+  /* deduplicate the partitions */
+  if (!had_err) {
+    GT_INITBITTAB(parts->duplicates, numofseqs + 1);
+    for (idx = 0; idx < parts->nof_partitions; idx++)
+      gt_xfflush(parts->fps[idx]);
+    had_err = gt_multithread(gt_sequniq_partitions_thread, parts, err);
+    if (!had_err && gt_error_is_set(parts->err)) {
+      gt_error_set(err, "%s", gt_error_get(parts->err));
+      had_err = -1;
+    }
+  }
+
+  /* second pass: output the first occurrences */
+  if (!had_err) {
+    if (!(seqit = gt_seq_iterator_sequence_buffer_new(files, err)))
+      had_err = -1;
+    for (idx = 0; !had_err; idx++) {
+      rval = gt_seq_iterator_next(seqit, &sequence, &len, &desc, err);
+      if (rval < 0)
+        had_err = -1;
+      if (rval != 1)
+        break;
+      gt_assert(idx < numofseqs);
+      if (!GT_ISIBITSET(parts->duplicates, idx))
+        gt_fasta_show_entry(desc, (const char*) sequence, len,
+                            arguments->width, arguments->outfp);
+    }
+    gt_assert(had_err || idx == numofseqs);
+    gt_seq_iterator_delete(seqit);
+  }
+  if (!had_err) {
+    *duplicates = (GtUint64) parts->numofduplicates;
+    *num_of_sequences = (GtUint64) numofseqs;
+  }
+  gt_sequniq_partitions_delete(parts);
+  return had_err;
+}
+
 static int gt_sequniq_runner(int argc, const char **argv, int parsed_args,
                              void *tool_arguments, GtError *err)
 {
   GtSequniqArguments *arguments = tool_arguments;
   GtUint64 duplicates = 0, num_of_sequences = 0;
   int i, had_err = 0;
-  GtMD5Set *md5set;
+  GtMD5Set *md5set = NULL;
+  GtSequniqBatch *batch = NULL;
 
   gt_error_check(err);
   gt_assert(arguments);
-  md5set = gt_md5set_new(arguments->nofseqs);
-  if (!arguments->seqit) {
+  if (arguments->partitions == 0) {
+    md5set = gt_md5set_new_sharded(arguments->nofseqs, MAX(gt_jobs, 1U));
+    batch = gt_sequniq_batch_new(md5set, arguments->rev);
+  }
+  if (arguments->partitions > 0) {
+    GtStrArray *files = gt_str_array_new();
+    for (i = parsed_args; i < argc; i++)
+      gt_str_array_add_cstr(files, argv[i]);
+    had_err = gt_sequniq_partitioned(files, arguments, &duplicates,
+                                     &num_of_sequences, err);
+    gt_str_array_delete(files);
+  }
+  else if (!arguments->seqit) {
     GtUword j;
     GtBioseq *bs;
 
@@ -122,23 +632,18 @@ static int gt_sequniq_runner(int argc, const char **argv, int parsed_args,
       if (!(bs = gt_bioseq_new(argv[i], err)))
         had_err = -1;
       if (!had_err) {
-        GtMD5SetStatus retval;
         for (j = 0; j < gt_bioseq_number_of_sequences(bs) && !had_err; j++) {
           char *seq = gt_bioseq_get_sequence(bs, j);
-          retval = gt_md5set_add_sequence(md5set, seq,
-                                          gt_bioseq_get_sequence_length(bs, j),
-                                          arguments->rev, err);
-          if (retval == GT_MD5SET_NOT_FOUND)
-            gt_fasta_show_entry(gt_bioseq_get_description(bs, j), seq,
-                                gt_bioseq_get_sequence_length(bs, j),
-                                arguments->width, arguments->outfp);
-          else if (retval != GT_MD5SET_ERROR)
-            duplicates++;
-          else
-            had_err = -1;
-          num_of_sequences++;
+          gt_sequniq_batch_add(batch, gt_bioseq_get_description(bs, j), seq,
+                               gt_bioseq_get_sequence_length(bs, j));
           gt_free(seq);
+          if (gt_sequniq_batch_is_full(batch))
+            had_err = gt_sequniq_batch_process(batch, arguments, &duplicates,
+                                               &num_of_sequences, err);
         }
+        if (!had_err)
+          had_err = gt_sequniq_batch_process(batch, arguments, &duplicates,
+                                             &num_of_sequences, err);
         gt_bioseq_delete(bs);
       }
     }
@@ -165,20 +670,18 @@ static int gt_sequniq_runner(int argc, const char **argv, int parsed_args,
                              (GtUint64) totalsize);
       }
       while (!had_err) {
-        GtMD5SetStatus retval;
-        if ((gt_seq_iterator_next(seqit, &sequence, &len, &desc, err)) != 1)
-          break;
-
-        retval = gt_md5set_add_sequence(md5set, (const char*) sequence, len,
-                                        arguments->rev, err);
-        if (retval == GT_MD5SET_NOT_FOUND)
-          gt_fasta_show_entry(desc, (const char*) sequence, len,
-                              arguments->width, arguments->outfp);
-        else if (retval != GT_MD5SET_ERROR)
-          duplicates++;
-        else
+        int rval = gt_seq_iterator_next(seqit, &sequence, &len, &desc, err);
+        if (rval < 0) {
           had_err = -1;
-        num_of_sequences++;
+          break;
+        }
+        if (rval == 1)
+          gt_sequniq_batch_add(batch, desc, (const char*) sequence, len);
+        if (rval != 1 || gt_sequniq_batch_is_full(batch))
+          had_err = gt_sequniq_batch_process(batch, arguments, &duplicates,
+                                             &num_of_sequences, err);
+        if (rval != 1)
+          break;
       }
       if (arguments->verbose)
         gt_progressbar_stop();
@@ -195,6 +698,7 @@ static int gt_sequniq_runner(int argc, const char **argv, int parsed_args,
             ((double) duplicates / (double)num_of_sequences) * 100.0);
   }
 
+  gt_sequniq_batch_delete(batch);
   gt_md5set_delete(md5set);
   return had_err;
 }
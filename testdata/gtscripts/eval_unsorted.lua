@@ -0,0 +1,44 @@
+--[[
+  Copyright (c) 2014 Center for Bioinformatics, University of Hamburg
+
+  Permission to use, copy, modify, and distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+]]
+
+-- evaluate streams whose genes are not sorted by sequence id, which the GFF3
+-- input streams would already reject
+
+function unsorted_stream()
+  local cs = gt.custom_stream_new_unsorted()
+  cs.seqids = { "seq2", "seq2", "seq1", "seq1" }
+  cs.count = 1
+  function cs:next_tree()
+    local seqid = cs.seqids[cs.count]
+    if not seqid then
+      return nil
+    end
+    cs.count = cs.count + 1
+    if cs.count % 2 == 0 then
+      return gt.region_node_new(seqid, 1, 1000)
+    end
+    local gene = gt.feature_node_new(seqid, "gene", 100, 500, "+")
+    gene:add_child(gt.feature_node_new(seqid, "exon", 100, 200, "+"))
+    gene:add_child(gt.feature_node_new(seqid, "exon", 300, 500, "+"))
+    return gene
+  end
+  return cs
+end
+
+stream_evaluator = gt.stream_evaluator_new(unsorted_stream(),
+                                           unsorted_stream())
+stream_evaluator:evaluate()
+stream_evaluator:show()
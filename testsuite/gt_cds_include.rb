@@ -9,6 +9,16 @@
   end
 end
 
+Name "gt cds (binary pipeline)"
+Keywords "gt_cds binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary #{$testdata}gt_cds_test_1.in | " +
+           "#{$bin}gt cds -binary -minorflen 1 -startcodon yes " +
+           "-seqfile #{$testdata}gt_cds_test_1.fas -matchdesc - | " +
+           "#{$bin}gt select -binary - | #{$bin}gt gff3 -"
+  run "diff #{last_stdout} #{$testdata}gt_cds_test_1.out"
+end
+
 Name "gt cds error message"
 Keywords "gt_cds"
 Test do
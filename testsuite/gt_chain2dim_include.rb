@@ -78,3 +78,49 @@ params = ["-global",
 	  "-local 20 -wf 1.8 -maxgap 10"]
 
 runchain2dimall(params,"#{$testdata}ecolicmp250.of")
+
+params.each do |args|
+  Name "gt chain2dim -sparse #{args}"
+  Keywords "gt_chain2dim sparse"
+  Test do
+    run_test "#{$bin}gt chain2dim -m #{$testdata}ecolicmp250.of " + args
+    run "mv #{last_stdout} chains.txt"
+    run_test "#{$bin}gt chain2dim -sparse -m #{$testdata}ecolicmp250.of " +
+             args
+    run "cmp -s #{last_stdout} chains.txt"
+  end
+end
+
+Name "gt chain2dim -ii"
+Keywords "gt_chain2dim maxpairs"
+Test do
+  run_test "#{$bin}gt suffixerator -db #{$testdata}Atinsert.fna " +
+           "-indexname sfx -dna -suf -lcp -tis"
+  # the reference: the matches of repfind with absolute positions (the
+  # sequences are separated by one position) and their length as weight
+  seqstarts = []
+  totallength = 0
+  File.read("#{$testdata}Atinsert.fna").split(/^>/).drop(1).each do |entry|
+    seqstarts.push(totallength)
+    totallength += entry.lines.drop(1).map { |l| l.chomp.length }.sum + 1
+  end
+  run_test "#{$bin}gt repfind -l 20 -ii sfx"
+  File.open("matches.txt", "w") do |f|
+    File.readlines(last_stdout).each do |line|
+      len, seq1, pos1, _, _, seq2, pos2 = line.split.map { |v| v.to_i }
+      pos = [seqstarts[seq1] + pos1, seqstarts[seq2] + pos2].sort
+      f.puts "#{pos[0]} #{pos[0] + len - 1} #{pos[1]} #{pos[1] + len - 1} " +
+             "#{len}"
+    end
+  end
+  ["-global","-local","-global gc -wf 1.5"].each do |args|
+    run_test "#{$bin}gt chain2dim -m matches.txt " + args
+    run "mv #{last_stdout} chains.txt"
+    run_test "#{$bin}gt chain2dim -ii sfx -l 20 " + args
+    run "cmp -s #{last_stdout} chains.txt"
+    run_test "#{$bin}gt chain2dim -sparse -ii sfx -l 20 " + args
+    run "cmp -s #{last_stdout} chains.txt"
+  end
+  run_test "#{$bin}gt chain2dim -l 20 -m #{$testdata}ecolicmp250.of",
+           :retval => 1
+end
@@ -129,6 +129,74 @@ opt_arr.each do |opt|
   end
 end
 
+opt_arr.each do |opt|
+  Name "gt condenser compress + native search #{opt}"
+  Keywords "gt_condenser compress search native"
+  Test do
+    searchfiles.each_pair do |file, info|
+      basename = File.basename(file)
+      queries = "#{File.join(File.dirname(file),
+                             File.basename(file,'.fas'))}_queries_300_2x"
+      run_test "#{$bin}gt encseq encode -clipdesc -indexname #{basename} " \
+        "-md5 no " \
+        "#{file}"
+      run_test "#{$bin}gt condenser compress " \
+        "#{opt} " \
+        "-indexname #{basename}_nr " \
+        "-alignlength #{info[0]} #{basename}",
+        :maxtime => 600
+      run_test "#{$bin}gt -debug condenser search -native " \
+        "-query #{queries}.fas -db #{basename}_nr -verbose " \
+        "> #{basename}_native_hits",
+        :maxtime => 600
+      grep(last_stderr, /stored k-mer index/)
+      grep(last_stderr, /debug: [1-9]+[0-9]* hits found/)
+      run_ruby "#$scriptsdir/condenser_statistics.rb " \
+        "#{queries}_blastn_result #{basename}_native_hits"
+      grep(last_stdout, /^## FP: 0$/)
+      grep(last_stdout, /^## TP: [1-9]+[0-9]*$/)
+      run_test "#{$bin}gt -j 4 condenser search -native -batchlength 1000 " \
+        "-query #{queries}.fas -db #{basename}_nr -verbose " \
+        "> #{basename}_native_hits_j4",
+        :maxtime => 600
+      grep(last_stderr, /read k-mer index/)
+      run "diff #{basename}_native_hits #{basename}_native_hits_j4"
+      # with 14-mer seeds the coarse search can miss links of low identity,
+      # short seeds find all hits of the search on the uncondensed database
+      run_test "#{$bin}gt condenser search -native -kmersize 8 " \
+        "-query #{queries}.fas -db #{basename}_nr " \
+        "> #{basename}_native_hits_k8",
+        :maxtime => 600
+      run_ruby "#$scriptsdir/condenser_statistics.rb " \
+        "#{queries}_blastn_result #{basename}_native_hits_k8"
+      grep(last_stdout, /^## FN: 0$/)
+      grep(last_stdout, /^## TP: [1-9]+[0-9]*$/)
+    end
+  end
+end
+
+Name "gt condenser native search without writable k-mer index"
+Keywords "gt_condenser search native"
+Test do
+  file = searchfiles.keys.first
+  basename = File.basename(file)
+  queries = "#{File.join(File.dirname(file),
+                         File.basename(file,'.fas'))}_queries_300_2x"
+  run_test "#{$bin}gt encseq encode -clipdesc -indexname #{basename} " \
+    "-md5 no #{file}"
+  run_test "#{$bin}gt condenser compress -indexname #{basename}_nr " \
+    "-alignlength #{searchfiles[file][0]} #{basename}",
+    :maxtime => 600
+  run "ln -s nonexistent_dir/index #{basename}_nr.kmi"
+  run_test "#{$bin}gt condenser search -native -query #{queries}.fas " \
+    "-db #{basename}_nr > #{basename}_native_hits",
+    :maxtime => 600
+  grep(last_stderr, /k-mer index is not stored/)
+  run_ruby "#$scriptsdir/condenser_statistics.rb " \
+    "#{queries}_blastn_result #{basename}_native_hits"
+  grep(last_stdout, /^## TP: [1-9]+[0-9]*$/)
+end
+
 range_ext = Proc.new do |file, info, opt|
   basename = File.basename(file)
   run_test "#{$bin}gt encseq encode -clipdesc -indexname #{basename} " \
@@ -54,6 +54,27 @@ Test do
   grep(last_stderr, /cannot open file.*ois/)
 end
 
+Name "gt encseq encode -parallelinput"
+Keywords "encseq gt_encseq_encode parallelinput"
+Test do
+  [["-dna -lossless", ["Atinsert.fna", "RandomN.fna", "TTTN.fna",
+                       "Duplicate.fna"]],
+   ["-protein", ["sw100K1.fsa", "sw100K2.fsa"]]].each do |opts, files|
+    inputs = files.map { |f| "#{$testdata}#{f}" }.join(" ")
+    run_test "#{$bin}gt encseq encode #{opts} -indexname seq #{inputs}"
+    [1, 4].each do |jobs|
+      run_test "#{$bin}gt -j #{jobs} encseq encode #{opts} -parallelinput " + \
+               "-indexname par#{jobs} #{inputs}"
+      ["esq", "ssp", "des", "sds"].each do |suffix|
+        run "cmp seq.#{suffix} par#{jobs}.#{suffix}"
+      end
+      if opts.include?("-lossless")
+        run "cmp seq.ois par#{jobs}.ois"
+      end
+    end
+  end
+end
+
 STDREADMODES  = ["fwd", "rev"]
 DNAREADMODES  = STDREADMODES + ["cpl", "rcl"]
 DNATESTSEQS   = ["#{$testdata}foobar.fas",
@@ -442,3 +463,40 @@ Test do
     end
   end
 end
+
+Name "gt encseq bench suite"
+Keywords "encseq gt_encseq bench"
+Test do
+  checksums = nil
+  ["direct", "bit", "uchar", "ushort", "uint32"].each do |sat|
+    run_test "#{$bin}gt encseq encode -sat #{sat} -indexname foo " + \
+             "#{$testdata}Atinsert.fna"
+    run_test "#{$bin}gt -j 2 encseq bench -suite -trials 1000 foo"
+    rows = File.readlines(last_stdout).reject { |l| l =~ /^#/ }
+    # the checksums must not depend on the representation
+    sums = rows.map { |l| f = l.chomp.split("\t"); [f[0], f[2], f[10]] }
+    if sums.length != 15 then
+      raise "expected 15 benchmarks, got #{sums.length} for sat #{sat}"
+    end
+    if checksums.nil? then
+      checksums = sums
+    elsif checksums != sums then
+      raise "checksums for sat #{sat} differ from those for sat direct"
+    end
+  end
+end
+
+# -scantrials also compares the ranges extracted in all read modes with
+# random access
+["Atinsert.fna", "RandomN.fna"].each do |file|
+  Name "gt encseq check -scantrials #{file}"
+  Keywords "encseq gt_encseq_check extractrange"
+  Test do
+    ["direct", "bit", "uchar", "ushort", "uint32"].each do |sat|
+      run_test "#{$bin}gt encseq encode -sat #{sat} -indexname foo " + \
+               "#{$testdata}#{file}"
+      run_test "#{$bin}gt encseq check -scantrials 200 foo"
+      run_test "#{$bin}gt encseq check -mirrored -scantrials 200 foo"
+    end
+  end
+end
@@ -110,3 +110,74 @@ if $gttestdata then
     run "diff #{last_stdout} #{$gttestdata}eval/gth_analysis_rate_10_minscr_0.85.txt"
   end
 end
+
+Name "gt -j 4 eval test 1"
+Keywords "gt_eval jobs"
+Test do
+  run_test "#{$bin}gt -j 4 eval #{$testdata}gt_eval_test_1.in #{$testdata}gt_eval_test_1.in"
+  run "diff #{last_stdout} #{$testdata}gt_eval_test_1.out"
+end
+
+2.upto(8) do |i|
+  Name "gt -j 4 eval test #{i}"
+  Keywords "gt_eval jobs"
+  Test do
+    run_test "#{$bin}gt -j 4 eval #{$testdata}gt_eval_test_#{i}.reality #{$testdata}gt_eval_test_#{i}.prediction"
+    run "diff #{last_stdout} #{$testdata}gt_eval_test_#{i}.nuc"
+    run_test "#{$bin}gt -j 4 eval -nuc no #{$testdata}gt_eval_test_#{i}.reality #{$testdata}gt_eval_test_#{i}.prediction"
+    run "diff #{last_stdout} #{$testdata}gt_eval_test_#{i}.out"
+  end
+end
+
+9.upto(10) do |i|
+  Name "gt -j 4 eval test #{i}"
+  Keywords "gt_eval jobs"
+  Test do
+    run_test "#{$bin}gt -j 4 eval #{$testdata}gt_eval_test_#{i}.in #{$testdata}gt_eval_test_#{i}.in"
+    run "diff #{last_stdout} #{$testdata}gt_eval_test_#{i}.out"
+  end
+end
+
+Name "gt -j 4 eval prob 1"
+Keywords "gt_eval jobs"
+Test do
+  run_test "#{$bin}gt -j 4 eval -nuc no #{$testdata}gt_eval_prob_1.reality #{$testdata}gt_eval_prob_1.prediction"
+  run "diff #{last_stdout} #{$testdata}gt_eval_prob_1.out"
+  run_test "#{$bin}gt -j 4 eval -nuc no #{$testdata}gt_eval_prob_1.prediction #{$testdata}gt_eval_prob_1.reality"
+  run "diff #{last_stdout} #{$testdata}gt_eval_prob_1.out_swapped"
+end
+
+1.upto(9) do |i|
+  Name "gt -j 4 eval -ltr test #{i}"
+  Keywords "gt_eval jobs"
+  Test do
+    if i == 1 then
+      run_test "#{$bin}gt -j 4 eval -ltr #{$testdata}gt_eval_ltr_test_1.in #{$testdata}gt_eval_ltr_test_1.in"
+    else
+      run_test "#{$bin}gt -j 4 eval -ltr #{$testdata}gt_eval_ltr_test_#{i}.reality #{$testdata}gt_eval_ltr_test_#{i}.prediction"
+    end
+    run "diff #{last_stdout} #{$testdata}gt_eval_ltr_test_#{i}.out"
+  end
+end
+
+Name "gt -j 4 eval (multiple sequence regions)"
+Keywords "gt_eval jobs"
+Test do
+  run "#{$bin}gt select -strand + " + \
+      "#{$testdata}encode_known_genes_Mar07.gff3 > prediction.gff3"
+  run_test "#{$bin}gt eval #{$testdata}encode_known_genes_Mar07.gff3 " + \
+           "prediction.gff3 > eval_j1.out"
+  run_test "#{$bin}gt -j 4 eval #{$testdata}encode_known_genes_Mar07.gff3 " + \
+           "prediction.gff3 > eval_j4.out"
+  run "diff eval_j1.out eval_j4.out"
+end
+
+Name "gt eval streams not sorted by sequence id"
+Keywords "gt_eval jobs"
+Test do
+  [1, 4].each do |jobs|
+    run_test "#{$bin}gt -j #{jobs} #{$testdata}gtscripts/eval_unsorted.lua", \
+             :retval => 1
+    grep(last_stderr, /not sorted by sequence id/)
+  end
+end
@@ -65,4 +65,73 @@ if not $arguments["nordb"] then
     end
   end
 
+  FEATUREINDEX_TEST_FILES.each do |file|
+    Name "gt featureindex bulk vs. single inserts (#{File.basename(file)})"
+    Keywords "gt_featureindex bulk"
+    Test do
+      run "#{$bin}gt mkfeatureindex -bulk no -filename single.db #{file}",
+          :maxtime => 1200
+      run "#{$bin}gt featureindex -filename single.db > single.gff3"
+      run "#{$bin}gt mkfeatureindex -batchsize 10 -filename bulk.db #{file}"
+      run "#{$bin}gt featureindex -filename bulk.db"
+      run "diff #{last_stdout} single.gff3"
+      run "#{$bin}gt mkfeatureindex -v -filename bulk2.db #{file}"
+      grep(last_stdout, /loaded \d+ rows in/)
+      run "#{$bin}gt featureindex -filename bulk2.db"
+      run "diff #{last_stdout} single.gff3"
+    end
+  end
+
+  # more nodes per query than fit into one IN list of IDs (512)
+  Name "gt featureindex (batched node loading)"
+  Keywords "gt_featureindex"
+  Test do
+    File.open("many.gff3", "w") do |f|
+      f.puts "##gff-version 3"
+      f.puts "##sequence-region ctg1 1 401000"
+      1.upto(400) do |i|
+        s = i * 1000
+        f.puts "ctg1\t.\tgene\t#{s}\t#{s+800}\t.\t+\t.\tID=gene#{i}"
+        f.puts "ctg1\t.\tmRNA\t#{s}\t#{s+800}\t.\t+\t.\t" +
+               "ID=mRNA#{i};Parent=gene#{i}"
+        f.puts "ctg1\t.\texon\t#{s}\t#{s+200}\t.\t+\t.\t" +
+               "Parent=mRNA#{i};Name=exon#{i}a"
+        f.puts "ctg1\t.\texon\t#{s+500}\t#{s+800}\t.\t+\t.\t" +
+               "Parent=mRNA#{i};Name=exon#{i}b"
+      end
+    end
+    run "#{$bin}gt mkfeatureindex -filename tmp.db many.gff3"
+    run "#{$bin}gt featureindex -seqid ctg1 -retain no -filename tmp.db"
+    run "#{$bin}gt gff3 -retainids no many.gff3"
+    run "diff #{last_stdout} stdout_2"
+    run "#{$bin}gt featureindex -seqid ctg1 -range 50000 350900 " +
+        "-retain no -filename tmp.db"
+    run "#{$bin}gt gff3 -retainids no many.gff3 | " +
+        "#{$bin}gt select -overlap 50000 350900"
+    run "diff #{last_stdout} stdout_5"
+  end
+
+  Name "gt featureindex (query does not modify database)"
+  Keywords "gt_featureindex"
+  Test do
+    run "#{$bin}gt mkfeatureindex -filename tmp.db #{$testdata}/eden.gff3"
+    run "cp tmp.db orig.db"
+    run "#{$bin}gt featureindex -seqid ctg123 -range 1000 2000 " +
+        "-filename tmp.db"
+    run "cmp tmp.db orig.db"
+  end
+
+  Name "gt mkfeatureindex -force (bulk)"
+  Keywords "gt_featureindex bulk"
+  Test do
+    run "#{$bin}gt mkfeatureindex -filename tmp.db " +
+        "#{$testdata}/standard_gene_simple.gff3"
+    run "#{$bin}gt mkfeatureindex -force -filename tmp.db " +
+        "#{$testdata}/eden.gff3"
+    run "#{$bin}gt featureindex -filename tmp.db > forced.gff3"
+    run "#{$bin}gt mkfeatureindex -filename fresh.db #{$testdata}/eden.gff3"
+    run "#{$bin}gt featureindex -filename fresh.db"
+    run "diff #{last_stdout} forced.gff3"
+  end
+
 end
@@ -135,6 +135,17 @@ Test do
   end
 end
 
+Name "gt genomediff pck multithreaded"
+Keywords "gt_genomediff pck threads"
+Test do
+  smallfilecodes.each do |code|
+    test_pck("#{code}*.fas", "", "")
+    run "mv #{last_stdout} sequential.out"
+    run_test "#{$bin}gt -j 4 genomediff -indextype pck pck"
+    run "cmp -s #{last_stdout} sequential.out"
+  end
+end
+
 Name "gt genomediff esa testset"
 Keywords "gt_genomediff esa"
 Test do
@@ -1189,6 +1189,22 @@ Test do
   run "diff #{last_stdout} #{$testdata}standard_gene_as_tree.gff3"
 end
 
+Name "gt gff3 reverse feature order, multi-level orphans (-typecheck so)"
+Keywords "gt_gff3 typecheck"
+Test do
+  run_test "#{$bin}gt gff3 -typecheck so " +
+           "#{$testdata}reverse_standard_gene_as_tree.gff3"
+  run "diff #{last_stdout} #{$testdata}standard_gene_as_tree.gff3"
+end
+
+Name "gt gff3 inherited part_of (-typecheck so)"
+Keywords "gt_gff3 typecheck"
+Test do
+  ["multiple_top_level_parents.gff3", "not_sorted.gff3"].each do |file|
+    run_test "#{$bin}gt gff3 -typecheck so #{$testdata}#{file}"
+  end
+end
+
 Name "gt gff3 reverse feature order, multi-level orphans (-strict)"
 Keywords "gt_gff3"
 Test do
@@ -1473,6 +1489,89 @@ Test do
   run "#{$bin}gt gff3 #{$testdata}/double_free.gff3", :retval => 1
 end
 
+[ "standard_gene_as_tree.gff3",
+  "standard_gene_as_dag.gff3",
+  "standard_gene_with_introns_as_tree.gff3",
+  "multi_feature_simple.gff3",
+  "cds_with_multiple_parents_1_tidied.gff3",
+  "pseudo_feature_minimal.gff3",
+  "standard_fasta_example.gff3",
+  "gff3_file_1_short.txt" ].each do |file|
+  Name "gt gff3 -binary roundtrip (#{file})"
+  Keywords "gt_gff3 binary"
+  Test do
+    run_test "#{$bin}gt gff3 -binary -o out.gtb #{$testdata}#{file}"
+    run_test "#{$bin}gt gff3 out.gtb"
+    run "#{$bin}gt gff3 #{$testdata}#{file}"
+    run "diff #{last_stdout} stdout_2"
+  end
+end
+
+Name "gt gff3 -binary (pipe)"
+Keywords "gt_gff3 binary"
+Test do
+  run "#{$bin}gt gff3 -sort #{$testdata}standard_gene_as_dag.gff3"
+  run_test "#{$bin}gt gff3 -sort -binary " +
+           "#{$testdata}standard_gene_as_dag.gff3 | #{$bin}gt gff3 -"
+  run "diff #{last_stdout} stdout_1"
+end
+
+Name "gt gff3 -binary (multiple files)"
+Keywords "gt_gff3 binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o out.gtb " +
+           "#{$testdata}standard_gene_as_tree.gff3"
+  run_test "#{$bin}gt gff3 out.gtb #{$testdata}standard_gene_simple.gff3 out.gtb"
+  run "#{$bin}gt gff3 #{$testdata}standard_gene_as_tree.gff3 " +
+      "#{$testdata}standard_gene_simple.gff3 " +
+      "#{$testdata}standard_gene_as_tree.gff3"
+  run "diff #{last_stdout} stdout_2"
+end
+
+Name "gt gff3 -binary (empty stream)"
+Keywords "gt_gff3 binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o eden.gtb #{$testdata}eden.gff3"
+  run_test "#{$bin}gt select -seqid nonexistent -binary eden.gtb > empty.gtb"
+  run_test "#{$bin}gt gff3 empty.gtb"
+  run "#{$bin}gt select -seqid nonexistent #{$testdata}eden.gff3"
+  run "diff #{last_stdout} stdout_3"
+end
+
+Name "gt gff3 -binary (corrupt file)"
+Keywords "gt_gff3 binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o out.gtb " +
+           "#{$testdata}standard_gene_as_tree.gff3"
+  run "head -c 100 out.gtb > corrupt.gtb"
+  run_test "#{$bin}gt gff3 corrupt.gtb", :retval => 1
+  grep last_stderr, /binary file "corrupt.gtb" is corrupt/
+end
+
+Name "gt gff3 -binary (cyclic graph)"
+Keywords "gt_gff3 binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -o dag.gtb " +
+           "#{$testdata}gt_gff3_binary_dag.gff3"
+  # nodes: gene, CDS, mRNA, exon; the last byte is the index of the only
+  # child of the exon (the CDS), make it point to the mRNA instead
+  data = File.binread("dag.gtb")
+  if data[-1].ord != 1 then
+    raise "unexpected last byte in dag.gtb"
+  end
+  data[-1] = 2.chr
+  File.binwrite("cycle.gtb", data)
+  run_test "#{$bin}gt gff3 cycle.gtb", :retval => 1, :maxtime => 10
+  grep last_stderr, /binary file "cycle.gtb" is corrupt/
+end
+
+Name "gt gff3 -binary -sortlines"
+Keywords "gt_gff3 binary"
+Test do
+  run_test "#{$bin}gt gff3 -binary -sortlines " +
+           "#{$testdata}standard_gene_as_tree.gff3", :retval => 1
+end
+
 def large_gff3_test(name, file)
   Name "gt gff3 #{name}"
   Keywords "gt_gff3 large_gff3"
@@ -41,6 +41,33 @@ Test do
   run("diff #{last_stdout} #{$testdata}gt_gtf_to_gff3_test_stop_codon_in_cds2.gff3")
 end
 
+Name "gt gtf_to_gff3 -stream"
+Keywords "gt_gtf_to_gff3"
+Test do
+  ["gt_gtf_to_gff3_test.gtf", "gt_gtf_to_gff3_test_stop_codon_in_cds2.gtf"].each do |file|
+    run "#{$bin}gt gtf_to_gff3 -tidy #{$testdata}#{file} | " +
+        "#{$bin}gt gff3 -sort -tidy > whole.gff3"
+    run_test "#{$bin}gt gtf_to_gff3 -tidy -stream #{$testdata}#{file}"
+    run "#{$bin}gt gff3 -sort -tidy #{last_stdout} > streamed.gff3"
+    run "diff streamed.gff3 whole.gff3"
+  end
+end
+
+Name "gt gtf_to_gff3 -stream (stdin)"
+Keywords "gt_gtf_to_gff3"
+Test do
+  run_test "#{$bin}gt gtf_to_gff3 -stream " +
+           "< #{$testdata}gt_gtf_to_gff3_test.gtf"
+  grep last_stdout, /ENSG00000169359\.2/
+end
+
+Name "gt gtf_to_gff3 -stream (not grouped by gene)"
+Keywords "gt_gtf_to_gff3"
+Test do
+  run_test "#{$bin}gt gtf_to_gff3 -stream #{$testdata}gt_gtf_to_gff3_test_inconsistent_strand2.gtf", :retval => 1
+  grep last_stderr, /input is not grouped by gene_id/
+end
+
 if $gttestdata then
   Name "gt gtf_to_gff3 test D. melanogaster"
   Keywords "gt_gtf_to_gff3 large_gtf"
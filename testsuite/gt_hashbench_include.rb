@@ -0,0 +1,18 @@
+Name "gt dev hashbench"
+Keywords "gt_hashbench"
+Test do
+  run "#{$bin}gt dev hashbench -ids 20000 -seqids 50 -lookups 100000"
+  run "grep -c '^# TIME' #{last_stdout}"
+  run "grep '^18$' #{last_stdout}"
+end
+
+["swiss", "chained"].each do |impl|
+  ["id", "seqid", "direct"].each do |workload|
+    Name "gt dev hashbench -impl #{impl} -workload #{workload}"
+    Keywords "gt_hashbench"
+    Test do
+      run "#{$bin}gt dev hashbench -impl #{impl} -workload #{workload} " +
+          "-ids 1000 -seqids 1 -lookups 1000 -runs 2"
+    end
+  end
+end
@@ -142,3 +142,24 @@ Test do
   grep(last_stdout, /and not edited:\s+2/)
   grep(last_stdout, /and edited:\s+2/)
 end
+
+Name "gt hop: -j 4 == -j 1"
+Keywords "gt_hop"
+Test do
+  run "#{$bin}gt encseq encode #{$testdata}hop/genome3.fas"
+  # the BAM index is built next to the BAM file
+  run "cp #{$testdata}hop/map3.bam ."
+  ["-aggressive", "-conservative"].each do |mode|
+    run_test "#{$bin}gt -j 1 hop -c genome3.fas "+
+             "-map map3.bam #{mode} -v "+
+             "-reads #{$testdata}hop/reads.fastq"
+    run "mv #{last_stdout} j1.log"
+    run "mv hop_reads.fastq j1.fastq"
+    run_test "#{$bin}gt -j 4 hop -c genome3.fas "+
+             "-map map3.bam #{mode} -v "+
+             "-reads #{$testdata}hop/reads.fastq"
+    run "diff j1.log #{last_stdout}"
+    run "diff j1.fastq hop_reads.fastq"
+    run "test -s map3.bam.bai"
+  end
+end
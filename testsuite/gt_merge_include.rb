@@ -37,3 +37,68 @@ Test do
   run_test "#{$bin}gt merge #{$testdata}minimal_fasta.gff3 #{$testdata}two_fasta_seqs.gff3"
   run "diff #{last_stdout} #{$testdata}merge_with_seq.gff3"
 end
+
+1.upto(2) do |i|
+  Name "gt merge test #{i+2} (parallel parsing)"
+  Keywords "gt_merge"
+  Test do
+    run_test "#{$bin}gt -j 2 merge #{$testdata}gt_merge_prob_#{i}.in1 " +
+             "#{$testdata}gt_merge_prob_#{i}.in2"
+    run "diff #{last_stdout} #{$testdata}gt_merge_prob_#{i}.out"
+  end
+end
+
+Name "gt merge with sequence (parallel parsing)"
+Keywords "gt_merge"
+Test do
+  run_test "#{$bin}gt -j 2 merge #{$testdata}minimal_fasta.gff3 " +
+           "#{$testdata}two_fasta_seqs.gff3"
+  run "diff #{last_stdout} #{$testdata}merge_with_seq.gff3"
+end
+
+Name "gt merge unsorted file (parallel parsing)"
+Keywords "gt_merge"
+Test do
+  run_test("#{$bin}gt -j 2 merge #{$testdata}unsorted_gff3_file.txt",
+           :retval => 1)
+  grep(last_stderr, "is not sorted")
+end
+
+[nil, 1, 2, 4].each do |jobs|
+  Name "gt merge -splitseqids (#{jobs ? "-j #{jobs}" : "without -j"})"
+  Keywords "gt_merge splitseqids"
+  Test do
+    run_test "#{$bin}gt #{"-j #{jobs}" if jobs} merge -splitseqids . " +
+             "#{$testdata}gt_merge_split.in1 #{$testdata}gt_merge_split.in2"
+    1.upto(3) do |s|
+      run "diff seq#{s}.gff3 #{$testdata}gt_merge_split_seq#{s}.out"
+    end
+  end
+end
+
+Name "gt merge -splitseqids with sequence"
+Keywords "gt_merge splitseqids"
+Test do
+  run_test("#{$bin}gt merge -splitseqids . " +
+           "#{$testdata}minimal_fasta.gff3 #{$testdata}two_fasta_seqs.gff3",
+           :retval => 1)
+  grep(last_stderr, "does not support FASTA sequences")
+end
+
+Name "gt merge -splitseqids with unsafe sequence ID"
+Keywords "gt_merge splitseqids"
+Test do
+  run "mkdir out"
+  run_test("#{$bin}gt merge -splitseqids out " +
+           "#{$testdata}gt_merge_split_badseqid.gff3", :retval => 1)
+  grep(last_stderr, "cannot be used as a file name")
+  run "test ! -e seq1.gff3"
+end
+
+Name "gt merge -splitseqids and -o"
+Keywords "gt_merge splitseqids"
+Test do
+  run_test("#{$bin}gt merge -splitseqids . -o out.gff3 " +
+           "#{$testdata}gt_merge_split.in1", :retval => 1)
+  grep(last_stderr, "cannot be combined")
+end
@@ -285,6 +285,43 @@ Test do
   grep last_stderr, /error/
 end
 
+Name "gt select test (-rule_files, parallel evaluation)"
+Keywords "gt_select"
+Test do
+  run_test "#{$bin}gt -j 2 select -rule_files " +
+           "#{$testdata}gtscripts/filter_test_orflength.lua -- " +
+           "#{$testdata}filter_luafilter_test.gff3"
+  run "diff #{last_stdout} #{$testdata}filter_luafilter_filtered_orfs.gff3"
+end
+
+Name "gt select test (-rule_files, parallel evaluation, -dropped_file)"
+Keywords "gt_select"
+Test do
+  run_test "#{$bin}gt select -dropped_file serial.gff3 -rule_files " +
+           "#{$testdata}gtscripts/filter_test_LTR.lua -- " +
+           "#{$testdata}filter_luafilter_test.gff3"
+  run "mv #{last_stdout} serial.out"
+  run_test "#{$bin}gt -j 3 select -dropped_file parallel.gff3 -rule_files " +
+           "#{$testdata}gtscripts/filter_test_LTR.lua -- " +
+           "#{$testdata}filter_luafilter_test.gff3"
+  run "diff #{last_stdout} serial.out"
+  run "diff parallel.gff3 serial.gff3"
+end
+
+Name "gt select test (-rule_files, parallel evaluation, read-only nodes)"
+Keywords "gt_select"
+Test do
+  File.open("modify.lua", "w") do |f|
+    f.puts "function filter(gn)"
+    f.puts "  gn:set_source(\"foo\")"
+    f.puts "  return false"
+    f.puts "end"
+  end
+  run_test "#{$bin}gt -j 2 select -rule_files modify.lua -- " +
+           "#{$testdata}standard_gene_as_tree.gff3", :retval => 1
+  grep last_stderr, /read-only/
+end
+
 Name "gt select test (reading_frame_length % 3 != 0)"
 Keywords "gt_select"
 Test do
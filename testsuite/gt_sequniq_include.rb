@@ -1,6 +1,7 @@
 require "fileutils"
 
-["", " -rev", " -seqit", " -seqit -rev"].each do |opt|
+["", " -rev", " -seqit", " -seqit -rev", " -partitions 3",
+ " -partitions 3 -rev"].each do |opt|
   Name "gt sequniq#{opt} 2xfoo test"
   Keywords "gt_sequniq"
   Test do
@@ -67,3 +68,39 @@ Test do
   run_test "#{$bin}gt sequniq -rev gt_sequniq_rev_bug.fas"
   run "diff #{last_stdout} #{$testdata}gt_sequniq_rev_bug.out"
 end
+
+["", " -rev"].each do |opt|
+  ["Reads1.fna", "Reads2.fna", "U89959_ests.fas"].each do |file|
+    Name "gt sequniq#{opt} multithreaded and partitioned #{file}"
+    Keywords "gt_sequniq"
+    Test do
+      run_test "#{$bin}gt sequniq -seqit#{opt} #{$testdata}#{file}"
+      run "mv #{last_stdout} sequential.fas"
+      run "mv #{last_stderr} sequential.stats"
+      ["-j 4 sequniq#{opt}", "-j 3 sequniq -seqit#{opt}",
+       "sequniq -partitions 5#{opt}",
+       "-j 2 sequniq -partitions 4#{opt}"].each do |args|
+        run_test "#{$bin}gt #{args} #{$testdata}#{file}"
+        run "diff #{last_stdout} sequential.fas"
+        run "diff #{last_stderr} sequential.stats"
+      end
+    end
+  end
+end
+
+Name "gt sequniq -partitions (stdin)"
+Keywords "gt_sequniq"
+Test do
+  run_test "#{$bin}gt sequniq -partitions 2 - < #{$testdata}foofoo.fas",
+           :retval => 1
+  grep last_stderr, /cannot be used with standard input/
+end
+
+Name "gt sequniq -partitions (too many)"
+Keywords "gt_sequniq"
+Test do
+  run_test "#{$bin}gt sequniq -partitions 257 #{$testdata}foofoo.fas",
+           :retval => 1
+  grep last_stderr, /must be an integer <= 256/
+  run_test "#{$bin}gt sequniq -partitions 256 #{$testdata}foofoo.fas"
+end
@@ -49,6 +49,40 @@ runtyrmkifail("-mersize 21 -pl")
 runtyrmkifail("-mersize 21 -pl -minocc")
 runtyrmkifail("-pl -minocc 30 -maxocc 40")
 
+Name "gt tallymer search multithreaded"
+Keywords "gt_tallymer search"
+Test do
+  run_test "#{$bin}gt suffixerator -pl -dna -tis -suf -lcp " +
+           "-indexname sfxidx -db #{$testdata}at1MB", :maxtime => 360
+  run_test "#{$bin}gt tallymer mkindex -counts -pl -mersize 20 -minocc 2 " +
+           "-indexname tyr-index -esa sfxidx", :maxtime => 360
+  run_test "#{$bin}gt tallymer mkindex -counts -mersize 20 -minocc 2 " +
+           "-indexname tyr-nobck -esa sfxidx", :maxtime => 360
+  searchargs = "tallymer search -strand fp -output qseqnum qpos counts " +
+               "sequence -q #{$testdata}U89959_genomic.fas #{$testdata}at1MB"
+  run_test "#{$bin}gt -j 1 #{searchargs} -tyr tyr-index", :maxtime => 360
+  run "mv #{last_stdout} search-j1.out"
+  run_test "#{$bin}gt -j 4 #{searchargs} -tyr tyr-index", :maxtime => 360
+  run "cmp -s #{last_stdout} search-j1.out"
+  run_test "#{$bin}gt -j 4 #{searchargs} -tyr tyr-nobck", :maxtime => 360
+  run "cmp -s #{last_stdout} search-j1.out"
+end
+
+Name "gt tallymer occratio multithreaded"
+Keywords "gt_tallymer occratio"
+Test do
+  run_test "#{$bin}gt suffixerator -pl -dna -tis -suf -lcp " +
+           "-indexname sfxidx -db #{$testdata}at1MB", :maxtime => 360
+  occargs = "tallymer occratio -esa sfxidx -output unique nonunique " +
+            "nonuniquemulti relative total"
+  ["-minmersize 1 -maxmersize 30","-mersizes 10 20 300"].each do |mersizes|
+    run_test "#{$bin}gt #{occargs} #{mersizes} -scan", :maxtime => 360
+    run "mv #{last_stdout} occratio-scan.out"
+    run_test "#{$bin}gt -j 4 #{occargs} #{mersizes}", :maxtime => 360
+    run "cmp -s #{last_stdout} occratio-scan.out"
+  end
+end
+
 if $gttestdata then
   tyrfiles.each_pair do |reffile,mersize|
     Name "gt tallymer #{reffile}"
@@ -50,6 +50,19 @@ if $gttestdata then
   end
 end
 
+Name "gt tirvish -j 4"
+Keywords "gt_tirvish"
+Test do
+  run_test "#{$bin}gt suffixerator -db #{$testdata}U89959_genomic.fas " + \
+           "-dna -mirrored -suf -lcp -tis -des -sds -ssp -indexname U89959"
+  ["", " -seed 12 -mintirlen 20 -mintirdist 50"].each do |opts|
+    run_test "#{$bin}gt -j 1 tirvish -index U89959#{opts} > sequential.gff3"
+    grep "sequential.gff3", /terminal_inverted_repeat_element/
+    run_test "#{$bin}gt -j 4 tirvish -index U89959#{opts} > parallel.gff3"
+    run "diff sequential.gff3 parallel.gff3"
+  end
+end
+
 Name "gt tirvish missing index"
 Keywords "gt_tirvish"
 Test do
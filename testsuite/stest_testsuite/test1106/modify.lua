@@ -0,0 +1,4 @@
+function filter(gn)
+  gn:set_source("foo")
+  return false
+end